@@ -5,6 +5,7 @@
 #include <export.h>
 #include <printk.h>
 #include <backing-dev.h>
+#include <linkage.h>
 
 struct backing_dev_info noop_backing_dev_info = {
     .capabilities = BDI_CAP_NO_ACCT_AND_WRITEBACK,
@@ -42,7 +43,7 @@ struct backing_dev_info *bdi_alloc(void)
 }
 EXPORT_SYMBOL(bdi_alloc);
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[backing-dev]: init begin ...\n");
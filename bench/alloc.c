@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <gfp.h>
+#include <slab.h>
+#include <errno.h>
+
+#include "internal.h"
+
+/* Up to the largest size class short of whole pages */
+#define KMALLOC_BENCH_MAX   PAGE_SIZE
+#define PAGES_BENCH_ORDER   5
+
+static void
+kmalloc_run(struct bench *b)
+{
+    unsigned int i;
+    void *p;
+
+    for (i = 0; i < b->ops; i++) {
+        p = kmalloc(b->arg, GFP_KERNEL);
+        kfree(p);
+    }
+}
+
+void bench_kmalloc(void)
+{
+    struct bench b = {
+        .name = "kmalloc_kfree",
+        .ops = 64,
+        .run = kmalloc_run,
+    };
+
+    for (b.arg = 8; b.arg <= KMALLOC_BENCH_MAX; b.arg <<= 1)
+        bench_report(&b);
+}
+
+static int
+alloc_pages_setup(struct bench *b)
+{
+    struct page *page = alloc_pages(GFP_KERNEL, b->arg);
+
+    if (!page)
+        return -ENOMEM;
+    __free_pages(page, b->arg);
+    return 0;
+}
+
+static void
+alloc_pages_run(struct bench *b)
+{
+    struct page *page;
+    unsigned int i;
+
+    for (i = 0; i < b->ops; i++) {
+        page = alloc_pages(GFP_KERNEL, b->arg);
+        if (page)
+            __free_pages(page, b->arg);
+    }
+}
+
+void bench_alloc_pages(void)
+{
+    struct bench b = {
+        .name = "alloc_free_pages",
+        .ops = 16,
+        .setup = alloc_pages_setup,
+        .run = alloc_pages_run,
+    };
+
+    for (b.arg = 0; b.arg <= PAGES_BENCH_ORDER; b.arg++)
+        bench_report(&b);
+}
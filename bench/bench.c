@@ -0,0 +1,124 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <timex.h>
+#include <export.h>
+#include <module.h>
+#include <printk.h>
+#include <linkage.h>
+
+#include "internal.h"
+
+/*
+ * Result table, one "bench: " console line per row between "begin"
+ * and "end". Cycles and instructions are per operation, lines that
+ * start with '#' are comments. scripts/benchcmp compares two tables.
+ */
+
+static u64 bench_cycles[BENCH_SAMPLES];
+static u64 bench_insns[BENCH_SAMPLES];
+
+static void
+sort_samples(u64 *samples, unsigned int n)
+{
+    unsigned int i, j;
+    u64 v;
+
+    for (i = 1; i < n; i++) {
+        v = samples[i];
+        for (j = i; j > 0 && samples[j - 1] > v; j--)
+            samples[j] = samples[j - 1];
+        samples[j] = v;
+    }
+}
+
+/* Sorts @samples in place */
+void bench_summarize(u64 *samples, unsigned int n, struct bench_result *res)
+{
+    sort_samples(samples, n);
+
+    res->min = samples[0];
+    res->median = samples[n / 2];
+    res->p99 = samples[(n * 99) / 100];
+}
+EXPORT_SYMBOL(bench_summarize);
+
+int bench_run(struct bench *b, struct bench_result *res)
+{
+    struct bench_result insns;
+    cycles_t c0, c1;
+    u64 n0, n1;
+    unsigned int i;
+    int err;
+
+    if (b->setup) {
+        err = b->setup(b);
+        if (err)
+            return err;
+    }
+
+    for (i = 0; i < BENCH_WARMUP; i++)
+        b->run(b);
+
+    for (i = 0; i < BENCH_SAMPLES; i++) {
+        n0 = get_instret();
+        c0 = get_cycles();
+        b->run(b);
+        c1 = get_cycles();
+        n1 = get_instret();
+
+        bench_cycles[i] = (c1 - c0) / b->ops;
+        bench_insns[i] = (n1 - n0) / b->ops;
+    }
+
+    if (b->teardown)
+        b->teardown(b);
+
+    bench_summarize(bench_cycles, BENCH_SAMPLES, res);
+    bench_summarize(bench_insns, BENCH_SAMPLES, &insns);
+    res->insns = insns.median;
+    return 0;
+}
+EXPORT_SYMBOL(bench_run);
+
+void bench_report(struct bench *b)
+{
+    struct bench_result res;
+    int err;
+
+    err = bench_run(b, &res);
+    if (err) {
+        printk("bench: # %s %lu failed %d\n", b->name, b->arg, err);
+        return;
+    }
+
+    printk("bench: %s %lu %u %lu %lu %lu %lu\n", b->name, b->arg, b->ops,
+           res.min, res.median, res.p99, res.insns);
+}
+
+/* Only worth the time when asked for, see 'make BENCH=1' */
+MODULE_INIT_LEVEL(MODULE_INIT_DEFERRED);
+
+static int __init
+init_module(void)
+{
+    printk("module[bench]: init begin ...\n");
+
+    printk("bench: begin %u\n", BENCH_SAMPLES);
+    printk("bench: # name arg ops min median p99 insns\n");
+
+    bench_kmalloc();
+    bench_alloc_pages();
+    bench_memcpy();
+    bench_memset();
+    bench_xarray();
+    bench_radix_tree();
+    bench_rbtree();
+    bench_d_lookup();
+    bench_find_vma();
+
+    printk("bench: end\n");
+    console_flush();
+
+    printk("module[bench]: init end!\n");
+    return 0;
+}
@@ -0,0 +1,49 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#include <types.h>
+
+/* Samples taken of each benchmark, after the warmup ones */
+#define BENCH_WARMUP    16
+#define BENCH_SAMPLES   200
+
+/*
+ * One sample is a call of run(), which does @ops operations, so that
+ * reading the counters around it costs little against them. Results
+ * are per operation.
+ */
+struct bench {
+    const char *name;
+    unsigned long arg;      /* size, order or count, as in the table */
+    unsigned int ops;
+
+    int (*setup)(struct bench *b);
+    void (*run)(struct bench *b);
+    void (*teardown)(struct bench *b);
+
+    void *data;
+};
+
+struct bench_result {
+    u64 min;
+    u64 median;
+    u64 p99;
+    u64 insns;              /* median instructions */
+};
+
+void bench_summarize(u64 *samples, unsigned int n, struct bench_result *res);
+
+int bench_run(struct bench *b, struct bench_result *res);
+
+/* Run @b and write its row of the result table */
+void bench_report(struct bench *b);
+
+/* The benchmarks, by subsystem */
+void bench_kmalloc(void);
+void bench_alloc_pages(void);
+void bench_memcpy(void);
+void bench_memset(void);
+void bench_xarray(void);
+void bench_radix_tree(void);
+void bench_rbtree(void);
+void bench_d_lookup(void);
+void bench_find_vma(void);
@@ -0,0 +1,182 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <mm.h>
+#include <slab.h>
+#include <errno.h>
+#include <dcache.h>
+#include <current.h>
+#include <kernel.h>
+#include <string.h>
+#include <stringhash.h>
+
+#include "internal.h"
+
+#define DCACHE_BENCH_NAMES  256
+#define DCACHE_BENCH_NLEN   8
+
+/*
+ * Negative children of a parent outside the tree, built on first use
+ * and kept, there is nothing to drop dentries here.
+ */
+static struct dentry *bench_parent;
+static char bench_names[DCACHE_BENCH_NAMES + 1][DCACHE_BENCH_NLEN];
+static struct qstr bench_qstrs[DCACHE_BENCH_NAMES + 1];
+
+static unsigned long bench_name_index;
+
+/* As hash_name() in fs/namei.c */
+static void
+bench_qstr_init(struct qstr *q, const char *name)
+{
+    unsigned long hash = init_name_hash(bench_parent);
+    unsigned long len;
+
+    for (len = 0; name[len]; len++)
+        hash = partial_name_hash((unsigned char)name[len], hash);
+
+    q->hash_len = hashlen_create(end_name_hash(hash), len);
+    q->name = (const unsigned char *)name;
+}
+
+/* The last name is never added, for lookups that miss */
+static int
+d_lookup_setup(struct bench *b)
+{
+    struct dentry *dentry;
+    unsigned int i;
+
+    if (bench_parent)
+        return 0;
+
+    bench_parent = d_alloc_anon(current->fs->root.dentry->d_sb);
+    if (!bench_parent)
+        return -ENOMEM;
+
+    for (i = 0; i <= DCACHE_BENCH_NAMES; i++) {
+        sprintf(bench_names[i], "b%u", i);
+        bench_qstr_init(&bench_qstrs[i], bench_names[i]);
+        if (i == DCACHE_BENCH_NAMES)
+            break;
+
+        dentry = d_alloc(bench_parent, &bench_qstrs[i]);
+        if (!dentry)
+            return -ENOMEM;
+        d_add(dentry, NULL);
+    }
+    return 0;
+}
+
+static void
+d_lookup_run(struct bench *b)
+{
+    unsigned int i;
+
+    for (i = 0; i < b->ops; i++) {
+        bench_name_index = (bench_name_index + 97) & (b->arg - 1);
+        d_lookup(bench_parent, &bench_qstrs[bench_name_index]);
+    }
+}
+
+static void
+d_lookup_miss_run(struct bench *b)
+{
+    unsigned int i;
+
+    for (i = 0; i < b->ops; i++)
+        d_lookup(bench_parent, &bench_qstrs[DCACHE_BENCH_NAMES]);
+}
+
+void bench_d_lookup(void)
+{
+    struct bench b = {
+        .name = "d_lookup",
+        .arg = DCACHE_BENCH_NAMES,
+        .ops = 64,
+        .setup = d_lookup_setup,
+        .run = d_lookup_run,
+    };
+
+    bench_report(&b);
+
+    b.name = "d_lookup_miss";
+    b.run = d_lookup_miss_run;
+    bench_report(&b);
+}
+
+/* VMAs of a page each with a page of hole between them */
+#define VMA_BENCH_BASE      0x10000000UL
+#define VMA_BENCH_STRIDE    (2 * PAGE_SIZE)
+
+struct bench_mm {
+    struct mm_struct mm;
+    struct vm_area_struct *vmas;
+    unsigned long index;
+};
+
+static int
+find_vma_setup(struct bench *b)
+{
+    struct bench_mm *bm;
+    struct vm_area_struct *vma;
+    unsigned long i;
+
+    bm = kmalloc(sizeof(*bm), GFP_KERNEL | __GFP_ZERO);
+    if (!bm)
+        return -ENOMEM;
+
+    bm->vmas = kmalloc(b->arg * sizeof(*bm->vmas), GFP_KERNEL);
+    if (!bm->vmas) {
+        kfree(bm);
+        return -ENOMEM;
+    }
+
+    for (i = 0; i < b->arg; i++) {
+        vma = bm->vmas + i;
+        vma_init(vma, &bm->mm);
+        vma->vm_start = VMA_BENCH_BASE + i * VMA_BENCH_STRIDE;
+        vma->vm_end = vma->vm_start + PAGE_SIZE;
+        if (insert_vm_struct(&bm->mm, vma)) {
+            kfree(bm->vmas);
+            kfree(bm);
+            return -ENOMEM;
+        }
+    }
+
+    b->data = bm;
+    return 0;
+}
+
+static void
+find_vma_run(struct bench *b)
+{
+    struct bench_mm *bm = b->data;
+    unsigned int i;
+
+    for (i = 0; i < b->ops; i++) {
+        bm->index = (bm->index + 97) & (b->arg - 1);
+        find_vma(&bm->mm, VMA_BENCH_BASE + bm->index * VMA_BENCH_STRIDE);
+    }
+}
+
+static void
+find_vma_teardown(struct bench *b)
+{
+    struct bench_mm *bm = b->data;
+
+    kfree(bm->vmas);
+    kfree(bm);
+}
+
+void bench_find_vma(void)
+{
+    struct bench b = {
+        .name = "find_vma",
+        .ops = 64,
+        .setup = find_vma_setup,
+        .run = find_vma_run,
+        .teardown = find_vma_teardown,
+    };
+
+    for (b.arg = 16; b.arg <= 1024; b.arg <<= 3)
+        bench_report(&b);
+}
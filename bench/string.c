@@ -0,0 +1,85 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <gfp.h>
+#include <log2.h>
+#include <sizes.h>
+#include <errno.h>
+#include <kernel.h>
+#include <string.h>
+
+#include "internal.h"
+
+#define STRING_BENCH_MAX    SZ_64K
+
+static const unsigned long string_bench_sizes[] = {
+    8, 64, 256, 1024, 4096, STRING_BENCH_MAX,
+};
+
+/* Source and destination of STRING_BENCH_MAX each */
+static int
+string_setup(struct bench *b)
+{
+    b->data = (void *)__get_free_pages(GFP_KERNEL,
+                                       get_order(2 * STRING_BENCH_MAX));
+    return b->data ? 0 : -ENOMEM;
+}
+
+static void
+string_teardown(struct bench *b)
+{
+    free_pages((unsigned long)b->data, get_order(2 * STRING_BENCH_MAX));
+}
+
+static void
+memcpy_run(struct bench *b)
+{
+    unsigned int i;
+
+    for (i = 0; i < b->ops; i++)
+        memcpy(b->data, b->data + STRING_BENCH_MAX, b->arg);
+}
+
+static void
+memset_run(struct bench *b)
+{
+    unsigned int i;
+
+    for (i = 0; i < b->ops; i++)
+        memset(b->data, i, b->arg);
+}
+
+static void
+string_bench(struct bench *b)
+{
+    unsigned int i;
+
+    for (i = 0; i < ARRAY_SIZE(string_bench_sizes); i++) {
+        b->arg = string_bench_sizes[i];
+        b->ops = b->arg >= 4096 ? 4 : 64;
+        bench_report(b);
+    }
+}
+
+void bench_memcpy(void)
+{
+    struct bench b = {
+        .name = "memcpy",
+        .setup = string_setup,
+        .run = memcpy_run,
+        .teardown = string_teardown,
+    };
+
+    string_bench(&b);
+}
+
+void bench_memset(void)
+{
+    struct bench b = {
+        .name = "memset",
+        .setup = string_setup,
+        .run = memset_run,
+        .teardown = string_teardown,
+    };
+
+    string_bench(&b);
+}
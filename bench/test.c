@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <printk.h>
+#include <linkage.h>
+
+#include "internal.h"
+
+static int
+test_summarize(void)
+{
+    struct bench_result res;
+    u64 samples[BENCH_SAMPLES];
+    unsigned int i;
+
+    /* BENCH_SAMPLES - 1 down to 0 */
+    for (i = 0; i < BENCH_SAMPLES; i++)
+        samples[i] = BENCH_SAMPLES - 1 - i;
+
+    bench_summarize(samples, BENCH_SAMPLES, &res);
+
+    for (i = 1; i < BENCH_SAMPLES; i++) {
+        if (samples[i - 1] > samples[i]) {
+            printk(_RED("samples aren't sorted at %u!\n"), i);
+            return -1;
+        }
+    }
+
+    if (res.min != 0 || res.median != BENCH_SAMPLES / 2 ||
+        res.p99 != BENCH_SAMPLES * 99 / 100) {
+        printk(_RED("bad summary %lu %lu %lu!\n"),
+               res.min, res.median, res.p99);
+        return -1;
+    }
+
+    return 0;
+}
+
+static unsigned long test_runs;
+
+static void
+test_run(struct bench *b)
+{
+    test_runs++;
+}
+
+static int
+test_bench_run(void)
+{
+    struct bench_result res;
+    struct bench b = {
+        .name = "test",
+        .ops = 1,
+        .run = test_run,
+    };
+
+    if (bench_run(&b, &res)) {
+        printk(_RED("bench_run failed!\n"));
+        return -1;
+    }
+
+    if (test_runs != BENCH_WARMUP + BENCH_SAMPLES) {
+        printk(_RED("run %lu times!\n"), test_runs);
+        return -1;
+    }
+
+    if (res.min > res.median || res.median > res.p99) {
+        printk(_RED("bad result %lu %lu %lu!\n"),
+               res.min, res.median, res.p99);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int __init
+init_module(void)
+{
+    printk("module[test_bench]: init begin ...\n");
+
+    if (test_summarize()) {
+        printk(_RED("test summarize failed!\n"));
+        return -1;
+    }
+
+    if (test_bench_run()) {
+        printk(_RED("test bench_run failed!\n"));
+        return -1;
+    }
+
+    printk(_GREEN("okay!\n"));
+
+    printk("module[test_bench]: init end!\n");
+    return 0;
+}
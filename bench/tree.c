@@ -0,0 +1,243 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <slab.h>
+#include <errno.h>
+#include <rbtree.h>
+#include <xarray.h>
+#include <radix-tree.h>
+
+#include "internal.h"
+
+/* Dense like the page cache of a 4M file */
+#define XA_BENCH_ENTRIES    1024
+/* Sparse, so that lookups go through more levels */
+#define RADIX_BENCH_ENTRIES 1024
+#define RADIX_BENCH_STRIDE  4099
+
+/*
+ * The arrays are built on first use and kept, neither has a way to
+ * free its nodes here.
+ */
+static struct xarray bench_xa;
+static bool bench_xa_ready;
+static RADIX_TREE(bench_radix, 0);
+static bool bench_radix_ready;
+
+/* Entries to store, 8 byte aligned so that none is an internal one */
+static u64 bench_items[XA_BENCH_ENTRIES];
+
+/* Index of the next operation, strides through the whole array */
+static unsigned long bench_index;
+
+#define next_index(n)   (bench_index = (bench_index + 97) & ((n) - 1))
+
+static int
+xarray_setup(struct bench *b)
+{
+    unsigned long i;
+
+    if (bench_xa_ready)
+        return 0;
+
+    for (i = 0; i < XA_BENCH_ENTRIES; i++) {
+        XA_STATE(xas, &bench_xa, i);
+
+        xas_store(&xas, &bench_items[i]);
+        if (xas_error(&xas))
+            return xas_error(&xas);
+    }
+    bench_xa_ready = true;
+    return 0;
+}
+
+static void
+xa_load_run(struct bench *b)
+{
+    unsigned int i;
+
+    for (i = 0; i < b->ops; i++)
+        xa_load(&bench_xa, next_index(XA_BENCH_ENTRIES));
+}
+
+static void
+xas_store_one(unsigned long index)
+{
+    XA_STATE(xas, &bench_xa, index);
+
+    xas_store(&xas, &bench_items[index]);
+}
+
+/* Replaces present entries, so it never allocates */
+static void
+xas_store_run(struct bench *b)
+{
+    unsigned int i;
+
+    for (i = 0; i < b->ops; i++)
+        xas_store_one(next_index(XA_BENCH_ENTRIES));
+}
+
+void bench_xarray(void)
+{
+    struct bench b = {
+        .name = "xa_load",
+        .arg = XA_BENCH_ENTRIES,
+        .ops = 64,
+        .setup = xarray_setup,
+        .run = xa_load_run,
+    };
+
+    bench_report(&b);
+
+    b.name = "xas_store";
+    b.run = xas_store_run;
+    bench_report(&b);
+}
+
+static int
+radix_tree_setup(struct bench *b)
+{
+    unsigned long i;
+    int err;
+
+    if (bench_radix_ready)
+        return 0;
+
+    for (i = 0; i < RADIX_BENCH_ENTRIES; i++) {
+        err = radix_tree_insert(&bench_radix, i * RADIX_BENCH_STRIDE,
+                                &bench_items[i]);
+        if (err)
+            return err;
+    }
+    bench_radix_ready = true;
+    return 0;
+}
+
+static void
+radix_tree_lookup_run(struct bench *b)
+{
+    unsigned int i;
+
+    for (i = 0; i < b->ops; i++) {
+        radix_tree_lookup(&bench_radix,
+                          next_index(RADIX_BENCH_ENTRIES) *
+                          RADIX_BENCH_STRIDE);
+    }
+}
+
+void bench_radix_tree(void)
+{
+    struct bench b = {
+        .name = "radix_tree_lookup",
+        .arg = RADIX_BENCH_ENTRIES,
+        .ops = 64,
+        .setup = radix_tree_setup,
+        .run = radix_tree_lookup_run,
+    };
+
+    bench_report(&b);
+}
+
+struct bench_rb_node {
+    struct rb_node node;
+    unsigned long key;
+};
+
+struct bench_rb_tree {
+    struct rb_root root;
+    struct bench_rb_node *nodes;
+    unsigned long seed;
+};
+
+static unsigned long
+next_key(struct bench_rb_tree *tree)
+{
+    tree->seed = tree->seed * 6364136223846793005UL + 1442695040888963407UL;
+    return tree->seed >> 16;
+}
+
+static void
+rb_bench_insert(struct bench_rb_tree *tree, struct bench_rb_node *data)
+{
+    struct rb_node **link = &tree->root.rb_node;
+    struct rb_node *parent = NULL;
+    struct bench_rb_node *this;
+
+    while (*link) {
+        parent = *link;
+        this = rb_entry(parent, struct bench_rb_node, node);
+        if (data->key < this->key)
+            link = &parent->rb_left;
+        else
+            link = &parent->rb_right;
+    }
+
+    rb_link_node(&data->node, parent, link);
+    rb_insert_color(&data->node, &tree->root);
+}
+
+static int
+rbtree_setup(struct bench *b)
+{
+    struct bench_rb_tree *tree;
+    unsigned long i;
+
+    tree = kmalloc(sizeof(*tree), GFP_KERNEL);
+    if (!tree)
+        return -ENOMEM;
+
+    tree->nodes = kmalloc(b->arg * sizeof(*tree->nodes), GFP_KERNEL);
+    if (!tree->nodes) {
+        kfree(tree);
+        return -ENOMEM;
+    }
+
+    tree->root = RB_ROOT;
+    tree->seed = b->arg;
+    for (i = 0; i < b->arg; i++) {
+        tree->nodes[i].key = next_key(tree);
+        rb_bench_insert(tree, tree->nodes + i);
+    }
+
+    b->data = tree;
+    return 0;
+}
+
+/* Move one node to a new key, so the tree keeps its size */
+static void
+rbtree_run(struct bench *b)
+{
+    struct bench_rb_tree *tree = b->data;
+    struct bench_rb_node *data;
+    unsigned int i;
+
+    for (i = 0; i < b->ops; i++) {
+        data = tree->nodes + next_index(b->arg);
+        rb_erase(&data->node, &tree->root);
+        data->key = next_key(tree);
+        rb_bench_insert(tree, data);
+    }
+}
+
+static void
+rbtree_teardown(struct bench *b)
+{
+    struct bench_rb_tree *tree = b->data;
+
+    kfree(tree->nodes);
+    kfree(tree);
+}
+
+void bench_rbtree(void)
+{
+    struct bench b = {
+        .name = "rb_erase_insert",
+        .ops = 64,
+        .setup = rbtree_setup,
+        .run = rbtree_run,
+        .teardown = rbtree_teardown,
+    };
+
+    for (b.arg = 64; b.arg <= 16384; b.arg <<= 4)
+        bench_report(&b);
+}
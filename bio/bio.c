@@ -8,6 +8,7 @@
 #include <string.h>
 #include <export.h>
 #include <mempool.h>
+#include <linkage.h>
 
 /*
  * Test patch to inline a certain number of bi_io_vec's inside the bio
@@ -268,7 +269,7 @@ static int init_bio(void)
     return 0;
 }
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[bio]: init begin ...\n");
@@ -1,7 +1,8 @@
 // SPDX-License-Identifier: GPL-2.0-only
 #include <printk.h>
+#include <linkage.h>
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[test_bio]: init begin ...\n");
@@ -5,6 +5,7 @@
 #include <kernel.h>
 #include <printk.h>
 #include <find_bit.h>
+#include <linkage.h>
 
 unsigned long
 bitmap_find_next_zero_area_off(unsigned long *map,
@@ -54,7 +55,7 @@ void __bitmap_set(unsigned long *map, unsigned int start, int len)
 }
 EXPORT_SYMBOL(__bitmap_set);
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[bitmap]: init begin ...\n");
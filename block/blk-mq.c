@@ -14,8 +14,19 @@
 #include <interrupt.h>
 #include <blk-mq-sched.h>
 
+#define CREATE_TRACE_POINTS
+#include <trace/events/block.h>
+
+/* ms before a queue which ran out of driver resources is run again */
+#define BLK_MQ_RESOURCE_DELAY   3
+
 static struct list_head blk_cpu_done;
 
+static void
+__blk_mq_delay_run_hw_queue(struct blk_mq_hw_ctx *hctx,
+                            bool async,
+                            unsigned long msecs);
+
 static int blk_mq_hw_ctx_size(struct blk_mq_tag_set *tag_set)
 {
     int hw_ctx_size = sizeof(struct blk_mq_hw_ctx);
@@ -28,7 +39,7 @@ blk_mq_dispatch_rq_list(struct blk_mq_hw_ctx *hctx,
                         unsigned int nr_budgets)
 {
     struct request *rq;
-    int errors, queued;
+    int errors = 0, queued = 0;
     blk_status_t ret = BLK_STS_OK;
     struct request_queue *q = hctx->queue;
 
@@ -45,13 +56,16 @@ blk_mq_dispatch_rq_list(struct blk_mq_hw_ctx *hctx,
         bd.last = true;
 
         ret = q->mq_ops->queue_rq(hctx, &bd);
+        if (ret == BLK_STS_RESOURCE || ret == BLK_STS_DEV_RESOURCE) {
+            /* The driver is full, it goes back with the rest */
+            list_add(&rq->queuelist, list);
+            break;
+        }
+
         switch (ret) {
         case BLK_STS_OK:
             queued++;
             break;
-        case BLK_STS_RESOURCE:
-        case BLK_STS_DEV_RESOURCE:
-            panic("BLK_STS_DEV_RESOURCE!");
         case BLK_STS_ZONE_RESOURCE:
             panic("BLK_STS_ZONE_RESOURCE!");
         default:
@@ -61,6 +75,20 @@ blk_mq_dispatch_rq_list(struct blk_mq_hw_ctx *hctx,
 
     } while (!list_empty(list));
 
+    /*
+     * Any items that need requeuing? Stuff them into hctx->dispatch,
+     * that is where we will continue on next queue run. Nothing
+     * restarts the queue on a completion, so run it a bit later.
+     */
+    if (!list_empty(list)) {
+        spin_lock(&hctx->lock);
+        list_splice_tail_init(list, &hctx->dispatch);
+        spin_unlock(&hctx->lock);
+
+        __blk_mq_delay_run_hw_queue(hctx, true, BLK_MQ_RESOURCE_DELAY);
+        return false;
+    }
+
     return (queued + errors) != 0;
 }
 
@@ -103,6 +131,23 @@ static int blk_mq_do_dispatch_sched(struct blk_mq_hw_ctx *hctx)
 
 static int __blk_mq_sched_dispatch_requests(struct blk_mq_hw_ctx *hctx)
 {
+    LIST_HEAD(rq_list);
+
+    /*
+     * If we have previous entries on our dispatch list, grab them first
+     * for more fair dispatch.
+     */
+    if (!list_empty_careful(&hctx->dispatch)) {
+        spin_lock(&hctx->lock);
+        list_splice_init(&hctx->dispatch, &rq_list);
+        spin_unlock(&hctx->lock);
+    }
+
+    /* They waited longest, the scheduler is only asked once they went */
+    if (!list_empty(&rq_list) &&
+        !blk_mq_dispatch_rq_list(hctx, &rq_list, 0))
+        return 0;
+
     return blk_mq_do_dispatch_sched(hctx);
 }
 
@@ -150,6 +195,8 @@ blk_mq_alloc_hctx(struct request_queue *q, struct blk_mq_tag_set *set)
     if (!hctx)
         panic("out of memory!");
 
+    spin_lock_init(&hctx->lock);
+    INIT_LIST_HEAD(&hctx->dispatch);
     INIT_DELAYED_WORK(&hctx->run_work, blk_mq_run_work_fn);
     hctx->queue = q;
     return hctx;
@@ -320,7 +367,8 @@ __blk_mq_alloc_request(struct blk_mq_alloc_data *data)
 
 static bool blk_mq_hctx_has_pending(struct blk_mq_hw_ctx *hctx)
 {
-    return blk_mq_sched_has_work(hctx);
+    return !list_empty_careful(&hctx->dispatch) ||
+        blk_mq_sched_has_work(hctx);
 }
 
 static void
@@ -379,6 +427,8 @@ blk_qc_t blk_mq_submit_bio(struct bio *bio)
         .q = q,
     };
 
+    trace_block_bio_queue(bio);
+
     data.cmd_flags = bio->bi_opf;
     rq = __blk_mq_alloc_request(&data);
     if (unlikely(!rq))
@@ -450,6 +500,7 @@ EXPORT_SYMBOL(blk_mq_complete_request_remote);
 
 void blk_mq_complete_request(struct request *rq)
 {
+    trace_block_rq_complete(rq);
     BUG_ON(!blk_mq_complete_request_remote(rq));
 }
 EXPORT_SYMBOL(blk_mq_complete_request);
@@ -4,6 +4,8 @@
 #include <blk-mq.h>
 #include <export.h>
 #include <printk.h>
+#include <linkage.h>
+#include <trace/events/block.h>
 
 extern int blk_dev_init(void);
 extern int deadline_init(void);
@@ -41,7 +43,7 @@ blk_queue_max_segments(struct request_queue *q,
 }
 EXPORT_SYMBOL(blk_queue_max_segments);
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[block]: init begin ...\n");
@@ -50,6 +52,10 @@ init_module(void)
     deadline_init();
     blk_dev_init();
 
+    trace_event_register(&event_block_bio_queue);
+    trace_event_register(&event_block_rq_issue);
+    trace_event_register(&event_block_rq_complete);
+
     printk("module[block]: init end!\n");
     return 0;
 }
@@ -4,8 +4,17 @@
 #include <slab.h>
 #include <errno.h>
 #include <blkdev.h>
+#include <jiffies.h>
 #include <blk-mq.h>
 #include <elevator.h>
+#include <spinlock.h>
+
+/*
+ * See Documentation/block/deadline-iosched.rst
+ */
+static const int read_expire = HZ / 2;  /* max time before a read is submitted. */
+static const int write_expire = 5 * HZ; /* ditto for writes, these limits are SOFT! */
+static const int writes_starved = 2;    /* max times reads can starve a write */
 
 struct deadline_data {
     struct list_head fifo_list[2];
@@ -13,6 +22,15 @@ struct deadline_data {
      * next in sort order. read, write or both are NULL
      */
     struct request *next_rq[2];
+    unsigned int starved;       /* times reads have starved writes */
+
+    /*
+     * settings that change how the i/o scheduler behaves
+     */
+    int fifo_expire[2];
+    int writes_starved;
+
+    spinlock_t lock;    /* of all the above */
 };
 
 static int
@@ -35,12 +53,13 @@ dd_init_queue(struct request_queue *q,
 
     INIT_LIST_HEAD(&dd->fifo_list[READ]);
     INIT_LIST_HEAD(&dd->fifo_list[WRITE]);
-    /*
-    dd->sort_list[READ] = RB_ROOT;
-    dd->sort_list[WRITE] = RB_ROOT;
     dd->fifo_expire[READ] = read_expire;
     dd->fifo_expire[WRITE] = write_expire;
     dd->writes_starved = writes_starved;
+    spin_lock_init(&dd->lock);
+    /*
+    dd->sort_list[READ] = RB_ROOT;
+    dd->sort_list[WRITE] = RB_ROOT;
     dd->front_merges = 1;
     dd->fifo_batch = fifo_batch;
     INIT_LIST_HEAD(&dd->dispatch);
@@ -61,6 +80,10 @@ dd_insert_request(struct blk_mq_hw_ctx *hctx,
 
     BUG_ON(at_head);
 
+    /*
+     * set expire time and add to fifo list
+     */
+    rq->fifo_time = jiffies + dd->fifo_expire[data_dir];
     list_add_tail(&rq->queuelist, &dd->fifo_list[data_dir]);
 }
 
@@ -71,6 +94,7 @@ dd_insert_requests(struct blk_mq_hw_ctx *hctx,
     struct request_queue *q = hctx->queue;
     struct deadline_data *dd = q->elevator->elevator_data;
 
+    spin_lock(&dd->lock);
     while (!list_empty(list)) {
         struct request *rq;
 
@@ -78,6 +102,7 @@ dd_insert_requests(struct blk_mq_hw_ctx *hctx,
         list_del_init(&rq->queuelist);
         dd_insert_request(hctx, rq, at_head);
     }
+    spin_unlock(&dd->lock);
 }
 
 static bool dd_has_work(struct blk_mq_hw_ctx *hctx)
@@ -112,6 +137,23 @@ deadline_fifo_request(struct deadline_data *dd, int data_dir)
     return NULL;
 }
 
+/*
+ * deadline_check_fifo returns 0 if there are no expired requests on the fifo,
+ * 1 otherwise. Requires !list_empty(&dd->fifo_list[data_dir])
+ */
+static inline int deadline_check_fifo(struct deadline_data *dd, int ddir)
+{
+    struct request *rq = rq_entry_fifo(dd->fifo_list[ddir].next);
+
+    /*
+     * rq is expired!
+     */
+    if (time_after_eq(jiffies, rq->fifo_time))
+        return 1;
+
+    return 0;
+}
+
 static struct request *
 deadline_next_request(struct deadline_data *dd, int data_dir)
 {
@@ -157,8 +199,15 @@ static struct request *__dd_dispatch_request(struct deadline_data *dd)
     reads = !list_empty(&dd->fifo_list[READ]);
     writes = !list_empty(&dd->fifo_list[WRITE]);
 
+    /*
+     * select the direction (read vs write) to dispatch requests from,
+     * reads unless they have starved writes too often or the oldest
+     * write is past its deadline
+     */
     if (reads) {
-        if (deadline_fifo_request(dd, WRITE))
+        if (deadline_fifo_request(dd, WRITE) &&
+            (deadline_check_fifo(dd, WRITE) ||
+             dd->starved++ >= dd->writes_starved))
             goto dispatch_writes;
 
         data_dir = READ;
@@ -168,6 +217,8 @@ static struct request *__dd_dispatch_request(struct deadline_data *dd)
 
     if (writes) {
  dispatch_writes:
+        dd->starved = 0;
+
         data_dir = WRITE;
 
         goto dispatch_find_request;
@@ -192,7 +243,13 @@ static struct request *__dd_dispatch_request(struct deadline_data *dd)
 static struct request *dd_dispatch_request(struct blk_mq_hw_ctx *hctx)
 {
     struct deadline_data *dd = hctx->queue->elevator->elevator_data;
-    return __dd_dispatch_request(dd);
+    struct request *rq;
+
+    spin_lock(&dd->lock);
+    rq = __dd_dispatch_request(dd);
+    spin_unlock(&dd->lock);
+
+    return rq;
 }
 
 static struct elevator_type mq_deadline = {
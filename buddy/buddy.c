@@ -16,6 +16,7 @@
 #include <mm_types.h>
 #include <page_ref.h>
 #include <page-flags.h>
+#include <linkage.h>
 
 #define RESERVED_CHUNK_SIZE (PAGE_SIZE << 3)
 
@@ -283,6 +284,7 @@ zone_init_internals(struct zone *zone,
     atomic_long_set(&zone->managed_pages, remaining_pages);
     zone->name = zone_names[idx];
     zone->zone_pgdat = NODE_DATA(0);
+    spin_lock_init(&zone->lock);
     zone_pcp_init(zone);
 }
 
@@ -583,7 +585,9 @@ free_one_page(struct zone *zone,
               unsigned long pfn,
               unsigned int order)
 {
+    spin_lock(&zone->lock);
     __free_one_page(page, pfn, zone, order, true);
+    spin_unlock(&zone->lock);
 }
 
 
@@ -593,7 +597,9 @@ __free_pages_ok(struct page *page, unsigned int order)
     unsigned long flags;
     unsigned long pfn = page_to_pfn(page);
 
+    local_irq_save(flags);
     free_one_page(page_zone(page), page, pfn, order);
+    local_irq_restore(flags);
 }
 
 static inline void
@@ -630,6 +636,29 @@ __free_pages_core(struct page *page, unsigned int order)
     __free_pages(page, order);
 }
 
+/*
+ * Give the whole pages in [start, end) reserved at boot back to the
+ * buddy allocator, e.g. init sections. Returns the pages freed.
+ */
+unsigned long
+free_reserved_area(void *start, void *end, const char *s)
+{
+    unsigned long pfn = PFN_UP(__pa(start));
+    unsigned long end_pfn = PFN_DOWN(__pa(end));
+    unsigned long pages = 0;
+
+    for (; pfn < end_pfn; pfn++, pages++)
+        __free_pages_core(pfn_to_page(pfn), 0);
+
+    totalram_pages_add(pages);
+
+    if (pages && s)
+        printk("Freeing %s memory: %luK\n", s, pages << (PAGE_SHIFT - 10));
+
+    return pages;
+}
+EXPORT_SYMBOL(free_reserved_area);
+
 static inline bool
 prepare_alloc_pages(gfp_t gfp_mask, unsigned int order,
                     struct alloc_context *ac)
@@ -747,7 +776,7 @@ rmqueue_bulk(struct zone *zone,
     return alloced;
 }
 
-/* Remove page from the per-cpu list, caller must protect the list */
+/* Remove page from the per-cpu list, caller holds the zone lock */
 static struct page *
 __rmqueue_pcplist(struct zone *zone,
                   unsigned int alloc_flags,
@@ -776,10 +805,16 @@ rmqueue_pcplist(struct zone *preferred_zone,
 {
     struct per_cpu_pages *pcp;
     struct list_head *list;
+    struct page *page;
+    unsigned long flags;
 
+    /* One pageset for all CPUs yet, so it is under the zone lock too */
+    spin_lock_irqsave(&zone->lock, flags);
     pcp = &zone->pageset->pcp;
     list = &pcp->lists;
-    return __rmqueue_pcplist(zone, alloc_flags, pcp, list);
+    page = __rmqueue_pcplist(zone, alloc_flags, pcp, list);
+    spin_unlock_irqrestore(&zone->lock, flags);
+    return page;
 }
 
 static inline struct page *
@@ -790,13 +825,16 @@ rmqueue(struct zone *preferred_zone,
         unsigned int alloc_flags)
 {
     struct page *page = NULL;
+    unsigned long flags;
 
     if (likely(order == 0)) {
         page = rmqueue_pcplist(preferred_zone, zone, gfp_flags, alloc_flags);
         goto out;
     }
 
+    spin_lock_irqsave(&zone->lock, flags);
     page = __rmqueue(zone, order, alloc_flags);
+    spin_unlock_irqrestore(&zone->lock, flags);
 
  out:
     if (!page)
@@ -817,6 +855,9 @@ static void
 prep_new_page(struct page *page, unsigned int order,
               gfp_t gfp_flags, unsigned int alloc_flags)
 {
+    /* __free_pages() drops this one, it leaked every page before */
+    set_page_refcounted(page);
+
     if (want_init_on_alloc(gfp_flags))
         kernel_init_free_pages(page, 1 << order);
 }
@@ -1072,7 +1113,7 @@ unsigned long get_zeroed_page(gfp_t gfp_mask)
 }
 EXPORT_SYMBOL(get_zeroed_page);
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[buddy]: init begin ...\n");
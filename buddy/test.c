@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: GPL-2.0-only
 #include <gfp.h>
 #include <printk.h>
+#include <linkage.h>
 
 static int
 test_alloc_pages(void)
@@ -19,7 +20,7 @@ test_alloc_pages(void)
     return 0;
 }
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[test_buddy]: init begin ...\n");
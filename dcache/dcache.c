@@ -11,6 +11,7 @@
 #include <string.h>
 #include <hashtable.h>
 #include <stringhash.h>
+#include <linkage.h>
 
 static struct kmem_cache *dentry_cache;
 
@@ -207,7 +208,10 @@ __d_lookup(const struct dentry *parent, const struct qstr *name)
     struct hlist_bl_node *node;
     u64 hashlen = name->hash_len;
     struct hlist_bl_head *b = d_hash(hashlen_hash(hashlen));
+    struct dentry *found = NULL;
 
+    /* No RCU walk, the chain is read under its lock */
+    hlist_bl_lock(b);
     hlist_bl_for_each_entry(dentry, node, b, d_hash) {
         if (dentry->d_parent != parent)
             continue;
@@ -218,10 +222,12 @@ __d_lookup(const struct dentry *parent, const struct qstr *name)
         if (dentry_cmp(dentry, name->name, hashlen_len(hashlen)) != 0)
             continue;
 
-        return dentry;
+        found = dentry;
+        break;
     }
+    hlist_bl_unlock(b);
 
-    return NULL;
+    return found;
 }
 EXPORT_SYMBOL(__d_lookup);
 
@@ -249,7 +255,10 @@ static void
 __d_rehash(struct dentry *entry)
 {
     struct hlist_bl_head *b = d_hash(entry->d_name.hash);
+
+    hlist_bl_lock(b);
     hlist_bl_add_head(&entry->d_hash, b);
+    hlist_bl_unlock(b);
 }
 
 static inline void
@@ -315,6 +324,7 @@ d_alloc_parallel(struct dentry *parent, const struct qstr *name)
     struct hlist_bl_head *b = in_lookup_hash(parent, hash);
     struct dentry *new = d_alloc(parent, name);
 
+    hlist_bl_lock(b);
     hlist_bl_for_each_entry(dentry, node, b, d_in_lookup_hash) {
         if (dentry->d_name.hash != hash)
             continue;
@@ -323,20 +333,27 @@ d_alloc_parallel(struct dentry *parent, const struct qstr *name)
         if (!d_same_name(dentry, parent, name))
             continue;
 
+        hlist_bl_unlock(b);
         return dentry;
     }
 
     /* we can't take ->d_lock here; it's OK, though. */
     new->d_flags |= DCACHE_PAR_LOOKUP;
     hlist_bl_add_head(&new->d_in_lookup_hash, b);
+    hlist_bl_unlock(b);
     return new;
 }
 EXPORT_SYMBOL(d_alloc_parallel);
 
 void __d_lookup_done(struct dentry *dentry)
 {
+    struct hlist_bl_head *b = in_lookup_hash(dentry->d_parent,
+                                             dentry->d_name.hash);
+
+    hlist_bl_lock(b);
     dentry->d_flags &= ~DCACHE_PAR_LOOKUP;
     __hlist_bl_del(&dentry->d_in_lookup_hash);
+    hlist_bl_unlock(b);
 }
 EXPORT_SYMBOL(__d_lookup_done);
 
@@ -412,7 +429,7 @@ dcache_init(void)
     d_hash_shift = 32 - d_hash_shift;
 }
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[dcache]: init begin ...\n");
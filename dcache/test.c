@@ -1,8 +1,9 @@
 // SPDX-License-Identifier: GPL-2.0-only
 
 #include <printk.h>
+#include <linkage.h>
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[test_dcache]: init begin ...\n");
@@ -7,6 +7,7 @@
 #include <devres.h>
 #include <ioport.h>
 #include <ioremap.h>
+#include <linkage.h>
 
 struct devres_node {
     struct list_head    entry;
@@ -430,7 +431,7 @@ devres_free(void *res)
 }
 EXPORT_SYMBOL(devres_free);
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[devres]: init begin ...\n");
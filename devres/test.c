@@ -7,6 +7,7 @@
 #include <printk.h>
 #include <string.h>
 #include <ioremap.h>
+#include <linkage.h>
 
 static int
 test_devres(void)
@@ -35,7 +36,7 @@ test_devres(void)
     return 0;
 }
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[test_devres]: init begin ...\n");
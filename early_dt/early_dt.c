@@ -3,10 +3,16 @@
 #include <bug.h>
 #include <fdt.h>
 #include <page.h>
+#include <smp.h>
 #include <params.h>
 #include <string.h>
+#include <timex.h>
 #include <export.h>
+#include <profile.h>
 #include <memblock.h>
+#include <tracepoint.h>
+#include <linkage.h>
+#include <vector.h>
 
 #define MIN_MEMBLOCK_ADDR   __pa(PAGE_OFFSET)
 #define MAX_MEMBLOCK_ADDR   ((phys_addr_t)~0)
@@ -482,15 +488,97 @@ early_init_dt_scan_chosen(unsigned long node, const char *uname,
     return 1;
 }
 
+/*
+ * Every hart that is okay is a possible CPU, numbered in the order of
+ * the DT after the boot hart, which is CPU 0. All harts are taken to
+ * have the ISA of the first one.
+ */
+static int
+early_init_dt_scan_cpus(unsigned long node, const char *uname,
+                        int depth, void *data)
+{
+    const char *type;
+    const char *status;
+    const char *isa;
+    const u32 *reg;
+    unsigned long hartid;
+    bool *isa_done = data;
+
+    type = of_get_flat_dt_prop(node, "device_type", NULL);
+    if (type == NULL || strcmp(type, "cpu") != 0)
+        return 0;
+
+    if (!*isa_done) {
+        isa = of_get_flat_dt_prop(node, "riscv,isa", NULL);
+        if (isa) {
+            printk("ISA is: %s\n", isa);
+
+            if (riscv_v_setup(isa))
+                printk("Use vector string functions\n");
+            *isa_done = true;
+        }
+    }
+
+    status = of_get_flat_dt_prop(node, "status", NULL);
+    if (status && strcmp(status, "okay") && strcmp(status, "ok"))
+        return 0;
+
+    reg = of_get_flat_dt_prop(node, "reg", NULL);
+    if (reg == NULL)
+        return 0;
+
+    hartid = be32_to_cpup(reg);
+    if (hartid == boot_cpu_hartid)
+        return 0;
+
+    if (nr_cpu_ids >= NR_CPUS) {
+        printk("Hart %lu left out\n", hartid);
+        return 0;
+    }
+
+    cpuid_to_hartid_map(nr_cpu_ids) = hartid;
+    set_cpu_possible(nr_cpu_ids, true);
+    nr_cpu_ids++;
+
+    return 0;
+}
+
+static int
+early_init_dt_scan_timebase(unsigned long node, const char *uname,
+                            int depth, void *data)
+{
+    const u32 *prop;
+
+    if (depth != 1 || strcmp(uname, "cpus") != 0)
+        return 0;
+
+    prop = of_get_flat_dt_prop(node, "timebase-frequency", NULL);
+    if (prop)
+        riscv_timebase = be32_to_cpup(prop);
+
+    printk("Timebase is: %lu Hz\n", riscv_timebase);
+
+    /* break now */
+    return 1;
+}
+
 void
 early_init_dt_scan_nodes(void)
 {
+    bool isa_done = false;
+
     if (!of_scan_flat_dt(early_init_dt_scan_chosen, boot_command_line))
         panic("No chosen node found!");
 
     of_scan_flat_dt(early_init_dt_scan_root, NULL);
 
     of_scan_flat_dt(early_init_dt_scan_memory, NULL);
+
+    cpuid_to_hartid_map(0) = boot_cpu_hartid;
+    of_scan_flat_dt(early_init_dt_scan_cpus, &isa_done);
+    printk("Harts: %u possible, boot hart %lu\n", nr_cpu_ids, boot_cpu_hartid);
+
+    of_scan_flat_dt(early_init_dt_scan_timebase, NULL);
 }
 EXPORT_SYMBOL(early_init_dt_scan_nodes);
 
@@ -507,12 +595,16 @@ root_dev_setup(char *param, char *value)
 static struct kernel_param kernel_params[] = {
     { .name = "root", .setup_func = root_dev_setup, },
     { .name = "console", .setup_func = console_setup, },
+    { .name = "loglevel", .setup_func = loglevel_setup, },
+    { .name = "debug", .setup_func = debug_setup, },
+    { .name = "trace_event", .setup_func = trace_event_setup, },
+    { .name = "profile", .setup_func = profile_setup, },
 };
 
 static unsigned int
 num_kernel_params = sizeof(kernel_params) / sizeof(struct kernel_param);
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[early_dt]: init begin ...\n");
@@ -3,13 +3,14 @@
 #include <bug.h>
 #include <export.h>
 #include <printk.h>
+#include <linkage.h>
 
 extern int init_ext2_fs(void);
 
 bool ext2_initialized = false;
 EXPORT_SYMBOL(ext2_initialized);
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[ext2]: init begin ...\n");
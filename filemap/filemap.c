@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: GPL-2.0-only
 
 #include <bug.h>
+#include <errno.h>
 #include <types.h>
 #include <export.h>
 #include <printk.h>
@@ -9,6 +10,8 @@
 #include <pgalloc.h>
 #include <mm_types.h>
 #include <readahead.h>
+#include <wait_bit.h>
+#include <linkage.h>
 
 static int
 __add_to_page_cache_locked(struct page *page,
@@ -83,10 +86,22 @@ pagecache_get_page(struct address_space *mapping, pgoff_t index,
 }
 EXPORT_SYMBOL(pagecache_get_page);
 
+/*
+ * Reads don't lock the page, sleep until page_endio() has marked it
+ * uptodate or in error instead. The page hashes into the shared
+ * waitqueue table, see wake_up_var().
+ */
+static void wait_on_page_uptodate(struct page *page)
+{
+    wait_var_event(page, PageUptodate(page) || PageError(page));
+}
+
 static struct page *wait_on_page_read(struct page *page)
 {
     if (!IS_ERR(page)) {
-        while (!PageUptodate(page));
+        wait_on_page_uptodate(page);
+        if (!PageUptodate(page))
+            page = ERR_PTR(-EIO);
     }
     return page;
 }
@@ -152,6 +167,10 @@ void page_endio(struct page *page, bool is_write, int err)
             SetPageError(page);
         }
         //unlock_page(page);
+
+        /* Order the flags before the test for waiters */
+        smp_mb();
+        wake_up_var(page);
     } else {
         if (err) {
             panic("err: %d", err);
@@ -201,8 +220,13 @@ ssize_t generic_file_buffered_read(struct kiocb *iocb,
 
         if (PageReadahead(page))
             panic("page readahead!");
-        if (!PageUptodate(page))
-            while (!PageUptodate(page));
+        if (!PageUptodate(page)) {
+            wait_on_page_uptodate(page);
+            if (!PageUptodate(page)) {
+                error = -EIO;
+                goto out;
+            }
+        }
 
         /*
          * i_size must be checked after we know the page is Uptodate.
@@ -465,7 +489,7 @@ int generic_file_mmap(struct file *file, struct vm_area_struct *vma)
 }
 EXPORT_SYMBOL(generic_file_mmap);
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[filemap]: init begin ...\n");
@@ -15,6 +15,7 @@
 #include <pgalloc.h>
 #include <mm_types.h>
 #include <user_namespace.h>
+#include <linkage.h>
 
 #define allocate_mm()   (kmem_cache_alloc(mm_cachep, GFP_KERNEL))
 
@@ -160,6 +161,25 @@ long _do_fork(struct kernel_clone_args *args)
     return 0;
 }
 
+/*
+ * The idle task of a secondary CPU, a copy of the boot thread. It
+ * isn't woken, the CPU starts right on it, see smp/smpboot.c.
+ */
+struct task_struct *fork_idle(int cpu)
+{
+    struct task_struct *task;
+    struct kernel_clone_args args = {
+        .flags = CLONE_VM,
+    };
+
+    task = copy_process(NULL, &args);
+    if (!IS_ERR(task))
+        init_idle(task, cpu);
+
+    return task;
+}
+EXPORT_SYMBOL(fork_idle);
+
 /*
  * Create a kernel thread.
  */
@@ -233,7 +253,7 @@ void fork_init(void)
                                    useroffset, usersize, NULL);
 }
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[fork]: init begin ...\n");
@@ -5,6 +5,7 @@
 #include <elf.h>
 #include <mman.h>
 #include <slab.h>
+#include <vdso.h>
 #include <errno.h>
 #include <auxvec.h>
 #include <export.h>
@@ -177,6 +178,7 @@ create_elf_tables(struct linux_binprm *bprm, const struct elfhdr *exec,
         *elf_info++ = val; \
     } while (0)
 
+    NEW_AUX_ENT(AT_SYSINFO_EHDR, (elf_addr_t)(unsigned long)mm->vdso);
     NEW_AUX_ENT(AT_PAGESZ, ELF_EXEC_PAGESIZE);
     NEW_AUX_ENT(AT_PHDR, load_addr + exec->e_phoff);
     NEW_AUX_ENT(AT_PHENT, sizeof(struct elf_phdr));
@@ -474,6 +476,10 @@ static int load_elf_binary(struct linux_binprm *bprm)
 
     set_binfmt(&elf_format);
 
+    retval = arch_setup_additional_pages(bprm, !!interpreter);
+    if (retval < 0)
+        panic("setup additional pages error!");
+
     retval = create_elf_tables(bprm, elf_ex,
                                load_addr, interp_load_addr, e_entry);
     if (retval < 0)
@@ -420,8 +420,8 @@ EXPORT_SYMBOL(__lock_buffer);
 void unlock_buffer(struct buffer_head *bh)
 {
     clear_bit_unlock(BH_Lock, &bh->b_state);
-    /* Todo */
-    // wake_up_bit(&bh->b_state, BH_Lock);
+    smp_mb();
+    wake_up_bit(&bh->b_state, BH_Lock);
 }
 EXPORT_SYMBOL(unlock_buffer);
 
@@ -9,6 +9,7 @@
 #include <limits.h>
 #include <printk.h>
 #include <string.h>
+#include <linkage.h>
 
 extern void init_open(void);
 extern void init_read_write(void);
@@ -260,7 +261,7 @@ init_pseudo(struct fs_context *fc, unsigned long magic)
 }
 EXPORT_SYMBOL(init_pseudo);
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[fs]: init begin ...\n");
@@ -12,6 +12,7 @@
 #include <string.h>
 #include <elevator.h>
 #include <kobj_map.h>
+#include <linkage.h>
 
 #define BLKDEV_MAJOR_HASH_SIZE 255
 static struct blk_major_name {
@@ -298,7 +299,7 @@ disk_get_part(struct gendisk *disk, int partno)
 }
 EXPORT_SYMBOL(disk_get_part);
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[genhd]: init begin ...\n");
@@ -2,6 +2,7 @@
 
 #include <genhd.h>
 #include <printk.h>
+#include <linkage.h>
 
 static int
 test_register_blkdev(void)
@@ -14,7 +15,7 @@ test_register_blkdev(void)
     return 0;
 }
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[test_genhd]: init begin ...\n");
@@ -6,6 +6,7 @@
 #include <export.h>
 #include <pgtable.h>
 #include <mm_types.h>
+#include <linkage.h>
 
 static struct page *
 no_page_table(struct vm_area_struct *vma, unsigned int flags)
@@ -270,7 +271,7 @@ long get_user_pages_remote(struct mm_struct *mm,
 }
 EXPORT_SYMBOL(get_user_pages_remote);
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[gup]: init begin ...\n");
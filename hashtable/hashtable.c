@@ -7,6 +7,7 @@
 #include <kernel.h>
 #include <printk.h>
 #include <hashtable.h>
+#include <linkage.h>
 
 #define ADAPT_SCALE_BASE    (64ul << 30)
 #define ADAPT_SCALE_SHIFT   2
@@ -81,7 +82,7 @@ alloc_large_system_hash(const char *tablename,
 }
 EXPORT_SYMBOL(alloc_large_system_hash);
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[hashtable]: init begin ...\n");
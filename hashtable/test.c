@@ -2,6 +2,7 @@
 
 #include <printk.h>
 #include <hashtable.h>
+#include <linkage.h>
 
 static void
 test_hash_table(void)
@@ -20,7 +21,7 @@ test_hash_table(void)
     printk(_GREEN("Test hash table ok!\n"));
 }
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[test_rbtree]: init begin ...\n");
@@ -0,0 +1,31 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <printk.h>
+
+#include "shim.h"
+#include "../bench/internal.h"
+
+/*
+ * The benchmarks of bench/ which only need the modules of the host
+ * build, with the result table of bench/bench.c. Cycles are TSC ticks
+ * and there is no instruction count, run it under 'perf stat' for
+ * that. scripts/benchcmp compares two runs as it does two boots.
+ */
+int main(void)
+{
+    host_boot(HOST_MEMORY_SIZE);
+
+    printk("bench: begin %u\n", BENCH_SAMPLES);
+    printk("bench: # name arg ops min median p99 insns\n");
+
+    bench_kmalloc();
+    bench_alloc_pages();
+    bench_memcpy();
+    bench_memset();
+    bench_xarray();
+    bench_radix_tree();
+    bench_rbtree();
+
+    printk("bench: end\n");
+    return 0;
+}
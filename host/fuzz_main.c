@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/*
+ * Stands in for libFuzzer without FUZZ=1: runs each file named on the
+ * command line, or stdin, through the target once. Enough to replay a
+ * crash or a corpus under the sanitizers with gcc.
+ */
+
+int LLVMFuzzerInitialize(int *argc, char ***argv);
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+static void
+run_file(FILE *fp, const char *name)
+{
+    uint8_t *data = NULL;
+    size_t size = 0, n;
+
+    for (;;) {
+        data = realloc(data, size + 4096);
+        if (!data) {
+            fprintf(stderr, "%s: out of memory\n", name);
+            exit(2);
+        }
+        n = fread(data + size, 1, 4096, fp);
+        size += n;
+        if (n < 4096)
+            break;
+    }
+
+    LLVMFuzzerTestOneInput(data, size);
+    free(data);
+}
+
+int main(int argc, char *argv[])
+{
+    FILE *fp;
+    int i;
+
+    LLVMFuzzerInitialize(&argc, &argv);
+
+    if (argc < 2) {
+        run_file(stdin, "-");
+        return 0;
+    }
+
+    for (i = 1; i < argc; i++) {
+        fp = fopen(argv[i], "rb");
+        if (!fp) {
+            perror(argv[i]);
+            return 2;
+        }
+        run_file(fp, argv[i]);
+        fclose(fp);
+    }
+    return 0;
+}
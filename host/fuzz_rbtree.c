@@ -0,0 +1,132 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <bug.h>
+#include <kernel.h>
+#include <printk.h>
+#include <rbtree.h>
+
+#include "shim.h"
+
+/*
+ * Each byte of the input inserts the node of that value, or erases it
+ * when it is in the tree, and the whole tree is checked after each:
+ * links, order, colours and black height, and rb_first()/rb_next().
+ */
+
+#define FUZZ_RB_VALUES  256
+
+struct fuzz_node {
+    struct rb_node node;
+    unsigned int value;
+    bool in_tree;
+};
+
+static struct fuzz_node fuzz_nodes[FUZZ_RB_VALUES];
+
+static void
+fuzz_insert(struct rb_root *root, struct fuzz_node *data)
+{
+    struct rb_node **link = &root->rb_node;
+    struct rb_node *parent = NULL;
+
+    while (*link) {
+        struct fuzz_node *this = rb_entry(*link, struct fuzz_node, node);
+
+        parent = *link;
+        if (data->value < this->value)
+            link = &(*link)->rb_left;
+        else
+            link = &(*link)->rb_right;
+    }
+
+    rb_link_node(&data->node, parent, link);
+    rb_insert_color(&data->node, root);
+}
+
+/* Returns the black height of the subtree, nodes are counted in @nr */
+static int
+fuzz_check_subtree(struct rb_node *node, struct rb_node *parent,
+                   unsigned int lo, unsigned int hi, unsigned int *nr)
+{
+    struct fuzz_node *this;
+    int left, right;
+
+    if (!node)
+        return 1;
+
+    this = rb_entry(node, struct fuzz_node, node);
+    if (rb_parent(node) != parent)
+        panic("rbtree %u has a bad parent!\n", this->value);
+    if (this->value < lo || this->value > hi)
+        panic("rbtree %u out of order!\n", this->value);
+    if (rb_is_red(node) && parent && rb_is_red(parent))
+        panic("rbtree %u is red under red!\n", this->value);
+
+    left = fuzz_check_subtree(node->rb_left, node, lo, this->value, nr);
+    right = fuzz_check_subtree(node->rb_right, node, this->value, hi, nr);
+    if (left != right)
+        panic("rbtree %u black heights %d %d!\n", this->value, left, right);
+
+    (*nr)++;
+    return left + rb_is_black(node);
+}
+
+static void
+fuzz_check(struct rb_root *root, unsigned int count)
+{
+    struct rb_node *node;
+    unsigned int nr = 0, prev = 0;
+
+    if (root->rb_node && !rb_is_black(root->rb_node))
+        panic("rbtree root is red!\n");
+
+    fuzz_check_subtree(root->rb_node, NULL, 0, FUZZ_RB_VALUES - 1, &nr);
+    if (nr != count)
+        panic("rbtree has %u nodes, not %u!\n", nr, count);
+
+    nr = 0;
+    for (node = rb_first(root); node; node = rb_next(node)) {
+        struct fuzz_node *this = rb_entry(node, struct fuzz_node, node);
+
+        if (nr && this->value <= prev)
+            panic("rb_next %u after %u!\n", this->value, prev);
+        prev = this->value;
+        nr++;
+    }
+    if (nr != count)
+        panic("rb_next walked %u nodes, not %u!\n", nr, count);
+}
+
+int LLVMFuzzerInitialize(int *argc, char ***argv)
+{
+    host_boot(HOST_MEMORY_SIZE);
+    return 0;
+}
+
+int LLVMFuzzerTestOneInput(const u8 *data, size_t size)
+{
+    struct rb_root root = RB_ROOT;
+    struct fuzz_node *node;
+    unsigned int count = 0;
+    size_t i;
+
+    for (i = 0; i < FUZZ_RB_VALUES; i++) {
+        fuzz_nodes[i].value = i;
+        fuzz_nodes[i].in_tree = false;
+    }
+
+    for (i = 0; i < size; i++) {
+        node = fuzz_nodes + data[i];
+        if (node->in_tree) {
+            rb_erase(&node->node, &root);
+            count--;
+        } else {
+            fuzz_insert(&root, node);
+            count++;
+        }
+        node->in_tree = !node->in_tree;
+
+        fuzz_check(&root, count);
+    }
+    return 0;
+}
@@ -0,0 +1,130 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <bug.h>
+#include <kernel.h>
+#include <printk.h>
+#include <string.h>
+
+#include "shim.h"
+
+/*
+ * Builds a format of literal text and up to FUZZ_FMT_CONVS conversions
+ * out of the input, and checks that snprintf() prints it the same as
+ * the pieces one at a time, and that each smaller buffer gets a prefix
+ * of that with the same return value, NUL terminated and not overrun.
+ *
+ * A byte from 0xf0 up is a conversion from fuzz_convs[], taking its
+ * argument from the eight bytes after it; any other byte is text.
+ */
+
+#define FUZZ_FMT_CONVS  4
+#define FUZZ_FMT_LEN    128
+#define FUZZ_OUT_LEN    1024
+
+static const char * const fuzz_convs[] = {
+    "%c", "%s", "%p", "%o", "%x", "%X", "%d", "%i", "%u",
+    "%lo", "%lx", "%ld", "%li", "%lu", "%s", "%p",
+};
+
+static const char fuzz_string[] = "xarray";
+
+struct fuzz_piece {
+    char fmt[FUZZ_FMT_LEN];
+    unsigned long arg;
+};
+
+static struct fuzz_piece fuzz_pieces[2 * FUZZ_FMT_CONVS + 1];
+static char fuzz_fmt[FUZZ_FMT_LEN];
+static char fuzz_out[FUZZ_OUT_LEN];
+static char fuzz_cat[FUZZ_OUT_LEN];
+static char fuzz_buf[FUZZ_OUT_LEN + 1];
+
+/*
+ * All arguments go as unsigned long, %c, %d and the like take the low
+ * half of the slot, as both the riscv and the x86-64 ABI pass them.
+ */
+static int
+fuzz_snprintf(char *buf, size_t size, const char *fmt, unsigned long *args)
+{
+    return snprintf(buf, size, fmt, args[0], args[1], args[2], args[3]);
+}
+
+int LLVMFuzzerInitialize(int *argc, char ***argv)
+{
+    host_boot(HOST_MEMORY_SIZE);
+    return 0;
+}
+
+int LLVMFuzzerTestOneInput(const u8 *data, size_t size)
+{
+    unsigned long args[FUZZ_FMT_CONVS] = { 0 };
+    unsigned int nr_args = 0, nr_pieces = 0, flen = 0, plen = 0;
+    const char *conv;
+    struct fuzz_piece *piece = NULL;
+    int len, cat = 0, n;
+    size_t i, j, bsize;
+
+    for (i = 0; i < size && flen + 4 < FUZZ_FMT_LEN; i++) {
+        if (data[i] < 0xf0 || nr_args == FUZZ_FMT_CONVS) {
+            /* Text, printable and never a '%' */
+            if (!piece || piece->arg != -1UL) {
+                piece = fuzz_pieces + nr_pieces++;
+                piece->arg = -1UL;
+                plen = 0;
+            }
+            fuzz_fmt[flen] = ' ' + data[i] % 95;
+            if (fuzz_fmt[flen] == '%')
+                fuzz_fmt[flen] = '#';
+            piece->fmt[plen++] = fuzz_fmt[flen++];
+            piece->fmt[plen] = '\0';
+            continue;
+        }
+
+        conv = fuzz_convs[data[i] - 0xf0];
+        piece = fuzz_pieces + nr_pieces++;
+        strcpy(piece->fmt, conv);
+        strcpy(fuzz_fmt + flen, conv);
+        flen += strlen(conv);
+
+        if (conv[1] == 's' || conv[1] == 'p') {
+            args[nr_args] = (unsigned long)fuzz_string;
+        } else {
+            for (j = 0; j < sizeof(long) && i + 1 < size; j++)
+                args[nr_args] |= (unsigned long)data[++i] << (j * 8);
+        }
+        piece->arg = args[nr_args++];
+        /* No text goes into a conversion piece */
+        piece = NULL;
+    }
+    fuzz_fmt[flen] = '\0';
+
+    len = fuzz_snprintf(fuzz_out, sizeof(fuzz_out), fuzz_fmt, args);
+    if (len >= sizeof(fuzz_out))
+        panic("'%s' printed %d bytes!\n", fuzz_fmt, len);
+
+    for (i = 0; i < nr_pieces; i++) {
+        n = snprintf(fuzz_cat + cat, sizeof(fuzz_cat) - cat,
+                     fuzz_pieces[i].fmt, fuzz_pieces[i].arg);
+        cat += n;
+    }
+    if (cat != len || memcmp(fuzz_cat, fuzz_out, len))
+        panic("'%s' isn't printed as its pieces!\n", fuzz_fmt);
+
+    for (bsize = 0; bsize <= len + 1; bsize++) {
+        memset(fuzz_buf, 0x5a, sizeof(fuzz_buf));
+
+        n = fuzz_snprintf(fuzz_buf, bsize, fuzz_fmt, args);
+        if (n != len)
+            panic("'%s' into %lu returned %d, not %d!\n",
+                  fuzz_fmt, bsize, n, len);
+        if (fuzz_buf[bsize] != 0x5a)
+            panic("'%s' overran %lu bytes!\n", fuzz_fmt, bsize);
+        if (!bsize)
+            continue;
+
+        n = min_t(size_t, bsize - 1, len);
+        if (memcmp(fuzz_buf, fuzz_out, n) || fuzz_buf[n])
+            panic("'%s' into %lu isn't a prefix!\n", fuzz_fmt, bsize);
+    }
+    return 0;
+}
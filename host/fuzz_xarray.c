@@ -0,0 +1,138 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <slab.h>
+#include <bug.h>
+#include <kernel.h>
+#include <printk.h>
+#include <string.h>
+#include <xarray.h>
+
+#include "shim.h"
+
+/*
+ * Stores, erases and loads at indices from the input, against a plain
+ * table of what the array should hold. Each op takes two bytes: the
+ * op and a shift of the index in the first, the index in the second.
+ */
+
+#define FUZZ_XA_KEYS    (4 * 256)
+
+extern struct kmem_cache *xa_node_cachep;
+
+enum {
+    FUZZ_XA_STORE,
+    FUZZ_XA_ERASE,
+    FUZZ_XA_LOAD,
+    FUZZ_XA_OPS
+};
+
+struct fuzz_xa_key {
+    unsigned long index;
+    void *entry;
+};
+
+static struct fuzz_xa_key fuzz_keys[FUZZ_XA_KEYS];
+static unsigned int fuzz_nr_keys;
+
+/* Entries only need to be distinct and not internal */
+static unsigned long fuzz_entries[FUZZ_XA_KEYS];
+
+static struct fuzz_xa_key *
+fuzz_key(unsigned long index)
+{
+    unsigned int i;
+
+    for (i = 0; i < fuzz_nr_keys; i++) {
+        if (fuzz_keys[i].index == index)
+            return fuzz_keys + i;
+    }
+
+    BUG_ON(fuzz_nr_keys >= FUZZ_XA_KEYS);
+    fuzz_keys[fuzz_nr_keys].index = index;
+    fuzz_keys[fuzz_nr_keys].entry = NULL;
+    return fuzz_keys + fuzz_nr_keys++;
+}
+
+static void
+fuzz_check(struct xarray *xa, struct fuzz_xa_key *key)
+{
+    void *entry = xa_load(xa, key->index);
+
+    if (entry != key->entry)
+        panic("xarray [%lx] is %p, not %p!\n",
+              key->index, entry, key->entry);
+}
+
+/* There is no xa_destroy(), nodes go back constructed, see xa_node_ctor */
+static void
+fuzz_free_nodes(void *entry)
+{
+    struct xa_node *node;
+    unsigned int i;
+
+    if (!xa_is_node(entry))
+        return;
+
+    node = xa_to_node(entry);
+    if (node->shift) {
+        for (i = 0; i < XA_CHUNK_SIZE; i++)
+            fuzz_free_nodes(node->slots[i]);
+    }
+
+    memset(node, 0, sizeof(*node));
+    kmem_cache_free(xa_node_cachep, node);
+}
+
+int LLVMFuzzerInitialize(int *argc, char ***argv)
+{
+    host_boot(HOST_MEMORY_SIZE);
+    return 0;
+}
+
+int LLVMFuzzerTestOneInput(const u8 *data, size_t size)
+{
+    struct xarray xa = XARRAY_INIT(xa, 0);
+    struct fuzz_xa_key *key;
+    unsigned long index;
+    unsigned int i, op;
+    void *old;
+
+    fuzz_nr_keys = 0;
+
+    for (i = 0; i + 1 < size; i += 2) {
+        /* Up to 255 << 18, three levels of nodes */
+        index = (unsigned long)data[i + 1] << ((data[i] >> 4) % 4 * 6);
+        op = (data[i] & 0xf) % FUZZ_XA_OPS;
+
+        key = fuzz_key(index);
+        switch (op) {
+        case FUZZ_XA_STORE:
+        case FUZZ_XA_ERASE: {
+            XA_STATE(xas, &xa, index);
+
+            old = xas_store(&xas, op == FUZZ_XA_STORE ?
+                            &fuzz_entries[key - fuzz_keys] : NULL);
+            if (xas_error(&xas))
+                panic("xas_store [%lx] failed!\n", index);
+            if (xa_is_zero(old))
+                old = NULL;
+            if (old != key->entry)
+                panic("xas_store [%lx] replaced %p, not %p!\n",
+                      index, old, key->entry);
+
+            key->entry = op == FUZZ_XA_STORE ?
+                &fuzz_entries[key - fuzz_keys] : NULL;
+            break;
+        }
+        case FUZZ_XA_LOAD:
+            fuzz_check(&xa, key);
+            break;
+        }
+    }
+
+    for (i = 0; i < fuzz_nr_keys; i++)
+        fuzz_check(&xa, fuzz_keys + i);
+
+    fuzz_free_nodes(xa.xa_head);
+    return 0;
+}
@@ -0,0 +1,46 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef _HOST_HOST_H
+#define _HOST_HOST_H
+
+/*
+ * Force-included by host/Makefile into every kernel file of the host
+ * build. Kernel code is built against the kernel headers but linked
+ * with the C library, so the functions both define are renamed on the
+ * kernel side. Calls from kernel code get the kernel versions, which
+ * are the ones to test, and libc and the sanitizers keep their own.
+ */
+
+#define CONFIG_HOST 1
+
+/* See read_word_at_a_time() */
+#define __no_sanitize_address   __attribute__((no_sanitize_address))
+
+/* startup/string.c */
+#define memset          xl_memset
+#define memcpy          xl_memcpy
+#define memmove         xl_memmove
+#define memcmp          xl_memcmp
+#define strcmp          xl_strcmp
+
+/* lib/string.c */
+#define memchr          xl_memchr
+#define strlen          xl_strlen
+#define strcspn         xl_strcspn
+#define strrchr         xl_strrchr
+#define strchr          xl_strchr
+#define strncmp         xl_strncmp
+#define strchrnul       xl_strchrnul
+#define strnlen         xl_strnlen
+#define strcasecmp      xl_strcasecmp
+#define strlcpy         xl_strlcpy
+#define strcpy          xl_strcpy
+#define strncpy         xl_strncpy
+
+/* lib/vsprintf.c */
+#define vsnprintf       xl_vsnprintf
+#define snprintf        xl_snprintf
+#define sprintf         xl_sprintf
+#define vscnprintf      xl_vscnprintf
+#define scnprintf       xl_scnprintf
+
+#endif /* _HOST_HOST_H */
@@ -0,0 +1,99 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef _ASM_RISCV_SPINLOCK_H
+#define _ASM_RISCV_SPINLOCK_H
+
+#include <types.h>
+#include <atomic.h>
+#include <barrier.h>
+#include <spinlock_types.h>
+
+/*
+ * include/asm-spinlock.h with the AMOs and LR/SC loops done by the
+ * compiler builtins: the ticket from a fetch-add, the trylocks and
+ * the rwlocks as compare-and-swap loops.
+ */
+
+static inline int arch_spin_value_unlocked(arch_spinlock_t lock)
+{
+    return lock.tickets.owner == lock.tickets.next;
+}
+
+static inline int arch_spin_is_locked(arch_spinlock_t *lock)
+{
+    arch_spinlock_t val = { .val = READ_ONCE(lock->val) };
+
+    return !arch_spin_value_unlocked(val);
+}
+
+static inline void arch_spin_lock(arch_spinlock_t *lock)
+{
+    arch_spinlock_t val;
+
+    val.val = __atomic_fetch_add(&lock->val, 1U << 16, __ATOMIC_RELAXED);
+
+    while (__atomic_load_n(&lock->tickets.owner, __ATOMIC_ACQUIRE) !=
+           val.tickets.next)
+        cpu_relax();
+}
+
+static inline int arch_spin_trylock(arch_spinlock_t *lock)
+{
+    arch_spinlock_t old = { .val = READ_ONCE(lock->val) };
+
+    if (!arch_spin_value_unlocked(old))
+        return 0;
+
+    return __atomic_compare_exchange_n(&lock->val, &old.val,
+                                       old.val + (1U << 16), false,
+                                       __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+
+static inline void arch_spin_unlock(arch_spinlock_t *lock)
+{
+    __atomic_store_n(&lock->tickets.owner, lock->tickets.owner + 1,
+                     __ATOMIC_RELEASE);
+}
+
+static inline int arch_read_trylock(arch_rwlock_t *lock)
+{
+    int val = READ_ONCE(lock->lock);
+
+    while (val >= 0) {
+        if (__atomic_compare_exchange_n(&lock->lock, &val, val + 1, false,
+                                        __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+            return 1;
+    }
+    return 0;
+}
+
+static inline int arch_write_trylock(arch_rwlock_t *lock)
+{
+    int val = 0;
+
+    return __atomic_compare_exchange_n(&lock->lock, &val, -1, false,
+                                       __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+
+static inline void arch_read_lock(arch_rwlock_t *lock)
+{
+    while (!arch_read_trylock(lock))
+        cpu_relax();
+}
+
+static inline void arch_write_lock(arch_rwlock_t *lock)
+{
+    while (!arch_write_trylock(lock))
+        cpu_relax();
+}
+
+static inline void arch_read_unlock(arch_rwlock_t *lock)
+{
+    __atomic_fetch_sub(&lock->lock, 1, __ATOMIC_RELEASE);
+}
+
+static inline void arch_write_unlock(arch_rwlock_t *lock)
+{
+    __atomic_store_n(&lock->lock, 0, __ATOMIC_RELEASE);
+}
+
+#endif /* _ASM_RISCV_SPINLOCK_H */
@@ -0,0 +1,176 @@
+// SPDX-License-Identifier: GPL-2.0
+
+#ifndef _ASM_GENERIC_ATOMIC_LONG_H
+#define _ASM_GENERIC_ATOMIC_LONG_H
+
+#include <bug.h>
+#include <types.h>
+#include <compiler_attributes.h>
+
+/*
+ * include/atomic.h with the AMOs and LR/SC loops done by the compiler
+ * builtins, in the same orderings: relaxed, or fully ordered for .aqrl.
+ */
+
+#ifndef __READ_ONCE
+#define __READ_ONCE(x)  (*(const volatile __unqual_scalar_typeof(x) *)&(x))
+#endif
+
+#define READ_ONCE(x)    \
+({                      \
+    __READ_ONCE(x);     \
+})
+
+#define __WRITE_ONCE(x, val)                        \
+do {                                    \
+    *(volatile typeof(x) *)&(x) = (val);                \
+} while (0)
+
+#define WRITE_ONCE(x, val)  \
+do {                        \
+    __WRITE_ONCE(x, val);   \
+} while (0)
+
+#define atomic_read(v)  READ_ONCE((v)->counter)
+#define atomic_set(v, i) WRITE_ONCE(((v)->counter), (i))
+
+typedef struct {
+    int counter;
+} atomic_t;
+
+typedef struct {
+    s64 counter;
+} atomic64_t;
+
+typedef atomic64_t atomic_long_t;
+
+static __always_inline s64
+atomic64_read(const atomic64_t *v)
+{
+    return READ_ONCE(v->counter);
+}
+
+static __always_inline void
+atomic64_set(atomic64_t *v, s64 i)
+{
+    WRITE_ONCE(v->counter, i);
+}
+
+#define ATOMIC_OP(op, I, c_type, prefix)                    \
+static __always_inline                                      \
+void atomic##prefix##_##op(c_type i, atomic##prefix##_t *v) \
+{                                                           \
+    __atomic_fetch_##op(&v->counter, I, __ATOMIC_RELAXED);  \
+}
+
+#define ATOMIC_OPS(op, I)               \
+        ATOMIC_OP(op, I, int,   )       \
+        ATOMIC_OP(op, I, s64, 64)
+
+ATOMIC_OPS(add, i)
+ATOMIC_OPS(sub, i)
+ATOMIC_OPS(and, i)
+ATOMIC_OPS( or, i)
+ATOMIC_OPS(xor, i)
+
+#undef ATOMIC_OP
+#undef ATOMIC_OPS
+
+#define ATOMIC_FETCH_OP(op, c_type, prefix)                         \
+static __always_inline                                              \
+c_type atomic##prefix##_fetch_##op##_relaxed(c_type i,              \
+                                             atomic##prefix##_t *v) \
+{                                                                   \
+    return __atomic_fetch_##op(&v->counter, i, __ATOMIC_RELAXED);   \
+}                                                                   \
+static __always_inline                                              \
+c_type atomic##prefix##_fetch_##op(c_type i, atomic##prefix##_t *v) \
+{                                                                   \
+    return __atomic_fetch_##op(&v->counter, i, __ATOMIC_SEQ_CST);   \
+}
+
+#define ATOMIC_OP_RETURN(op, c_type, prefix)                            \
+static __always_inline                                                  \
+c_type atomic##prefix##_##op##_return_relaxed(c_type i,                 \
+                                              atomic##prefix##_t *v)    \
+{                                                                       \
+    return __atomic_##op##_fetch(&v->counter, i, __ATOMIC_RELAXED);     \
+}                                                                       \
+static __always_inline                                                  \
+c_type atomic##prefix##_##op##_return(c_type i, atomic##prefix##_t *v)  \
+{                                                                       \
+    return __atomic_##op##_fetch(&v->counter, i, __ATOMIC_SEQ_CST);     \
+}
+
+#define ATOMIC_OPS(op)                      \
+        ATOMIC_FETCH_OP(op, int,   )        \
+        ATOMIC_OP_RETURN(op, int,   )       \
+        ATOMIC_FETCH_OP(op, s64, 64)        \
+        ATOMIC_OP_RETURN(op, s64, 64)
+
+ATOMIC_OPS(add)
+ATOMIC_OPS(sub)
+
+#define atomic_add_return_relaxed   atomic_add_return_relaxed
+#define atomic_sub_return_relaxed   atomic_sub_return_relaxed
+#define atomic_add_return       atomic_add_return
+#define atomic_sub_return       atomic_sub_return
+
+#define atomic_fetch_add_relaxed    atomic_fetch_add_relaxed
+#define atomic_fetch_sub_relaxed    atomic_fetch_sub_relaxed
+#define atomic_fetch_add        atomic_fetch_add
+#define atomic_fetch_sub        atomic_fetch_sub
+
+#define atomic64_add_return_relaxed atomic64_add_return_relaxed
+#define atomic64_sub_return_relaxed atomic64_sub_return_relaxed
+#define atomic64_add_return     atomic64_add_return
+#define atomic64_sub_return     atomic64_sub_return
+
+#define atomic64_fetch_add_relaxed  atomic64_fetch_add_relaxed
+#define atomic64_fetch_sub_relaxed  atomic64_fetch_sub_relaxed
+#define atomic64_fetch_add      atomic64_fetch_add
+#define atomic64_fetch_sub      atomic64_fetch_sub
+
+#undef ATOMIC_FETCH_OP
+#undef ATOMIC_OP_RETURN
+#undef ATOMIC_OPS
+
+static __always_inline void
+atomic_long_set(atomic_long_t *v, long i)
+{
+    atomic64_set(v, i);
+}
+
+static __always_inline void
+atomic_long_add(long i, atomic_long_t *v)
+{
+    atomic64_add(i, v);
+}
+
+static __always_inline int
+atomic_dec_return(atomic_t *v)
+{
+    return atomic_sub_return(1, v);
+}
+
+static __always_inline bool
+atomic_dec_and_test(atomic_t *v)
+{
+    return atomic_dec_return(v) == 0;
+}
+
+static __always_inline long
+atomic_long_read(const atomic_long_t *v)
+{
+    return atomic64_read(v);
+}
+
+static __always_inline s64
+atomic64_cmpxchg(atomic64_t *v, s64 old, s64 new)
+{
+    __atomic_compare_exchange_n(&v->counter, &old, new, false,
+                                __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    return old;
+}
+
+#endif /* _ASM_GENERIC_ATOMIC_LONG_H */
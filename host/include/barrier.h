@@ -0,0 +1,18 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef _ASM_RISCV_BARRIER_H
+#define _ASM_RISCV_BARRIER_H
+
+#define barrier() __asm__ __volatile__ ("" : : : "memory")
+
+/* The host has no devices to order against, fences are enough */
+#define mb()        __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define rmb()       __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#define wmb()       __atomic_thread_fence(__ATOMIC_RELEASE)
+
+#define smp_mb()    mb()
+#define smp_rmb()   rmb()
+#define smp_wmb()   wmb()
+
+#define cpu_relax() __builtin_ia32_pause()
+
+#endif /* _ASM_RISCV_BARRIER_H */
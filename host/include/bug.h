@@ -0,0 +1,13 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef _HOST_BUG_H
+#define _HOST_BUG_H
+
+#include_next <bug.h>
+
+/* A BUG() or panic() aborts, so a debugger or sanitizer stops there */
+void host_halt(void) __attribute__((noreturn));
+
+#undef halt
+#define halt() host_halt()
+
+#endif /* _HOST_BUG_H */
@@ -0,0 +1,21 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef _ASM_RISCV_CURRENT_H
+#define _ASM_RISCV_CURRENT_H
+
+#ifndef __ASSEMBLY__
+
+#include <sched.h>
+
+/* One task, the program itself, see host/kernel.c */
+extern struct task_struct *host_current;
+
+static __always_inline struct task_struct *get_current(void)
+{
+    return host_current;
+}
+
+#define current get_current()
+
+#endif /* __ASSEMBLY__ */
+
+#endif /* _ASM_RISCV_CURRENT_H */
@@ -0,0 +1,8 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef _LINUX_EXPORT_H
+#define _LINUX_EXPORT_H
+
+/* There is no module loader on the host to resolve symbols for */
+#define EXPORT_SYMBOL(sym)
+
+#endif /* _LINUX_EXPORT_H */
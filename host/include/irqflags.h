@@ -0,0 +1,36 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+#ifndef _LINUX_TRACE_IRQFLAGS_H
+#define _LINUX_TRACE_IRQFLAGS_H
+
+/* No interrupts on the host, the flags only keep the callers as is */
+
+static inline void arch_local_irq_enable(void)
+{
+}
+
+static inline void arch_local_irq_disable(void)
+{
+}
+
+static inline unsigned long arch_local_irq_save(void)
+{
+    return 0;
+}
+
+static inline void arch_local_irq_restore(unsigned long flags)
+{
+}
+
+#define raw_local_irq_enable()  arch_local_irq_enable()
+
+#define raw_local_irq_disable() arch_local_irq_disable()
+
+#define local_irq_enable()  do { raw_local_irq_enable(); } while (0)
+#define local_irq_disable() do { raw_local_irq_disable(); } while (0)
+
+#define local_irq_save(flags) \
+    do { (flags) = arch_local_irq_save(); } while (0)
+#define local_irq_restore(flags) \
+    do { arch_local_irq_restore(flags); } while (0)
+
+#endif /* _LINUX_TRACE_IRQFLAGS_H */
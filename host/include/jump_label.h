@@ -0,0 +1,12 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef _HOST_JUMP_LABEL_H
+#define _HOST_JUMP_LABEL_H
+
+#include_next <jump_label.h>
+
+/* Nothing patches code on the host, a branch tests the key */
+#undef static_branch_unlikely
+#define static_branch_unlikely(key) \
+    __builtin_expect(static_key_enabled(key), 0)
+
+#endif /* _HOST_JUMP_LABEL_H */
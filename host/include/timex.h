@@ -0,0 +1,31 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef _ASM_RISCV_TIMEX_H
+#define _ASM_RISCV_TIMEX_H
+
+#include <types.h>
+
+typedef unsigned long cycles_t;
+
+/* Frequency of get_time(), nanoseconds on the host */
+extern unsigned long riscv_timebase;
+
+/* CLOCK_MONOTONIC in nanoseconds, from host/shim.c */
+u64 host_time_ns(void);
+
+static inline cycles_t get_cycles(void)
+{
+    return __builtin_ia32_rdtsc();
+}
+
+/* There is no cheap retired instruction count, see perf stat */
+static inline cycles_t get_instret(void)
+{
+    return 0;
+}
+
+static inline u64 get_time(void)
+{
+    return host_time_ns();
+}
+
+#endif /* _ASM_RISCV_TIMEX_H */
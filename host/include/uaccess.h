@@ -0,0 +1,88 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef _ASM_RISCV_UACCESS_H
+#define _ASM_RISCV_UACCESS_H
+
+#include <errno.h>
+#include <string.h>
+#include <thread_info.h>
+#include <word-at-a-time.h>
+#include <compiler_attributes.h>
+
+/*
+ * The host has one address space, so "user" memory is plain memory.
+ * The limit is kept as in include/uaccess.h, the task starts with
+ * KERNEL_DS. Only what lib/ needs.
+ */
+
+#define access_ok(addr, size) ({                    \
+    likely(__access_ok((unsigned long __force)(addr), (size))); \
+})
+
+#define get_fs() (current_thread_info()->addr_limit)
+#define user_addr_max() (get_fs().seg)
+
+#define user_access_begin(ptr,len) access_ok(ptr, len)
+#define user_access_end() do { } while (0)
+
+#define user_read_access_begin user_access_begin
+#define user_read_access_end user_access_end
+
+#define uaccess_kernel() (get_fs().seg == KERNEL_DS.seg)
+
+static inline void set_fs(mm_segment_t fs)
+{
+    current_thread_info()->addr_limit = fs;
+}
+
+static inline int __access_ok(unsigned long addr, unsigned long size)
+{
+    const mm_segment_t fs = get_fs();
+
+    return size <= fs.seg && addr <= fs.seg - size;
+}
+
+/* Word loads of lib/string.c may run past a string, as in the kernel */
+#define __get_user(x, ptr) ({                                       \
+    if (sizeof(*(ptr)) == sizeof(unsigned long))                    \
+        (x) = (__typeof__(*(ptr)))read_word_at_a_time(ptr);         \
+    else                                                            \
+        (x) = *(ptr);                                               \
+    0;                                                              \
+})
+#define __put_user(x, ptr)      ({ *(ptr) = (x); 0; })
+
+#define get_user(x, ptr)        __get_user(x, ptr)
+#define put_user(x, ptr)        __put_user(x, ptr)
+
+#define unsafe_get_user(x,p)    __get_user(x,p)
+
+static inline unsigned long
+copy_to_user(void *to, const void *from, unsigned long n)
+{
+    if (!access_ok(to, n))
+        return n;
+    memcpy(to, from, n);
+    return 0;
+}
+
+static inline unsigned long
+copy_from_user(void *to, const void *from, unsigned long n)
+{
+    if (!access_ok(from, n)) {
+        memset(to, 0, n);
+        return n;
+    }
+    memcpy(to, from, n);
+    return 0;
+}
+
+static inline unsigned long
+clear_user(void *to, unsigned long n)
+{
+    if (!access_ok(to, n))
+        return n;
+    memset(to, 0, n);
+    return 0;
+}
+
+#endif /* _ASM_RISCV_UACCESS_H */
@@ -0,0 +1,18 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef _HOST_INITCALL_H
+#define _HOST_INITCALL_H
+
+/*
+ * Force-included by host/Makefile into the file which defines
+ * init_module() of a module or its test, as scripts/initcall.h is
+ * into the monolithic image. HOST_INITCALL names a pointer to it, for
+ * host_boot() and the test runner to call.
+ */
+
+#include <module.h>
+
+static int init_module(void);
+
+init_module_t HOST_INITCALL = init_module;
+
+#endif /* _HOST_INITCALL_H */
@@ -0,0 +1,190 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <mm.h>
+#include <bug.h>
+#include <page.h>
+#include <slab.h>
+#include <sizes.h>
+#include <timex.h>
+#include <export.h>
+#include <module.h>
+#include <kernel.h>
+#include <printk.h>
+#include <string.h>
+#include <memblock.h>
+#include <jump_label.h>
+#include <vector.h>
+#include <thread_info.h>
+
+#include "shim.h"
+
+/*
+ * What startup/ and early_dt/ own in the kernel, for the modules of
+ * the host build. Memory is an arena from the host, which the kernel
+ * sees at HOST_PHYS_BASE as it would see DRAM.
+ */
+
+#define HOST_PHYS_BASE  0x80000000UL
+
+/* startup/mm.c */
+uintptr_t kernel_start;
+unsigned long pfn_base;
+unsigned long va_pa_offset;
+
+/* The program runs as one kernel thread */
+static struct task_struct host_task = {
+    .thread_info.addr_limit = KERNEL_DS,
+};
+struct task_struct *host_current = &host_task;
+
+/* startup/module.c, no image to reserve */
+uintptr_t kernel_size;
+uintptr_t modules_init_start;
+uintptr_t modules_init_end;
+
+/* early_dt/early_dt.c */
+phys_addr_t dt_memory_base;
+phys_addr_t dt_memory_size;
+
+/* lib/time.c, get_time() is in nanoseconds */
+unsigned long riscv_timebase = 1000000000;
+
+/* startup/init.c, set by slab */
+kmalloc_t kmalloc;
+kfree_t kfree;
+kmemdup_nul_t kmemdup_nul;
+kmem_cache_alloc_t kmem_cache_alloc;
+kmem_cache_free_t kmem_cache_free;
+
+/* lib/wait_bit.c, nothing sleeps in the one thread of the host */
+void wait_bit_init(void)
+{
+}
+
+/* lib/printk.c */
+int console_loglevel = CONSOLE_LOGLEVEL_DEFAULT;
+DEFINE_STATIC_KEY_FALSE(printk_debug_key);
+
+/* The direct map is the arena itself, there is nothing to map */
+void
+setup_vm_final(struct memblock_region *regions,
+               unsigned long regions_cnt,
+               phys_alloc_t alloc)
+{
+}
+
+/* A branch tests the key, see host/include/jump_label.h */
+void static_key_enable(struct static_key *key)
+{
+    key->enabled++;
+}
+
+void static_key_disable(struct static_key *key)
+{
+    if (key->enabled)
+        key->enabled--;
+}
+
+/* startup/vector.c, the scalar string functions do it all */
+bool may_use_vector(void)
+{
+    return false;
+}
+
+void kernel_vector_begin(void)
+{
+    BUG();
+}
+
+void kernel_vector_end(void)
+{
+    BUG();
+}
+
+void *__memcpy_rvv(void *dest, const void *src, size_t count)
+{
+    BUG();
+}
+
+void *__memset_rvv(void *s, int c, size_t count)
+{
+    BUG();
+}
+
+void *__memmove_rvv(void *dest, const void *src, size_t count)
+{
+    BUG();
+}
+
+/* Written straight out, there is no log buffer to drain */
+void printk(const char *fmt, ...)
+{
+    char buf[1024];
+    int level = MESSAGE_LOGLEVEL_DEFAULT;
+    va_list args;
+    int len;
+
+    if (fmt[0] == KERN_SOH_ASCII && fmt[1]) {
+        level = fmt[1] - '0';
+        fmt += 2;
+    }
+    if (level >= console_loglevel)
+        return;
+
+    va_start(args, fmt);
+    len = vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+
+    if (len >= sizeof(buf))
+        len = sizeof(buf) - 1;
+
+    host_write(buf, len);
+}
+
+void console_flush(void)
+{
+}
+
+/* Boot modules of the host build, in the order the loader takes them */
+extern init_module_t host_init_lib;
+extern init_module_t host_init_memblock;
+extern init_module_t host_init_buddy;
+extern init_module_t host_init_slab;
+extern init_module_t host_init_rbtree;
+extern init_module_t host_init_radix_tree;
+extern init_module_t host_init_bitmap;
+extern init_module_t host_init_xarray;
+extern init_module_t host_init_scatterlist;
+
+static init_module_t *host_initcalls[] = {
+    &host_init_lib,
+    &host_init_memblock,
+    &host_init_buddy,
+    &host_init_slab,
+    &host_init_rbtree,
+    &host_init_radix_tree,
+    &host_init_bitmap,
+    &host_init_xarray,
+    &host_init_scatterlist,
+};
+
+void
+host_boot(unsigned long size)
+{
+    unsigned long i;
+    void *arena;
+
+    arena = host_alloc_arena(size);
+
+    va_pa_offset = (unsigned long)arena - HOST_PHYS_BASE;
+    pfn_base = PFN_DOWN(HOST_PHYS_BASE);
+
+    dt_memory_base = HOST_PHYS_BASE;
+    dt_memory_size = size;
+    kernel_start = HOST_PHYS_BASE;
+
+    for (i = 0; i < ARRAY_SIZE(host_initcalls); i++) {
+        if ((*host_initcalls[i])())
+            panic("init of boot module %lu failed!\n", i);
+    }
+}
@@ -0,0 +1,68 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <time.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "shim.h"
+
+/*
+ * Aligned to the largest buddy block, as DRAM is, so that the first
+ * pages can merge all the way up.
+ */
+#define HOST_ARENA_ALIGN    (4UL << 20)
+
+void *host_alloc_arena(unsigned long size)
+{
+    unsigned long base;
+    void *p;
+
+    p = mmap(NULL, size + HOST_ARENA_ALIGN, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (p == MAP_FAILED) {
+        perror("mmap");
+        exit(2);
+    }
+
+    base = ((unsigned long)p + HOST_ARENA_ALIGN - 1) &
+        ~(HOST_ARENA_ALIGN - 1);
+    return (void *)base;
+}
+
+/* The arch routines behind startup/string.c */
+void *__memset(void *s, int c, size_t count)
+{
+    return memset(s, c, count);
+}
+
+void *__memcpy(void *dest, const void *src, size_t count)
+{
+    return memcpy(dest, src, count);
+}
+
+void *__memmove(void *dest, const void *src, size_t count)
+{
+    return memmove(dest, src, count);
+}
+
+void host_write(const char *buf, int len)
+{
+    fwrite(buf, 1, len, stdout);
+}
+
+unsigned long host_time_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000UL + ts.tv_nsec;
+}
+
+void host_halt(void)
+{
+    fflush(stdout);
+    abort();
+}
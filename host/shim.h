@@ -0,0 +1,23 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef _HOST_SHIM_H
+#define _HOST_SHIM_H
+
+/*
+ * Between the kernel and the host side of the host build, so only
+ * plain C types here: kernel.c is built against the kernel headers,
+ * shim.c and the programs against the C library.
+ */
+
+/* Size of the memory which the programs give host_boot() */
+#define HOST_MEMORY_SIZE    (256UL << 20)
+
+/* kernel.c: set up memory and call the init of each boot module */
+void host_boot(unsigned long size);
+
+/* shim.c */
+void *host_alloc_arena(unsigned long size);
+void host_write(const char *buf, int len);
+unsigned long host_time_ns(void);
+void host_halt(void) __attribute__((noreturn));
+
+#endif /* _HOST_SHIM_H */
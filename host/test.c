@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <kernel.h>
+#include <module.h>
+#include <printk.h>
+#include <string.h>
+
+#include "shim.h"
+
+/*
+ * Runs the test module of each subsystem in the host build, or of
+ * those named on the command line, after host_boot(). Exits with the
+ * number that failed.
+ */
+
+#define HOST_TEST(name) \
+    extern init_module_t host_test_##name
+
+HOST_TEST(lib);
+HOST_TEST(rbtree);
+HOST_TEST(radix_tree);
+HOST_TEST(bitmap);
+HOST_TEST(xarray);
+HOST_TEST(scatterlist);
+HOST_TEST(buddy);
+
+#define HOST_TEST_ENTRY(name)   { #name, &host_test_##name }
+
+static const struct {
+    const char *name;
+    init_module_t *init;
+} host_tests[] = {
+    HOST_TEST_ENTRY(lib),
+    HOST_TEST_ENTRY(rbtree),
+    HOST_TEST_ENTRY(radix_tree),
+    HOST_TEST_ENTRY(bitmap),
+    HOST_TEST_ENTRY(xarray),
+    HOST_TEST_ENTRY(scatterlist),
+    HOST_TEST_ENTRY(buddy),
+};
+
+static bool
+test_selected(const char *name, int argc, char *argv[])
+{
+    int i;
+
+    if (argc < 2)
+        return true;
+
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], name))
+            return true;
+    }
+    return false;
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned long i;
+    int failed = 0;
+
+    host_boot(HOST_MEMORY_SIZE);
+
+    for (i = 0; i < ARRAY_SIZE(host_tests); i++) {
+        if (!test_selected(host_tests[i].name, argc, argv))
+            continue;
+
+        if ((*host_tests[i].init)()) {
+            printk(_RED("test_%s failed!\n"), host_tests[i].name);
+            failed++;
+        }
+    }
+
+    return failed;
+}
@@ -0,0 +1,163 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef _ASM_RISCV_SPINLOCK_H
+#define _ASM_RISCV_SPINLOCK_H
+
+#include <types.h>
+#include <atomic.h>
+#include <barrier.h>
+#include <spinlock_types.h>
+
+/*
+ * Ticket locks. The ticket is taken with one amoadd.w on the whole
+ * word, the owner is only ever stored by the holder, with a halfword
+ * store which the AMOs of the others on the word don't lose.
+ */
+
+static inline int arch_spin_value_unlocked(arch_spinlock_t lock)
+{
+    return lock.tickets.owner == lock.tickets.next;
+}
+
+static inline int arch_spin_is_locked(arch_spinlock_t *lock)
+{
+    arch_spinlock_t val = { .val = READ_ONCE(lock->val) };
+
+    return !arch_spin_value_unlocked(val);
+}
+
+static inline void arch_spin_lock(arch_spinlock_t *lock)
+{
+    arch_spinlock_t val;
+
+    __asm__ __volatile__ (
+        "   amoadd.w %0, %2, %1\n"
+        : "=&r" (val.val), "+A" (lock->val)
+        : "r" (1U << 16)
+        : "memory");
+
+    while (READ_ONCE(lock->tickets.owner) != val.tickets.next)
+        cpu_relax();
+
+    __asm__ __volatile__ (RISCV_ACQUIRE_BARRIER ::: "memory");
+}
+
+/* Takes a ticket only when it is the one served next */
+static inline int arch_spin_trylock(arch_spinlock_t *lock)
+{
+    arch_spinlock_t old;
+    u32 tmp, owner;
+
+    __asm__ __volatile__ (
+        "1: lr.w    %0, %3\n"
+        "   srliw   %1, %0, 16\n"
+        "   slli    %2, %0, 48\n"
+        "   srli    %2, %2, 48\n"
+        "   bne     %1, %2, 2f\n"
+        "   addw    %1, %0, %4\n"
+        "   sc.w    %1, %1, %3\n"
+        "   bnez    %1, 1b\n"
+        RISCV_ACQUIRE_BARRIER
+        "2:\n"
+        : "=&r" (old.val), "=&r" (tmp), "=&r" (owner), "+A" (lock->val)
+        : "r" (1U << 16)
+        : "memory");
+
+    return arch_spin_value_unlocked(old);
+}
+
+static inline void arch_spin_unlock(arch_spinlock_t *lock)
+{
+    u16 owner = lock->tickets.owner;
+
+    __asm__ __volatile__ (RISCV_RELEASE_BARRIER ::: "memory");
+    WRITE_ONCE(lock->tickets.owner, owner + 1);
+}
+
+/*
+ * Reader/writer locks, LR/SC on the count. A writer waits for the
+ * last reader to leave, readers keep coming in meanwhile.
+ */
+
+static inline void arch_read_lock(arch_rwlock_t *lock)
+{
+    int tmp;
+
+    __asm__ __volatile__ (
+        "1: lr.w    %1, %0\n"
+        "   bltz    %1, 1b\n"
+        "   addi    %1, %1, 1\n"
+        "   sc.w    %1, %1, %0\n"
+        "   bnez    %1, 1b\n"
+        RISCV_ACQUIRE_BARRIER
+        : "+A" (lock->lock), "=&r" (tmp)
+        :: "memory");
+}
+
+static inline void arch_write_lock(arch_rwlock_t *lock)
+{
+    int tmp;
+
+    __asm__ __volatile__ (
+        "1: lr.w    %1, %0\n"
+        "   bnez    %1, 1b\n"
+        "   li      %1, -1\n"
+        "   sc.w    %1, %1, %0\n"
+        "   bnez    %1, 1b\n"
+        RISCV_ACQUIRE_BARRIER
+        : "+A" (lock->lock), "=&r" (tmp)
+        :: "memory");
+}
+
+static inline int arch_read_trylock(arch_rwlock_t *lock)
+{
+    int busy;
+
+    __asm__ __volatile__ (
+        "1: lr.w    %1, %0\n"
+        "   bltz    %1, 2f\n"
+        "   addi    %1, %1, 1\n"
+        "   sc.w    %1, %1, %0\n"
+        "   bnez    %1, 1b\n"
+        RISCV_ACQUIRE_BARRIER
+        "2:\n"
+        : "+A" (lock->lock), "=&r" (busy)
+        :: "memory");
+
+    return !busy;
+}
+
+static inline int arch_write_trylock(arch_rwlock_t *lock)
+{
+    int busy;
+
+    __asm__ __volatile__ (
+        "1: lr.w    %1, %0\n"
+        "   bnez    %1, 2f\n"
+        "   li      %1, -1\n"
+        "   sc.w    %1, %1, %0\n"
+        "   bnez    %1, 1b\n"
+        RISCV_ACQUIRE_BARRIER
+        "2:\n"
+        : "+A" (lock->lock), "=&r" (busy)
+        :: "memory");
+
+    return !busy;
+}
+
+static inline void arch_read_unlock(arch_rwlock_t *lock)
+{
+    __asm__ __volatile__ (
+        RISCV_RELEASE_BARRIER
+        "   amoadd.w x0, %1, %0\n"
+        : "+A" (lock->lock)
+        : "r" (-1)
+        : "memory");
+}
+
+static inline void arch_write_unlock(arch_rwlock_t *lock)
+{
+    __asm__ __volatile__ (RISCV_RELEASE_BARRIER ::: "memory");
+    WRITE_ONCE(lock->lock, 0);
+}
+
+#endif /* _ASM_RISCV_SPINLOCK_H */
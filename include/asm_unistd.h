@@ -16,10 +16,26 @@ __SYSCALL(__NR_write, sys_write)
 #define __NR_readlinkat 78
 __SYSCALL(__NR_readlinkat, sys_readlinkat)
 
+/* timer/time.c */
+#define __NR_clock_gettime 113
+__SYSCALL(__NR_clock_gettime, sys_clock_gettime)
+
+/* sys/sys.c */
+#define __NR_reboot 142
+__SYSCALL(__NR_reboot, sys_reboot)
+
 /* sys/sys.c */
 #define __NR_uname 160
 __SYSCALL(__NR_uname, sys_newuname)
 
+/* sys/sys.c */
+#define __NR_getcpu 168
+__SYSCALL(__NR_getcpu, sys_getcpu)
+
+/* timer/time.c */
+#define __NR_gettimeofday 169
+__SYSCALL(__NR_gettimeofday, sys_gettimeofday)
+
 /* mm/nommu.c, also with MMU */
 #define __NR_brk 214
 __SYSCALL(__NR_brk, sys_brk)
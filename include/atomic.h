@@ -196,4 +196,32 @@ atomic_long_read(const atomic_long_t *v)
     return atomic64_read(v);
 }
 
+/**
+ * atomic64_cmpxchg - compare and exchange
+ * @v: pointer of type atomic64_t
+ * @old: expected value
+ * @new: value to store if @v holds @old
+ *
+ * Atomically stores @new in @v if it holds @old, fully ordered.
+ * Returns the value @v held before, which equals @old on success.
+ */
+static __always_inline s64
+atomic64_cmpxchg(atomic64_t *v, s64 old, s64 new)
+{
+    s64 ret;
+    register unsigned int rc;
+
+    __asm__ __volatile__ (
+        "0: lr.d %0, %2\n"
+        "   bne  %0, %z3, 1f\n"
+        "   sc.d.rl %1, %z4, %2\n"
+        "   bnez %1, 0b\n"
+        "   fence rw, rw\n"
+        "1:\n"
+        : "=&r" (ret), "=&r" (rc), "+A" (v->counter)
+        : "rJ" (old), "rJ" (new)
+        : "memory");
+    return ret;
+}
+
 #endif /* _ASM_GENERIC_ATOMIC_LONG_H */
@@ -31,4 +31,6 @@
 
 #define AT_EXECFN 31   /* filename of program */
 
+#define AT_SYSINFO_EHDR 33  /* the start address of the page containing the VDSO */
+
 #endif /* _UAPI_LINUX_AUXVEC_H */
@@ -0,0 +1,33 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef _ASM_RISCV_BARRIER_H
+#define _ASM_RISCV_BARRIER_H
+
+#define RISCV_FENCE(p, s) \
+    __asm__ __volatile__ ("fence " #p "," #s : : : "memory")
+
+#define barrier() __asm__ __volatile__ ("" : : : "memory")
+
+/* These barriers need to enforce ordering on both devices or memory. */
+#define mb()        RISCV_FENCE(iorw,iorw)
+#define rmb()       RISCV_FENCE(ir,ir)
+#define wmb()       RISCV_FENCE(ow,ow)
+
+/* These barriers do not need to enforce ordering on devices, just memory. */
+#define smp_mb()    RISCV_FENCE(rw,rw)
+#define smp_rmb()   RISCV_FENCE(r,r)
+#define smp_wmb()   RISCV_FENCE(w,w)
+
+/* Of a lock, the accesses in the section stay in between */
+#define RISCV_ACQUIRE_BARRIER   "\tfence r , rw\n"
+#define RISCV_RELEASE_BARRIER   "\tfence rw,  w\n"
+
+/* For spin loops, a long-latency stall in lieu of a pause */
+static inline void cpu_relax(void)
+{
+    int dummy;
+
+    __asm__ __volatile__ ("div %0, %0, zero" : "=r" (dummy));
+    barrier();
+}
+
+#endif /* _ASM_RISCV_BARRIER_H */
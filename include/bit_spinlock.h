@@ -0,0 +1,50 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+#ifndef __LINUX_BIT_SPINLOCK_H
+#define __LINUX_BIT_SPINLOCK_H
+
+#include <bits.h>
+#include <barrier.h>
+#include <compiler_attributes.h>
+
+/*
+ *  bit-based spin_lock()
+ *
+ * Don't use this unless you really need to: spin_lock() and spin_unlock()
+ * are significantly faster. There is no lockstat for these, and nothing
+ * fair about who gets the bit next, but it fits where there is no room
+ * for a lock, e.g. the heads of a large hash table.
+ */
+static inline void bit_spin_lock(int bitnum, unsigned long *addr)
+{
+    while (unlikely(test_and_set_bit_lock(bitnum, addr))) {
+        do {
+            cpu_relax();
+        } while (test_bit(bitnum, addr));
+    }
+}
+
+/*
+ * Return true if it was acquired
+ */
+static inline int bit_spin_trylock(int bitnum, unsigned long *addr)
+{
+    return !test_and_set_bit_lock(bitnum, addr);
+}
+
+/*
+ *  bit-based spin_unlock()
+ */
+static inline void bit_spin_unlock(int bitnum, unsigned long *addr)
+{
+    clear_bit_unlock(bitnum, addr);
+}
+
+/*
+ * Return true if the lock is held.
+ */
+static inline int bit_spin_is_locked(int bitnum, unsigned long *addr)
+{
+    return test_bit(bitnum, addr);
+}
+
+#endif /* __LINUX_BIT_SPINLOCK_H */
@@ -4,6 +4,7 @@
 #define BLK_MQ_H
 
 #include <blkdev.h>
+#include <spinlock.h>
 #include <workqueue.h>
 
 /**
@@ -79,6 +80,20 @@ struct blk_mq_tags {
 };
 
 struct blk_mq_hw_ctx {
+    /**
+     * @lock: Protects the dispatch list.
+     */
+    spinlock_t lock;
+
+    /**
+     * @dispatch: Used for requests that are ready to be dispatched to
+     * the hardware but for some reason (e.g. lack of resources) could
+     * not be sent to the hardware. As soon as the driver can send new
+     * requests, requests at this list will be sent first for a fairer
+     * dispatch.
+     */
+    struct list_head dispatch;
+
     /**
      * @state: BLK_MQ_S_* flags. Defines the state of the hw
      * queue (active, scheduled to restart, stopped).
@@ -119,6 +119,9 @@ struct request {
     enum mq_rq_state state;
     struct list_head queuelist;
 
+    /* jiffies by which the I/O scheduler should dispatch it */
+    unsigned long fifo_time;
+
     struct gendisk *rq_disk;
 };
 
@@ -10,6 +10,7 @@
     printk("\n########################\n"); \
     printk("BUG: %s (%s:%u)", __FUNCTION__, __FILE__, __LINE__); \
     printk("\n########################\n"); \
+    console_flush(); \
     halt();  \
 } while (0)
 
@@ -23,6 +24,7 @@
         printk("PANIC: %s (%s:%u)\n", __FUNCTION__, __FILE__, __LINE__); \
         printk(args); \
         printk("\n########################\n"); \
+        console_flush(); \
         halt();  \
     } while(0)
 
@@ -8,6 +8,9 @@ struct circ_buf {
     int tail;
 };
 
+/* Return count in buffer.  */
+#define CIRC_CNT(head,tail,size) (((head) - (tail)) & ((size)-1))
+
 /* Return space available up to the end of the buffer.  */
 #define CIRC_SPACE_TO_END(head,tail,size) \
     ({int end = (size) - 1 - (head); \
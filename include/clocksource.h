@@ -0,0 +1,54 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+#ifndef _LINUX_CLOCKSOURCE_H
+#define _LINUX_CLOCKSOURCE_H
+
+#include <types.h>
+#include <math64.h>
+
+/**
+ * struct clocksource - hardware abstraction for a free running counter
+ *  Provides mostly state-free accessors to the underlying hardware.
+ *  This is the structure used for system time.
+ *
+ * @read:       Returns a cycle value, passes clocksource as argument
+ * @mask:       Bitmask for two's complement
+ *              subtraction of non 64 bit counters
+ * @mult:       Cycle to nanosecond multiplier
+ * @shift:      Cycle to nanosecond divisor (power of two)
+ * @name:       Pointer to clocksource name
+ * @rating:     Rating value for selection (higher is better)
+ */
+struct clocksource {
+    u64         (*read)(struct clocksource *cs);
+    u64         mask;
+    u32         mult;
+    u32         shift;
+    const char  *name;
+    int         rating;
+};
+
+#define CLOCKSOURCE_MASK(bits) (u64)((bits) < 64 ? ((1ULL << (bits)) - 1) : -1)
+
+/**
+ * clocksource_cyc2ns - converts clocksource cycles to nanoseconds
+ * @cycles:     cycles
+ * @mult:       cycle to nanosecond multiplier
+ * @shift:      cycle to nanosecond divisor (power of two)
+ *
+ * Done with a 128 bit product, see mul_u64_u32_shr(), so there is
+ * no range of @cycles to keep it to.
+ */
+static inline u64 clocksource_cyc2ns(u64 cycles, u32 mult, u32 shift)
+{
+    return mul_u64_u32_shr(cycles, mult, shift);
+}
+
+void
+clocks_calc_mult_shift(u32 *mult, u32 *shift, u32 from, u32 to, u32 maxsec);
+
+int clocksource_register_hz(struct clocksource *cs, u32 hz);
+
+/* ns since boot for the scheduler, the cheapest clock there is */
+u64 sched_clock(void);
+
+#endif /* _LINUX_CLOCKSOURCE_H */
@@ -5,12 +5,18 @@
 #define __packed                __attribute__((__packed__))
 #define __section(S)            __attribute__((__section__(#S)))
 #define __cold                  __attribute__((__cold__))
+#define __noreturn              __attribute__((__noreturn__))
 #define __aligned(x)            __attribute__((__aligned__(x)))
 #define __attribute_const__     __attribute__((__const__))
 #define __always_inline         inline __attribute__((__always_inline__))
 
 #define __force
 
+/* Loads that may run past an object on purpose, host/host.h sets it */
+#ifndef __no_sanitize_address
+#define __no_sanitize_address
+#endif
+
 #define likely(x)   (x)
 #define unlikely(x) (x)
 
@@ -9,7 +9,7 @@
 #define CONFIG_VA_BITS      39
 #define CONFIG_PA_BITS      56
 #define CONFIG_PAGE_OFFSET  0xffffffe000000000
-#define CONFIG_NR_CPUS      1
+#define CONFIG_NR_CPUS      16
 
 #define COMMAND_LINE_SIZE   512
 
@@ -18,4 +18,15 @@
 #define CONFIG_SERIAL_8250_NR_UARTS 4
 #define CONFIG_SERIAL_8250_RUNTIME_UARTS 4
 
+/* Records in the ring of each trace event, a power of 2 */
+#define CONFIG_TRACE_RING_RECORDS   512
+
+/* Bytes of kernel text per bucket of the profiler, as a shift */
+#define CONFIG_PROFILE_SHIFT        2
+
+/* Highest printk level compiled in, set by 'make LOGLEVEL=n' */
+#ifndef CONFIG_PRINTK_LEVEL
+#define CONFIG_PRINTK_LEVEL 7
+#endif
+
 #endif  /* _CONFIG_H */
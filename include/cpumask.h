@@ -2,10 +2,34 @@
 #ifndef __LINUX_CPUMASK_H
 #define __LINUX_CPUMASK_H
 
-#define nr_cpu_ids 1U
+#include <bits.h>
+#include <types.h>
+#include <find_bit.h>
+
+/* Possible CPUs are numbered from 0 on, see early_init_dt_scan_cpus() */
+extern unsigned int nr_cpu_ids;
 
 #define nr_cpumask_bits ((unsigned int)NR_CPUS)
 
+/*
+ * The following particular system cpumasks and operations manage
+ * possible and online cpus. Each of them is a fixed size bitmap.
+ *
+ *  cpu_possible_mask- has bit 'cpu' set iff cpu is populated
+ *  cpu_online_mask  - has bit 'cpu' set iff cpu available to scheduler
+ */
+extern struct cpumask __cpu_possible_mask;
+extern struct cpumask __cpu_online_mask;
+
+#define cpu_possible_mask   ((const struct cpumask *)&__cpu_possible_mask)
+#define cpu_online_mask     ((const struct cpumask *)&__cpu_online_mask)
+
+/**
+ * cpumask_bits - get the bits in a cpumask
+ * @maskp: the struct cpumask *
+ */
+#define cpumask_bits(maskp) ((maskp)->bits)
+
 /**
  * cpumask_size - size to allocate for a 'struct cpumask' in bytes
  */
@@ -14,4 +38,74 @@ static inline unsigned int cpumask_size(void)
     return BITS_TO_LONGS(nr_cpumask_bits) * sizeof(long);
 }
 
+static inline void cpumask_set_cpu(unsigned int cpu, struct cpumask *dstp)
+{
+    set_bit(cpu, cpumask_bits(dstp));
+}
+
+static inline void cpumask_clear_cpu(int cpu, struct cpumask *dstp)
+{
+    clear_bit(cpu, cpumask_bits(dstp));
+}
+
+static inline int cpumask_test_cpu(int cpu, const struct cpumask *cpumask)
+{
+    return test_bit(cpu, cpumask_bits(cpumask));
+}
+
+/**
+ * cpumask_next - get the next cpu in a cpumask
+ * @n: the cpu prior to the place to search (ie. return will be > @n)
+ * @srcp: the cpumask pointer
+ *
+ * Returns >= nr_cpu_ids if no further cpus set.
+ */
+static inline unsigned int cpumask_next(int n, const struct cpumask *srcp)
+{
+    return find_next_bit(cpumask_bits(srcp), nr_cpumask_bits, n + 1);
+}
+
+/**
+ * for_each_cpu - iterate over every cpu in a mask
+ * @cpu: the (optionally unsigned) integer iterator
+ * @mask: the cpumask pointer
+ *
+ * After the loop, cpu is >= nr_cpu_ids.
+ */
+#define for_each_cpu(cpu, mask)                     \
+    for ((cpu) = -1;                                \
+         (cpu) = cpumask_next((cpu), (mask)),       \
+         (cpu) < nr_cpu_ids;)
+
+#define for_each_possible_cpu(cpu)  for_each_cpu((cpu), cpu_possible_mask)
+#define for_each_online_cpu(cpu)    for_each_cpu((cpu), cpu_online_mask)
+
+#define cpu_possible(cpu)   cpumask_test_cpu((cpu), cpu_possible_mask)
+#define cpu_online(cpu)     cpumask_test_cpu((cpu), cpu_online_mask)
+
+static inline void set_cpu_possible(unsigned int cpu, bool possible)
+{
+    if (possible)
+        cpumask_set_cpu(cpu, &__cpu_possible_mask);
+    else
+        cpumask_clear_cpu(cpu, &__cpu_possible_mask);
+}
+
+static inline void set_cpu_online(unsigned int cpu, bool online)
+{
+    if (online)
+        cpumask_set_cpu(cpu, &__cpu_online_mask);
+    else
+        cpumask_clear_cpu(cpu, &__cpu_online_mask);
+}
+
+static inline unsigned int num_online_cpus(void)
+{
+    unsigned int cpu, nr = 0;
+
+    for_each_online_cpu(cpu)
+        nr++;
+    return nr;
+}
+
 #endif /* __LINUX_CPUMASK_H */
@@ -15,6 +15,16 @@
 #define CSR_SIP         0x144
 #define CSR_SATP        0x180
 
+#define CSR_CYCLE       0xc00
+#define CSR_TIME        0xc01
+#define CSR_INSTRET     0xc02
+
+#define CSR_VSTART      0x008
+#define CSR_VCSR        0x00f
+#define CSR_VL          0xc20
+#define CSR_VTYPE       0xc21
+#define CSR_VLENB       0xc22
+
 #define CSR_IE      CSR_SIE
 #define CSR_IP      CSR_SIP
 #define CSR_STATUS	CSR_SSTATUS
@@ -35,6 +45,17 @@
 #define SR_FS_CLEAN	_AC(0x00004000, UL)
 #define SR_FS_DIRTY	_AC(0x00006000, UL)
 
+#define SR_VS		_AC(0x00000600, UL) /* Vector Status */
+#define SR_VS_OFF	_AC(0x00000000, UL)
+#define SR_VS_INITIAL	_AC(0x00000200, UL)
+#define SR_VS_CLEAN	_AC(0x00000400, UL)
+#define SR_VS_DIRTY	_AC(0x00000600, UL)
+
+/* Counters that U-mode may read, in the scounteren CSR */
+#define SCOUNTEREN_CY   _AC(0x00000001, UL)
+#define SCOUNTEREN_TM   _AC(0x00000002, UL)
+#define SCOUNTEREN_IR   _AC(0x00000004, UL)
+
 /* Exception cause high bit - is an interrupt if set */
 #define CAUSE_IRQ_FLAG  (_AC(1, UL) << (__riscv_xlen - 1))
 
@@ -49,6 +70,11 @@
 #define IRQ_S_EXT       9
 #define IRQ_M_EXT       11
 
+/* Interrupt enable bits of the ie CSR */
+#define IE_SIE      (_AC(1, UL) << IRQ_S_SOFT)
+#define IE_TIE      (_AC(1, UL) << IRQ_S_TIMER)
+#define IE_EIE      (_AC(1, UL) << IRQ_S_EXT)
+
 /* Exception causes */
 #define EXC_INST_MISALIGNED     0
 #define EXC_INST_ACCESS         1
@@ -66,6 +92,15 @@
 #define RV_IRQ_EXT  IRQ_S_EXT
 
 #ifndef __ASSEMBLY__
+#define csr_read(csr)                                   \
+({                                                      \
+    register unsigned long __v;                         \
+    __asm__ __volatile__ ("csrr %0, " __ASM_STR(csr)    \
+                          : "=r" (__v) :                \
+                          : "memory");                  \
+    __v;                                                \
+})
+
 #define csr_write(csr, val)                             \
 ({                                                      \
     unsigned long __v = (unsigned long)(val);           \
@@ -89,6 +124,15 @@
                           : : "rK" (__v)                \
                           : "memory");                  \
 })
+
+#define csr_read_clear(csr, val)                        \
+({                                                      \
+    unsigned long __v = (unsigned long)(val);           \
+    __asm__ __volatile__ ("csrrc %0, " __ASM_STR(csr) ", %1" \
+                          : "=r" (__v) : "rK" (__v)     \
+                          : "memory");                  \
+    __v;                                                \
+})
 #endif /* __ASSEMBLY__ */
 
 #endif /* _ASM_RISCV_CSR_H */
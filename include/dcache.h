@@ -74,6 +74,9 @@ __d_lookup_rcu(const struct dentry *parent, const struct qstr *name);
 struct dentry *
 d_alloc(struct dentry * parent, const struct qstr *name);
 
+struct dentry *
+d_alloc_anon(struct super_block *sb);
+
 void
 d_instantiate(struct dentry *entry, struct inode * inode);
 
@@ -15,6 +15,8 @@ void set_mm_exe_file(struct mm_struct *mm, struct file *new_exe_file);
 
 pid_t kernel_thread(int (*fn)(void *), void *arg, unsigned long flags);
 
+struct task_struct *fork_idle(int cpu);
+
 int copy_thread(unsigned long clone_flags,
                 unsigned long usp, unsigned long arg,
                 struct task_struct *p, unsigned long tls);
@@ -16,8 +16,28 @@ static inline void arch_local_irq_disable(void)
     csr_clear(CSR_STATUS, SR_IE);
 }
 
+/* get status and disable interrupts */
+static inline unsigned long arch_local_irq_save(void)
+{
+    return csr_read_clear(CSR_STATUS, SR_IE);
+}
+
+/* set interrupt enabled status */
+static inline void arch_local_irq_restore(unsigned long flags)
+{
+    csr_set(CSR_STATUS, flags & SR_IE);
+}
+
 #define raw_local_irq_enable()  arch_local_irq_enable()
 
+#define raw_local_irq_disable() arch_local_irq_disable()
+
 #define local_irq_enable()  do { raw_local_irq_enable(); } while (0)
+#define local_irq_disable() do { raw_local_irq_disable(); } while (0)
+
+#define local_irq_save(flags) \
+    do { (flags) = arch_local_irq_save(); } while (0)
+#define local_irq_restore(flags) \
+    do { arch_local_irq_restore(flags); } while (0)
 
 #endif /* _LINUX_TRACE_IRQFLAGS_H */
@@ -8,6 +8,32 @@
 #define HZ              CONFIG_HZ   /* Internal kernel timer frequency */
 #define MSEC_PER_SEC    1000L
 
+/*
+ * Have the 32 bit jiffies value wrap 5 minutes after boot
+ * so jiffies wrap bugs show up earlier.
+ */
+#define INITIAL_JIFFIES ((unsigned long)(unsigned int) (-300*HZ))
+
+/* Ticks of HZ since boot, advanced by the timer interrupt */
+extern unsigned long volatile jiffies;
+
+/*
+ * These inlines deal with timer wrapping correctly. You are
+ * strongly encouraged to use them:
+ *
+ * time_after(a,b) returns true if the time a is after time b.
+ */
+#define time_after(a,b)     ((long)((b) - (a)) < 0)
+#define time_before(a,b)    time_after(b,a)
+
+#define time_after_eq(a,b)  ((long)((a) - (b)) >= 0)
+#define time_before_eq(a,b) time_after_eq(b,a)
+
+static inline unsigned int jiffies_to_msecs(const unsigned long j)
+{
+    return (MSEC_PER_SEC / HZ) * j;
+}
+
 /*
  * HZ is equal to or smaller than 1000, and 1000 is a nice round
  * multiple of HZ, divide with the factor between them, but round
@@ -0,0 +1,73 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef _LINUX_JUMP_LABEL_H
+#define _LINUX_JUMP_LABEL_H
+
+#include <types.h>
+#include <compiler_attributes.h>
+
+/*
+ * Static keys: a branch on a key compiles to a single nop, which is
+ * patched into a jump to the out of line code when the key is enabled.
+ * Every such site is recorded in the __jump_table section of the image
+ * it lives in, startup's own and each module's.
+ */
+struct static_key {
+    int enabled;
+};
+
+struct jump_entry {
+    unsigned long code;     /* address of the nop */
+    unsigned long target;   /* where it jumps when enabled */
+    struct static_key *key;
+};
+
+#define STATIC_KEY_INIT_FALSE   { .enabled = 0 }
+
+#define DEFINE_STATIC_KEY_FALSE(name) \
+    struct static_key name = STATIC_KEY_INIT_FALSE
+
+#define DECLARE_STATIC_KEY_FALSE(name) \
+    extern struct static_key name
+
+/*
+ * A macro rather than an inline function, so that the key stays a
+ * link time constant for the "i" constraint without optimization.
+ */
+#define arch_static_branch(key) ({                                  \
+    __label__ l_yes;                                                \
+    bool __ret = true;                                              \
+    asm goto("  .option push                    \n"                 \
+             "  .option norelax                 \n"                 \
+             "  .option norvc                   \n"                 \
+             "1: nop                            \n"                 \
+             "  .option pop                     \n"                 \
+             "  .pushsection __jump_table, \"aw\" \n"               \
+             "  .align 3                        \n"                 \
+             "  .dword 1b, %l[l_yes], %0        \n"                 \
+             "  .popsection                     \n"                 \
+             : : "i" (key) : : l_yes);                              \
+    __ret = false;                                                  \
+l_yes:                                                              \
+    __ret;                                                          \
+})
+
+#define static_branch_unlikely(key) \
+    __builtin_expect(arch_static_branch(key), 0)
+
+static inline bool
+static_key_enabled(struct static_key *key)
+{
+    return key->enabled > 0;
+}
+
+void static_key_enable(struct static_key *key);
+void static_key_disable(struct static_key *key);
+
+/* Patch the sites of enabled keys in a freshly loaded module */
+struct module;
+void jump_label_apply_module(struct module *mod);
+
+/* Forget the sites in init text, called once it is freed */
+void jump_label_invalidate_initmem(void);
+
+#endif /* _LINUX_JUMP_LABEL_H */
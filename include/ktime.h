@@ -0,0 +1,62 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+#ifndef _LINUX_KTIME_H
+#define _LINUX_KTIME_H
+
+#include <types.h>
+
+#define NSEC_PER_USEC   1000L
+#define NSEC_PER_MSEC   1000000L
+#define USEC_PER_MSEC   1000L
+#define USEC_PER_SEC    1000000L
+#define NSEC_PER_SEC    1000000000L
+
+/* Nanosecond scalar representation for kernel time values */
+typedef s64 ktime_t;
+
+#define KTIME_MAX       ((s64)~((u64)1 << 63))
+
+/* Subtract two ktime_t variables. rem = lhs -rhs: */
+#define ktime_sub(lhs, rhs)     ((lhs) - (rhs))
+
+/* Add two ktime_t variables. res = lhs + rhs: */
+#define ktime_add(lhs, rhs)     ((lhs) + (rhs))
+
+/* Add a ktime_t variable and a scalar nanosecond value. res = kt + nsval: */
+#define ktime_add_ns(kt, nsval) ((kt) + (nsval))
+
+static inline s64 ktime_to_ns(const ktime_t kt)
+{
+    return kt;
+}
+
+static inline ktime_t ns_to_ktime(u64 ns)
+{
+    return ns;
+}
+
+static inline s64 ktime_to_us(const ktime_t kt)
+{
+    return kt / NSEC_PER_USEC;
+}
+
+static inline s64 ktime_us_delta(const ktime_t later, const ktime_t earlier)
+{
+    return ktime_to_us(ktime_sub(later, earlier));
+}
+
+/*
+ * The time CSR through the clocksource of the timer module, in ns
+ * since reset. One CSR read, one multiply and a shift, no division.
+ */
+ktime_t ktime_get(void);
+
+static inline u64 ktime_get_ns(void)
+{
+    return ktime_to_ns(ktime_get());
+}
+
+/* Conversions between timebase cycles and ns, with the same mult/shift */
+u64 cycles_to_ns(u64 cycles);
+u64 ns_to_cycles(u64 ns);
+
+#endif /* _LINUX_KTIME_H */
@@ -5,7 +5,12 @@
 #include <page.h>
 #include <compiler_attributes.h>
 
-#define __initdata __section(.init.data)
+/*
+ * Code and data only used at boot. They are freed by free_initmem()
+ * once all modules have been initialized.
+ */
+#define __init      __section(.init.text)
+#define __initdata  __section(.init.data)
 
 #define __page_aligned_bss \
     __section(.bss..page_aligned) __aligned(PAGE_SIZE)
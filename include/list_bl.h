@@ -2,6 +2,12 @@
 #ifndef _LINUX_LIST_BL_H
 #define _LINUX_LIST_BL_H
 
+#include <bit_spinlock.h>
+
+/*
+ * Bit 0 of the head pointer is a lock of the list, see hlist_bl_lock().
+ * The list is only changed with it held.
+ */
 #define LIST_BL_LOCKMASK    1UL
 
 #define hlist_bl_entry(ptr, type, member) container_of(ptr, type, member)
@@ -81,4 +87,19 @@ static inline void __hlist_bl_del(struct hlist_bl_node *n)
         next->pprev = pprev;
 }
 
+static inline void hlist_bl_lock(struct hlist_bl_head *b)
+{
+    bit_spin_lock(0, (unsigned long *)b);
+}
+
+static inline void hlist_bl_unlock(struct hlist_bl_head *b)
+{
+    bit_spin_unlock(0, (unsigned long *)b);
+}
+
+static inline bool hlist_bl_is_locked(struct hlist_bl_head *b)
+{
+    return bit_spin_is_locked(0, (unsigned long *)b);
+}
+
 #endif /* _LINUX_LIST_BL_H */
@@ -0,0 +1,50 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef _LINUX_LOCKSTAT_H
+#define _LINUX_LOCKSTAT_H
+
+/*
+ * Lock statistics, built in with "make LOCKSTAT=1". Each lock is of a
+ * class, that of its DEFINE_SPINLOCK() or of the spin_lock_init()
+ * call site, so e.g. the locks of all zones are one class. A class
+ * counts per CPU how often its locks were taken and how often they
+ * were found taken, and the time spent waiting for and holding them,
+ * in timebase ticks. Readers of a rwlock are counted without a hold
+ * time, they hold it together.
+ *
+ * lockstat_dump() writes the classes taken so far to the console.
+ */
+
+#include <types.h>
+
+#ifdef CONFIG_LOCK_STAT
+
+struct lock_class_stats {
+    unsigned long acquisitions;
+    unsigned long contentions;
+    u64 wait_total;
+    u64 wait_max;
+    u64 hold_total;
+    u64 hold_max;
+};
+
+struct lock_class {
+    const char *name;
+    struct lock_class *next;    /* on lock_classes, once taken */
+    bool registered;
+    struct lock_class_stats stats[NR_CPUS];
+};
+
+/* The classes taken so far, latest first */
+extern struct lock_class *lock_classes;
+
+void lockstat_dump(void);
+
+#else
+
+static inline void lockstat_dump(void)
+{
+}
+
+#endif /* CONFIG_LOCK_STAT */
+
+#endif /* _LINUX_LOCKSTAT_H */
@@ -0,0 +1,48 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef _LINUX_LZ4_H
+#define _LINUX_LZ4_H
+
+#include <types.h>
+
+#define LZ4_MINMATCH    4
+
+/*
+ * Decompress the LZ4 block @src into @dst in a single pass.
+ * Returns the number of bytes written to @dst, or -1 if the block is
+ * corrupted or doesn't fit into @dst_len bytes.
+ */
+long lz4_decompress(const void *src, size_t src_len,
+                    void *dst, size_t dst_len);
+
+/*
+ * Layout of an LZ4-compressed module produced by scripts/lz4mod.
+ *
+ * It takes the place of the .ko file after startup.bin in the flash
+ * and is followed by two LZ4 blocks:
+ *
+ * - meta: the ELF header, section headers and the non-allocated
+ *   sections (symtab, strtab, rela, .modname). The sh_offset of the
+ *   allocated sections is 0, they are not in here.
+ * - image: the allocated sections already laid out by the same rules
+ *   as layout_sections() in startup/module.c, NOBITS zeroed, so it is
+ *   decompressed straight to the load address of the module.
+ * - init: the .init.* sections laid out the same way, decompressed
+ *   straight to the init area of the module.
+ *
+ * scripts/lz4mod.c has its own copy of this structure, keep both
+ * in sync.
+ */
+#define MODULE_LZ4_MAGIC    "XLMODLZ4"
+#define MODULE_LZ4_SMAGIC   8
+
+struct module_lz4_header {
+    char magic[MODULE_LZ4_SMAGIC];
+    u32 meta_size;      /* decompressed */
+    u32 meta_csize;
+    u32 image_size;     /* layout size, without struct module */
+    u32 image_csize;
+    u32 init_size;      /* layout size of the init sections */
+    u32 init_csize;
+};
+
+#endif /* _LINUX_LZ4_H */
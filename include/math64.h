@@ -0,0 +1,17 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+#ifndef _LINUX_MATH64_H
+#define _LINUX_MATH64_H
+
+#include <types.h>
+
+/*
+ * Many a GCC version messes this up and generates a 64x64 mult :-(
+ * rv64 has mulhu, the 128 bit product is two multiplies and can't
+ * overflow, unlike (a * mul) >> shift.
+ */
+static inline u64 mul_u64_u32_shr(u64 a, u32 mul, unsigned int shift)
+{
+    return (u64)(((unsigned __int128)a * mul) >> shift);
+}
+
+#endif /* _LINUX_MATH64_H */
@@ -54,6 +54,7 @@
 #define VM_GROWSUP      VM_NONE
 #define VM_SEQ_READ     0x00008000  /* App will access data sequentially */
 #define VM_RAND_READ    0x00010000  /* App will not benefit from clustered reads */
+#define VM_DONTEXPAND   0x00040000  /* Cannot expand with mremap() */
 #define VM_ACCOUNT      0x00100000  /* Is a VM accounted object */
 #define VM_NORESERVE    0x00200000  /* should the VM suppress accounting */
 #define VM_SYNC         0x00800000  /* Synchronous page faults */
@@ -152,6 +153,12 @@ extern pgd_t swapper_pg_dir[];
 
 extern phys_addr_t dtb_early_pa;
 
+extern char __init_begin[];
+extern char __init_end[];
+
+unsigned long
+free_reserved_area(void *start, void *end, const char *s);
+
 typedef phys_addr_t (*phys_alloc_t)(phys_addr_t size, phys_addr_t align);
 
 typedef void (*do_page_fault_t)(struct pt_regs *);
@@ -232,6 +239,14 @@ static inline struct page *virt_to_head_page(const void *x)
 
 int insert_vm_struct(struct mm_struct *mm, struct vm_area_struct *vma);
 
+struct vm_special_mapping;
+
+struct vm_area_struct *
+_install_special_mapping(struct mm_struct *mm,
+                         unsigned long addr, unsigned long len,
+                         unsigned long vm_flags,
+                         const struct vm_special_mapping *spec);
+
 void __vma_link_list(struct mm_struct *mm, struct vm_area_struct *vma,
                      struct vm_area_struct *prev);
 
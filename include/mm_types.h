@@ -64,6 +64,8 @@ struct mm_struct {
 
     struct linux_binfmt *binfmt;
 
+    void *vdso;                 /* base of the vDSO text */
+
     unsigned long highest_vm_end;   /* highest vma end address */
 
     unsigned long (*get_unmapped_area)(struct file *filp,
@@ -132,6 +134,17 @@ struct vm_area_struct {
 
     /* Function pointers to deal with this struct. */
     const struct vm_operations_struct *vm_ops;
+
+    void *vm_private_data;      /* was vm_pte (shared mem) */
+};
+
+/*
+ * Kernel pages mapped into a process as they are, e.g. the vDSO.
+ * @pages is NULL terminated, faults past the last page get SIGBUS.
+ */
+struct vm_special_mapping {
+    const char *name;
+    struct page **pages;
 };
 
 static inline void
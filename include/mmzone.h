@@ -6,6 +6,7 @@
 #include <page.h>
 #include <atomic.h>
 #include <kernel.h>
+#include <spinlock.h>
 
 #define MAX_ORDER 11
 #define MAX_ORDER_NR_PAGES (1 << (MAX_ORDER - 1))
@@ -104,6 +105,9 @@ struct zone {
 
     int initialized;
 
+    /* Primarily protects free_area, and the list of the pageset */
+    spinlock_t          lock;
+
     /* free areas of different sizes */
     struct free_area    free_area[MAX_ORDER];
 };
@@ -2,23 +2,106 @@
 #ifndef _LINUX_MODULE_H
 #define _LINUX_MODULE_H
 
+#include <types.h>
 #include <export.h>
 #include <list.h>
 
+struct jump_entry;
+
+#define MODULE_NAME_LEN 32
+#define MODULE_MAX_DEPS 8
+
+enum module_init_level {
+    MODULE_INIT_BOOT = 0,   /* before rest_init(), the default */
+    MODULE_INIT_DEFERRED,   /* by do_deferred_modules() after boot */
+};
+
+/*
+ * Put MODULE_INIT_LEVEL(MODULE_INIT_DEFERRED) into the file defining
+ * init_module() of a module which isn't needed to start /sbin/init.
+ * The loader still calls it at boot if a boot module uses any of its
+ * symbols.
+ */
+#define MODULE_INIT_LEVEL(level) \
+    static const int init_module_level __attribute__((used)) = (level)
+
 typedef int (*init_module_t)(void);
 typedef void (*exit_module_t)(void);
 
+/* Entry of the initcall table in the monolithic image */
+struct initcall {
+    init_module_t init;
+    const int *level;
+    int idx;                /* of the subsystem in SUBDIRS, from 1 */
+};
+
+/* Subsystem @user uses symbols of @owner, see scripts/initcall_deps.sh */
+struct initcall_dep {
+    int user;
+    int owner;
+};
+
+/* Cycles spent in each phase of loading a module at boot */
+struct module_boot_stat {
+    u64 layout;
+    u64 copy;
+    u64 symbols;
+    u64 relocate;
+    u64 init;
+
+    /* Bytes copied into the module image */
+    u64 bytes;
+};
+
 struct module {
     struct list_head list;
 
+    char name[MODULE_NAME_LEN];
+
+    /*
+     * Where the core of the module got laid out, text first. The text
+     * of a prelinked module keeps its .init.* sections in place.
+     */
+    uintptr_t base;
+    unsigned long size;
+    bool prelinked;
+
     const struct kernel_symbol *syms;
     unsigned int num_syms;
 
+    /* Static branch sites, see jump_label.h */
+    struct jump_entry *jump_entries;
+    unsigned int num_jump_entries;
+
     /* Startup function. */
     init_module_t init;
 
     /* Destruction function. */
     exit_module_t exit;
+
+    int init_level;
+    bool init_done;
+
+    /* Deferred modules whose symbols this module uses */
+    struct module *deps[MODULE_MAX_DEPS];
+    unsigned int num_deps;
+
+    struct module_boot_stat boot_stat;
 };
 
+extern struct list_head modules;
+
+/* Timebase ticks spent in load_modules() */
+extern u64 modules_load_ticks;
+
+/* Init sections of the modules linked at boot, see free_initmem() */
+extern uintptr_t modules_init_start;
+extern uintptr_t modules_init_end;
+
+void do_deferred_modules(void);
+
+/* Boot statistics of resolving undefined symbols for modules */
+extern unsigned long ksym_lookups;
+extern unsigned long ksym_lookup_cycles;
+
 #endif /* _LINUX_MODULE_H */
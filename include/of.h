@@ -157,6 +157,8 @@ of_match_node(const struct of_device_id *matches,
 
 bool of_device_is_available(const struct device_node *device);
 
+int riscv_of_parent_hartid(struct device_node *node);
+
 static inline bool
 of_property_read_bool(const struct device_node *np, const char *propname)
 {
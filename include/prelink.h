@@ -0,0 +1,54 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef _LINUX_PRELINK_H
+#define _LINUX_PRELINK_H
+
+#include <types.h>
+#include <module.h>
+
+/*
+ * Layout of a prelinked module image produced by scripts/prelink.
+ *
+ * The image takes the place of the .ko files after startup.bin in the
+ * flash. All modules are already laid out, relocated and resolved for
+ * the fixed load address @base, so the loader only copies each module
+ * from the image behind the entry table to its @addr and registers it.
+ * The space for each struct module behind a module is left zeroed.
+ *
+ * @ksymtab_hash is the FNV-1a hash of the names and values in _ksymtab
+ * of the startup image the modules were resolved against, the loader
+ * only takes the image if its own _ksymtab hashes the same.
+ *
+ * scripts/prelink.c has its own copy of these structures, keep both
+ * in sync and bump PRELINK_VERSION on any change.
+ */
+#define PRELINK_MAGIC   "XLPRELNK"
+#define PRELINK_SMAGIC  8
+#define PRELINK_VERSION 5
+
+struct prelink_header {
+    char magic[PRELINK_SMAGIC];
+    u32 version;
+    u32 nr_modules;
+    u64 base;           /* load address of the first module */
+    u64 module_size;    /* sizeof(struct module) prelinked for */
+    u64 total_size;     /* bytes of the image behind the entries */
+    u64 ksymtab_hash;   /* of startup.elf, see ksymtab_hash() */
+};
+
+#define PRELINK_FNV_OFFSET  0xcbf29ce484222325ULL
+#define PRELINK_FNV_PRIME   0x100000001b3ULL
+
+struct prelink_entry {
+    char name[MODULE_NAME_LEN];
+    u64 addr;           /* load address of this module */
+    u64 size;           /* layout size, without struct module */
+    u64 syms;           /* _start_mod_ksymtab */
+    u64 num_syms;
+    u64 init;           /* init_module */
+    u64 exit;           /* exit_module */
+    u64 init_level;     /* after promotion for boot modules */
+    u64 jump_entries;   /* __jump_table */
+    u64 num_jump_entries;
+};
+
+#endif /* _LINUX_PRELINK_H */
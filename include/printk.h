@@ -5,7 +5,9 @@
 
 #include <acgcc.h>
 #include <types.h>
+#include <config.h>
 #include <console.h>
+#include <jump_label.h>
 
 #define _CP_RESET   "\033[0m"
 #define _CP_RED     "\033[31;1m"
@@ -19,16 +21,93 @@
 #define _YELLOW(text)   _COLORED(text, _CP_YELLOW)
 #define _BLUE(text)     _COLORED(text, _CP_BLUE)
 
-#ifdef X_DEBUG
-#define pr_debug printk
-#else
-#define pr_debug(msg, ...)
-#endif
+/*
+ * A message may start with one of these to give its log level, the
+ * default is LOGLEVEL_WARNING. Levels above CONFIG_PRINTK_LEVEL are
+ * compiled out of the pr_*() helpers, the console only shows those
+ * below console_loglevel ("loglevel=" on the command line).
+ */
+#define KERN_SOH        "\001"
+#define KERN_SOH_ASCII  '\001'
+
+#define KERN_EMERG      KERN_SOH "0"    /* system is unusable */
+#define KERN_ALERT      KERN_SOH "1"    /* action must be taken immediately */
+#define KERN_CRIT       KERN_SOH "2"    /* critical conditions */
+#define KERN_ERR        KERN_SOH "3"    /* error conditions */
+#define KERN_WARNING    KERN_SOH "4"    /* warning conditions */
+#define KERN_NOTICE     KERN_SOH "5"    /* normal but significant condition */
+#define KERN_INFO       KERN_SOH "6"    /* informational */
+#define KERN_DEBUG      KERN_SOH "7"    /* debug-level messages */
+
+#define LOGLEVEL_EMERG      0
+#define LOGLEVEL_ALERT      1
+#define LOGLEVEL_CRIT       2
+#define LOGLEVEL_ERR        3
+#define LOGLEVEL_WARNING    4
+#define LOGLEVEL_NOTICE     5
+#define LOGLEVEL_INFO       6
+#define LOGLEVEL_DEBUG      7
+
+#define MESSAGE_LOGLEVEL_DEFAULT    LOGLEVEL_WARNING
+#define CONSOLE_LOGLEVEL_DEFAULT    7
+#define CONSOLE_LOGLEVEL_DEBUG      10  /* everything */
+
+extern int console_loglevel;
 
 int vsnprintf(char *buf, size_t size, const char *fmt, va_list args);
 
 void printk(const char *fmt, ...);
 
+void console_flush(void);
+
+void printk_tick(void);
+
+/* Bytes from the next log record up to the end of the log buffer */
+u32 printk_log_room(void);
+
+/* The compiler drops it when @level is above CONFIG_PRINTK_LEVEL */
+#define printk_level(level, fmt, ...)           \
+do {                                            \
+    if ((level) <= CONFIG_PRINTK_LEVEL)         \
+        printk(fmt, ##__VA_ARGS__);             \
+} while (0)
+
+#define pr_emerg(fmt, ...) \
+    printk_level(LOGLEVEL_EMERG, KERN_EMERG fmt, ##__VA_ARGS__)
+#define pr_alert(fmt, ...) \
+    printk_level(LOGLEVEL_ALERT, KERN_ALERT fmt, ##__VA_ARGS__)
+#define pr_crit(fmt, ...) \
+    printk_level(LOGLEVEL_CRIT, KERN_CRIT fmt, ##__VA_ARGS__)
+#define pr_err(fmt, ...) \
+    printk_level(LOGLEVEL_ERR, KERN_ERR fmt, ##__VA_ARGS__)
+#define pr_warn(fmt, ...) \
+    printk_level(LOGLEVEL_WARNING, KERN_WARNING fmt, ##__VA_ARGS__)
+#define pr_notice(fmt, ...) \
+    printk_level(LOGLEVEL_NOTICE, KERN_NOTICE fmt, ##__VA_ARGS__)
+#define pr_info(fmt, ...) \
+    printk_level(LOGLEVEL_INFO, KERN_INFO fmt, ##__VA_ARGS__)
+
+/*
+ * Debug messages sit behind a static key which "debug" on the command
+ * line enables, until then each costs a nop. X_DEBUG prints them all
+ * from the start, as before.
+ */
+DECLARE_STATIC_KEY_FALSE(printk_debug_key);
+
+#if defined(X_DEBUG)
+#define pr_debug(fmt, ...) \
+    printk(KERN_DEBUG fmt, ##__VA_ARGS__)
+#elif LOGLEVEL_DEBUG <= CONFIG_PRINTK_LEVEL
+#define pr_debug(fmt, ...)                          \
+do {                                                \
+    if (static_branch_unlikely(&printk_debug_key))  \
+        printk(KERN_DEBUG fmt, ##__VA_ARGS__);      \
+} while (0)
+#else
+#define pr_debug(fmt, ...) \
+    printk_level(LOGLEVEL_DEBUG, KERN_DEBUG fmt, ##__VA_ARGS__)
+#endif
+
 struct console_cmdline
 {
     char    name[16];       /* Name of the driver       */
@@ -38,6 +117,8 @@ struct console_cmdline
 };
 
 int console_setup(char *param, char *value);
+int loglevel_setup(char *param, char *value);
+int debug_setup(char *param, char *value);
 
 void register_console(struct console *newcon);
 
@@ -18,6 +18,11 @@
     ((struct pt_regs *)(task_stack_page(tsk) + THREAD_SIZE \
                         - ALIGN(sizeof(struct pt_regs), STACK_ALIGN)))
 
+static inline void wait_for_interrupt(void)
+{
+    __asm__ __volatile__ ("wfi");
+}
+
 #endif /* __ASSEMBLY__ */
 
 #endif /* _ASM_RISCV_PROCESSOR_H */
@@ -0,0 +1,32 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef _LINUX_PROFILE_H
+#define _LINUX_PROFILE_H
+
+#include <types.h>
+#include <ptrace.h>
+
+/*
+ * Sampling profiler, off unless "profile=<hz>[,<shift>]" is on the
+ * command line. The timer interrupt, shared with the tick, counts
+ * the sepc it interrupted <hz> times a second in a histogram over
+ * the kernel image, startup and the modules behind it, one bucket
+ * per 1 << shift bytes. Samples from
+ * user mode and from outside the image, e.g. the init text of the
+ * modules, are only counted.
+ *
+ * profile_dump() writes the histogram and the load map of the modules
+ * to the console for scripts/profile to symbolize, at boot and again
+ * on reboot(POWER_OFF).
+ */
+
+int profile_setup(char *param, char *value);
+
+int profile_init(void);
+
+void profile_tick(struct pt_regs *regs);
+
+u64 profile_next_event(void);
+
+void profile_dump(void);
+
+#endif /* _LINUX_PROFILE_H */
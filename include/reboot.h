@@ -0,0 +1,27 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef _LINUX_REBOOT_H
+#define _LINUX_REBOOT_H
+
+#include <compiler_attributes.h>
+
+/*
+ * Magic values required to use reboot(), as in the uapi of Linux.
+ * Only LINUX_REBOOT_CMD_POWER_OFF is implemented, see sys/sys.c.
+ */
+#define LINUX_REBOOT_MAGIC1     0xfee1dead
+#define LINUX_REBOOT_MAGIC2     672274793
+#define LINUX_REBOOT_MAGIC2A    85072278
+#define LINUX_REBOOT_MAGIC2B    369367448
+#define LINUX_REBOOT_MAGIC2C    537993216
+
+#define LINUX_REBOOT_CMD_RESTART    0x01234567
+#define LINUX_REBOOT_CMD_HALT       0xCDEF0123
+#define LINUX_REBOOT_CMD_POWER_OFF  0x4321FEDC
+
+/*
+ * Writes the trace, profile and lock statistics of the whole run to
+ * the console, like deferred_init() does at boot, then powers off.
+ */
+void __noreturn kernel_power_off(void);
+
+#endif /* _LINUX_REBOOT_H */
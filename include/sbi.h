@@ -10,6 +10,20 @@ void sbi_putchar(int ch);
 
 void sbi_puts(const char *s);
 
+void sbi_console_write(const char *s, unsigned long len);
+
+void sbi_set_timer(u64 stime_value);
+
+void sbi_send_ipi(unsigned long hart_mask, unsigned long hart_mask_base);
+
+void sbi_remote_fence_i(unsigned long hart_mask,
+                        unsigned long hart_mask_base);
+
+int sbi_hart_start(unsigned long hartid, unsigned long saddr,
+                   unsigned long priv);
+
+void sbi_shutdown(void);
+
 static __always_inline void
 early_puts(unsigned long val)
 {
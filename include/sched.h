@@ -3,6 +3,9 @@
 #define _LINUX_SCHED_H
 
 #include <fs.h>
+#include <smp.h>
+#include <bits.h>
+#include <barrier.h>
 #include <thread_info.h>
 
 #define MAX_NICE    19
@@ -13,6 +16,7 @@
 #define MAX_RT_PRIO MAX_USER_RT_PRIO
 
 #define MAX_PRIO    (MAX_RT_PRIO + NICE_WIDTH)
+#define DEFAULT_PRIO    (MAX_RT_PRIO + NICE_WIDTH / 2)
 
 /*
  * cloning flags:
@@ -27,20 +31,25 @@
 #define TASK_RUNNING            0x0000
 #define TASK_INTERRUPTIBLE      0x0001
 #define TASK_UNINTERRUPTIBLE    0x0002
+#define TASK_DEAD               0x0080
 
 #define TASK_NEW    0x0800
 
 #define PF_IDLE     0x00000002  /* I am an IDLE thread */
 #define PF_KTHREAD  0x00200000  /* I am a kernel thread */
 
-#define cpu_rq()    (&runqueue)
-#define task_rq(p)  cpu_rq()
+#define cpu_rq(cpu)     (&runqueues[(cpu)])
+#define this_rq()       cpu_rq(smp_processor_id())
+#define task_rq(p)      cpu_rq(task_cpu(p))
+#define cpu_of(rq)      ((rq)->cpu)
 
 #define TASK_ON_RQ_QUEUED   1
 
 #define ENQUEUE_WAKEUP      0x01
 #define ENQUEUE_NOCLOCK     0x08
 
+#define DEQUEUE_SLEEP       0x01
+
 #define SCHED_FIXEDPOINT_SHIFT  10
 #define SCHED_FIXEDPOINT_SCALE  (1L << SCHED_FIXEDPOINT_SHIFT)
 
@@ -80,8 +89,18 @@ struct thread_struct {
     struct __riscv_d_ext_state fstate;
 };
 
+struct load_weight {
+    unsigned long   weight;
+    u32             inv_weight;
+};
+
 /* CFS-related fields in a runqueue */
 struct cfs_rq {
+    struct load_weight load;
+    unsigned int nr_running;
+
+    u64 min_vruntime;
+
     struct rb_root_cached tasks_timeline;
 
     /*
@@ -94,7 +113,12 @@ struct cfs_rq {
     struct task_group *tg;  /* group that "owns" this runqueue */
 };
 
+/* Under the kernel lock, like all of the scheduler, see startup/smp.c */
 struct rq {
+    int             cpu;
+    unsigned int    nr_running;
+    u64             clock;      /* sched_clock() of the last update */
+
     struct cfs_rq   cfs;
 
     struct task_struct *curr;
@@ -103,9 +127,23 @@ struct rq {
 
 struct sched_class {
     void (*enqueue_task)(struct rq *rq, struct task_struct *p, int flags);
+    void (*dequeue_task)(struct rq *rq, struct task_struct *p, int flags);
+
+    void (*check_preempt_curr)(struct rq *rq, struct task_struct *p, int flags);
+
+    void (*put_prev_task)(struct rq *rq, struct task_struct *p);
+
+    void (*task_tick)(struct rq *rq, struct task_struct *p, int queued);
+    void (*task_fork)(struct task_struct *p);
+
+    /* The CPU for a new or waking task, which is off the runqueues */
+    int (*select_task_rq)(struct task_struct *p, int prev_cpu);
+    void (*migrate_task_rq)(struct task_struct *p, int new_cpu);
 };
 
 struct sched_entity {
+    /* For load-balancing: */
+    struct load_weight load;
     struct rb_node run_node;
     struct list_head group_node;
     struct sched_entity *parent;
@@ -115,7 +153,11 @@ struct sched_entity {
     struct cfs_rq *my_q;
 
     unsigned int on_rq;
+
+    u64 exec_start;
+    u64 sum_exec_runtime;
     u64 vruntime;
+    u64 prev_sum_exec_runtime;
 };
 
 struct task_struct {
@@ -150,6 +192,7 @@ struct task_struct {
     struct sched_entity se;
 
     int prio;
+    int static_prio;
     int normal_prio;
 
     int on_rq;
@@ -167,11 +210,41 @@ struct task_group {
     unsigned long       shares;
 };
 
-static struct rq runqueue;
+extern struct rq runqueues[NR_CPUS];
 
 typedef void (*schedule_tail_t)(struct task_struct *);
 extern schedule_tail_t schedule_tail_func;
 
+/* Hooks of startup/ into the sched module, see startup/init.c */
+typedef void (*scheduler_tick_t)(void);
+extern scheduler_tick_t scheduler_tick_func;
+
+void scheduler_tick(void);
+
+typedef void (*schedule_user_t)(void);
+extern schedule_user_t schedule_user_func;
+
+void schedule_user(void);
+
+/* The waiters of wait queues load before sched, see lib/wait.c */
+typedef void (*schedule_t)(void);
+extern schedule_t schedule_func;
+
+typedef int (*try_to_wake_up_t)(struct task_struct *, unsigned int, int);
+extern try_to_wake_up_t try_to_wake_up_func;
+
+int try_to_wake_up(struct task_struct *p, unsigned int state, int wake_flags);
+int wake_up_process(struct task_struct *p);
+
+void schedule(void);
+
+void __noreturn do_task_dead(void);
+
+/* The idle loop of each CPU, see sched/idle.c */
+void cpu_startup_entry(void);
+
+void init_idle(struct task_struct *idle, int cpu);
+
 void wake_up_new_task(struct task_struct *p);
 
 int sched_fork(unsigned long clone_flags, struct task_struct *p);
@@ -194,10 +267,16 @@ static inline void set_task_rq(struct task_struct *p, unsigned int cpu)
     p->se.parent = tg->se[cpu];
 }
 
+static inline unsigned int task_cpu(const struct task_struct *p)
+{
+    return p->thread_info.cpu;
+}
+
 static inline void
 __set_task_cpu(struct task_struct *p, unsigned int cpu)
 {
     set_task_rq(p, cpu);
+    p->thread_info.cpu = cpu;
 }
 
 void init_tg_cfs_entry(struct task_group *tg, struct cfs_rq *cfs_rq,
@@ -206,10 +285,38 @@ void init_tg_cfs_entry(struct task_group *tg, struct cfs_rq *cfs_rq,
 
 void schedule_preempt_disabled(void);
 
-struct task_struct *
-pick_next_task_fair(struct rq *rq, struct task_struct *prev);
+struct task_struct *pick_next_task_fair(struct rq *rq);
 
 /* An entity is a task if it doesn't "own" a runqueue */
 #define entity_is_task(se)  (!se->my_q)
 
+/*
+ * TIF_NEED_RESCHED asks the task to call schedule() at the next
+ * return to user mode. The tick sets it, schedule() clears it.
+ */
+static inline void set_tsk_need_resched(struct task_struct *tsk)
+{
+    set_bit(TIF_NEED_RESCHED, &tsk->thread_info.flags);
+}
+
+static inline void clear_tsk_need_resched(struct task_struct *tsk)
+{
+    clear_bit(TIF_NEED_RESCHED, &tsk->thread_info.flags);
+}
+
+static inline int test_tsk_need_resched(struct task_struct *tsk)
+{
+    return unlikely(test_bit(TIF_NEED_RESCHED, &tsk->thread_info.flags));
+}
+
+/* Macros, current.h includes this header */
+#define need_resched()  test_tsk_need_resched(current)
+
+#define __set_current_state(state_value)    \
+    do { current->state = (state_value); } while (0)
+
+/* Ordered before the test of the condition waited for */
+#define set_current_state(state_value)      \
+    do { WRITE_ONCE(current->state, (state_value)); smp_mb(); } while (0)
+
 #endif /* _LINUX_SCHED_H */
@@ -0,0 +1,60 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+#ifndef __LINUX_SEQLOCK_H
+#define __LINUX_SEQLOCK_H
+
+/*
+ * Sequence counters: a lockless reader retries when the writer bumped
+ * the count under it. The count is odd while a write is in progress.
+ * Writers serialize among themselves, here by running with irqs off.
+ *
+ * Only plain loads, stores and fences, so the vDSO can read one from
+ * user mode as well.
+ */
+
+#include <types.h>
+#include <atomic.h>
+#include <barrier.h>
+
+typedef struct seqcount {
+    unsigned sequence;
+} seqcount_t;
+
+#define SEQCNT_ZERO(name)   { .sequence = 0 }
+
+static inline void seqcount_init(seqcount_t *s)
+{
+    s->sequence = 0;
+}
+
+/* Wait out a writer, then return the count to check against */
+static inline unsigned raw_read_seqcount_begin(const seqcount_t *s)
+{
+    unsigned ret;
+
+    while ((ret = READ_ONCE(s->sequence)) & 1)
+        barrier();
+    smp_rmb();
+    return ret;
+}
+
+#define read_seqcount_begin(s)  raw_read_seqcount_begin(s)
+
+static inline int read_seqcount_retry(const seqcount_t *s, unsigned start)
+{
+    smp_rmb();
+    return unlikely(READ_ONCE(s->sequence) != start);
+}
+
+static inline void write_seqcount_begin(seqcount_t *s)
+{
+    WRITE_ONCE(s->sequence, s->sequence + 1);
+    smp_wmb();
+}
+
+static inline void write_seqcount_end(seqcount_t *s)
+{
+    smp_wmb();
+    WRITE_ONCE(s->sequence, s->sequence + 1);
+}
+
+#endif /* __LINUX_SEQLOCK_H */
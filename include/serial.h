@@ -9,7 +9,19 @@
 
 #define UART_TX         0       /* Out: Transmit buffer */
 
+#define UART_IER        1       /* Out: Interrupt Enable Register */
+#define UART_IER_THRI   0x02    /* Enable Transmitter holding register int. */
+
+#define UART_IIR        2       /* In:  Interrupt ID Register */
+#define UART_IIR_NO_INT 0x01    /* No interrupts pending */
+
+#define UART_FCR        2       /* Out: FIFO Control Register */
+#define UART_FCR_ENABLE_FIFO    0x01 /* Enable the FIFO */
+#define UART_FCR_CLEAR_RCVR     0x02 /* Clear the RCVR FIFO */
+#define UART_FCR_CLEAR_XMIT     0x04 /* Clear the XMIT FIFO */
+
 #define UART_LSR        5       /* In:  Line Status Register */
+#define UART_LSR_TEMT   0x40    /* Transmitter empty */
 #define UART_LSR_THRE   0x20    /* Transmit-hold-register empty */
 
 #define UART_LSR_BRK_ERROR_BITS 0x1E /* BI, FE, PE, OE bits */
@@ -51,6 +63,7 @@ struct serial8250_config {
 };
 
 struct uart_ops {
+    void (*stop_tx)(struct uart_port *);
     void (*start_tx)(struct uart_port *);
     int (*startup)(struct uart_port *);
     void (*config_port)(struct uart_port *, int);
@@ -133,6 +146,7 @@ struct uart_port {
 struct uart_8250_port {
     struct uart_port    port;
     unsigned int        tx_loadsz;  /* transmit fifo load size */
+    unsigned char       ier;
     unsigned char       cur_iotype; /* Running I/O type */
 #define LSR_SAVE_FLAGS UART_LSR_BRK_ERROR_BITS
     unsigned char       lsr_saved_flags;
@@ -159,6 +173,9 @@ enum {
 int serial8250_console_setup(struct uart_port *port,
                              char *options, bool probe);
 
+void serial8250_console_write(struct uart_8250_port *up,
+                              const char *s, unsigned int count);
+
 int uart_set_options(struct uart_port *port, struct console *co,
                      int baud, int parity, int bits, int flow);
 
@@ -172,6 +189,14 @@ static inline struct uart_8250_port *up_to_u8250p(struct uart_port *up)
 #define uart_circ_empty(circ)   ((circ)->head == (circ)->tail)
 #define uart_circ_clear(circ)   ((circ)->head = (circ)->tail = 0)
 
+#define uart_circ_chars_pending(circ)   \
+    (CIRC_CNT((circ)->head, (circ)->tail, UART_XMIT_SIZE))
+
+/* Writers blocked on a full xmit ring are woken below this many chars */
+#define WAKEUP_CHARS    256
+
+void uart_write_wakeup(struct uart_port *port);
+
 static inline int uart_tx_stopped(struct uart_port *port)
 {
     return 0;
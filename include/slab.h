@@ -9,6 +9,7 @@
 #include <page.h>
 #include <mmzone.h>
 #include <kernel.h>
+#include <spinlock.h>
 #include <compiler_attributes.h>
 
 /* Panic if kmem_cache_create() fails */
@@ -97,6 +98,8 @@ enum slab_state {
 };
 
 struct kmem_cache_node {
+    spinlock_t list_lock;           /* of the lists and the counts below */
+
     struct list_head slabs_partial; /* partial list first, better asm code */
     struct list_head slabs_full;
     struct list_head slabs_free;
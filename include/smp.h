@@ -0,0 +1,68 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef _ASM_RISCV_SMP_H
+#define _ASM_RISCV_SMP_H
+
+/* Offsets in struct sbi_hart_boot_data, for secondary_start_sbi */
+#define SBI_HART_BOOT_TASK_PTR_OFFSET   0x00
+#define SBI_HART_BOOT_STACK_PTR_OFFSET  0x08
+
+#ifndef __ASSEMBLY__
+
+#include <types.h>
+#include <cpumask.h>
+#include <thread_info.h>
+
+struct pt_regs;
+
+#define INVALID_HARTID  (~0UL)
+
+/* Handed by SBI HSM to a starting hart in a1, by physical address */
+struct sbi_hart_boot_data {
+    void *task_ptr;     /* its idle task, for tp */
+    void *stack_ptr;    /* the top of the stack of that task */
+};
+
+/* Hart of the boot CPU, saved by _start_kernel in core.S */
+extern unsigned long boot_cpu_hartid;
+
+/* Hart ID of each CPU, the boot hart is CPU 0 */
+extern unsigned long __cpuid_to_hartid_map[NR_CPUS];
+#define cpuid_to_hartid_map(cpu)    __cpuid_to_hartid_map[cpu]
+
+int riscv_hartid_to_cpuid(unsigned long hartid);
+
+/* Macros, thread_info.h and sched.h include each other through current.h */
+#define raw_smp_processor_id()  (current_thread_info()->cpu)
+#define smp_processor_id()      raw_smp_processor_id()
+
+/*
+ * The kernel lock, see startup/smp.c. Taken on every entry into the
+ * kernel, nested ones included, and by the idle loop for the kernel
+ * state it looks at.
+ */
+void lock_kernel(void);
+void unlock_kernel(void);
+bool kernel_locked(void);
+
+/* Hold it across the switch of __schedule(), with interrupts off */
+unsigned int sched_lock_kernel(void);
+void sched_unlock_kernel(unsigned int depth);
+
+/* Have the CPU call schedule(), its current task is flagged already */
+void smp_send_reschedule(int cpu);
+
+/* fence.i on all online CPUs, after writing kernel text */
+void flush_icache_all(void);
+
+/* The software interrupt of the IPIs, from the intc */
+void handle_IPI(struct pt_regs *regs);
+
+/* Secondary harts come here on their idle task, see core.S */
+void smp_callin(void);
+
+typedef void (*smp_callin_t)(void);
+extern smp_callin_t smp_callin_func;
+
+#endif /* !__ASSEMBLY__ */
+
+#endif /* _ASM_RISCV_SMP_H */
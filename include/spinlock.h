@@ -0,0 +1,206 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+#ifndef __LINUX_SPINLOCK_H
+#define __LINUX_SPINLOCK_H
+
+/*
+ * Spinlocks and reader/writer locks, see asm-spinlock.h.
+ *
+ * The kernel is only preempted on the return to user mode, so there
+ * is no preempt count to raise: a holder must not sleep, and a lock
+ * which is also taken by an interrupt handler must be taken with the
+ * _irq or _irqsave variants everywhere else.
+ *
+ * With CONFIG_LOCK_STAT the do_raw_*() are out of line in
+ * startup/lockstat.c, which counts for the class of the lock.
+ */
+
+#include <types.h>
+#include <irqflags.h>
+#include <lockstat.h>
+#include <spinlock_types.h>
+#include <asm-spinlock.h>
+
+#ifdef CONFIG_LOCK_STAT
+
+void __spin_lock_init(spinlock_t *lock, struct lock_class *class);
+void __rwlock_init(rwlock_t *lock, struct lock_class *class);
+
+/* A class per call site, the name is that of the lock there */
+#define spin_lock_init(_lock)                               \
+do {                                                        \
+    static struct lock_class __class = { .name = #_lock };  \
+    __spin_lock_init((_lock), &__class);                    \
+} while (0)
+
+#define rwlock_init(_lock)                                  \
+do {                                                        \
+    static struct lock_class __class = { .name = #_lock };  \
+    __rwlock_init((_lock), &__class);                       \
+} while (0)
+
+void do_raw_spin_lock(spinlock_t *lock);
+int do_raw_spin_trylock(spinlock_t *lock);
+void do_raw_spin_unlock(spinlock_t *lock);
+
+void do_raw_read_lock(rwlock_t *lock);
+int do_raw_read_trylock(rwlock_t *lock);
+void do_raw_read_unlock(rwlock_t *lock);
+
+void do_raw_write_lock(rwlock_t *lock);
+int do_raw_write_trylock(rwlock_t *lock);
+void do_raw_write_unlock(rwlock_t *lock);
+
+#else
+
+#define spin_lock_init(_lock)   \
+    do { *(_lock) = __SPIN_LOCK_UNLOCKED(_lock); } while (0)
+
+#define rwlock_init(_lock)      \
+    do { *(_lock) = __RW_LOCK_UNLOCKED(_lock); } while (0)
+
+static inline void do_raw_spin_lock(spinlock_t *lock)
+{
+    arch_spin_lock(&lock->raw_lock);
+}
+
+static inline int do_raw_spin_trylock(spinlock_t *lock)
+{
+    return arch_spin_trylock(&lock->raw_lock);
+}
+
+static inline void do_raw_spin_unlock(spinlock_t *lock)
+{
+    arch_spin_unlock(&lock->raw_lock);
+}
+
+static inline void do_raw_read_lock(rwlock_t *lock)
+{
+    arch_read_lock(&lock->raw_lock);
+}
+
+static inline int do_raw_read_trylock(rwlock_t *lock)
+{
+    return arch_read_trylock(&lock->raw_lock);
+}
+
+static inline void do_raw_read_unlock(rwlock_t *lock)
+{
+    arch_read_unlock(&lock->raw_lock);
+}
+
+static inline void do_raw_write_lock(rwlock_t *lock)
+{
+    arch_write_lock(&lock->raw_lock);
+}
+
+static inline int do_raw_write_trylock(rwlock_t *lock)
+{
+    return arch_write_trylock(&lock->raw_lock);
+}
+
+static inline void do_raw_write_unlock(rwlock_t *lock)
+{
+    arch_write_unlock(&lock->raw_lock);
+}
+
+#endif /* CONFIG_LOCK_STAT */
+
+static inline void spin_lock(spinlock_t *lock)
+{
+    do_raw_spin_lock(lock);
+}
+
+static inline int spin_trylock(spinlock_t *lock)
+{
+    return do_raw_spin_trylock(lock);
+}
+
+static inline void spin_unlock(spinlock_t *lock)
+{
+    do_raw_spin_unlock(lock);
+}
+
+static inline int spin_is_locked(spinlock_t *lock)
+{
+    return arch_spin_is_locked(&lock->raw_lock);
+}
+
+static inline void spin_lock_irq(spinlock_t *lock)
+{
+    local_irq_disable();
+    do_raw_spin_lock(lock);
+}
+
+static inline void spin_unlock_irq(spinlock_t *lock)
+{
+    do_raw_spin_unlock(lock);
+    local_irq_enable();
+}
+
+#define spin_lock_irqsave(lock, flags)      \
+do {                                        \
+    local_irq_save(flags);                  \
+    do_raw_spin_lock(lock);                 \
+} while (0)
+
+#define spin_unlock_irqrestore(lock, flags) \
+do {                                        \
+    do_raw_spin_unlock(lock);               \
+    local_irq_restore(flags);               \
+} while (0)
+
+static inline void read_lock(rwlock_t *lock)
+{
+    do_raw_read_lock(lock);
+}
+
+static inline int read_trylock(rwlock_t *lock)
+{
+    return do_raw_read_trylock(lock);
+}
+
+static inline void read_unlock(rwlock_t *lock)
+{
+    do_raw_read_unlock(lock);
+}
+
+static inline void write_lock(rwlock_t *lock)
+{
+    do_raw_write_lock(lock);
+}
+
+static inline int write_trylock(rwlock_t *lock)
+{
+    return do_raw_write_trylock(lock);
+}
+
+static inline void write_unlock(rwlock_t *lock)
+{
+    do_raw_write_unlock(lock);
+}
+
+#define read_lock_irqsave(lock, flags)      \
+do {                                        \
+    local_irq_save(flags);                  \
+    do_raw_read_lock(lock);                 \
+} while (0)
+
+#define read_unlock_irqrestore(lock, flags) \
+do {                                        \
+    do_raw_read_unlock(lock);               \
+    local_irq_restore(flags);               \
+} while (0)
+
+#define write_lock_irqsave(lock, flags)     \
+do {                                        \
+    local_irq_save(flags);                  \
+    do_raw_write_lock(lock);                \
+} while (0)
+
+#define write_unlock_irqrestore(lock, flags) \
+do {                                        \
+    do_raw_write_unlock(lock);              \
+    local_irq_restore(flags);               \
+} while (0)
+
+#endif /* __LINUX_SPINLOCK_H */
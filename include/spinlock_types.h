@@ -0,0 +1,83 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+#ifndef __LINUX_SPINLOCK_TYPES_H
+#define __LINUX_SPINLOCK_TYPES_H
+
+#include <types.h>
+
+/*
+ * Ticket lock. A CPU takes the next ticket and spins until the owner
+ * is its ticket, so the lock is handed on in the order it was asked
+ * for. Both halves wrap, only their equality is ever looked at.
+ */
+typedef struct {
+    union {
+        u32 val;
+        struct {
+            u16 owner;      /* low half, bumped by the unlock */
+            u16 next;       /* high half, bumped by each lock */
+        } tickets;
+    };
+} arch_spinlock_t;
+
+#define __ARCH_SPIN_LOCK_UNLOCKED   { { 0 } }
+
+/* Number of readers in, or -1 for a writer */
+typedef struct {
+    volatile int lock;
+} arch_rwlock_t;
+
+#define __ARCH_RW_LOCK_UNLOCKED     { 0 }
+
+#ifdef CONFIG_LOCK_STAT
+
+struct lock_class;
+
+/* The class is counted in, the time is of the last acquisition */
+#define LOCK_STAT_MAP           \
+    struct lock_class *class;   \
+    u64 acquired;
+
+/* A class of its own for a lock defined at file scope */
+#define __LOCK_STAT_INIT(lockname)                          \
+    .class = &(struct lock_class){ .name = #lockname },
+
+#else
+
+#define LOCK_STAT_MAP
+#define __LOCK_STAT_INIT(lockname)
+
+#endif /* CONFIG_LOCK_STAT */
+
+typedef struct spinlock {
+    arch_spinlock_t raw_lock;
+    LOCK_STAT_MAP
+} spinlock_t;
+
+#define __SPIN_LOCK_INITIALIZER(lockname)       \
+    {                                           \
+        .raw_lock = __ARCH_SPIN_LOCK_UNLOCKED,  \
+        __LOCK_STAT_INIT(lockname)              \
+    }
+
+#define __SPIN_LOCK_UNLOCKED(lockname) \
+    (spinlock_t) __SPIN_LOCK_INITIALIZER(lockname)
+
+#define DEFINE_SPINLOCK(x)  spinlock_t x = __SPIN_LOCK_INITIALIZER(x)
+
+typedef struct {
+    arch_rwlock_t raw_lock;
+    LOCK_STAT_MAP
+} rwlock_t;
+
+#define __RW_LOCK_INITIALIZER(lockname)         \
+    {                                           \
+        .raw_lock = __ARCH_RW_LOCK_UNLOCKED,    \
+        __LOCK_STAT_INIT(lockname)              \
+    }
+
+#define __RW_LOCK_UNLOCKED(lockname) \
+    (rwlock_t) __RW_LOCK_INITIALIZER(lockname)
+
+#define DEFINE_RWLOCK(x)    rwlock_t x = __RW_LOCK_INITIALIZER(x)
+
+#endif /* __LINUX_SPINLOCK_TYPES_H */
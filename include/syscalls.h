@@ -4,6 +4,7 @@
 #define _LINUX_SYSCALLS_H
 
 #include <types.h>
+#include <time.h>
 #include <utsname.h>
 
 /* Are two types/vars the same type (ignoring qualifiers)? */
@@ -101,4 +102,31 @@ extern ksys_write_t ksys_write;
 
 long sys_write(unsigned int fd, const char *buf, size_t count);
 
+typedef long (*do_sys_clock_gettime_t)(clockid_t which_clock,
+                                       struct __kernel_timespec *tp);
+
+extern do_sys_clock_gettime_t do_sys_clock_gettime;
+
+long sys_clock_gettime(clockid_t which_clock, struct __kernel_timespec *tp);
+
+typedef long (*do_sys_gettimeofday_t)(struct __kernel_old_timeval *tv,
+                                      struct timezone *tz);
+
+extern do_sys_gettimeofday_t do_sys_gettimeofday;
+
+long sys_gettimeofday(struct __kernel_old_timeval *tv, struct timezone *tz);
+
+typedef long (*do_sys_getcpu_t)(unsigned *cpu, unsigned *node, void *cache);
+
+extern do_sys_getcpu_t do_sys_getcpu;
+
+long sys_getcpu(unsigned *cpu, unsigned *node, void *cache);
+
+typedef long (*do_sys_reboot_t)(int magic1, int magic2, unsigned int cmd,
+                                void *arg);
+
+extern do_sys_reboot_t do_sys_reboot;
+
+long sys_reboot(int magic1, int magic2, unsigned int cmd, void *arg);
+
 #endif /* _LINUX_SYSCALLS_H */
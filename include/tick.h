@@ -0,0 +1,37 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef _LINUX_TICK_H
+#define _LINUX_TICK_H
+
+#include <types.h>
+#include <ptrace.h>
+
+/*
+ * Periodic tick of HZ from the supervisor timer, which is programmed
+ * through SBI set_timer. Each tick advances jiffies and runs the
+ * expired timers of the wheel in the TIMER_SOFTIRQ. The profiler
+ * samples from the same interrupt, the timer is set for whichever of
+ * the two comes first.
+ *
+ * The idle loop stops the tick while the CPU waits for an interrupt,
+ * the timer is then set for the next timer of the wheel only. The
+ * wheel and jiffies are of the boot CPU, the others tick for the
+ * scheduler alone and don't set a timer at all while idle.
+ */
+
+/* Called by the interrupt controller driver once it takes interrupts */
+int tick_init(void);
+
+/* On each secondary CPU as it comes online, see smp/smpboot.c */
+void tick_init_secondary(void);
+
+void tick_interrupt(struct pt_regs *regs);
+
+/* From the idle loop of sched/idle.c */
+void tick_nohz_idle_enter(void);
+void tick_nohz_idle_stop_tick(void);
+void tick_nohz_idle_exit(void);
+
+u64 get_cpu_idle_time_us(int cpu, u64 *last_update_time);
+void tick_nohz_dump(void);
+
+#endif /* _LINUX_TICK_H */
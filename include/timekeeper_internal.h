@@ -0,0 +1,25 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+#ifndef _LINUX_TIMEKEEPER_INTERNAL_H
+#define _LINUX_TIMEKEEPER_INTERNAL_H
+
+#include <types.h>
+#include <ktime.h>
+#include <clocksource.h>
+
+/*
+ * The clock of ktime_get() with both conversions precomputed, one
+ * cache line read on every call.
+ */
+struct timekeeper {
+    struct clocksource  *clock;
+    u32                 mult;       /* cycles to ns */
+    u32                 shift;
+    u32                 ns2cyc_mult;
+    u32                 ns2cyc_shift;
+    ktime_t             base;       /* ktime_get() at the last tick */
+};
+
+/* Publish @tk to the vDSO data page, see vdso.h */
+void update_vsyscall(struct timekeeper *tk);
+
+#endif /* _LINUX_TIMEKEEPER_INTERNAL_H */
@@ -0,0 +1,89 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+#ifndef _LINUX_TIMER_H
+#define _LINUX_TIMER_H
+
+#include <list.h>
+#include <types.h>
+#include <jiffies.h>
+
+struct timer_list {
+    /*
+     * All fields that change during normal runtime grouped to the
+     * same cacheline
+     */
+    struct hlist_node   entry;
+    unsigned long       expires;
+    void                (*function)(struct timer_list *);
+    u32                 flags;
+};
+
+/*
+ * The wheel bucket a pending timer sits in is kept in the upper
+ * bits of the flags.
+ */
+#define TIMER_ARRAYSHIFT    22
+#define TIMER_ARRAYMASK     0xFFC00000
+
+#define TIMER_INIT_FLAGS    0
+
+static inline void
+__init_timer(struct timer_list *timer,
+             void (*func)(struct timer_list *),
+             unsigned int flags)
+{
+    timer->entry.pprev = NULL;
+    timer->function = func;
+    timer->flags = flags;
+}
+
+/**
+ * timer_setup - prepare a timer for first use
+ * @timer: the timer in question
+ * @callback: the function to call when timer expires
+ * @flags: any TIMER_* flags
+ *
+ * Regular timer initialization should use timer_setup() in process
+ * context, the callback is called from the TIMER_SOFTIRQ with
+ * interrupts off.
+ */
+#define timer_setup(timer, callback, flags) \
+    __init_timer((timer), (callback), (flags))
+
+#define from_timer(var, callback_timer, timer_fieldname) \
+    container_of(callback_timer, typeof(*var), timer_fieldname)
+
+/**
+ * timer_pending - is a timer pending?
+ * @timer: the timer in question
+ *
+ * timer_pending will tell whether a given timer is currently pending,
+ * or not. Callers must ensure serialization wrt. other operations done
+ * to this timer, eg. interrupt contexts, or other CPUs on SMP.
+ *
+ * return value: 1 if the timer is pending, 0 if not.
+ */
+static inline int timer_pending(const struct timer_list *timer)
+{
+    return !hlist_unhashed(&timer->entry);
+}
+
+void add_timer(struct timer_list *timer);
+
+int mod_timer(struct timer_list *timer, unsigned long expires);
+
+int del_timer(struct timer_list *timer);
+
+/* One CPU and callbacks with interrupts off, nothing to wait for */
+#define del_timer_sync(t)   del_timer(t)
+
+/* Called by the tick, see timer/tick.c */
+void do_timer(unsigned long ticks);
+
+void update_process_times(int user_tick);
+
+/* For the tick to sleep until the next timer when idle */
+#define NEXT_TIMER_MAX_DELTA    ((1UL << 30) - 1)
+
+unsigned long get_next_timer_interrupt(unsigned long basej);
+
+#endif /* _LINUX_TIMER_H */
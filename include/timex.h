@@ -0,0 +1,28 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef _ASM_RISCV_TIMEX_H
+#define _ASM_RISCV_TIMEX_H
+
+#include <csr.h>
+#include <types.h>
+
+typedef unsigned long cycles_t;
+
+/* Frequency of the time CSR, from the device tree */
+extern unsigned long riscv_timebase;
+
+static inline cycles_t get_cycles(void)
+{
+    return csr_read(CSR_CYCLE);
+}
+
+static inline cycles_t get_instret(void)
+{
+    return csr_read(CSR_INSTRET);
+}
+
+static inline u64 get_time(void)
+{
+    return csr_read(CSR_TIME);
+}
+
+#endif /* _ASM_RISCV_TIMEX_H */
@@ -0,0 +1,72 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+/*
+ * Included at the end of each header in trace/events/. The file that
+ * defines CREATE_TRACE_POINTS reads that header a second time here to
+ * get the rings, the struct trace_event and the record functions.
+ * No include guard, it must be read for every header.
+ */
+#ifdef CREATE_TRACE_POINTS
+
+/* Only the header that was included right after it */
+#undef CREATE_TRACE_POINTS
+
+#include <timex.h>
+#include <atomic.h>
+#include <export.h>
+
+#define __TRACE_STRINGIFY_1(x...)   #x
+#define __TRACE_STRINGIFY(x...)     __TRACE_STRINGIFY_1(x)
+#define TRACE_INCLUDE(system)       __TRACE_STRINGIFY(trace/events/system.h)
+
+#define TRACE_HEADER_MULTI_READ
+
+#undef __field
+#define __field(type, item)         #type " " #item ";"
+
+#undef TRACE_EVENT
+#define TRACE_EVENT(call, proto, args, tstruct, assign)             \
+    static struct trace_event_raw_##call                            \
+    trace_ring_##call[TRACE_RING_RECORDS];                          \
+                                                                    \
+    struct trace_event event_##call = {                             \
+        .name = #call,                                              \
+        .format = tstruct,                                          \
+        .record_size = sizeof(struct trace_event_raw_##call),      \
+        .ring = trace_ring_##call,                                  \
+    };                                                              \
+    EXPORT_SYMBOL(event_##call);                                    \
+                                                                    \
+    void __trace_##call(proto)                                      \
+    {                                                               \
+        unsigned long __idx;                                        \
+        struct trace_event_raw_##call *__entry;                     \
+                                                                    \
+        if (READ_ONCE(event_##call.dumping))                        \
+            return;                                                 \
+        __idx = atomic64_fetch_add_relaxed(1, &event_##call.head);  \
+        __entry = trace_ring_##call +                               \
+            (__idx & (TRACE_RING_RECORDS - 1));                     \
+        __entry->ts = get_cycles();                                 \
+        { assign }                                                  \
+    }                                                               \
+    EXPORT_SYMBOL(__trace_##call)
+
+#include TRACE_INCLUDE(TRACE_SYSTEM)
+
+#undef TRACE_HEADER_MULTI_READ
+
+/* Back to declarations for any header read after this one */
+#undef __field
+#define __field(type, item)         type item;
+
+#undef TRACE_EVENT
+#define TRACE_EVENT(name, proto, args, tstruct, assign)             \
+    DECLARE_TRACE_EVENT(name, PARAMS(proto), PARAMS(args),          \
+                        PARAMS(tstruct))
+
+#undef TRACE_INCLUDE
+#undef __TRACE_STRINGIFY
+#undef __TRACE_STRINGIFY_1
+
+#endif /* CREATE_TRACE_POINTS */
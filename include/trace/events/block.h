@@ -0,0 +1,80 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM block
+
+#if !defined(_TRACE_BLOCK_H) || defined(TRACE_HEADER_MULTI_READ)
+#define _TRACE_BLOCK_H
+
+#include <blkdev.h>
+#include <tracepoint.h>
+
+/* A bio handed to the block layer */
+TRACE_EVENT(block_bio_queue,
+
+    TP_PROTO(struct bio *bio),
+
+    TP_ARGS(bio),
+
+    TP_STRUCT__entry(
+        __field(sector_t,       sector)
+        __field(unsigned int,   bytes)
+        __field(unsigned int,   op)
+    ),
+
+    TP_fast_assign(
+        __entry->sector     = bio->bi_iter.bi_sector;
+        __entry->bytes      = bio->bi_iter.bi_size;
+        __entry->op         = bio_op(bio);
+    )
+);
+
+/*
+ * Requests are identified by their address, which matches an issue
+ * with its completion.
+ */
+TRACE_EVENT(block_rq_issue,
+
+    TP_PROTO(struct request *rq),
+
+    TP_ARGS(rq),
+
+    TP_STRUCT__entry(
+        __field(unsigned long,  rq)
+        __field(sector_t,       sector)
+        __field(unsigned int,   bytes)
+        __field(unsigned int,   op)
+    ),
+
+    TP_fast_assign(
+        __entry->rq         = (unsigned long)rq;
+        __entry->sector     = blk_rq_pos(rq);
+        __entry->bytes      = blk_rq_bytes(rq);
+        __entry->op         = req_op(rq);
+    )
+);
+
+TRACE_EVENT(block_rq_complete,
+
+    TP_PROTO(struct request *rq),
+
+    TP_ARGS(rq),
+
+    TP_STRUCT__entry(
+        __field(unsigned long,  rq)
+        __field(sector_t,       sector)
+        __field(unsigned int,   bytes)
+        __field(unsigned int,   op)
+    ),
+
+    TP_fast_assign(
+        __entry->rq         = (unsigned long)rq;
+        __entry->sector     = blk_rq_pos(rq);
+        __entry->bytes      = blk_rq_bytes(rq);
+        __entry->op         = req_op(rq);
+    )
+);
+
+#endif /* _TRACE_BLOCK_H */
+
+/* This part must be outside protection */
+#include <trace/define_trace.h>
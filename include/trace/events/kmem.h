@@ -0,0 +1,34 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM kmem
+
+#if !defined(_TRACE_KMEM_H) || defined(TRACE_HEADER_MULTI_READ)
+#define _TRACE_KMEM_H
+
+#include <slab.h>
+#include <tracepoint.h>
+
+/* The per-cpu array of a cache ran empty */
+TRACE_EVENT(kmem_cache_refill,
+
+    TP_PROTO(struct kmem_cache *cachep, unsigned int batchcount),
+
+    TP_ARGS(cachep, batchcount),
+
+    TP_STRUCT__entry(
+        __field(unsigned long,  free_objects)
+        __field(unsigned int,   size)
+        __field(unsigned int,   batchcount)
+    ),
+
+    TP_fast_assign(
+        __entry->free_objects = cachep->node->free_objects;
+        __entry->size       = cachep->size;
+        __entry->batchcount = batchcount;
+    )
+);
+
+#endif /* _TRACE_KMEM_H */
+
+/* This part must be outside protection */
+#include <trace/define_trace.h>
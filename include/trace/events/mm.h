@@ -0,0 +1,35 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM mm
+
+#if !defined(_TRACE_MM_H) || defined(TRACE_HEADER_MULTI_READ)
+#define _TRACE_MM_H
+
+#include <mm.h>
+#include <tracepoint.h>
+
+TRACE_EVENT(mm_pte_fault,
+
+    TP_PROTO(struct vm_fault *vmf),
+
+    TP_ARGS(vmf),
+
+    TP_STRUCT__entry(
+        __field(unsigned long,  address)
+        __field(unsigned long,  pgoff)
+        __field(unsigned int,   flags)
+        __field(int,            anon)
+    ),
+
+    TP_fast_assign(
+        __entry->address    = vmf->address;
+        __entry->pgoff      = vmf->pgoff;
+        __entry->flags      = vmf->flags;
+        __entry->anon       = vma_is_anonymous(vmf->vma);
+    )
+);
+
+#endif /* _TRACE_MM_H */
+
+/* This part must be outside protection */
+#include <trace/define_trace.h>
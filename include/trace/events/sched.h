@@ -0,0 +1,36 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM sched
+
+#if !defined(_TRACE_SCHED_H) || defined(TRACE_HEADER_MULTI_READ)
+#define _TRACE_SCHED_H
+
+#include <sched.h>
+#include <tracepoint.h>
+
+/* Tasks are identified by the address of their task_struct */
+TRACE_EVENT(sched_switch,
+
+    TP_PROTO(struct task_struct *prev, struct task_struct *next),
+
+    TP_ARGS(prev, next),
+
+    TP_STRUCT__entry(
+        __field(unsigned long,  prev)
+        __field(unsigned long,  next)
+        __field(long,           prev_state)
+        __field(int,            next_prio)
+    ),
+
+    TP_fast_assign(
+        __entry->prev       = (unsigned long)prev;
+        __entry->next       = (unsigned long)next;
+        __entry->prev_state = prev->state;
+        __entry->next_prio  = next->prio;
+    )
+);
+
+#endif /* _TRACE_SCHED_H */
+
+/* This part must be outside protection */
+#include <trace/define_trace.h>
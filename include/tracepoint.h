@@ -0,0 +1,79 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef _LINUX_TRACEPOINT_H
+#define _LINUX_TRACEPOINT_H
+
+#include <list.h>
+#include <types.h>
+#include <atomic.h>
+#include <config.h>
+#include <jump_label.h>
+
+/*
+ * A trace event records fixed size binary records into a ring of its
+ * own, preallocated in the module that defines it. Each record starts
+ * with the cycle counter at the hook, the fields follow in their
+ * natural alignment. The ring wraps and keeps the newest records.
+ *
+ * Events are declared with TRACE_EVENT() in include/trace/events/,
+ * exactly one file of the module defines them:
+ *
+ *     #define CREATE_TRACE_POINTS
+ *     #include <trace/events/sched.h>
+ *
+ * and registers them from its init_module(). A disabled hook is a
+ * single nop, see jump_label.h. "trace_event=<name>,..." on the
+ * command line enables events at boot and trace_dump() writes the
+ * rings to the console for scripts/tracedump to decode, once the
+ * deferred modules are in and again on reboot(POWER_OFF).
+ */
+#define TRACE_RING_RECORDS  CONFIG_TRACE_RING_RECORDS
+
+struct trace_event {
+    struct list_head list;
+    const char *name;
+    const char *format;     /* "<type> <field>;" for each field */
+    unsigned int record_size;
+    void *ring;
+    atomic64_t head;        /* records written so far */
+    struct static_key key;
+    bool dumping;           /* drop records while trace_dump() reads */
+};
+
+#define PARAMS(args...)             args
+
+#define TP_PROTO(args...)           args
+#define TP_ARGS(args...)            args
+#define TP_STRUCT__entry(args...)   args
+#define TP_fast_assign(args...)     args
+
+#define DECLARE_TRACE_EVENT(name, proto, args, tstruct)             \
+    struct trace_event_raw_##name {                                 \
+        u64 ts;                                                     \
+        tstruct                                                     \
+    };                                                              \
+    extern struct trace_event event_##name;                         \
+    void __trace_##name(proto);                                     \
+    static inline void                                              \
+    trace_##name(proto)                                             \
+    {                                                               \
+        if (static_branch_unlikely(&event_##name.key))              \
+            __trace_##name(args);                                   \
+    }
+
+/* trace/define_trace.h redefines both for its second read */
+#define __field(type, item)         type item;
+
+#define TRACE_EVENT(name, proto, args, tstruct, assign)             \
+    DECLARE_TRACE_EVENT(name, PARAMS(proto), PARAMS(args),          \
+                        PARAMS(tstruct))
+
+void trace_event_register(struct trace_event *event);
+
+int trace_event_enable(const char *name);
+int trace_event_disable(const char *name);
+
+void trace_dump(void);
+
+int trace_event_setup(char *param, char *value);
+
+#endif /* _LINUX_TRACEPOINT_H */
@@ -3,6 +3,7 @@
 #define _LINUX_TTY_H
 
 #include <file.h>
+#include <wait.h>
 #include <sysfs.h>
 #include <kernel.h>
 
@@ -40,6 +41,7 @@ struct tty_struct {
     unsigned char *write_buf;
     int write_cnt;
     struct list_head tty_files;
+    wait_queue_head_t write_wait;
 };
 
 /* Each of a tty's open files has private_data pointing to tty_file_private */
@@ -144,6 +146,8 @@ tty_set_operations(struct tty_driver *driver,
 int
 tty_standard_install(struct tty_driver *driver, struct tty_struct *tty);
 
+void tty_wakeup(struct tty_struct *tty);
+
 /* tty_port::iflags bits -- use atomic bit ops */
 #define TTY_PORT_INITIALIZED    0   /* device is initialized */
 #define TTY_PORT_SUSPENDED      1   /* device is suspended */
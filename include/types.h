@@ -11,6 +11,7 @@
 #ifndef __ASSEMBLY__
 
 #include <bits.h>
+#include <config.h>
 
 #define offsetof(TYPE, MEMBER)  ((size_t)&((TYPE *)0)->MEMBER)
 #define sizeof_field(TYPE, MEMBER) sizeof((((TYPE *)0)->MEMBER))
@@ -220,7 +221,7 @@ static inline u32 __swab32p(const u32 *p)
 #define DECLARE_BITMAP(name, bits) \
     unsigned long name[BITS_TO_LONGS(bits)]
 
-#define NR_CPUS 1
+#define NR_CPUS CONFIG_NR_CPUS
 
 /* Don't assign or return these: may not be this big! */
 typedef struct cpumask { DECLARE_BITMAP(bits, NR_CPUS); } cpumask_t;
@@ -0,0 +1,30 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef _ASM_RISCV_VDSO_H
+#define _ASM_RISCV_VDSO_H
+
+#include <types.h>
+#include <seqlock.h>
+
+/*
+ * The page shared read-only with every process, right in front of
+ * the vDSO text which finds it PC relative as _vdso_data. The tick
+ * rewrites it under @seq, a clock read in user mode that raced with
+ * the update reads again.
+ *
+ * There is no RTC, CLOCK_REALTIME counts from reset as the monotonic
+ * clocks do.
+ */
+struct vdso_data {
+    seqcount_t  seq;
+    u32         mult;       /* time CSR cycles to ns, as ktime_get() */
+    u32         shift;
+    u64         coarse_ns;  /* ktime_get() at the last tick */
+    u32         nr_cpus;    /* online, getcpu() traps unless a single one */
+};
+
+struct linux_binprm;
+
+/* Map the data page and the vDSO into current->mm, see binfmt_elf */
+int arch_setup_additional_pages(struct linux_binprm *bprm, int uses_interp);
+
+#endif /* _ASM_RISCV_VDSO_H */
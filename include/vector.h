@@ -0,0 +1,30 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef _ASM_RISCV_VECTOR_H
+#define _ASM_RISCV_VECTOR_H
+
+#include <types.h>
+
+/* Below this size the scalar string functions are faster. */
+#define RISCV_V_MIN_BYTES   64
+
+extern bool riscv_v_enabled;
+
+/*
+ * Enable the vector string functions if the ISA string from the
+ * device tree has the V extension. Returns whether they are used.
+ */
+bool riscv_v_setup(const char *isa);
+
+/*
+ * Vector registers may only be used between kernel_vector_begin() and
+ * kernel_vector_end(), without sleeping, and only if may_use_vector().
+ */
+bool may_use_vector(void);
+void kernel_vector_begin(void);
+void kernel_vector_end(void);
+
+void *__memcpy_rvv(void *, const void *, size_t);
+void *__memset_rvv(void *, int, size_t);
+void *__memmove_rvv(void *, const void *, size_t);
+
+#endif /* _ASM_RISCV_VECTOR_H */
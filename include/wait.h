@@ -0,0 +1,152 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+#ifndef _LINUX_WAIT_H
+#define _LINUX_WAIT_H
+
+#include <list.h>
+#include <sched.h>
+#include <current.h>
+
+typedef struct wait_queue_entry wait_queue_entry_t;
+
+typedef int (*wait_queue_func_t)(struct wait_queue_entry *wq_entry,
+                                 unsigned mode, int flags, void *key);
+
+int default_wake_function(struct wait_queue_entry *wq_entry,
+                          unsigned mode, int flags, void *key);
+
+/* wait_queue_entry::flags */
+#define WQ_FLAG_EXCLUSIVE   0x01
+
+#define TASK_NORMAL (TASK_INTERRUPTIBLE | TASK_UNINTERRUPTIBLE)
+
+/*
+ * A single entry in a wait queue:
+ */
+struct wait_queue_entry {
+    unsigned int        flags;
+    void                *private;
+    wait_queue_func_t   func;
+    struct list_head    entry;
+};
+
+/*
+ * Only the CPU holding the kernel lock gets at the list, see
+ * startup/smp.c. It is kept with interrupts off instead of a lock of
+ * its own, wakers may run in an interrupt handler.
+ */
+struct wait_queue_head {
+    struct list_head    head;
+};
+typedef struct wait_queue_head wait_queue_head_t;
+
+#define __WAIT_QUEUE_HEAD_INITIALIZER(name) {   \
+    .head = LIST_HEAD_INIT((name).head)         \
+}
+
+#define DECLARE_WAIT_QUEUE_HEAD(name) \
+    struct wait_queue_head name = __WAIT_QUEUE_HEAD_INITIALIZER(name)
+
+static inline void init_waitqueue_head(struct wait_queue_head *wq_head)
+{
+    INIT_LIST_HEAD(&wq_head->head);
+}
+
+static inline void
+init_waitqueue_entry(struct wait_queue_entry *wq_entry, struct task_struct *p)
+{
+    wq_entry->flags     = 0;
+    wq_entry->private   = p;
+    wq_entry->func      = default_wake_function;
+}
+
+/**
+ * waitqueue_active -- locklessly test for waiters on the queue
+ * @wq_head: the waitqueue to test for waiters
+ *
+ * The waker must have made the condition true before, and the waiter
+ * tests the condition after prepare_to_wait() has queued it.
+ */
+static inline int waitqueue_active(struct wait_queue_head *wq_head)
+{
+    return !list_empty(&wq_head->head);
+}
+
+void add_wait_queue(struct wait_queue_head *wq_head,
+                    struct wait_queue_entry *wq_entry);
+void add_wait_queue_exclusive(struct wait_queue_head *wq_head,
+                              struct wait_queue_entry *wq_entry);
+void remove_wait_queue(struct wait_queue_head *wq_head,
+                       struct wait_queue_entry *wq_entry);
+
+void __wake_up(struct wait_queue_head *wq_head, unsigned int mode,
+               int nr_exclusive, void *key);
+
+#define wake_up(x)          __wake_up(x, TASK_NORMAL, 1, NULL)
+#define wake_up_nr(x, nr)   __wake_up(x, TASK_NORMAL, nr, NULL)
+#define wake_up_all(x)      __wake_up(x, TASK_NORMAL, 0, NULL)
+
+#define wake_up_interruptible(x)    __wake_up(x, TASK_INTERRUPTIBLE, 1, NULL)
+#define wake_up_interruptible_all(x) __wake_up(x, TASK_INTERRUPTIBLE, 0, NULL)
+
+void prepare_to_wait(struct wait_queue_head *wq_head,
+                     struct wait_queue_entry *wq_entry, int state);
+void prepare_to_wait_exclusive(struct wait_queue_head *wq_head,
+                               struct wait_queue_entry *wq_entry, int state);
+void finish_wait(struct wait_queue_head *wq_head,
+                 struct wait_queue_entry *wq_entry);
+void init_wait_entry(struct wait_queue_entry *wq_entry, int flags);
+
+int autoremove_wake_function(struct wait_queue_entry *wq_entry,
+                             unsigned mode, int sync, void *key);
+
+#define DEFINE_WAIT_FUNC(name, function)                    \
+    struct wait_queue_entry name = {                        \
+        .private    = current,                              \
+        .func       = function,                             \
+        .entry      = LIST_HEAD_INIT((name).entry),         \
+    }
+
+#define DEFINE_WAIT(name) DEFINE_WAIT_FUNC(name, autoremove_wake_function)
+
+/*
+ * The condition is tested after the task has been queued and its
+ * state set, a wakeup in between puts it back to TASK_RUNNING and
+ * schedule() returns at once.
+ */
+#define ___wait_event(wq_head, condition, state, exclusive)     \
+do {                                                            \
+    struct wait_queue_entry __wq_entry;                         \
+                                                                \
+    init_wait_entry(&__wq_entry, exclusive ? WQ_FLAG_EXCLUSIVE : 0); \
+    for (;;) {                                                  \
+        if (exclusive)                                          \
+            prepare_to_wait_exclusive(&(wq_head), &__wq_entry, state); \
+        else                                                    \
+            prepare_to_wait(&(wq_head), &__wq_entry, state);    \
+        if (condition)                                          \
+            break;                                              \
+        schedule();                                             \
+    }                                                           \
+    finish_wait(&(wq_head), &__wq_entry);                       \
+} while (0)
+
+/**
+ * wait_event - sleep until a condition gets true
+ * @wq_head: the waitqueue to wait on
+ * @condition: a C expression for the event to wait for
+ *
+ * The process is put to sleep (TASK_UNINTERRUPTIBLE) until the
+ * @condition evaluates to true. The @condition is checked each time
+ * the waitqueue @wq_head is woken up.
+ *
+ * wake_up() has to be called after changing any variable that could
+ * change the result of the wait condition.
+ */
+#define wait_event(wq_head, condition)                          \
+do {                                                            \
+    if (condition)                                              \
+        break;                                                  \
+    ___wait_event(wq_head, condition, TASK_UNINTERRUPTIBLE, 0); \
+} while (0)
+
+#endif /* _LINUX_WAIT_H */
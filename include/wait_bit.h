@@ -2,6 +2,57 @@
 #ifndef _LINUX_WAIT_BIT_H
 #define _LINUX_WAIT_BIT_H
 
+/*
+ * Linux wait-bit related types and methods:
+ */
+#include <bits.h>
+#include <wait.h>
+
+struct wait_bit_key {
+    void            *flags;
+    int             bit_nr;
+};
+
+struct wait_bit_queue_entry {
+    struct wait_bit_key         key;
+    struct wait_queue_entry     wq_entry;
+};
+
+#define __WAIT_BIT_KEY_INITIALIZER(word, bit)   \
+    { .flags = word, .bit_nr = bit, }
+
+typedef int wait_bit_action_f(struct wait_bit_key *key, int mode);
+
+void __wake_up_bit(struct wait_queue_head *wq_head, void *word, int bit);
+int __wait_on_bit(struct wait_queue_head *wq_head,
+                  struct wait_bit_queue_entry *wbq_entry,
+                  wait_bit_action_f *action, unsigned int mode);
+int __wait_on_bit_lock(struct wait_queue_head *wq_head,
+                       struct wait_bit_queue_entry *wbq_entry,
+                       wait_bit_action_f *action, unsigned int mode);
+void wake_up_bit(void *word, int bit);
+int out_of_line_wait_on_bit(void *word, int,
+                            wait_bit_action_f *action, unsigned int mode);
+int out_of_line_wait_on_bit_lock(void *word, int,
+                                 wait_bit_action_f *action, unsigned int mode);
+struct wait_queue_head *bit_waitqueue(void *word, int bit);
+void wait_bit_init(void);
+
+int wake_bit_function(struct wait_queue_entry *wq_entry,
+                      unsigned mode, int sync, void *key);
+
+#define DEFINE_WAIT_BIT(name, word, bit)                            \
+    struct wait_bit_queue_entry name = {                            \
+        .key = __WAIT_BIT_KEY_INITIALIZER(word, bit),               \
+        .wq_entry = {                                               \
+            .private    = current,                                  \
+            .func       = wake_bit_function,                        \
+            .entry      = LIST_HEAD_INIT((name).wq_entry.entry),    \
+        },                                                          \
+    }
+
+int bit_wait_io(struct wait_bit_key *key, int mode);
+
 /**
  * wait_on_bit_io - wait for a bit to be cleared
  * @word: the word being waited on, a kernel virtual address
@@ -19,10 +70,9 @@
 static inline int
 wait_on_bit_io(unsigned long *word, int bit, unsigned mode)
 {
-    /* NOTICE: Just wait until the bit is cleared. */
-    printk("%s: ...\n", __func__);
-    while (test_bit(bit, word));
-    return 0;
+    if (!test_bit(bit, word))
+        return 0;
+    return out_of_line_wait_on_bit(word, bit, bit_wait_io, mode);
 }
 
 /**
@@ -45,8 +95,38 @@ wait_on_bit_lock_io(unsigned long *word, int bit, unsigned mode)
 {
     if (!test_and_set_bit(bit, word))
         return 0;
-    panic("%s:", __func__);
-    //return out_of_line_wait_on_bit_lock(word, bit, bit_wait_io, mode);
+    return out_of_line_wait_on_bit_lock(word, bit, bit_wait_io, mode);
 }
 
+/*
+ * Waits on any variable, hashed into the same table. The waker
+ * changes it and calls wake_up_var() on its address.
+ */
+struct wait_queue_head *__var_waitqueue(void *p);
+void wake_up_var(void *var);
+void init_wait_var_entry(struct wait_bit_queue_entry *wbq_entry,
+                         void *var, int flags);
+
+#define ___wait_var_event(var, condition, state)                    \
+do {                                                                \
+    struct wait_queue_head *__wq_head = __var_waitqueue(var);       \
+    struct wait_bit_queue_entry __wbq_entry;                        \
+                                                                    \
+    init_wait_var_entry(&__wbq_entry, var, 0);                      \
+    for (;;) {                                                      \
+        prepare_to_wait(__wq_head, &__wbq_entry.wq_entry, state);   \
+        if (condition)                                              \
+            break;                                                  \
+        schedule();                                                 \
+    }                                                               \
+    finish_wait(__wq_head, &__wbq_entry.wq_entry);                  \
+} while (0)
+
+#define wait_var_event(var, condition)                              \
+do {                                                                \
+    if (condition)                                                  \
+        break;                                                      \
+    ___wait_var_event(var, condition, TASK_UNINTERRUPTIBLE);        \
+} while (0)
+
 #endif /* _LINUX_WAIT_BIT_H */
@@ -2,6 +2,7 @@
 #ifndef _ASM_RISCV_WORD_AT_A_TIME_H
 #define _ASM_RISCV_WORD_AT_A_TIME_H
 
+#include <log2.h>
 #include <kernel.h>
 
 struct word_at_a_time {
@@ -11,6 +12,16 @@ struct word_at_a_time {
 
 #define WORD_AT_A_TIME_CONSTANTS { REPEAT_BYTE(0x01), REPEAT_BYTE(0x80) }
 
+/*
+ * Load the aligned word which holds the next bytes of a string. It
+ * may run past the end of the string, though never into another page.
+ */
+static __no_sanitize_address inline unsigned long
+read_word_at_a_time(const void *addr)
+{
+    return *(const unsigned long *)addr;
+}
+
 static inline unsigned long
 has_zero(unsigned long val, unsigned long *bits,
          const struct word_at_a_time *c)
@@ -38,4 +49,7 @@ static inline unsigned long find_zero(unsigned long mask)
     return fls64(mask) >> 3;
 }
 
+/* The bytes before the first zero, as left by create_zero_mask() */
+#define zero_bytemask(mask) (mask)
+
 #endif /* _ASM_RISCV_WORD_AT_A_TIME_H */
@@ -2,6 +2,7 @@
 #ifndef _LINUX_WORKQUEUE_H
 #define _LINUX_WORKQUEUE_H
 
+#include <timer.h>
 #include <atomic.h>
 
 /*
@@ -22,6 +23,9 @@
 #define __INIT_DELAYED_WORK(_work, _func, _tflags)  \
     do {                                            \
         INIT_WORK(&(_work)->work, (_func));         \
+        __init_timer(&(_work)->timer,               \
+                     delayed_work_timer_fn,         \
+                     (_tflags));                    \
     } while (0)
 
 #define INIT_DELAYED_WORK(_work, _func) \
@@ -29,6 +33,7 @@
 
 struct work_struct;
 typedef void (*work_func_t)(struct work_struct *work);
+void delayed_work_timer_fn(struct timer_list *t);
 
 enum {
     WORK_STRUCT_PENDING_BIT = 0,    /* work item is pending execution */
@@ -121,8 +126,18 @@ struct work_struct {
 
 struct delayed_work {
     struct work_struct work;
+    struct timer_list timer;
+
+    /* target workqueue and CPU ->timer uses to queue ->work */
+    struct workqueue_struct *wq;
+    int cpu;
 };
 
+static inline struct delayed_work *to_delayed_work(struct work_struct *work)
+{
+    return container_of(work, struct delayed_work, work);
+}
+
 struct pool_workqueue {
     struct worker_pool *pool;       /* I: the associated pool */
     struct workqueue_struct *wq;    /* I: the owning workqueue */
@@ -139,4 +154,6 @@ bool
 mod_delayed_work_on(int cpu, struct workqueue_struct *wq,
                     struct delayed_work *dwork, unsigned long delay);
 
+bool cancel_delayed_work(struct delayed_work *dwork);
+
 #endif /* _LINUX_WORKQUEUE_H */
@@ -2,8 +2,10 @@
 #include <mm.h>
 #include <bug.h>
 #include <fdt.h>
+#include <module.h>
 #include <printk.h>
 #include <platform.h>
+#include <linkage.h>
 
 extern uintptr_t kernel_size;
 extern void arch_call_rest_init(void);
@@ -22,7 +24,7 @@ start_kernel(void)
     printk("start_kernel: init ok!\n");
 }
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[init]: init begin ...\n");
@@ -1,12 +1,20 @@
 // SPDX-License-Identifier: GPL-2.0-only
 
 #include <fs.h>
+#include <mm.h>
 #include <bug.h>
 #include <fork.h>
 #include <errno.h>
+#include <smp.h>
 #include <sched.h>
 #include <limits.h>
+#include <module.h>
+#include <jump_label.h>
+#include <tracepoint.h>
 #include <printk.h>
+#include <profile.h>
+#include <lockstat.h>
+#include <tick.h>
 
 /*
  * Boot command-line arguments
@@ -29,6 +37,9 @@ static int run_init_process(const char *init_filename)
     printk("  with environment:\n");
     for (p = envp_init; *p; p++)
         printk("    %s\n", *p);
+
+    /* Hand the boot log to the console before init takes over */
+    console_flush();
     return kernel_execve(init_filename, argv_init, envp_init);
 }
 
@@ -54,6 +65,65 @@ static int kernel_init(void *unused)
           "See Linux Documentation/admin-guide/init.rst for guidance.");
 }
 
+/*
+ * Give the init sections of the kernel and the modules back to the
+ * buddy allocator. Nothing may call into them afterwards.
+ */
+static void free_initmem(void)
+{
+    unsigned long pages;
+
+    /* No static branch site may be patched in there anymore */
+    jump_label_invalidate_initmem();
+
+    pages = free_reserved_area(__init_begin, __init_end, "unused kernel");
+    pages += free_reserved_area((void *)modules_init_start,
+                                (void *)modules_init_end, "module init");
+
+    printk("Reclaimed %lu bytes of init memory\n", pages << PAGE_SHIFT);
+}
+
+/* Only complete once the deferred modules had their init too */
+static void
+print_module_boot_stats(void)
+{
+    struct module *mod;
+    struct module_boot_stat *st;
+
+    printk("modules loaded in %lu timebase ticks\n", modules_load_ticks);
+    printk("ksymtab: %lu lookups in %lu cycles\n",
+           ksym_lookups, ksym_lookup_cycles);
+
+    printk("module: layout copy symbols relocate init (cycles) bytes\n");
+    list_for_each_entry(mod, &modules, list) {
+        st = &mod->boot_stat;
+        printk("%s: %lu %lu %lu %lu %lu %lu%s\n",
+               mod->name, st->layout, st->copy, st->symbols,
+               st->relocate, st->init, st->bytes,
+               mod->init_level == MODULE_INIT_DEFERRED ? " deferred" : "");
+    }
+}
+
+/*
+ * Init the modules which have been deferred at boot. It is created
+ * behind kernel_init, so it only runs once /sbin/init has been started.
+ * All init_module() have been called after it, so free init memory.
+ */
+static int deferred_init(void *unused)
+{
+    do_deferred_modules();
+    print_module_boot_stats();
+    trace_dump();
+    profile_dump();
+    lockstat_dump();
+    tick_nohz_dump();
+    free_initmem();
+    console_flush();
+
+    /* Nobody waits for a kernel thread to exit yet */
+    do_task_dead();
+}
+
 void rest_init(void)
 {
     int pid;
@@ -62,13 +132,19 @@ void rest_init(void)
     pid = kernel_thread(kernel_init, NULL, CLONE_FS);
     printk("%s: 2\n", __func__);
 
+    kernel_thread(deferred_init, NULL, CLONE_FS);
+
     /*
      * The boot idle thread must execute schedule()
      * at least once to get things moving:
      */
     schedule_preempt_disabled();
 
-    panic("Call into cpu_idle with preempt disabled.");
+    /* Taken in smp_init(), an idle loop runs without the kernel lock */
+    unlock_kernel();
+
+    /* Call into cpu_idle with preempt disabled */
+    cpu_startup_entry();
 }
 
 void arch_call_rest_init(void)
@@ -3,12 +3,16 @@
 #include <bug.h>
 #include <csr.h>
 #include <irq.h>
+#include <smp.h>
+#include <tick.h>
 #include <export.h>
 #include <printk.h>
+#include <profile.h>
 #include <of_irq.h>
 #include <irqchip.h>
 #include <irqdesc.h>
 #include <irqdomain.h>
+#include <linkage.h>
 
 bool intc_initialized;
 EXPORT_SYMBOL(intc_initialized);
@@ -25,7 +29,10 @@ riscv_intc_irq(struct pt_regs *regs)
 
     switch (cause) {
     case IRQ_S_SOFT:
-        panic("no irq soft!");
+        handle_IPI(regs);
+        break;
+    case IRQ_S_TIMER:
+        tick_interrupt(regs);
         break;
     default:
         printk("%s: 1\n", __func__);
@@ -75,6 +82,13 @@ riscv_intc_init(struct device_node *node,
 {
     int rc;
 
+    /*
+     * There is one of these in each cpu node, the domain and handler
+     * are set up once, from the boot hart's.
+     */
+    if (riscv_of_parent_hartid(node) != boot_cpu_hartid)
+        return 0;
+
     intc_domain = irq_domain_add_linear(node, BITS_PER_LONG,
                                         &riscv_intc_domain_ops, NULL);
     if (!intc_domain)
@@ -84,10 +98,19 @@ riscv_intc_init(struct device_node *node,
     if (rc)
         panic("failed to set irq handler");
 
+    /* The profiler samples from the timer interrupt of the tick */
+    rc = profile_init();
+    if (rc)
+        printk("profile: can't start, %d\n", rc);
+
+    rc = tick_init();
+    if (rc)
+        panic("failed to start the tick");
+
     return 0;
 }
 
-static int
+static int __init
 init_module(void)
 {
     struct of_device_id matchs[] = {
@@ -7,6 +7,7 @@
 #include <ioremap.h>
 #include <pgalloc.h>
 #include <pgtable.h>
+#include <linkage.h>
 
 static inline pmd_t *
 pmd_alloc_track(struct mm_struct *mm, pgd_t *pgd,
@@ -144,7 +145,7 @@ ioremap_prot(phys_addr_t addr, size_t size, unsigned long prot)
 }
 EXPORT_SYMBOL(ioremap_prot);
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[ioremap]: init begin ...\n");
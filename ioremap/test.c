@@ -2,6 +2,7 @@
 #include <printk.h>
 #include <string.h>
 #include <ioremap.h>
+#include <linkage.h>
 
 static int
 test_ioremap(void)
@@ -16,7 +17,7 @@ test_ioremap(void)
     return 0;
 }
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[test_ioremap]: init begin ...\n");
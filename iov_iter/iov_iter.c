@@ -7,6 +7,7 @@
 #include <printk.h>
 #include <highmem.h>
 #include <uaccess.h>
+#include <linkage.h>
 
 #define iterate_kvec(i, n, __v, __p, skip, STEP) {  \
     size_t wanted = n;              \
@@ -144,7 +145,7 @@ size_t _copy_to_iter(const void *addr, size_t bytes, struct iov_iter *i)
 }
 EXPORT_SYMBOL(_copy_to_iter);
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[iov_iter]: init begin ...\n");
@@ -2,8 +2,9 @@
 
 #include <printk.h>
 #include <irqflags.h>
+#include <linkage.h>
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[irq]: init begin ...\n");
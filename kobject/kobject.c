@@ -9,6 +9,7 @@
 #include <printk.h>
 #include <string.h>
 #include <kobject.h>
+#include <linkage.h>
 
 static void
 kobject_init_internal(struct kobject *kobj)
@@ -237,7 +238,7 @@ kobject_init_and_add(struct kobject *kobj, const char *fmt, ...)
 }
 EXPORT_SYMBOL(kobject_init_and_add);
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[kobject]: init begin ...\n");
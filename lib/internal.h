@@ -0,0 +1,31 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#include <types.h>
+#include <kernel.h>
+
+/*
+ * Layout of the log buffer of printk.c, for the tests of test.c to
+ * place records with.
+ */
+#define PREFIX_MAX      32
+#define LOG_LINE_MAX    (1024 - PREFIX_MAX)
+
+#define LOG_BUF_SHIFT   16
+#define LOG_BUF_LEN     (1UL << LOG_BUF_SHIFT)
+#define LOG_ALIGN       __alignof__(struct printk_log)
+
+/* What vprintk_store() reserves, the longest a record can be */
+#define LOG_REC_MAX     ALIGN(sizeof(struct printk_log) + LOG_LINE_MAX, \
+                              LOG_ALIGN)
+
+#define LOG_PAD         1   /* Filler up to the end of the buffer */
+
+struct printk_log {
+    u64 ts;         /* timestamp in timebase ticks */
+    u32 seq;        /* sequence number */
+    u32 commit;     /* position of the record once it's complete */
+    u16 len;        /* length of entire record */
+    u16 text_len;   /* length of text buffer */
+    u16 flags;      /* LOG_PAD */
+    u16 level;      /* LOGLEVEL_* */
+};
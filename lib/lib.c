@@ -1,11 +1,16 @@
 // SPDX-License-Identifier: GPL-2.0-only
 
 #include <printk.h>
+#include <linkage.h>
+#include <wait_bit.h>
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[lib]: init begin ...\n");
+
+    wait_bit_init();
+
     printk("module[lib]: init end!\n");
     return 0;
 }
@@ -2,13 +2,16 @@
 
 #include <bug.h>
 #include <sbi.h>
+#include <timex.h>
+#include <jiffies.h>
 #include <acgcc.h>
 #include <errno.h>
+#include <atomic.h>
+#include <barrier.h>
 #include <string.h>
 #include <export.h>
 
-#define PREFIX_MAX      32
-#define LOG_LINE_MAX    (1024 - PREFIX_MAX)
+#include "internal.h"
 
 /*
  *  Array of consoles built from command line options (console=)
@@ -26,25 +29,276 @@ EXPORT_SYMBOL(preferred_console);
 struct console *console_drivers;
 EXPORT_SYMBOL(console_drivers);
 
+/*
+ * The log buffer is a ring of records, each a struct printk_log header
+ * followed by the text. Writers reserve a record with one cmpxchg on
+ * log_head and format straight into it, nothing waits for the console.
+ * console_flush() drains committed records in bulk and only then lets
+ * writers reuse the space, by moving log_tail. It runs once half the
+ * buffer is waiting, from the idle loop, and from the tick for records
+ * older than LOG_FLUSH_DELAY_MS.
+ *
+ * log_head packs the sequence number of the next record in its upper
+ * half and the byte position of the next record in its lower half.
+ * Positions run freely and are masked into the buffer, a record never
+ * wraps around its end: the rest is taken by a padding record instead,
+ * or skipped by the reader if it's too short to hold a header. The
+ * layout is in internal.h.
+ */
+
+/* printk_tick() drains the log once its oldest record is this old */
+#define LOG_FLUSH_DELAY_MS  100
+
+static char log_buf[LOG_BUF_LEN] __aligned(LOG_ALIGN);
+
+static atomic64_t log_head;
+static u32 log_tail;
+static atomic_t console_draining;
+static atomic_t log_dropped;
+
+int console_loglevel = CONSOLE_LOGLEVEL_DEFAULT;
+EXPORT_SYMBOL(console_loglevel);
+
+DEFINE_STATIC_KEY_FALSE(printk_debug_key);
+EXPORT_SYMBOL(printk_debug_key);
+
+#define LOG_HEAD(seq, pos)  (((u64)(seq) << 32) | (u32)(pos))
+#define LOG_SEQ(head)       ((u32)((u64)(head) >> 32))
+#define LOG_POS(head)       ((u32)(head))
+
+static inline struct printk_log *
+log_from_pos(u32 pos)
+{
+    return (struct printk_log *)(log_buf + (pos & (LOG_BUF_LEN - 1)));
+}
+
+/* Bytes from @pos up to the end of the buffer */
+static inline u32
+log_room(u32 pos)
+{
+    return LOG_BUF_LEN - (pos & (LOG_BUF_LEN - 1));
+}
+
+/*
+ * Reserve a record of @size bytes, padding up to the end of the
+ * buffer first if it doesn't fit there. A rest shorter than a header
+ * gets no padding record, console_flush() steps over it on its own.
+ * Returns NULL when the console hasn't drained enough yet.
+ */
+static struct printk_log *
+log_reserve(u32 size, u32 *seq, u32 *posp)
+{
+    u64 head, new;
+    u32 pos, pad;
+    struct printk_log *pad_msg;
+
+    do {
+        head = atomic64_read(&log_head);
+        pos = LOG_POS(head);
+        pad = log_room(pos);
+        if (pad >= size)
+            pad = 0;
+        if (pos + pad + size - READ_ONCE(log_tail) > LOG_BUF_LEN)
+            return NULL;
+        new = LOG_HEAD(LOG_SEQ(head) + 1, pos + pad + size);
+    } while (atomic64_cmpxchg(&log_head, head, new) != head);
+
+    if (pad >= sizeof(*pad_msg)) {
+        pad_msg = log_from_pos(pos);
+        pad_msg->len = pad;
+        pad_msg->text_len = 0;
+        pad_msg->flags = LOG_PAD;
+        WRITE_ONCE(pad_msg->commit, pos);
+    }
+    pos += pad;
+
+    *seq = LOG_SEQ(head);
+    *posp = pos;
+    return log_from_pos(pos);
+}
+
+/* Give back the unused end of the record at @pos if it's still the last */
+static u32
+log_shrink(u32 pos, u32 size, u32 used)
+{
+    u64 head = atomic64_read(&log_head);
+
+    if (LOG_POS(head) != pos + size)
+        return size;
+    if (atomic64_cmpxchg(&log_head, head,
+                         LOG_HEAD(LOG_SEQ(head), pos + used)) != head)
+        return size;
+    return used;
+}
+
+/* Strip the KERN_<LEVEL> prefix off @fmt, if any */
+static int
+printk_get_level(const char **fmt)
+{
+    const char *s = *fmt;
+
+    if (s[0] != KERN_SOH_ASCII || s[1] < '0' || s[1] > '7')
+        return MESSAGE_LOGLEVEL_DEFAULT;
+
+    *fmt = s + 2;
+    return s[1] - '0';
+}
+
 static void
-vprintk_func(const char *fmt, va_list args)
+vprintk_store(const char *fmt, va_list args)
+{
+    u32 size, seq, pos;
+    int text_len;
+    int level = printk_get_level(&fmt);
+    struct printk_log *msg;
+
+    size = LOG_REC_MAX;
+    msg = log_reserve(size, &seq, &pos);
+    if (!msg) {
+        /* Out of room, the caller pays for the console this once */
+        console_flush();
+        msg = log_reserve(size, &seq, &pos);
+        if (!msg) {
+            atomic_add(1, &log_dropped);
+            return;
+        }
+    }
+
+    text_len = vsnprintf((char *)(msg + 1), LOG_LINE_MAX, fmt, args);
+    if (text_len >= LOG_LINE_MAX)
+        text_len = LOG_LINE_MAX - 1;
+
+    msg->ts = get_time();
+    msg->seq = seq;
+    msg->text_len = text_len;
+    msg->flags = 0;
+    msg->level = level;
+    msg->len = log_shrink(pos, size,
+                          ALIGN(sizeof(*msg) + text_len, LOG_ALIGN));
+
+    /* Stale bytes from an earlier lap can't match the position */
+    smp_wmb();
+    WRITE_ONCE(msg->commit, pos);
+}
+
+/* Registered consoles with a write op take over from SBI */
+static void
+console_write(const char *text, unsigned int len)
+{
+    bool written = false;
+    struct console *con;
+
+    for_each_console(con) {
+        if (!(con->flags & CON_ENABLED) || !con->write)
+            continue;
+        con->write(con, text, len);
+        written = true;
+    }
+
+    if (!written)
+        sbi_console_write(text, len);
+}
+
+/**
+ * console_flush - Write all committed log records to the console
+ *
+ * Records go out in order up to the first one that is still being
+ * written. Only one context drains at a time, others return at once
+ * and leave their records to it.
+ */
+void console_flush(void)
 {
-    static char textbuf[LOG_LINE_MAX];
+    static const char dropped_msg[] = "** printk messages dropped **\n";
+    int dropped;
+    u32 head;
+    struct printk_log *msg;
 
-    vsnprintf(textbuf, sizeof(textbuf), fmt, args);
+    if (atomic_fetch_add(1, &console_draining)) {
+        atomic_sub(1, &console_draining);
+        return;
+    }
+
+    head = LOG_POS(atomic64_read(&log_head));
+    while (log_tail != head) {
+        if (log_room(log_tail) < sizeof(*msg)) {
+            /* No room for a padding record there, wrap around */
+            WRITE_ONCE(log_tail, log_tail + log_room(log_tail));
+            continue;
+        }
+
+        msg = log_from_pos(log_tail);
+        if (READ_ONCE(msg->commit) != log_tail)
+            break;
+        smp_rmb();
 
-    sbi_puts(textbuf);
+        if (!(msg->flags & LOG_PAD) && msg->level < console_loglevel)
+            console_write((char *)(msg + 1), msg->text_len);
+
+        WRITE_ONCE(log_tail, log_tail + msg->len);
+        head = LOG_POS(atomic64_read(&log_head));
+    }
+
+    dropped = atomic_read(&log_dropped);
+    if (dropped) {
+        atomic_sub(dropped, &log_dropped);
+        console_write(dropped_msg, sizeof(dropped_msg) - 1);
+    }
+
+    atomic_sub(1, &console_draining);
 }
+EXPORT_SYMBOL(console_flush);
 
 void printk(const char *fmt, ...)
 {
     va_list args;
     va_start(args, fmt);
-    vprintk_func(fmt, args);
+    vprintk_store(fmt, args);
     va_end(args);
+
+    /* Drain in bulk once half the buffer is waiting */
+    if (LOG_POS(atomic64_read(&log_head)) - READ_ONCE(log_tail) >=
+        LOG_BUF_LEN / 2)
+        console_flush();
 }
 EXPORT_SYMBOL(printk);
 
+/**
+ * printk_tick - Drain the log if its oldest record waited long enough
+ *
+ * Called from the tick, so that a few messages don't sit in the buffer
+ * for ever below the size printk() drains at. The record is read
+ * unlocked, a drain which moves on under it only makes this one early.
+ */
+void printk_tick(void)
+{
+    u32 tail = READ_ONCE(log_tail);
+    struct printk_log *msg;
+
+    if (LOG_POS(atomic64_read(&log_head)) == tail)
+        return;
+
+    if (log_room(tail) >= sizeof(*msg)) {
+        msg = log_from_pos(tail);
+        if (READ_ONCE(msg->commit) != tail)
+            return;
+        smp_rmb();
+
+        if (!(msg->flags & LOG_PAD) && get_time() - msg->ts <
+            riscv_timebase / MSEC_PER_SEC * LOG_FLUSH_DELAY_MS)
+            return;
+    }
+
+    console_flush();
+}
+EXPORT_SYMBOL(printk_tick);
+
+/* Where the next record goes, for the tests of lib/test.c */
+u32 printk_log_room(void)
+{
+    return log_room(LOG_POS(atomic64_read(&log_head)));
+}
+EXPORT_SYMBOL(printk_log_room);
+
 static int
 try_enable_new_console(struct console *newcon, bool user_specified)
 {
@@ -248,6 +502,27 @@ __add_preferred_console(char *name, int idx, char *options,
     return 0;
 }
 
+int
+loglevel_setup(char *param, char *value)
+{
+    if (!value || !isdigit(value[0]))
+        return 0;
+
+    console_loglevel = simple_strtoul(value, NULL, 10);
+    return 1;
+}
+EXPORT_SYMBOL(loglevel_setup);
+
+/* "debug": show everything and turn the pr_debug() sites on */
+int
+debug_setup(char *param, char *value)
+{
+    console_loglevel = CONSOLE_LOGLEVEL_DEBUG;
+    static_key_enable(&printk_debug_key);
+    return 1;
+}
+EXPORT_SYMBOL(debug_setup);
+
 /*
  * Set up a console.  Called via do_early_param() in init/main.c
  * for each "console=" parameter in the boot command line.
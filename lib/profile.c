@@ -0,0 +1,174 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <smp.h>
+#include <page.h>
+#include <slab.h>
+#include <timex.h>
+#include <errno.h>
+#include <limits.h>
+#include <export.h>
+#include <module.h>
+#include <printk.h>
+#include <string.h>
+#include <profile.h>
+
+/*
+ * Dump format, one "profile: " console line each:
+ *
+ *   begin <hz> <shift> <start> <samples> <user> <other>
+ *   module <name> <base> <size> boot|prelinked
+ *   hit <bucket address> <count>
+ *   end
+ *
+ * Numbers are hex, only buckets with samples are written.
+ * scripts/profile.c parses it, keep both in sync.
+ */
+
+extern uintptr_t kernel_start;
+extern uintptr_t kernel_size;
+
+static unsigned long prof_hz;
+static unsigned int prof_shift = CONFIG_PROFILE_SHIFT;
+
+/* Timebase ticks between two samples, and time of the next one on each CPU */
+static unsigned long prof_interval;
+static u64 prof_next[NR_CPUS];
+
+static unsigned long prof_start;
+static unsigned long prof_len;      /* buckets */
+static u32 *prof_buffer;
+
+static unsigned long prof_samples;
+static unsigned long prof_user;
+static unsigned long prof_other;
+
+/* Don't profile the dump */
+static bool prof_dumping;
+
+int
+profile_setup(char *param, char *value)
+{
+    char *p;
+
+    if (!value)
+        return 0;
+
+    prof_hz = simple_strtoul(value, &p, 0);
+    if (*p == ',')
+        prof_shift = simple_strtoul(p + 1, NULL, 0);
+    return 1;
+}
+EXPORT_SYMBOL(profile_setup);
+
+/**
+ * profile_init - Allocate the histogram and set the first sample
+ *
+ * Called by the interrupt controller driver before the tick starts,
+ * which then also programs the timer for the samples.
+ */
+int profile_init(void)
+{
+    size_t size;
+    int cpu;
+
+    if (!prof_hz)
+        return 0;
+
+    prof_start = (unsigned long)__va(kernel_start);
+    prof_len = (kernel_size + (1UL << prof_shift) - 1) >> prof_shift;
+    size = prof_len * sizeof(*prof_buffer);
+    if (size > KMALLOC_MAX_SIZE) {
+        pr_err("profile: %lu bytes of histogram, raise the shift\n", size);
+        return -ENOMEM;
+    }
+
+    prof_buffer = kmalloc(size, GFP_KERNEL | __GFP_ZERO);
+    if (!prof_buffer)
+        return -ENOMEM;
+
+    prof_interval = riscv_timebase / prof_hz ? : 1;
+
+    pr_info("profile: %lu Hz, %u bytes per bucket over %lx-%lx\n",
+            prof_hz, 1U << prof_shift, prof_start, prof_start + kernel_size);
+
+    for_each_possible_cpu(cpu)
+        prof_next[cpu] = get_time() + prof_interval;
+    return 0;
+}
+EXPORT_SYMBOL(profile_init);
+
+/* When the tick has to program the timer for the next sample */
+u64 profile_next_event(void)
+{
+    return prof_buffer ? prof_next[smp_processor_id()] : ULONG_MAX;
+}
+EXPORT_SYMBOL(profile_next_event);
+
+/* Called on every timer interrupt, samples once one is due */
+void profile_tick(struct pt_regs *regs)
+{
+    unsigned long offset = regs->epc - prof_start;
+    int cpu = smp_processor_id();
+    u64 now;
+
+    if (!prof_buffer)
+        return;
+
+    now = get_time();
+    if (now < prof_next[cpu])
+        return;
+    prof_next[cpu] = now + prof_interval;
+
+    if (prof_dumping)
+        return;
+
+    prof_samples++;
+    if (user_mode(regs))
+        prof_user++;
+    else if (offset < prof_len << prof_shift)
+        prof_buffer[offset >> prof_shift]++;
+    else
+        prof_other++;
+}
+EXPORT_SYMBOL(profile_tick);
+
+/**
+ * profile_dump - Write the histogram to the console
+ *
+ * Called once the deferred modules are in and again by
+ * kernel_power_off(). Samples keep being counted in between, so the
+ * dump at power off covers the whole run. Symbolize the console log
+ * with scripts/profile, it reads the last dump.
+ */
+void profile_dump(void)
+{
+    struct module *mod;
+    unsigned long i;
+
+    if (!prof_buffer)
+        return;
+
+    prof_dumping = true;
+
+    printk("profile: begin %lx %x %lx %lx %lx %lx\n",
+           prof_hz, prof_shift, prof_start,
+           prof_samples, prof_user, prof_other);
+
+    list_for_each_entry(mod, &modules, list) {
+        printk("profile: module %s %lx %lx %s\n",
+               mod->name, mod->base, mod->size,
+               mod->prelinked ? "prelinked" : "boot");
+    }
+
+    for (i = 0; i < prof_len; i++) {
+        if (prof_buffer[i])
+            printk("profile: hit %lx %x\n",
+                   prof_start + (i << prof_shift), prof_buffer[i]);
+    }
+
+    printk("profile: end\n");
+    console_flush();
+
+    prof_dumping = false;
+}
+EXPORT_SYMBOL(profile_dump);
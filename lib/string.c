@@ -56,47 +56,31 @@ void *memchr(const void *s, int c, size_t n)
 }
 EXPORT_SYMBOL(memchr);
 
-/**
- * memmove - Copy one area of memory to another
- * @dest: Where to copy to
- * @src: Where to copy from
- * @count: The size of the area.
- *
- * Unlike memcpy(), memmove() copes with overlapping areas.
- */
-void *memmove(void *dest, const void *src, size_t count)
-{
-    char *tmp;
-    const char *s;
-
-    if (dest <= src) {
-        tmp = dest;
-        s = src;
-        while (count--)
-            *tmp++ = *s++;
-    } else {
-        tmp = dest;
-        tmp += count;
-        s = src;
-        s += count;
-        while (count--)
-            *--tmp = *--s;
-    }
-    return dest;
-}
-EXPORT_SYMBOL(memmove);
-
 /**
  * strlen - Find the length of a string
  * @s: The string to be sized
  */
 size_t strlen(const char *s)
 {
-    const char *sc;
+    const struct word_at_a_time constants = WORD_AT_A_TIME_CONSTANTS;
+    const unsigned long *p;
+    unsigned long align, c, data;
 
-    for (sc = s; *sc != '\0'; ++sc)
-        /* nothing */;
-    return sc - s;
+    /*
+     * Only aligned words are loaded, so a load never reaches into a
+     * page that the string itself doesn't. The bytes ahead of @s in
+     * the first word are forced non-zero.
+     */
+    align = (unsigned long)s & (sizeof(unsigned long) - 1);
+    p = (const unsigned long *)(s - align);
+    c = read_word_at_a_time(p) | aligned_byte_mask(align);
+
+    while (!has_zero(c, &data, &constants))
+        c = read_word_at_a_time(++p);
+
+    data = prep_zero_mask(c, data, &constants);
+    data = create_zero_mask(data);
+    return (const char *)p - s + find_zero(data);
 }
 EXPORT_SYMBOL(strlen);
 
@@ -166,7 +150,33 @@ int
 strncmp(const char *cs, const char *ct, size_t count)
 {
     unsigned char c1, c2;
+    const struct word_at_a_time constants = WORD_AT_A_TIME_CONSTANTS;
+
+    /* Whole words once both strings reach a word boundary together */
+    if (IS_ALIGNED((unsigned long)cs ^ (unsigned long)ct,
+                   sizeof(unsigned long))) {
+        while (count && *cs == *ct && *cs &&
+               !IS_ALIGNED((unsigned long)cs, sizeof(unsigned long))) {
+            cs++;
+            ct++;
+            count--;
+        }
 
+        while (count >= sizeof(unsigned long) &&
+               IS_ALIGNED((unsigned long)cs, sizeof(unsigned long))) {
+            unsigned long w1 = read_word_at_a_time(cs);
+            unsigned long w2 = read_word_at_a_time(ct);
+            unsigned long data;
+
+            if (w1 != w2 || has_zero(w1, &data, &constants))
+                break;
+            cs += sizeof(unsigned long);
+            ct += sizeof(unsigned long);
+            count -= sizeof(unsigned long);
+        }
+    }
+
+    /* The rest, or the word holding the difference or the NUL */
     while (count) {
         c1 = *cs++;
         c2 = *ct++;
@@ -205,11 +215,30 @@ EXPORT_SYMBOL(strchrnul);
 size_t
 strnlen(const char *s, size_t count)
 {
-    const char *sc;
+    const struct word_at_a_time constants = WORD_AT_A_TIME_CONSTANTS;
+    const unsigned long *p;
+    unsigned long align, c, data;
+    size_t len;
 
-    for (sc = s; count-- && *sc != '\0'; ++sc)
-        /* nothing */;
-    return sc - s;
+    if (!count)
+        return 0;
+
+    /* Aligned loads only, as in strlen() */
+    align = (unsigned long)s & (sizeof(unsigned long) - 1);
+    p = (const unsigned long *)(s - align);
+    c = read_word_at_a_time(p) | aligned_byte_mask(align);
+
+    while (!has_zero(c, &data, &constants)) {
+        p++;
+        if ((size_t)((const char *)p - s) >= count)
+            return count;
+        c = read_word_at_a_time(p);
+    }
+
+    data = prep_zero_mask(c, data, &constants);
+    data = create_zero_mask(data);
+    len = (const char *)p - s + find_zero(data);
+    return len < count ? len : count;
 }
 EXPORT_SYMBOL(strnlen);
 
@@ -293,6 +322,10 @@ EXPORT_SYMBOL(strcpy);
  * 'count' is the user-supplied count (return 'count' if we
  * hit it), 'max' is the address space maximum (and we return
  * -EFAULT if we hit it).
+ *
+ * Bytes are copied until the source is word aligned, so that no
+ * word load can cross into a page the string doesn't reach, then
+ * a word at a time, then the bytes left below 'max'.
  */
 static inline long
 do_strncpy_from_user(char *dst, const char *src,
@@ -301,23 +334,62 @@ do_strncpy_from_user(char *dst, const char *src,
     unsigned long res = 0;
     const struct word_at_a_time constants = WORD_AT_A_TIME_CONSTANTS;
 
+    while (max && !IS_ALIGNED((unsigned long)(src+res),
+                              sizeof(unsigned long))) {
+        char c;
+
+        unsafe_get_user(c, src+res);
+        dst[res] = c;
+        if (!c)
+            return res;
+        res++;
+        max--;
+    }
+
     while (max >= sizeof(unsigned long)) {
         unsigned long c, data;
 
-        /* Fall back to byte-at-a-time if we get a page fault */
         unsafe_get_user(c, (unsigned long *)(src+res));
 
-        *(unsigned long *)(dst+res) = c;
         if (has_zero(c, &data, &constants)) {
             data = prep_zero_mask(c, data, &constants);
             data = create_zero_mask(data);
+            c &= zero_bytemask(data);
+            memcpy(dst+res, &c, sizeof(c));
             return res + find_zero(data);
         }
+
+        if (IS_ALIGNED((unsigned long)(dst+res), sizeof(unsigned long)))
+            *(unsigned long *)(dst+res) = c;
+        else
+            memcpy(dst+res, &c, sizeof(c));
         res += sizeof(unsigned long);
         max -= sizeof(unsigned long);
     }
 
-    panic("%s: !", __func__);
+    while (max) {
+        char c;
+
+        unsafe_get_user(c, src+res);
+        dst[res] = c;
+        if (!c)
+            return res;
+        res++;
+        max--;
+    }
+
+    /*
+     * Uhhuh. We hit 'max'. But was that the user-specified maximum
+     * too? If so, that's ok - we got as much as the user asked for.
+     */
+    if (res >= count)
+        return res;
+
+    /*
+     * Nope: we hit the address space limit, and we still had more
+     * characters the caller would have wanted. That's an EFAULT.
+     */
+    return -EFAULT;
 }
 
 long strncpy_from_user(char *dst, const char *src, long count)
@@ -375,7 +447,9 @@ do_strnlen_user(const char *src, unsigned long count, unsigned long max)
         if (has_zero(c, &data, &constants)) {
             data = prep_zero_mask(c, data, &constants);
             data = create_zero_mask(data);
-            return res + find_zero(data) + 1 - align;
+            res += find_zero(data) + 1 - align;
+            /* The NUL may sit past 'count' in the last word */
+            return res > count ? count + 1 : res;
         }
         res += sizeof(unsigned long);
         /* We already handled 'unsigned long' bytes. Did we do it all ? */
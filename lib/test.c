@@ -1,2 +1,363 @@
 // SPDX-License-Identifier: GPL-2.0-only
 
+#include <printk.h>
+#include <string.h>
+#include <linkage.h>
+#include <uaccess.h>
+
+#include "internal.h"
+
+#define TEST_BUF_SIZE   512
+
+static unsigned char src_buf[TEST_BUF_SIZE];
+static unsigned char dst_buf[TEST_BUF_SIZE];
+
+static void
+fill_pattern(unsigned char *buf, size_t len)
+{
+    size_t i;
+
+    for (i = 0; i < len; i++)
+        buf[i] = (unsigned char)(i * 7 + 3);
+}
+
+/* Both the scalar and the vector paths, at every alignment */
+static int
+test_memcpy(void)
+{
+    size_t len, off;
+
+    fill_pattern(src_buf, TEST_BUF_SIZE);
+
+    for (len = 0; len <= 300; len += 13) {
+        for (off = 0; off < 8; off++) {
+            memset(dst_buf, 0, TEST_BUF_SIZE);
+            memcpy(dst_buf + off, src_buf + 8 - off, len);
+            if (memcmp(dst_buf + off, src_buf + 8 - off, len) ||
+                dst_buf[off + len] != 0) {
+                printk(_RED("memcpy len %lu off %lu failed!\n"), len, off);
+                return -1;
+            }
+        }
+    }
+
+    printk(_GREEN("memcpy okay!\n"));
+    return 0;
+}
+
+static int
+test_memset(void)
+{
+    size_t len, off, i;
+
+    for (len = 0; len <= 300; len += 13) {
+        for (off = 0; off < 8; off++) {
+            memset(dst_buf, 0, TEST_BUF_SIZE);
+            memset(dst_buf + off, 0x5a, len);
+            for (i = 0; i < TEST_BUF_SIZE; i++) {
+                unsigned char c = (i >= off && i < off + len) ? 0x5a : 0;
+                if (dst_buf[i] != c) {
+                    printk(_RED("memset len %lu off %lu failed!\n"),
+                           len, off);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    printk(_GREEN("memset okay!\n"));
+    return 0;
+}
+
+/* Overlapping both ways */
+static int
+test_memmove(void)
+{
+    size_t len, i;
+    int shift;
+
+    for (len = 1; len <= 300; len += 13) {
+        for (shift = -9; shift <= 9; shift += 3) {
+            fill_pattern(dst_buf, TEST_BUF_SIZE);
+            fill_pattern(src_buf, TEST_BUF_SIZE);
+
+            memmove(dst_buf + 100 + shift, dst_buf + 100, len);
+            for (i = 0; i < len; i++) {
+                if (dst_buf[100 + shift + i] != src_buf[100 + i]) {
+                    printk(_RED("memmove len %lu shift %d failed!\n"),
+                           len, shift);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    printk(_GREEN("memmove okay!\n"));
+    return 0;
+}
+
+/* Byte-at-a-time references for the word-at-a-time string functions */
+static size_t
+ref_strnlen(const char *s, size_t count)
+{
+    size_t n = 0;
+
+    while (n < count && s[n])
+        n++;
+    return n;
+}
+
+static int
+ref_strncmp(const char *cs, const char *ct, size_t count)
+{
+    unsigned char c1, c2;
+
+    while (count--) {
+        c1 = *cs++;
+        c2 = *ct++;
+        if (c1 != c2)
+            return c1 < c2 ? -1 : 1;
+        if (!c1)
+            break;
+    }
+    return 0;
+}
+
+/* A string of @len bytes at @off into @buf, with garbage around it */
+static char *
+make_string(unsigned char *buf, size_t off, size_t len)
+{
+    size_t i;
+
+    memset(buf, 0x7f, TEST_BUF_SIZE);
+    fill_pattern(buf + off, len);
+    for (i = 0; i < len; i++) {
+        if (!buf[off + i])
+            buf[off + i] = 1;
+    }
+    buf[off + len] = '\0';
+    return (char *)buf + off;
+}
+
+static int
+test_strlen(void)
+{
+    size_t len, off, count;
+    char *s;
+
+    for (len = 0; len <= 40; len++) {
+        for (off = 0; off < 8; off++) {
+            s = make_string(src_buf, off, len);
+            if (strlen(s) != len) {
+                printk(_RED("strlen len %lu off %lu failed!\n"), len, off);
+                return -1;
+            }
+            for (count = 0; count <= 48; count++) {
+                if (strnlen(s, count) != ref_strnlen(s, count)) {
+                    printk(_RED("strnlen len %lu off %lu count %lu failed!\n"),
+                           len, off, count);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    printk(_GREEN("strlen okay!\n"));
+    return 0;
+}
+
+/* Co-aligned and not, differing at every position */
+static int
+test_strcmp(void)
+{
+    size_t len, off1, off2, count;
+    long diff;
+    char *s1, *s2;
+
+    for (len = 0; len <= 24; len++) {
+        for (off1 = 0; off1 < 8; off1++) {
+            for (off2 = 0; off2 < 8; off2++) {
+                for (diff = -1; diff <= (long)len; diff++) {
+                    s1 = make_string(src_buf, off1, len);
+                    s2 = make_string(dst_buf, off2, len);
+                    if (diff >= 0)
+                        s2[diff] ^= 0x40;
+
+                    if (strcmp(s1, s2) != ref_strncmp(s1, s2, ~0UL)) {
+                        printk(_RED("strcmp len %lu off %lu/%lu failed!\n"),
+                               len, off1, off2);
+                        return -1;
+                    }
+                    for (count = 0; count <= 28; count++) {
+                        if (strncmp(s1, s2, count) !=
+                            ref_strncmp(s1, s2, count)) {
+                            printk(_RED("strncmp len %lu off %lu/%lu "
+                                        "count %lu failed!\n"),
+                                   len, off1, off2, count);
+                            return -1;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    printk(_GREEN("strcmp okay!\n"));
+    return 0;
+}
+
+/* Kernel buffers stand in for user memory under KERNEL_DS */
+static int
+test_user_strings(void)
+{
+    mm_segment_t old_fs = get_fs();
+    size_t len, off1, off2;
+    long count, ret, want;
+    char *s, *d;
+
+    set_fs(KERNEL_DS);
+    for (len = 0; len <= 40; len++) {
+        for (off1 = 0; off1 < 8; off1++) {
+            s = make_string(src_buf, off1, len);
+
+            for (count = 1; count <= 48; count++) {
+                want = len < count ? len + 1 : count + 1;
+                if (strnlen_user(s, count) != want) {
+                    printk(_RED("strnlen_user len %lu off %lu failed!\n"),
+                           len, off1);
+                    goto fail;
+                }
+
+                for (off2 = 0; off2 < 8; off2++) {
+                    memset(dst_buf, 0x7f, TEST_BUF_SIZE);
+                    d = (char *)dst_buf + off2;
+                    ret = strncpy_from_user(d, s, count);
+                    want = len < count ? len : count;
+                    if (ret != want || memcmp(d, s, want) ||
+                        (want < count && d[want]) ||
+                        dst_buf[off2 + count] != 0x7f) {
+                        printk(_RED("strncpy_from_user len %lu off %lu/%lu "
+                                    "count %ld failed!\n"),
+                               len, off1, off2, count);
+                        goto fail;
+                    }
+                }
+            }
+        }
+    }
+    set_fs(old_fs);
+
+    printk(_GREEN("user strings okay!\n"));
+    return 0;
+
+fail:
+    set_fs(old_fs);
+    return -1;
+}
+
+#ifndef CONFIG_HOST
+#define PRINTK_HDR_LEN  ((u32)sizeof(struct printk_log))
+#define PRINTK_REC_MAX  ((u32)LOG_REC_MAX)
+
+static char printk_fill[LOG_REC_MAX];
+
+/*
+ * A record of @size bytes, hidden from the console by its level. The
+ * text of the longest is cut at LOG_LINE_MAX - 1, which still fills it.
+ */
+static void
+printk_record(u32 size)
+{
+    u32 len = size - PRINTK_HDR_LEN;
+
+    memset(printk_fill, '-', len);
+    printk_fill[len] = '\0';
+    printk(KERN_DEBUG "%s", printk_fill);
+}
+
+/*
+ * Leave @gap bytes at the end of the log buffer, too few for a
+ * padding record, and see the next record wrap around to the start.
+ */
+static int
+test_printk_gap(u32 gap)
+{
+    u32 room, d, size;
+    int loglevel = console_loglevel;
+
+    console_loglevel = LOGLEVEL_DEBUG;
+    while ((room = printk_log_room()) != gap) {
+        if (room < PRINTK_REC_MAX) {
+            size = PRINTK_HDR_LEN;  /* wraps */
+        } else if (room <= PRINTK_REC_MAX + gap) {
+            size = room - gap;
+        } else {
+            d = room - PRINTK_REC_MAX;
+            if (d < PRINTK_HDR_LEN)
+                size = PRINTK_HDR_LEN;
+            else if (d <= PRINTK_REC_MAX)
+                size = d;
+            else if (d - PRINTK_REC_MAX >= PRINTK_HDR_LEN)
+                size = PRINTK_REC_MAX;
+            else
+                size = PRINTK_REC_MAX / 2;
+        }
+        printk_record(size);
+    }
+
+    printk_record(PRINTK_HDR_LEN + 8);
+    room = printk_log_room();
+    console_flush();
+    console_loglevel = loglevel;
+
+    if (room != LOG_BUF_LEN - PRINTK_HDR_LEN - 8) {
+        printk(_RED("printk gap %u: next record at %lu failed!\n"),
+               gap, LOG_BUF_LEN - room);
+        return -1;
+    }
+    return 0;
+}
+
+static int
+test_printk_wrap(void)
+{
+    if (test_printk_gap(8) || test_printk_gap(16))
+        return -1;
+
+    printk(_GREEN("printk wrap okay!\n"));
+    return 0;
+}
+#endif /* CONFIG_HOST */
+
+static int __init
+init_module(void)
+{
+    printk("module[test_lib]: init begin ...\n");
+
+    if (test_memcpy())
+        return -1;
+
+    if (test_memset())
+        return -1;
+
+    if (test_memmove())
+        return -1;
+
+    if (test_strlen())
+        return -1;
+
+    if (test_strcmp())
+        return -1;
+
+    if (test_user_strings())
+        return -1;
+
+#ifndef CONFIG_HOST
+    /* The host build writes printk straight out, there is no ring */
+    if (test_printk_wrap())
+        return -1;
+#endif
+
+    printk("module[test_lib]: init end!\n");
+    return 0;
+}
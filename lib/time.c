@@ -1,8 +1,13 @@
 // SPDX-License-Identifier: GPL-2.0
 
+#include <timex.h>
 #include <export.h>
 #include <jiffies.h>
 
+/* That of QEMU virt until early_dt reads timebase-frequency */
+unsigned long riscv_timebase = 10000000;
+EXPORT_SYMBOL(riscv_timebase);
+
 unsigned long __msecs_to_jiffies(const unsigned int m)
 {
     /*
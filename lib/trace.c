@@ -0,0 +1,212 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <list.h>
+#include <errno.h>
+#include <export.h>
+#include <printk.h>
+#include <string.h>
+#include <tracepoint.h>
+
+/*
+ * Dump stream, written as hex on "trace: " console lines. Each event
+ * with records gives a header, its name and format strings with their
+ * NULs and then the records, oldest first. A header with an empty
+ * name ends the stream.
+ *
+ * scripts/tracedump.c has its own copy of the header, keep both in
+ * sync and bump TRACE_DUMP_MAGIC on any change.
+ */
+#define TRACE_DUMP_MAGIC    "XLTRACE1"
+#define TRACE_DUMP_SMAGIC   8
+#define TRACE_DUMP_LINE     32
+
+struct trace_dump_header {
+    char magic[TRACE_DUMP_SMAGIC];
+    u32 record_size;
+    u32 nr_records;
+    u32 name_len;
+    u32 format_len;
+};
+
+struct trace_dump_line {
+    unsigned char buf[TRACE_DUMP_LINE];
+    unsigned int len;
+};
+
+static LIST_HEAD(trace_events);
+
+/* Events named by "trace_event=" get enabled once they register */
+static char trace_boot_events[COMMAND_LINE_SIZE];
+
+static bool
+trace_boot_listed(const char *name)
+{
+    size_t len = strlen(name);
+    const char *s = trace_boot_events;
+
+    while (*s) {
+        if (!strncmp(s, name, len) && (s[len] == ',' || s[len] == 0))
+            return true;
+        s = strchrnul(s, ',');
+        if (*s)
+            s++;
+    }
+    return false;
+}
+
+static struct trace_event *
+find_trace_event(const char *name)
+{
+    struct trace_event *event;
+
+    list_for_each_entry(event, &trace_events, list) {
+        if (!strcmp(event->name, name))
+            return event;
+    }
+    return NULL;
+}
+
+void trace_event_register(struct trace_event *event)
+{
+    list_add_tail(&event->list, &trace_events);
+
+    if (trace_boot_listed(event->name))
+        static_key_enable(&event->key);
+}
+EXPORT_SYMBOL(trace_event_register);
+
+int trace_event_enable(const char *name)
+{
+    struct trace_event *event = find_trace_event(name);
+
+    if (!event)
+        return -ENOENT;
+    if (!static_key_enabled(&event->key))
+        static_key_enable(&event->key);
+    return 0;
+}
+EXPORT_SYMBOL(trace_event_enable);
+
+int trace_event_disable(const char *name)
+{
+    struct trace_event *event = find_trace_event(name);
+
+    if (!event)
+        return -ENOENT;
+    if (static_key_enabled(&event->key))
+        static_key_disable(&event->key);
+    return 0;
+}
+EXPORT_SYMBOL(trace_event_disable);
+
+int
+trace_event_setup(char *param, char *value)
+{
+    if (!value)
+        return 0;
+
+    strlcpy(trace_boot_events, value, sizeof(trace_boot_events));
+    return 1;
+}
+EXPORT_SYMBOL(trace_event_setup);
+
+static void
+dump_flush(struct trace_dump_line *line)
+{
+    static const char hex[] = "0123456789abcdef";
+    char text[TRACE_DUMP_LINE * 2 + 1];
+    unsigned int i;
+
+    if (!line->len)
+        return;
+
+    for (i = 0; i < line->len; i++) {
+        text[i * 2] = hex[line->buf[i] >> 4];
+        text[i * 2 + 1] = hex[line->buf[i] & 0xf];
+    }
+    text[i * 2] = 0;
+    printk("trace: %s\n", text);
+    line->len = 0;
+}
+
+static void
+dump_bytes(struct trace_dump_line *line, const void *data, size_t len)
+{
+    const unsigned char *p = data;
+    size_t n;
+
+    while (len) {
+        n = min_t(size_t, len, TRACE_DUMP_LINE - line->len);
+        memcpy(line->buf + line->len, p, n);
+        line->len += n;
+        p += n;
+        len -= n;
+        if (line->len == TRACE_DUMP_LINE)
+            dump_flush(line);
+    }
+}
+
+static void
+dump_event(struct trace_dump_line *line, struct trace_event *event)
+{
+    struct trace_dump_header hdr;
+    u64 head = atomic64_read(&event->head);
+    u64 start;
+
+    if (!head)
+        return;
+
+    start = head > TRACE_RING_RECORDS ? head - TRACE_RING_RECORDS : 0;
+
+    memcpy(hdr.magic, TRACE_DUMP_MAGIC, TRACE_DUMP_SMAGIC);
+    hdr.record_size = event->record_size;
+    hdr.nr_records = head - start;
+    hdr.name_len = strlen(event->name) + 1;
+    hdr.format_len = strlen(event->format) + 1;
+
+    dump_bytes(line, &hdr, sizeof(hdr));
+    dump_bytes(line, event->name, hdr.name_len);
+    dump_bytes(line, event->format, hdr.format_len);
+    for (; start < head; start++) {
+        dump_bytes(line, event->ring +
+                   (start & (TRACE_RING_RECORDS - 1)) * event->record_size,
+                   event->record_size);
+    }
+}
+
+/**
+ * trace_dump - Write the rings of all events to the console
+ *
+ * Records are dropped meanwhile, so the dump doesn't trace itself and
+ * reads rings that stand still. The keys stay as they are, the events
+ * record again right after. Decode the console log with
+ * scripts/tracedump on the host.
+ */
+void trace_dump(void)
+{
+    struct trace_dump_line line = { .len = 0 };
+    struct trace_dump_header end;
+    struct trace_event *event;
+    bool any = false;
+
+    list_for_each_entry(event, &trace_events, list) {
+        WRITE_ONCE(event->dumping, true);
+        if (atomic64_read(&event->head))
+            any = true;
+    }
+
+    if (any) {
+        list_for_each_entry(event, &trace_events, list)
+            dump_event(&line, event);
+
+        memset(&end, 0, sizeof(end));
+        memcpy(end.magic, TRACE_DUMP_MAGIC, TRACE_DUMP_SMAGIC);
+        dump_bytes(&line, &end, sizeof(end));
+        dump_flush(&line);
+        console_flush();
+    }
+
+    list_for_each_entry(event, &trace_events, list)
+        WRITE_ONCE(event->dumping, false);
+}
+EXPORT_SYMBOL(trace_dump);
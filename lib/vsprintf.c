@@ -168,6 +168,9 @@ format_decode(const char *fmt, struct printf_spec *spec)
     /* skip '%' */
     fmt++;
 
+    /* SIGN of a %d went on to the next %u */
+    spec->flags = 0;
+
     /* get the precision */
     spec->precision = -1;
 
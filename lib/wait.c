@@ -0,0 +1,187 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Generic waiting primitives.
+ */
+
+#include <wait.h>
+#include <export.h>
+#include <irqflags.h>
+
+void add_wait_queue(struct wait_queue_head *wq_head,
+                    struct wait_queue_entry *wq_entry)
+{
+    unsigned long flags;
+
+    wq_entry->flags &= ~WQ_FLAG_EXCLUSIVE;
+    local_irq_save(flags);
+    list_add(&wq_entry->entry, &wq_head->head);
+    local_irq_restore(flags);
+}
+EXPORT_SYMBOL(add_wait_queue);
+
+void add_wait_queue_exclusive(struct wait_queue_head *wq_head,
+                              struct wait_queue_entry *wq_entry)
+{
+    unsigned long flags;
+
+    wq_entry->flags |= WQ_FLAG_EXCLUSIVE;
+    local_irq_save(flags);
+    list_add_tail(&wq_entry->entry, &wq_head->head);
+    local_irq_restore(flags);
+}
+EXPORT_SYMBOL(add_wait_queue_exclusive);
+
+void remove_wait_queue(struct wait_queue_head *wq_head,
+                       struct wait_queue_entry *wq_entry)
+{
+    unsigned long flags;
+
+    local_irq_save(flags);
+    list_del(&wq_entry->entry);
+    local_irq_restore(flags);
+}
+EXPORT_SYMBOL(remove_wait_queue);
+
+/*
+ * The core wakeup function. Non-exclusive wakeups (nr_exclusive == 0) just
+ * wake everything up. If it's an exclusive wakeup (nr_exclusive == small
+ * +ve number) then we wake that number of exclusive tasks, and potentially
+ * all the non-exclusive tasks. Normally, exclusive tasks will be at the end
+ * of the list and any non-exclusive tasks will be woken first. A priority
+ * task may be at the head of the list, and can consume the event without
+ * any other tasks being woken.
+ */
+static void
+__wake_up_common(struct wait_queue_head *wq_head, unsigned int mode,
+                 int nr_exclusive, int wake_flags, void *key)
+{
+    struct wait_queue_entry *curr, *next;
+    unsigned flags;
+    int ret;
+
+    list_for_each_entry_safe(curr, next, &wq_head->head, entry) {
+        flags = curr->flags;
+        ret = curr->func(curr, mode, wake_flags, key);
+        if (ret < 0)
+            break;
+        if (ret && (flags & WQ_FLAG_EXCLUSIVE) && !--nr_exclusive)
+            break;
+    }
+}
+
+/**
+ * __wake_up - wake up threads blocked on a waitqueue.
+ * @wq_head: the waitqueue
+ * @mode: which threads
+ * @nr_exclusive: how many wake-one or wake-many threads to wake up
+ * @key: is directly passed to the wakeup function
+ *
+ * May be called from an interrupt handler, such as the completion
+ * of a request.
+ */
+void __wake_up(struct wait_queue_head *wq_head, unsigned int mode,
+               int nr_exclusive, void *key)
+{
+    unsigned long flags;
+
+    local_irq_save(flags);
+    __wake_up_common(wq_head, mode, nr_exclusive, 0, key);
+    local_irq_restore(flags);
+}
+EXPORT_SYMBOL(__wake_up);
+
+/*
+ * Note: we use "set_current_state()" _after_ the wait-queue add,
+ * because we need a memory barrier there on SMP, so that any
+ * wake-function that tests for the wait-queue being active
+ * will be guaranteed to see waitqueue addition _or_ subsequent
+ * tests in this thread will see the wakeup having taken place.
+ *
+ * The spin_unlock() itself is semi-permeable and only protects
+ * one way (it only protects stuff inside the critical region and
+ * stops them from bleeding out - it would still allow subsequent
+ * loads to move into the critical region).
+ */
+void prepare_to_wait(struct wait_queue_head *wq_head,
+                     struct wait_queue_entry *wq_entry, int state)
+{
+    unsigned long flags;
+
+    wq_entry->flags &= ~WQ_FLAG_EXCLUSIVE;
+    local_irq_save(flags);
+    if (list_empty(&wq_entry->entry))
+        list_add(&wq_entry->entry, &wq_head->head);
+    set_current_state(state);
+    local_irq_restore(flags);
+}
+EXPORT_SYMBOL(prepare_to_wait);
+
+void prepare_to_wait_exclusive(struct wait_queue_head *wq_head,
+                               struct wait_queue_entry *wq_entry, int state)
+{
+    unsigned long flags;
+
+    wq_entry->flags |= WQ_FLAG_EXCLUSIVE;
+    local_irq_save(flags);
+    if (list_empty(&wq_entry->entry))
+        list_add_tail(&wq_entry->entry, &wq_head->head);
+    set_current_state(state);
+    local_irq_restore(flags);
+}
+EXPORT_SYMBOL(prepare_to_wait_exclusive);
+
+void init_wait_entry(struct wait_queue_entry *wq_entry, int flags)
+{
+    wq_entry->flags = flags;
+    wq_entry->private = current;
+    wq_entry->func = autoremove_wake_function;
+    INIT_LIST_HEAD(&wq_entry->entry);
+}
+EXPORT_SYMBOL(init_wait_entry);
+
+/**
+ * finish_wait - clean up after waiting in a queue
+ * @wq_head: waitqueue waited on
+ * @wq_entry: wait descriptor
+ *
+ * Sets current thread back to running state and removes
+ * the wait descriptor from the given waitqueue if still
+ * queued.
+ */
+void finish_wait(struct wait_queue_head *wq_head,
+                 struct wait_queue_entry *wq_entry)
+{
+    unsigned long flags;
+
+    __set_current_state(TASK_RUNNING);
+
+    /*
+     * The entry is off the list already when autoremove_wake_function()
+     * woke us, only take the interrupts off if it is still queued.
+     */
+    if (!list_empty_careful(&wq_entry->entry)) {
+        local_irq_save(flags);
+        list_del_init(&wq_entry->entry);
+        local_irq_restore(flags);
+    }
+}
+EXPORT_SYMBOL(finish_wait);
+
+int default_wake_function(struct wait_queue_entry *wq_entry,
+                          unsigned mode, int flags, void *key)
+{
+    return try_to_wake_up(wq_entry->private, mode, flags);
+}
+EXPORT_SYMBOL(default_wake_function);
+
+int autoremove_wake_function(struct wait_queue_entry *wq_entry,
+                             unsigned mode, int sync, void *key)
+{
+    int ret = default_wake_function(wq_entry, mode, sync, key);
+
+    if (ret)
+        list_del_init(&wq_entry->entry);
+
+    return ret;
+}
+EXPORT_SYMBOL(autoremove_wake_function);
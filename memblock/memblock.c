@@ -11,6 +11,8 @@
 #include <printk.h>
 #include <memblock.h>
 #include <mmzone.h>
+#include <module.h>
+#include <linkage.h>
 
 #define INIT_MEMBLOCK_REGIONS           128
 #define INIT_MEMBLOCK_RESERVED_REGIONS  INIT_MEMBLOCK_REGIONS
@@ -596,7 +598,7 @@ __next_mem_range(u64 *idx,
     *idx = ULLONG_MAX;
 }
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[memblock]: init begin ...\n");
@@ -605,6 +607,9 @@ init_module(void)
         memblock_add(dt_memory_base, dt_memory_size);
 
     memblock_reserve(kernel_start, kernel_size);
+    if (modules_init_end > modules_init_start)
+        memblock_reserve(__pa(modules_init_start),
+                         modules_init_end - modules_init_start);
 
     setup_vm_final(memblock.memory.regions,
                    memblock.memory.cnt,
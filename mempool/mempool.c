@@ -4,6 +4,7 @@
 #include <export.h>
 #include <printk.h>
 #include <mempool.h>
+#include <linkage.h>
 
 /*
  * A commonly used alloc and free fn.
@@ -80,7 +81,7 @@ int mempool_init(mempool_t *pool, int min_nr, mempool_alloc_t *alloc_fn,
 }
 EXPORT_SYMBOL(mempool_init);
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[mempool]: init begin ...\n");
@@ -11,6 +11,7 @@
 #include <current.h>
 #include <pgtable.h>
 #include <mm_types.h>
+#include <linkage.h>
 
 void init_mprotect(void);
 
@@ -237,7 +238,7 @@ void _do_page_fault(struct pt_regs *regs)
     return;
 }
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[mm]: init begin ...\n");
@@ -158,6 +158,63 @@ int insert_vm_struct(struct mm_struct *mm, struct vm_area_struct *vma)
 }
 EXPORT_SYMBOL(insert_vm_struct);
 
+static vm_fault_t special_mapping_fault(struct vm_fault *vmf)
+{
+    const struct vm_special_mapping *sm = vmf->vma->vm_private_data;
+    struct page **pages = sm->pages;
+    pgoff_t pgoff = vmf->pgoff;
+
+    for (; pgoff && *pages; ++pages)
+        pgoff--;
+
+    /* The pages live as long as the kernel, no reference to take */
+    if (*pages) {
+        vmf->page = *pages;
+        return 0;
+    }
+
+    return VM_FAULT_SIGBUS;
+}
+
+static const struct vm_operations_struct special_mapping_vmops = {
+    .fault = special_mapping_fault,
+};
+
+/*
+ * Called with mm->mmap_lock held for writing.
+ * Insert a new vma covering the given region, with the given flags.
+ * Its pages are supplied by the given array of struct page *.
+ * The region past the last page supplied will always produce SIGBUS.
+ */
+struct vm_area_struct *
+_install_special_mapping(struct mm_struct *mm,
+                         unsigned long addr, unsigned long len,
+                         unsigned long vm_flags,
+                         const struct vm_special_mapping *spec)
+{
+    struct vm_area_struct *vma;
+
+    vma = vm_area_alloc(mm);
+    if (unlikely(vma == NULL))
+        return ERR_PTR(-ENOMEM);
+
+    vma->vm_start = addr;
+    vma->vm_end = addr + len;
+
+    vma->vm_flags = vm_flags | mm->def_flags | VM_DONTEXPAND;
+    vma->vm_page_prot = vm_get_page_prot(vma->vm_flags);
+
+    vma->vm_ops = &special_mapping_vmops;
+    vma->vm_private_data = (void *)spec;
+
+    if (insert_vm_struct(mm, vma))
+        return ERR_PTR(-ENOMEM);
+
+    mm->total_vm += len >> PAGE_SHIFT;
+    return vma;
+}
+EXPORT_SYMBOL(_install_special_mapping);
+
 /* Look up the first VMA which satisfies  addr < vm_end,  NULL if none. */
 struct vm_area_struct *
 find_vma(struct mm_struct *mm, unsigned long addr)
@@ -278,6 +335,7 @@ get_unmapped_area(struct file *file, unsigned long addr, unsigned long len,
 
     return addr;
 }
+EXPORT_SYMBOL(get_unmapped_area);
 
 static inline u64
 file_mmap_size_max(struct file *file, struct inode *inode)
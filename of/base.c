@@ -202,6 +202,27 @@ of_device_is_available(const struct device_node *device)
 }
 EXPORT_SYMBOL(of_device_is_available);
 
+/*
+ * Find the hart ID of the CPU node above @node, such as the one of
+ * its "riscv,cpu-intc". Returns -1 if there is none.
+ */
+int riscv_of_parent_hartid(struct device_node *node)
+{
+    u32 hartid;
+
+    for (; node; node = node->parent) {
+        if (!__of_node_is_type(node, "cpu"))
+            continue;
+
+        if (of_property_read_u32(node, "reg", &hartid))
+            return -1;
+        return hartid;
+    }
+
+    return -1;
+}
+EXPORT_SYMBOL(riscv_of_parent_hartid);
+
 int
 of_phandle_iterator_args(struct of_phandle_iterator *it,
                          uint32_t *args, int size)
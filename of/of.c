@@ -8,6 +8,7 @@
 #include <export.h>
 #include <string.h>
 #include <mod_devicetable.h>
+#include <linkage.h>
 
 struct device_node *of_aliases;
 struct device_node *of_chosen;
@@ -597,7 +598,7 @@ const void *of_device_get_match_data(const struct device *dev)
 }
 EXPORT_SYMBOL(of_device_get_match_data);
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[of]: init begin ...\n");
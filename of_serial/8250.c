@@ -6,12 +6,15 @@
 #include <errno.h>
 #include <major.h>
 #include <config.h>
+#include <of_irq.h>
+#include <barrier.h>
 #include <device.h>
 #include <export.h>
 #include <printk.h>
 #include <serial.h>
 #include <console.h>
 #include <platform.h>
+#include <linkage.h>
 
 #define UART_NR CONFIG_SERIAL_8250_NR_UARTS
 
@@ -60,6 +63,19 @@ univ8250_console_setup(struct console *co, char *options)
     return retval;
 }
 
+/*
+ * Once the port is set up, printk drains straight to the UART's FIFO
+ * instead of going through SBI one ecall per character.
+ */
+static void
+univ8250_console_write(struct console *co, const char *s,
+                       unsigned int count)
+{
+    struct uart_8250_port *up = &serial8250_ports[co->index];
+
+    serial8250_console_write(up, s, count);
+}
+
 static struct uart_driver serial8250_reg;
 
 struct tty_driver *uart_console_device(struct console *co, int *index)
@@ -72,6 +88,7 @@ EXPORT_SYMBOL(uart_console_device);
 
 static struct console univ8250_console = {
     .name   = "ttyS",
+    .write  = univ8250_console_write,
     .device = uart_console_device,
     .setup  = univ8250_console_setup,
     .match  = univ8250_console_match,
@@ -268,7 +285,6 @@ of_platform_serial_setup(struct platform_device *ofdev,
                          struct of_serial_info *info)
 {
     int ret;
-    int irq;
     struct resource resource;
     struct uart_port *port = &up->port;
     struct device_node *np = ofdev->dev.of_node;
@@ -291,6 +307,9 @@ of_platform_serial_setup(struct platform_device *ofdev,
         port->flags |= UPF_IOREMAP;
     }
 
+    /* Without an irq the xmit ring is drained by polling */
+    port->irq = irq_of_parse_and_map(np, 0);
+
     port->type = type;
     return 0;
 }
@@ -404,6 +423,18 @@ static int uart_write_room(struct tty_struct *tty)
     panic("%s: !", __func__);
 }
 
+/*
+ * This routine is used by the interrupt handler to schedule processing in
+ * the software interrupt portion of the driver.
+ */
+void uart_write_wakeup(struct uart_port *port)
+{
+    struct tty_struct *tty = port->state->port.tty;
+
+    if (tty)
+        tty_wakeup(tty);
+}
+
 static void __uart_start(struct tty_struct *tty)
 {
     struct uart_state *state = tty->driver_data;
@@ -441,6 +472,8 @@ uart_write(struct tty_struct *tty, const unsigned char *buf, int count)
         if (c <= 0)
             break;
         memcpy(circ->buf + circ->head, buf, c);
+        /* The THRE interrupt may pick the bytes up as soon as head moves */
+        smp_wmb();
         circ->head = (circ->head + c) & (UART_XMIT_SIZE - 1);
         buf += c;
         count -= c;
@@ -581,7 +614,7 @@ static void serial8250_init(void)
         panic("bad driver!");
 }
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[of_serial]: init begin ...\n");
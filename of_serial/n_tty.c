@@ -9,8 +9,11 @@ n_tty_write(struct tty_struct *tty, struct file *file,
     int c;
     ssize_t retval = 0;
     const unsigned char *b = buf;
+    DEFINE_WAIT(wait);
 
+    /* Sleep while the xmit ring is full, the tx interrupt wakes us */
     while (1) {
+        prepare_to_wait(&tty->write_wait, &wait, TASK_UNINTERRUPTIBLE);
         while (nr > 0) {
             c = tty->ops->write(tty, b, nr);
             if (c < 0)
@@ -24,7 +27,9 @@ n_tty_write(struct tty_struct *tty, struct file *file,
         }
         if (!nr)
             break;
+        schedule();
     }
+    finish_wait(&tty->write_wait, &wait);
     return (b - buf) ? b - buf : retval;
 }
 
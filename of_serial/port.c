@@ -7,12 +7,88 @@
 #include <ioport.h>
 #include <serial.h>
 #include <ioremap.h>
+#include <irqflags.h>
+#include <interrupt.h>
 
+/*
+ * Here we define the default xmit fifo size used for each type of UART.
+ */
+static const struct serial8250_config uart_config[] = {
+    [PORT_UNKNOWN] = {
+        .name       = "unknown",
+        .fifo_size  = 1,
+        .tx_loadsz  = 1,
+    },
+    [PORT_8250] = {
+        .name       = "8250",
+        .fifo_size  = 1,
+        .tx_loadsz  = 1,
+    },
+    [PORT_16450] = {
+        .name       = "16450",
+        .fifo_size  = 1,
+        .tx_loadsz  = 1,
+    },
+    [PORT_16550] = {
+        .name       = "16550",
+        .fifo_size  = 1,
+        .tx_loadsz  = 1,
+    },
+    [PORT_16550A] = {
+        .name       = "16550A",
+        .fifo_size  = 16,
+        .tx_loadsz  = 16,
+    },
+};
+
+static void wait_for_xmitr(struct uart_8250_port *up, int bits)
+{
+    while ((serial_in(up, UART_LSR) & bits) != bits)
+        ;
+}
+
+/*
+ * Print a string to the serial port by polling, a FIFO load at a time.
+ * The tx interrupt is masked meanwhile, so tty output queued in the
+ * xmit ring carries on from where it was afterwards. Interrupts are
+ * off throughout, else __start_tx() or __stop_tx() in between would
+ * change up->ier and the end would put back a stale mask.
+ */
 void
 serial8250_console_write(struct uart_8250_port *up,
                          const char *s, unsigned int count)
 {
-    panic("%s: !", __func__);
+    unsigned int fifo;
+    unsigned long flags;
+
+    if (!up->tx_loadsz)
+        up->tx_loadsz = uart_config[up->port.type].tx_loadsz;
+
+    local_irq_save(flags);
+    serial_out(up, UART_IER, 0);
+
+    fifo = 0;
+    while (count) {
+        if (!fifo) {
+            wait_for_xmitr(up, UART_LSR_THRE);
+            fifo = up->tx_loadsz;
+        }
+        if (*s == '\n') {
+            serial_out(up, UART_TX, '\r');
+            if (!--fifo) {
+                wait_for_xmitr(up, UART_LSR_THRE);
+                fifo = up->tx_loadsz;
+            }
+        }
+        serial_out(up, UART_TX, *s++);
+        fifo--;
+        count--;
+    }
+
+    /* Let the last bytes out before giving the transmitter back */
+    wait_for_xmitr(up, UART_LSR_TEMT | UART_LSR_THRE);
+    serial_out(up, UART_IER, up->ier);
+    local_irq_restore(flags);
 }
 
 int
@@ -20,6 +96,7 @@ serial8250_console_setup(struct uart_port *port, char *options,
                          bool probe)
 {
     int ret;
+    struct uart_8250_port *up = up_to_u8250p(port);
     int baud = 9600;
     int bits = 8;
     int parity = 'n';
@@ -37,6 +114,13 @@ serial8250_console_setup(struct uart_port *port, char *options,
     if (ret)
         return ret;
 
+    /* The console writes a FIFO load at a time from now on */
+    if (!up->tx_loadsz)
+        up->tx_loadsz = uart_config[port->type].tx_loadsz;
+    if (uart_config[port->type].fifo_size > 1)
+        serial_out(up, UART_FCR, UART_FCR_ENABLE_FIFO |
+                   UART_FCR_CLEAR_RCVR | UART_FCR_CLEAR_XMIT);
+
     return 0;
 }
 
@@ -132,39 +216,73 @@ static void serial8250_config_port(struct uart_port *port, int flags)
     printk("%s: 2 ret(%d)\n", __func__, ret);
 }
 
+static inline void __stop_tx(struct uart_8250_port *up)
+{
+    if (up->ier & UART_IER_THRI) {
+        up->ier &= ~UART_IER_THRI;
+        serial_out(up, UART_IER, up->ier);
+    }
+}
+
+static void serial8250_stop_tx(struct uart_port *port)
+{
+    __stop_tx(up_to_u8250p(port));
+}
+
 /*
- * Here we define the default xmit fifo size used for each type of UART.
+ * Called with THRE set, so the whole FIFO is free: fill it from the
+ * xmit ring and let the next THRE interrupt come back for more.
  */
-static const struct serial8250_config uart_config[] = {
-    [PORT_UNKNOWN] = {
-        .name       = "unknown",
-        .fifo_size  = 1,
-        .tx_loadsz  = 1,
-    },
-    [PORT_8250] = {
-        .name       = "8250",
-        .fifo_size  = 1,
-        .tx_loadsz  = 1,
-    },
-    [PORT_16450] = {
-        .name       = "16450",
-        .fifo_size  = 1,
-        .tx_loadsz  = 1,
-    },
-    [PORT_16550] = {
-        .name       = "16550",
-        .fifo_size  = 1,
-        .tx_loadsz  = 1,
-    },
-    [PORT_16550A] = {
-        .name       = "16550A",
-        .fifo_size  = 16,
-        .tx_loadsz  = 16,
-    },
-};
+void serial8250_tx_chars(struct uart_8250_port *up)
+{
+    int count;
+    struct uart_port *port = &up->port;
+    struct circ_buf *xmit = &port->state->xmit;
+
+    for (;;) {
+        if (uart_circ_empty(xmit)) {
+            __stop_tx(up);
+            return;
+        }
+
+        count = up->tx_loadsz;
+        do {
+            serial_out(up, UART_TX, xmit->buf[xmit->tail]);
+            xmit->tail = (xmit->tail + 1) & (UART_XMIT_SIZE - 1);
+            if (uart_circ_empty(xmit))
+                break;
+        } while (--count > 0);
+
+        if (uart_circ_chars_pending(xmit) < WAKEUP_CHARS)
+            uart_write_wakeup(port);
+
+        if (port->irq)
+            return;
+
+        /* No interrupt to come back with, poll for the next THRE */
+        wait_for_xmitr(up, UART_LSR_THRE);
+    }
+}
+
+static irqreturn_t serial8250_interrupt(int irq, void *dev_id)
+{
+    unsigned char lsr;
+    struct uart_8250_port *up = dev_id;
+
+    if (serial_in(up, UART_IIR) & UART_IIR_NO_INT)
+        return IRQ_NONE;
+
+    lsr = serial_in(up, UART_LSR);
+    up->lsr_saved_flags |= lsr & LSR_SAVE_FLAGS;
+    if (lsr & UART_LSR_THRE)
+        serial8250_tx_chars(up);
+
+    return IRQ_HANDLED;
+}
 
 int serial8250_do_startup(struct uart_port *port)
 {
+    int ret;
     struct uart_8250_port *up = up_to_u8250p(port);
 
     printk("%s: 1 port(%d) tx_loadsz(%d)!\n",
@@ -175,7 +293,24 @@ int serial8250_do_startup(struct uart_port *port)
     if (port->iotype != up->cur_iotype)
         set_io_from_upio(port);
 
-    printk("%s: 2 tx_loadsz(%d)!\n", __func__, up->tx_loadsz);
+    /* Clear and enable the FIFOs so that a THRE can take a full load */
+    if (uart_config[port->type].fifo_size > 1)
+        serial_out(up, UART_FCR, UART_FCR_ENABLE_FIFO |
+                   UART_FCR_CLEAR_RCVR | UART_FCR_CLEAR_XMIT);
+
+    /* The tx interrupt stays masked until there is something to send */
+    up->ier = 0;
+    serial_out(up, UART_IER, 0);
+
+    if (port->irq) {
+        ret = request_irq(port->irq, serial8250_interrupt, IRQF_SHARED,
+                          "serial", up);
+        if (ret)
+            return ret;
+    }
+
+    printk("%s: 2 tx_loadsz(%d) irq(%u)!\n",
+           __func__, up->tx_loadsz, port->irq);
     return 0;
 }
 
@@ -186,34 +321,25 @@ static int serial8250_startup(struct uart_port *port)
     return serial8250_do_startup(port);
 }
 
-void serial8250_tx_chars(struct uart_8250_port *up)
-{
-    int count;
-    struct uart_port *port = &up->port;
-    struct circ_buf *xmit = &port->state->xmit;
-
-    if (uart_circ_empty(xmit))
-        return;
-
-    count = up->tx_loadsz;
-    printk("%s: send count(%d) ...\n", __func__, count);
-    do {
-        serial_out(up, UART_TX, xmit->buf[xmit->tail]);
-        xmit->tail = (xmit->tail + 1) & (UART_XMIT_SIZE - 1);
-        if (uart_circ_empty(xmit))
-            break;
-    } while (--count > 0);
-}
-
 static inline void __start_tx(struct uart_port *port)
 {
     unsigned char lsr;
+    unsigned long flags;
     struct uart_8250_port *up = up_to_u8250p(port);
 
+    /* The THRE interrupt must not come in while we fill the FIFO */
+    local_irq_save(flags);
+    if (port->irq && !(up->ier & UART_IER_THRI)) {
+        up->ier |= UART_IER_THRI;
+        serial_out(up, UART_IER, up->ier);
+    }
+
+    /* Kick off the first load, the THRE interrupt does the rest */
     lsr = serial_in(up, UART_LSR);
     up->lsr_saved_flags |= lsr & LSR_SAVE_FLAGS;
     if (lsr & UART_LSR_THRE)
         serial8250_tx_chars(up);
+    local_irq_restore(flags);
 }
 
 static void serial8250_start_tx(struct uart_port *port)
@@ -222,6 +348,7 @@ static void serial8250_start_tx(struct uart_port *port)
 }
 
 static const struct uart_ops serial8250_pops = {
+    .stop_tx        = serial8250_stop_tx,
     .start_tx       = serial8250_start_tx,
     .startup        = serial8250_startup,
     .config_port    = serial8250_config_port,
@@ -250,6 +377,10 @@ void tty_port_tty_set(struct tty_port *port, struct tty_struct *tty)
 }
 EXPORT_SYMBOL(tty_port_tty_set);
 
+/*
+ * There are no modem lines, the port is always ready, as with CLOCAL.
+ * Nothing to wait for on port open.
+ */
 int
 tty_port_block_til_ready(struct tty_port *port,
                          struct tty_struct *tty, struct file *filp)
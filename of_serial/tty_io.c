@@ -77,6 +77,7 @@ struct tty_struct *alloc_tty_struct(struct tty_driver *driver, int idx)
         panic("init ldisc error!");
 
     INIT_LIST_HEAD(&tty->tty_files);
+    init_waitqueue_head(&tty->write_wait);
 
     tty->driver = driver;
     tty->ops = driver->ops;
@@ -138,6 +139,20 @@ tty_open_by_driver(dev_t device, struct file *filp)
     return tty;
 }
 
+/**
+ *  tty_wakeup  -   request more data
+ *  @tty: terminal
+ *
+ *  Internal and external helper for wakeups of tty. This function
+ *  informs the line discipline if present that the driver is ready
+ *  to receive more output data.
+ */
+void tty_wakeup(struct tty_struct *tty)
+{
+    wake_up(&tty->write_wait);
+}
+EXPORT_SYMBOL(tty_wakeup);
+
 /* Associate a new file with the tty structure */
 void tty_add_file(struct tty_struct *tty, struct file *file)
 {
@@ -11,6 +11,10 @@
 #include <pgalloc.h>
 #include <pgtable.h>
 #include <syscalls.h>
+#include <linkage.h>
+
+#define CREATE_TRACE_POINTS
+#include <trace/events/mm.h>
 
 static unsigned long fault_around_bytes = rounddown_pow_of_two(65536);
 
@@ -51,8 +55,8 @@ static vm_fault_t do_anonymous_page(struct vm_fault *vmf)
     struct page *page;
     struct vm_area_struct *vma = vmf->vma;
 
-    printk("%s: addr(%lx) pgoff(%lx) flags(%x)\n",
-           __func__, vmf->address, vmf->pgoff, vmf->flags);
+    pr_debug("%s: addr(%lx) pgoff(%lx) flags(%x)\n",
+             __func__, vmf->address, vmf->pgoff, vmf->flags);
 
     if (pte_alloc(vma->vm_mm, vmf->pmd))
         return VM_FAULT_OOM;
@@ -169,8 +173,8 @@ static vm_fault_t do_read_fault(struct vm_fault *vmf)
     vm_fault_t ret = 0;
     struct vm_area_struct *vma = vmf->vma;
 
-    printk("%s: addr(%lx) pgoff(%lx) flags(%x)\n",
-           __func__, vmf->address, vmf->pgoff, vmf->flags);
+    pr_debug("%s: addr(%lx) pgoff(%lx) flags(%x)\n",
+             __func__, vmf->address, vmf->pgoff, vmf->flags);
 
     /*
      * Let's call ->map_pages() first and use ->fault() as fallback
@@ -196,8 +200,8 @@ static vm_fault_t do_cow_fault(struct vm_fault *vmf)
     vm_fault_t ret;
     struct vm_area_struct *vma = vmf->vma;
 
-    printk("%s: addr(%lx) pgoff(%lx) flags(%x)\n",
-           __func__, vmf->address, vmf->pgoff, vmf->flags);
+    pr_debug("%s: addr(%lx) pgoff(%lx) flags(%x)\n",
+             __func__, vmf->address, vmf->pgoff, vmf->flags);
 
     vmf->cow_page = alloc_page_vma(GFP_HIGHUSER_MOVABLE, vma, vmf->address);
     if (!vmf->cow_page)
@@ -243,6 +247,8 @@ static vm_fault_t do_fault(struct vm_fault *vmf)
 
 static vm_fault_t handle_pte_fault(struct vm_fault *vmf)
 {
+    trace_mm_pte_fault(vmf);
+
     if (unlikely(pmd_none(*vmf->pmd))) {
         /*
          * Leave __pte_alloc() until later: because vm_ops->fault may
@@ -452,11 +458,13 @@ out:
     return retval;
 }
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[pgalloc]: init begin ...\n");
 
+    trace_event_register(&event_mm_pte_fault);
+
     handle_mm_fault = _handle_mm_fault;
     do_sys_brk = _do_sys_brk;
 
@@ -10,6 +10,7 @@
 #include <export.h>
 #include <platform.h>
 #include <of_address.h>
+#include <linkage.h>
 
 extern bool plic_initialized;
 extern bool intc_initialized;
@@ -366,7 +367,7 @@ devm_platform_ioremap_resource(struct platform_device *pdev,
 }
 EXPORT_SYMBOL(devm_platform_ioremap_resource);
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[platform]: init begin ...\n");
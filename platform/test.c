@@ -3,6 +3,7 @@
 #include <klist.h>
 #include <printk.h>
 #include <platform.h>
+#include <linkage.h>
 
 struct platform_device *example = NULL;
 
@@ -69,7 +70,7 @@ test_ioremap(void)
     return 0;
 }
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[test_platform]: init begin ...\n");
@@ -4,12 +4,14 @@
 #include <irq.h>
 #include <mmio.h>
 #include <slab.h>
+#include <smp.h>
 #include <export.h>
 #include <of_irq.h>
 #include <printk.h>
 #include <irqchip.h>
 #include <irqdomain.h>
 #include <of_address.h>
+#include <linkage.h>
 
 #define PRIORITY_BASE   0
 #define PRIORITY_PER_ID 4
@@ -198,6 +200,10 @@ plic_init(struct device_node *node, struct device_node *parent)
         if (parent.args[0] != RV_IRQ_EXT)
             continue;
 
+        /* Device interrupts all go to the boot hart */
+        if (riscv_of_parent_hartid(parent.np) != boot_cpu_hartid)
+            continue;
+
         /* Find parent domain and register chained handler */
         if (!plic_parent_irq && irq_find_host(parent.np)) {
             plic_parent_irq = irq_of_parse_and_map(node, i);
@@ -219,7 +225,7 @@ plic_init(struct device_node *node, struct device_node *parent)
     return 0;
 }
 
-static int
+static int __init
 init_module(void)
 {
     struct of_device_id match = {
@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: GPL-2.0-only
 
 #include <sched.h>
+#include <module.h>
 #include <kbuild.h>
 
 void asm_offsets(void)
@@ -63,4 +64,6 @@ void asm_offsets(void)
           offsetof(struct task_struct, thread.s[11])
         - offsetof(struct task_struct, thread.ra)
     );
+
+    DEFINE(MODULE_STRUCT_SIZE, sizeof(struct module));
 }
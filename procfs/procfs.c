@@ -4,8 +4,10 @@
 #include <bug.h>
 #include <slab.h>
 #include <dcache.h>
+#include <module.h>
 #include <printk.h>
 #include "internal.h"
+#include <linkage.h>
 
 static struct kmem_cache *proc_inode_cachep;
 
@@ -111,7 +113,10 @@ void proc_init_kmemcache(void)
                               SLAB_ACCOUNT|SLAB_PANIC), init_once);
 }
 
-static int
+/* Nothing on the way to /sbin/init mounts proc. */
+MODULE_INIT_LEVEL(MODULE_INIT_DEFERRED);
+
+static int __init
 init_module(void)
 {
     printk("module[procfs]: init begin ...\n");
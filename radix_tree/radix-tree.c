@@ -6,6 +6,7 @@
 #include <printk.h>
 #include <string.h>
 #include <radix-tree.h>
+#include <linkage.h>
 
 /*
  * Radix tree node cache.
@@ -101,25 +102,6 @@ radix_tree_lookup(const struct radix_tree_root *root,
 }
 EXPORT_SYMBOL(radix_tree_lookup);
 
-static int
-radix_tree_extend(struct radix_tree_root *root,
-                  unsigned long index, unsigned int shift)
-{
-    void *entry;
-    unsigned int maxshift;
-
-    /* Figure out what the shift should be.  */
-    maxshift = shift;
-    while (index > shift_maxindex(maxshift))
-        maxshift += RADIX_TREE_MAP_SHIFT;
-
-    entry = root->xa_head;
-    if (!entry)
-        return maxshift + RADIX_TREE_MAP_SHIFT;
-
-    panic("%s: (%u, %u, %u)!", __func__, index, shift);
-}
-
 static struct radix_tree_node *
 radix_tree_node_alloc(gfp_t gfp_mask, struct radix_tree_node *parent,
                       struct radix_tree_root *root,
@@ -144,6 +126,46 @@ static inline void *node_to_entry(void *ptr)
     return (void *)((unsigned long)ptr | RADIX_TREE_INTERNAL_NODE);
 }
 
+/*
+ * Add nodes above the head until the tree reaches @index. The old
+ * head, an entry at index 0 or the old top node, goes into slot 0.
+ */
+static int
+radix_tree_extend(struct radix_tree_root *root,
+                  unsigned long index, unsigned int shift)
+{
+    struct radix_tree_node *node;
+    void *entry;
+    unsigned int maxshift;
+
+    /* Figure out what the shift should be.  */
+    maxshift = shift;
+    while (index > shift_maxindex(maxshift))
+        maxshift += RADIX_TREE_MAP_SHIFT;
+
+    entry = root->xa_head;
+    if (!entry)
+        goto out;
+
+    do {
+        node = radix_tree_node_alloc(GFP_KERNEL, NULL, root, shift, 0, 1, 0);
+        if (!node)
+            return -ENOMEM;
+
+        BUG_ON(shift > BITS_PER_LONG);
+        if (radix_tree_is_internal_node(entry))
+            entry_to_node(entry)->parent = node;
+
+        node->slots[0] = entry;
+        entry = node_to_entry(node);
+        root->xa_head = entry;
+        shift += RADIX_TREE_MAP_SHIFT;
+    } while (shift <= maxshift);
+
+ out:
+    return maxshift + RADIX_TREE_MAP_SHIFT;
+}
+
 static int
 __radix_tree_create(struct radix_tree_root *root,
                     unsigned long index,
@@ -243,7 +265,7 @@ void radix_tree_init(void)
                           radix_tree_node_ctor);
 }
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[radix-tree]: init begin ...\n");
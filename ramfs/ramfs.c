@@ -8,6 +8,7 @@
 #include <types.h>
 #include <export.h>
 #include <string.h>
+#include <linkage.h>
 
 #define RAMFS_DEFAULT_MODE  0755
 
@@ -149,7 +150,7 @@ static struct file_system_type ramfs_fs_type = {
     .fs_flags = FS_USERNS_MOUNT,
 };
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[ramfs]: init begin ...\n");
@@ -3,6 +3,7 @@
 #include <export.h>
 #include <printk.h>
 #include <rbtree.h>
+#include <linkage.h>
 
 static inline struct rb_node *
 rb_red_parent(struct rb_node *red)
@@ -557,7 +558,7 @@ struct rb_node *rb_next(const struct rb_node *node)
 }
 EXPORT_SYMBOL(rb_next);
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[rbtree]: init begin ...\n");
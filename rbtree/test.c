@@ -3,6 +3,7 @@
 #include <printk.h>
 #include <rbtree.h>
 #include <string.h>
+#include <linkage.h>
 
 struct test_node {
     struct rb_node node;
@@ -175,7 +176,7 @@ test_argumented_rbtree(void)
     printk(_GREEN("Test argumented rbtree ok!\n"));
 }
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[test_rbtree]: init begin ...\n");
@@ -6,6 +6,7 @@
 #include <pagemap.h>
 #include <readahead.h>
 #include <backing-dev.h>
+#include <linkage.h>
 
 /*
  * Initialise a struct file's readahead state.  Assumes that the caller has
@@ -51,9 +52,9 @@ ondemand_readahead(struct address_space *mapping,
     ra->size = get_init_ra_size(req_size, max_pages);
     ra->async_size = ra->size > req_size ? ra->size - req_size : ra->size;
 
-    printk("%s: ra_pages(%lu) max_pages(%lu) io_pages(%lu) req_size(%lu) (%lu, %lu)\n",
-           __func__, ra->ra_pages, max_pages, bdi->io_pages, req_size,
-           ra->size, ra->async_size);
+    pr_debug("%s: ra_pages(%lu) max_pages(%lu) io_pages(%lu) req_size(%lu) (%lu, %lu)\n",
+             __func__, ra->ra_pages, max_pages, bdi->io_pages, req_size,
+             ra->size, ra->async_size);
 
     ra_submit(ra, mapping, filp);
 }
@@ -177,7 +178,7 @@ void __do_page_cache_readahead(struct address_space *mapping,
 }
 EXPORT_SYMBOL(__do_page_cache_readahead);
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[readahead]: init begin ...\n");
@@ -15,6 +15,7 @@
 #include <printk.h>
 #include <string.h>
 #include <current.h>
+#include <linkage.h>
 
 extern char boot_command_line[];
 extern bool ext2_initialized;
@@ -247,7 +248,7 @@ void console_on_rootfs(void)
     init_dup(file);
 }
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[rootfs]: init begin ...\n");
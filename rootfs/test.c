@@ -5,6 +5,7 @@
 #include <stat.h>
 #include <mount.h>
 #include <printk.h>
+#include <linkage.h>
 
 static int
 test_create_dir(void)
@@ -20,7 +21,7 @@ test_create_dev(void)
     return create_dev("/dev/root", 0xFE00001);
 }
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[test_rootfs]: init begin ...\n");
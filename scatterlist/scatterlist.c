@@ -4,6 +4,7 @@
 #include <printk.h>
 #include <string.h>
 #include <scatterlist.h>
+#include <linkage.h>
 
 /**
  * sg_init_table - Initialize SG table
@@ -61,7 +62,7 @@ sg_init_one(struct scatterlist *sg,
 }
 EXPORT_SYMBOL(sg_init_one);
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[scatterlist]: init begin ...\n");
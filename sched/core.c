@@ -1,5 +1,6 @@
 // SPDX-License-Identifier: GPL-2.0-only
 
+#include <smp.h>
 #include <slab.h>
 #include <sched.h>
 #include <export.h>
@@ -7,9 +8,90 @@
 #include <sched/rt.h>
 #include <asm-switch_to.h>
 #include <sched/deadline.h>
+#include <linkage.h>
+#include <irqflags.h>
+#include <mmu_context.h>
+
+#define CREATE_TRACE_POINTS
+#include <trace/events/sched.h>
+
+#include "internal.h"
 
 extern struct task_group root_task_group;
 
+struct rq runqueues[NR_CPUS];
+
+/*
+ * Nice levels are multiplicative, with a gentle 10% change for every
+ * nice level changed. I.e. when a CPU-bound task goes from nice 0 to
+ * nice 1, it will get ~10% less CPU time than another CPU-bound task
+ * that remained on nice 0.
+ *
+ * The "10% effect" is relative and cumulative: from _any_ nice level,
+ * if you go up 1 level, it's -10% CPU usage, if you go down 1 level
+ * it's +10% CPU usage. (to achieve that we use a multiplier of 1.25.
+ * If a task goes up by ~10% and another task goes down by ~10% then
+ * the relative distance between them is ~25%.)
+ */
+const int sched_prio_to_weight[40] = {
+ /* -20 */     88761,     71755,     56483,     46273,     36291,
+ /* -15 */     29154,     23254,     18705,     14949,     11916,
+ /* -10 */      9548,      7620,      6100,      4904,      3906,
+ /*  -5 */      3121,      2501,      1991,      1586,      1277,
+ /*   0 */      1024,       820,       655,       526,       423,
+ /*   5 */       335,       272,       215,       172,       137,
+ /*  10 */       110,        87,        70,        56,        45,
+ /*  15 */        36,        29,        23,        18,        15,
+};
+
+/*
+ * Inverse (2^32/x) values of the sched_prio_to_weight[] array, precalculated.
+ *
+ * In cases where the weight does not change often, we can use the
+ * precalculated inverse to speed up arithmetics by turning divisions
+ * into multiplications:
+ */
+const u32 sched_prio_to_wmult[40] = {
+ /* -20 */     48388,     59856,     76040,     92818,    118348,
+ /* -15 */    147320,    184698,    229616,    287308,    360437,
+ /* -10 */    449829,    563644,    704093,    875809,   1099582,
+ /*  -5 */   1376151,   1717300,   2157191,   2708050,   3363326,
+ /*   0 */   4194304,   5237765,   6557202,   8165337,  10153587,
+ /*   5 */  12820798,  15790321,  19976592,  24970740,  31350126,
+ /*  10 */  39045157,  49367440,  61356676,  76695844,  95443717,
+ /*  15 */ 119304647, 148102320, 186737708, 238609294, 286331153,
+};
+
+static void set_load_weight(struct task_struct *p)
+{
+    int prio = p->static_prio - MAX_RT_PRIO;
+    struct load_weight *load = &p->se.load;
+
+    load->weight = scale_load(sched_prio_to_weight[prio]);
+    load->inv_weight = sched_prio_to_wmult[prio];
+}
+
+/*
+ * resched_curr - mark rq's current task 'to be rescheduled now'.
+ *
+ * The flag is acted on when the current task returns to user mode or
+ * the idle loop polls it. Another CPU gets an IPI for that, it may be
+ * waiting for an interrupt.
+ */
+void resched_curr(struct rq *rq)
+{
+    struct task_struct *curr = rq->curr;
+    int cpu;
+
+    if (test_tsk_need_resched(curr))
+        return;
+
+    cpu = cpu_of(rq);
+    set_tsk_need_resched(curr);
+    if (cpu != smp_processor_id())
+        smp_send_reschedule(cpu);
+}
+
 /* Cacheline aligned slab cache for task_group */
 static struct kmem_cache *task_group_cache;
 
@@ -17,9 +99,24 @@ static struct kmem_cache *task_group_cache;
  * schedule_tail - first thing a freshly forked thread must call.
  * @prev: the thread we just switched away from.
  */
+static void finish_task_switch(struct task_struct *prev)
+{
+    /*
+     * A dead task stays where it is, there is nobody to reap it yet
+     * and its stack is only let go of once it is off the CPU.
+     */
+    prev->on_cpu = 0;
+}
+
 void _schedule_tail(struct task_struct *prev)
 {
-    /* Todo: add it. */
+    finish_task_switch(prev);
+
+    /* A new task starts out in the kernel, holding the kernel lock */
+    sched_unlock_kernel(1);
+
+    /* Forked in __schedule() with interrupts off */
+    local_irq_enable();
 }
 
 struct rq *
@@ -34,6 +131,12 @@ enqueue_task(struct rq *rq, struct task_struct *p, int flags)
     p->sched_class->enqueue_task(rq, p, flags);
 }
 
+static inline void
+dequeue_task(struct rq *rq, struct task_struct *p, int flags)
+{
+    p->sched_class->dequeue_task(rq, p, flags);
+}
+
 void activate_task(struct rq *rq, struct task_struct *p, int flags)
 {
     enqueue_task(rq, p, flags);
@@ -41,6 +144,91 @@ void activate_task(struct rq *rq, struct task_struct *p, int flags)
     p->on_rq = TASK_ON_RQ_QUEUED;
 }
 
+void deactivate_task(struct rq *rq, struct task_struct *p, int flags)
+{
+    p->on_rq = 0;
+
+    dequeue_task(rq, p, flags);
+}
+
+/* Move @p, which is off the runqueues, over to @new_cpu */
+void set_task_cpu(struct task_struct *p, unsigned int new_cpu)
+{
+    if (task_cpu(p) == new_cpu)
+        return;
+
+    if (p->sched_class->migrate_task_rq)
+        p->sched_class->migrate_task_rq(p, new_cpu);
+
+    __set_task_cpu(p, new_cpu);
+}
+
+static inline int select_task_rq(struct task_struct *p)
+{
+    return p->sched_class->select_task_rq(p, task_cpu(p));
+}
+
+static void check_preempt_curr(struct rq *rq, struct task_struct *p, int flags)
+{
+    if (rq->curr == rq->idle)
+        resched_curr(rq);
+    else if (p->sched_class == rq->curr->sched_class)
+        rq->curr->sched_class->check_preempt_curr(rq, p, flags);
+}
+
+/**
+ * try_to_wake_up - wake up a thread
+ * @p: the thread to be awakened
+ * @state: the mask of task states that can be woken
+ * @wake_flags: wake modifier flags (WF_*)
+ *
+ * Conceptually does:
+ *
+ *   If (@state & @p->state) @p->state = TASK_RUNNING.
+ *
+ * If the task was not queued/runnable, also place it back on a runqueue,
+ * that of the CPU select_task_rq() finds for it. A task that set its
+ * state but hasn't switched out yet is still queued, __schedule() then
+ * sees TASK_RUNNING and keeps it there.
+ *
+ * Called from interrupt handlers as well, such as block completions.
+ * Under the kernel lock a task off its runqueue is off its CPU too,
+ * __schedule() only lets go of the lock once it switched away.
+ *
+ * Return: %true if @p->state changes (an actual wakeup was done),
+ *         %false otherwise.
+ */
+static int
+_try_to_wake_up(struct task_struct *p, unsigned int state, int wake_flags)
+{
+    struct rq *rq;
+    unsigned long flags;
+    int success = 0;
+
+    local_irq_save(flags);
+
+    if (!(p->state & state))
+        goto out;
+
+    success = 1;
+    p->state = TASK_RUNNING;
+
+    /* The idle task is never queued, it waits by polling */
+    if (p->on_rq || p == task_rq(p)->idle)
+        goto out;
+
+    set_task_cpu(p, select_task_rq(p));
+    rq = task_rq(p);
+
+    update_rq_clock(rq);
+    activate_task(rq, p, ENQUEUE_WAKEUP);
+    check_preempt_curr(rq, p, wake_flags);
+
+out:
+    local_irq_restore(flags);
+    return success;
+}
+
 /*
  * wake_up_new_task - wake up a newly created task for the first time.
  *
@@ -54,9 +242,20 @@ void wake_up_new_task(struct task_struct *p)
 
     p->state = TASK_RUNNING;
 
+    /* Off the CPU of its parent, where sched_fork() left it */
+    set_task_cpu(p, select_task_rq(p));
+
     rq = __task_rq_lock(p);
+    update_rq_clock(rq);
 
     activate_task(rq, p, ENQUEUE_NOCLOCK);
+
+    /*
+     * Another CPU gets an IPI to leave its idle loop. The boot thread
+     * idles in rest_init() until there is work.
+     */
+    if (rq->curr == rq->idle)
+        resched_curr(rq);
 }
 EXPORT_SYMBOL(wake_up_new_task);
 
@@ -65,10 +264,16 @@ static void __sched_fork(unsigned long clone_flags, struct task_struct *p)
     p->on_rq = 0;
 
     p->se.on_rq = 0;
+    p->se.exec_start = 0;
+    p->se.sum_exec_runtime = 0;
+    p->se.prev_sum_exec_runtime = 0;
     p->se.vruntime = 0;
     INIT_LIST_HEAD(&p->se.group_node);
 
     p->se.cfs_rq = NULL;
+
+    /* Copied from the parent along with the rest of thread_info */
+    clear_tsk_need_resched(p);
 }
 
 int sched_fork(unsigned long clone_flags, struct task_struct *p)
@@ -81,6 +286,7 @@ int sched_fork(unsigned long clone_flags, struct task_struct *p)
      * Make sure we do not leak PI boosting priority to the child.
      */
     p->prio = current->normal_prio;
+    set_load_weight(p);
 
     if (dl_prio(p->prio))
         panic("bad prio %d", p->prio);
@@ -89,7 +295,14 @@ int sched_fork(unsigned long clone_flags, struct task_struct *p)
     else
         p->sched_class = &fair_sched_class;
 
-    __set_task_cpu(p, 0);
+    /*
+     * On the CPU of the parent for task_fork(), which places it behind
+     * the parent in vruntime. wake_up_new_task() picks its CPU.
+     */
+    __set_task_cpu(p, smp_processor_id());
+
+    if (p->sched_class->task_fork)
+        p->sched_class->task_fork(p);
 
     p->on_cpu = 0;
     return 0;
@@ -100,6 +313,7 @@ int alloc_fair_sched_group(struct task_group *tg)
 {
     struct cfs_rq *cfs_rq;
     struct sched_entity *se;
+    int i;
 
     tg->cfs_rq = kcalloc(nr_cpu_ids, sizeof(cfs_rq), GFP_KERNEL);
     if (!tg->cfs_rq)
@@ -111,16 +325,18 @@ int alloc_fair_sched_group(struct task_group *tg)
 
     tg->shares = NICE_0_LOAD;
 
-    cfs_rq = kzalloc_node(sizeof(struct cfs_rq), GFP_KERNEL);
-    if (!cfs_rq)
-        panic("out of memory!");
+    for_each_possible_cpu(i) {
+        cfs_rq = kzalloc_node(sizeof(struct cfs_rq), GFP_KERNEL);
+        if (!cfs_rq)
+            panic("out of memory!");
 
-    se = kzalloc_node(sizeof(struct sched_entity), GFP_KERNEL);
-    if (!se)
-        panic("out of memory!");
+        se = kzalloc_node(sizeof(struct sched_entity), GFP_KERNEL);
+        if (!se)
+            panic("out of memory!");
 
-    init_cfs_rq(cfs_rq);
-    init_tg_cfs_entry(tg, cfs_rq, se, 0, NULL);
+        init_cfs_rq(cfs_rq);
+        init_tg_cfs_entry(tg, cfs_rq, se, i, NULL);
+    }
     return 1;
 }
 
@@ -140,28 +356,23 @@ sched_create_group(void)
     return tg;
 }
 
+/*
+ * There is only the fair class, with nothing runnable it is the turn
+ * of the idle task.
+ */
 static inline struct task_struct *
 pick_next_task(struct rq *rq, struct task_struct *prev)
 {
     struct task_struct *p;
-    const struct sched_class *class;
 
-    /*
-     * Optimization: we know that if all tasks are in the fair class we can
-     * call that function directly, but only if the @prev task wasn't of a
-     * higher scheduling class, because otherwise those loose the
-     * opportunity to pull in more work from other CPUs.
-     */
-    if (likely(prev->sched_class <= &fair_sched_class)) {
+    if (prev != rq->idle)
+        prev->sched_class->put_prev_task(rq, prev);
 
-        p = pick_next_task_fair(rq, prev);
-        if (unlikely(p == RETRY_TASK))
-            panic("need to retry task!");
+    p = pick_next_task_fair(rq);
+    if (!p)
+        return rq->idle;
 
-        return p;
-    }
-
-    panic("%s: !", __func__);
+    return p;
 }
 
 static inline void prepare_task(struct task_struct *next)
@@ -189,23 +400,52 @@ context_switch(struct rq *rq, struct task_struct *prev,
 {
     prepare_task_switch(rq, prev, next);
 
-    printk("switch ...\n");
+    /* Kernel threads borrow the address space of whom they follow */
+    if (!next->mm)
+        next->active_mm = prev->active_mm;
+    else
+        switch_mm(prev->active_mm, next->mm, next);
 
     /* Here we just switch the register state and the stack. */
     switch_to(prev, next, prev);
 
-    panic("Never reach here!");
+    /* Back in @next, prev is the task that switched to it */
+    finish_task_switch(prev);
+    return this_rq();
 }
 
+/*
+ * __schedule() is the main scheduler function.
+ *
+ * It is entered with @preempt from the return to user mode when the
+ * tick has set TIF_NEED_RESCHED, the task stays runnable then. Else
+ * it is a voluntary switch and a task which set its state to sleep
+ * goes off the runqueue.
+ *
+ * The kernel lock is held across the switch, which an idle task takes
+ * for it. The task switched to carries on with the lock as it held it,
+ * maybe on another CPU than it left off on.
+ */
 static void __schedule(bool preempt)
 {
     struct rq *rq;
+    unsigned long flags;
+    unsigned int locked;
     struct task_struct *prev, *next;
 
-    rq = cpu_rq();
+    local_irq_save(flags);
+    locked = sched_lock_kernel();
+
+    rq = this_rq();
     prev = rq->curr;
 
+    update_rq_clock(rq);
+
+    if (!preempt && prev->state && prev != rq->idle)
+        deactivate_task(rq, prev, DEQUEUE_SLEEP);
+
     next = pick_next_task(rq, prev);
+    clear_tsk_need_resched(prev);
 
     if (likely(prev != next)) {
         /*
@@ -214,20 +454,59 @@ static void __schedule(bool preempt)
          */
         rq->curr = next;
 
-        /* Also unlocks the rq: */
+        trace_sched_switch(prev, next);
+
         rq = context_switch(rq, prev, next);
-    } else {
-        panic("still IS idle task!");
     }
 
-    panic("%s: !", __func__);
+    sched_unlock_kernel(locked);
+    local_irq_restore(flags);
 }
 
-void schedule(void)
+/* schedule() of startup/init.c, for the wait queues of early modules */
+static void _schedule(void)
 {
     __schedule(false);
 }
-EXPORT_SYMBOL(schedule);
+
+/* From the return to user mode, see work_pending in entry.S */
+static void _schedule_user(void)
+{
+    __schedule(true);
+}
+
+void __noreturn do_task_dead(void)
+{
+    current->state = TASK_DEAD;
+
+    __schedule(false);
+    BUG();
+
+    /* Avoid "noreturn function does return" */
+    for (;;)
+        ;
+}
+EXPORT_SYMBOL(do_task_dead);
+
+/*
+ * This function gets called by the timer code, with HZ frequency,
+ * with interrupts disabled.
+ */
+static void _scheduler_tick(void)
+{
+    struct rq *rq = this_rq();
+    struct task_struct *curr = rq->curr;
+
+    update_rq_clock(rq);
+
+    if (curr == rq->idle) {
+        if (rq->nr_running)
+            resched_curr(rq);
+        return;
+    }
+
+    curr->sched_class->task_tick(rq, curr, 0);
+}
 
 /**
  * schedule_preempt_disabled - called with preemption disabled
@@ -242,13 +521,15 @@ EXPORT_SYMBOL(schedule_preempt_disabled);
 
 void init_idle(struct task_struct *idle, int cpu)
 {
-    struct rq *rq = cpu_rq();
+    struct rq *rq = cpu_rq(cpu);
 
     __sched_fork(0, idle);
 
     idle->state = TASK_RUNNING;
     idle->flags |= PF_IDLE;
 
+    __set_task_cpu(idle, cpu);
+
     rq->idle = idle;
     rq->curr = idle;
     idle->on_rq = TASK_ON_RQ_QUEUED;
@@ -259,6 +540,7 @@ void sched_init(void)
 {
     struct rq *rq;
     unsigned long ptr = 0;
+    int i;
 
     ptr += 2 * nr_cpu_ids * sizeof(void **);
 
@@ -272,9 +554,12 @@ void sched_init(void)
 
     root_task_group.shares = ROOT_TASK_GROUP_LOAD;
 
-    rq = cpu_rq();
-    init_cfs_rq(&rq->cfs);
-    init_tg_cfs_entry(&root_task_group, &rq->cfs, NULL, 0, NULL);
+    for_each_possible_cpu(i) {
+        rq = cpu_rq(i);
+        rq->cpu = i;
+        init_cfs_rq(&rq->cfs);
+        init_tg_cfs_entry(&root_task_group, &rq->cfs, NULL, i, NULL);
+    }
 
     task_group_cache = KMEM_CACHE(task_group, 0);
 
@@ -286,15 +571,21 @@ void sched_init(void)
      * but because we are the idle thread, we just pick up running again
      * when this runqueue becomes "idle".
      */
-    init_idle(current, 0);
+    init_idle(current, smp_processor_id());
 }
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[sched]: init begin ...\n");
 
     schedule_tail_func = _schedule_tail;
+    scheduler_tick_func = _scheduler_tick;
+    schedule_user_func = _schedule_user;
+    try_to_wake_up_func = _try_to_wake_up;
+    schedule_func = _schedule;
+
+    trace_event_register(&event_sched_switch);
 
     sched_init();
 
@@ -1,6 +1,13 @@
 // SPDX-License-Identifier: GPL-2.0
 
+#include <log2.h>
 #include <sched.h>
+#include <cpumask.h>
+
+#include "internal.h"
+
+#define WMULT_CONST (~0U)
+#define WMULT_SHIFT 32
 
 /* Walk up scheduling entities hierarchy */
 #define for_each_sched_entity(se) for(; se; se = se->parent)
@@ -11,12 +18,137 @@ static inline struct cfs_rq *cfs_rq_of(struct sched_entity *se)
     return se->cfs_rq;
 }
 
+/* cpu runqueue to which this cfs_rq is attached */
+static inline struct rq *rq_of(struct cfs_rq *cfs_rq)
+{
+    return cfs_rq->rq;
+}
+
+static inline struct task_struct *task_of(struct sched_entity *se)
+{
+    BUG_ON(!entity_is_task(se));
+    return container_of(se, struct task_struct, se);
+}
+
+static void __update_inv_weight(struct load_weight *lw)
+{
+    unsigned long w;
+
+    if (likely(lw->inv_weight))
+        return;
+
+    w = scale_load_down(lw->weight);
+
+    if (unlikely(w >= WMULT_CONST))
+        lw->inv_weight = 1;
+    else if (unlikely(!w))
+        lw->inv_weight = WMULT_CONST;
+    else
+        lw->inv_weight = WMULT_CONST / w;
+}
+
+/*
+ * delta_exec * weight / lw.weight
+ *   OR
+ * (delta_exec * (weight * lw->inv_weight)) >> WMULT_SHIFT
+ *
+ * Either weight := NICE_0_LOAD and lw \e sched_prio_to_wmult[], in which case
+ * we're guaranteed shift stays positive because inv_weight is guaranteed to
+ * fit 32 bits, and NICE_0_LOAD gives another 10 bits; therefore shift >= 22.
+ *
+ * Or, weight =< lw.weight (because lw.weight is the runqueue weight), thus
+ * weight/lw.weight <= 1, and therefore our shift will also be positive.
+ */
+static u64
+__calc_delta(u64 delta_exec, unsigned long weight, struct load_weight *lw)
+{
+    u64 fact = scale_load_down(weight);
+    u32 fact_hi = (u32)(fact >> 32);
+    int shift = WMULT_SHIFT;
+    int fs;
+
+    __update_inv_weight(lw);
+
+    if (unlikely(fact_hi)) {
+        fs = fls(fact_hi);
+        shift -= fs;
+        fact >>= fs;
+    }
+
+    fact = (u64)(u32)fact * lw->inv_weight;
+
+    fact_hi = (u32)(fact >> 32);
+    if (fact_hi) {
+        fs = fls(fact_hi);
+        shift -= fs;
+        fact >>= fs;
+    }
+
+    return mul_u64_u32_shr(delta_exec, fact, shift);
+}
+
+/* delta /= w */
+static inline u64 calc_delta_fair(u64 delta, struct sched_entity *se)
+{
+    if (unlikely(se->load.weight != NICE_0_LOAD))
+        delta = __calc_delta(delta, NICE_0_LOAD, &se->load);
+
+    return delta;
+}
+
+static inline u64 max_vruntime(u64 max_vruntime, u64 vruntime)
+{
+    s64 delta = (s64)(vruntime - max_vruntime);
+
+    if (delta > 0)
+        max_vruntime = vruntime;
+
+    return max_vruntime;
+}
+
+static inline u64 min_vruntime(u64 min_vruntime, u64 vruntime)
+{
+    s64 delta = (s64)(vruntime - min_vruntime);
+
+    if (delta < 0)
+        min_vruntime = vruntime;
+
+    return min_vruntime;
+}
+
 static inline int
 entity_before(struct sched_entity *a, struct sched_entity *b)
 {
     return (s64)(a->vruntime - b->vruntime) < 0;
 }
 
+static void update_min_vruntime(struct cfs_rq *cfs_rq)
+{
+    struct sched_entity *curr = cfs_rq->curr;
+    struct rb_node *leftmost = rb_first_cached(&cfs_rq->tasks_timeline);
+    struct sched_entity *se;
+    u64 vruntime = cfs_rq->min_vruntime;
+
+    if (curr) {
+        if (curr->on_rq)
+            vruntime = curr->vruntime;
+        else
+            curr = NULL;
+    }
+
+    if (leftmost) { /* non-empty tree */
+        se = rb_entry(leftmost, struct sched_entity, run_node);
+
+        if (!curr)
+            vruntime = se->vruntime;
+        else
+            vruntime = min_vruntime(vruntime, se->vruntime);
+    }
+
+    /* ensure we never gain time by being placed backwards. */
+    cfs_rq->min_vruntime = max_vruntime(cfs_rq->min_vruntime, vruntime);
+}
+
 /*
  * Enqueue an entity into the rb-tree:
  */
@@ -49,55 +181,218 @@ static void __enqueue_entity(struct cfs_rq *cfs_rq, struct sched_entity *se)
     rb_insert_color_cached(&se->run_node, &cfs_rq->tasks_timeline, leftmost);
 }
 
+static void
+__dequeue_entity(struct cfs_rq *cfs_rq, struct sched_entity *se)
+{
+    rb_erase_cached(&se->run_node, &cfs_rq->tasks_timeline);
+}
+
+struct sched_entity *__pick_first_entity(struct cfs_rq *cfs_rq)
+{
+    struct rb_node *left = rb_first_cached(&cfs_rq->tasks_timeline);
+
+    if (!left)
+        return NULL;
+
+    return rb_entry(left, struct sched_entity, run_node);
+}
+
+/*
+ * The idea is to set a period in which each task runs once.
+ *
+ * When there are too many tasks (sched_nr_latency) we have to stretch
+ * this period because otherwise the slices get too small.
+ *
+ * p = (nr <= nl) ? l : l*nr/nl
+ */
+static u64 __sched_period(unsigned long nr_running)
+{
+    if (unlikely(nr_running > SCHED_NR_LATENCY))
+        return nr_running * SCHED_MIN_GRANULARITY;
+    else
+        return SCHED_LATENCY;
+}
+
+/*
+ * We calculate the wall-time slice from the period by taking a part
+ * proportional to the weight.
+ *
+ * s = p*P[w/rw]
+ */
+static u64 sched_slice(struct cfs_rq *cfs_rq, struct sched_entity *se)
+{
+    u64 slice = __sched_period(cfs_rq->nr_running + !se->on_rq);
+    struct load_weight *load;
+    struct load_weight lw;
+
+    for_each_sched_entity(se) {
+        cfs_rq = cfs_rq_of(se);
+        load = &cfs_rq->load;
+
+        if (unlikely(!se->on_rq)) {
+            lw = cfs_rq->load;
+
+            update_load_add(&lw, se->load.weight);
+            load = &lw;
+        }
+        slice = __calc_delta(slice, se->load.weight, load);
+    }
+    return slice;
+}
+
+/*
+ * We calculate the vruntime slice of a to-be-inserted task.
+ *
+ * vs = s/w
+ */
+static u64 sched_vslice(struct cfs_rq *cfs_rq, struct sched_entity *se)
+{
+    return calc_delta_fair(sched_slice(cfs_rq, se), se);
+}
+
+/*
+ * Update the current task's runtime statistics, called on the tick
+ * and on every change of the runqueue.
+ */
+static void update_curr(struct cfs_rq *cfs_rq)
+{
+    struct sched_entity *curr = cfs_rq->curr;
+    u64 now = rq_clock(rq_of(cfs_rq));
+    u64 delta_exec;
+
+    if (unlikely(!curr))
+        return;
+
+    delta_exec = now - curr->exec_start;
+    if (unlikely((s64)delta_exec <= 0))
+        return;
+
+    curr->exec_start = now;
+    curr->sum_exec_runtime += delta_exec;
+
+    curr->vruntime += calc_delta_fair(delta_exec, curr);
+    update_min_vruntime(cfs_rq);
+}
+
+static void
+account_entity_enqueue(struct cfs_rq *cfs_rq, struct sched_entity *se)
+{
+    update_load_add(&cfs_rq->load, se->load.weight);
+    cfs_rq->nr_running++;
+}
+
+static void
+account_entity_dequeue(struct cfs_rq *cfs_rq, struct sched_entity *se)
+{
+    update_load_sub(&cfs_rq->load, se->load.weight);
+    cfs_rq->nr_running--;
+}
+
+static void
+place_entity(struct cfs_rq *cfs_rq, struct sched_entity *se, int initial)
+{
+    u64 vruntime = cfs_rq->min_vruntime;
+
+    /*
+     * The 'current' period is already promised to the current tasks,
+     * however the extra weight of the new task will slow them down a
+     * little, place the new task so that it fits in the slot that
+     * stays open at the end.
+     */
+    if (initial)
+        vruntime += sched_vslice(cfs_rq, se);
+
+    /* sleeps up to a single latency don't count. */
+    if (!initial)
+        vruntime -= SCHED_LATENCY >> 1;
+
+    /* ensure we never gain time by being placed backwards. */
+    se->vruntime = max_vruntime(se->vruntime, vruntime);
+}
+
 static void
 enqueue_entity(struct cfs_rq *cfs_rq, struct sched_entity *se, int flags)
 {
     bool curr = cfs_rq->curr == se;
 
+    update_curr(cfs_rq);
+
+    if (flags & ENQUEUE_WAKEUP)
+        place_entity(cfs_rq, se, 0);
+
+    account_entity_enqueue(cfs_rq, se);
+
     if (!curr)
         __enqueue_entity(cfs_rq, se);
     se->on_rq = 1;
 }
 
-void init_cfs_rq(struct cfs_rq *cfs_rq)
+static void
+dequeue_entity(struct cfs_rq *cfs_rq, struct sched_entity *se, int flags)
 {
-    cfs_rq->tasks_timeline = RB_ROOT_CACHED;
+    update_curr(cfs_rq);
+
+    if (se != cfs_rq->curr)
+        __dequeue_entity(cfs_rq, se);
+    se->on_rq = 0;
+    account_entity_dequeue(cfs_rq, se);
+
+    update_min_vruntime(cfs_rq);
 }
 
-void init_tg_cfs_entry(struct task_group *tg, struct cfs_rq *cfs_rq,
-                       struct sched_entity *se, int cpu,
-                       struct sched_entity *parent)
+/*
+ * Preempt the current task with a newly woken task if needed:
+ */
+static void
+check_preempt_tick(struct cfs_rq *cfs_rq, struct sched_entity *curr)
 {
-    struct rq *rq = cpu_rq();
-
-    cfs_rq->tg = tg;
-    cfs_rq->rq = rq;
+    u64 ideal_runtime, delta_exec;
+    struct sched_entity *se;
+    s64 delta;
 
-    tg->cfs_rq[cpu] = cfs_rq;
-    tg->se[cpu] = se;
+    ideal_runtime = sched_slice(cfs_rq, curr);
+    delta_exec = curr->sum_exec_runtime - curr->prev_sum_exec_runtime;
+    if (delta_exec > ideal_runtime) {
+        resched_curr(rq_of(cfs_rq));
+        return;
+    }
 
-    /* se could be NULL for root_task_group */
-    if (!se)
+    /*
+     * Ensure that a task that missed wakeup preemption by a
+     * narrow margin doesn't have to wait for a full slice.
+     * This also mitigates buddy induced latencies under load.
+     */
+    if (delta_exec < SCHED_MIN_GRANULARITY)
         return;
 
-    if (!parent) {
-        se->cfs_rq = &rq->cfs;
-    } else {
-        se->cfs_rq = parent->my_q;
-    }
+    se = __pick_first_entity(cfs_rq);
+    delta = curr->vruntime - se->vruntime;
 
-    se->my_q = cfs_rq;
-    se->parent = parent;
+    if (delta < 0)
+        return;
+
+    if (delta > ideal_runtime)
+        resched_curr(rq_of(cfs_rq));
 }
 
-struct sched_entity *__pick_first_entity(struct cfs_rq *cfs_rq)
+static void
+set_next_entity(struct cfs_rq *cfs_rq, struct sched_entity *se)
 {
-    struct rb_node *left = rb_first_cached(&cfs_rq->tasks_timeline);
+    /* 'current' is not kept within the tree. */
+    if (se->on_rq) {
+        /*
+         * Any task has to be enqueued before it get to execute on
+         * a CPU. So account for the time it spent waiting on the
+         * runqueue.
+         */
+        __dequeue_entity(cfs_rq, se);
+    }
 
-    if (!left)
-        return NULL;
+    se->exec_start = rq_clock(rq_of(cfs_rq));
+    cfs_rq->curr = se;
 
-    return rb_entry(left, struct sched_entity, run_node);
+    /* The slice of check_preempt_tick() starts now */
+    se->prev_sum_exec_runtime = se->sum_exec_runtime;
 }
 
 static struct sched_entity *
@@ -117,32 +412,64 @@ pick_next_entity(struct cfs_rq *cfs_rq, struct sched_entity *curr)
     return se;
 }
 
-static inline struct task_struct *task_of(struct sched_entity *se)
+static void put_prev_entity(struct cfs_rq *cfs_rq, struct sched_entity *prev)
 {
-    BUG_ON(!entity_is_task(se));
-    return container_of(se, struct task_struct, se);
+    /*
+     * If still on the runqueue then deactivate_task()
+     * was not called and update_curr() has to be done:
+     */
+    if (prev->on_rq) {
+        update_curr(cfs_rq);
+        /* Put 'current' back into the tree. */
+        __enqueue_entity(cfs_rq, prev);
+    }
+    cfs_rq->curr = NULL;
 }
 
 static void
-__dequeue_entity(struct cfs_rq *cfs_rq, struct sched_entity *se)
+entity_tick(struct cfs_rq *cfs_rq, struct sched_entity *curr, int queued)
 {
-    rb_erase_cached(&se->run_node, &cfs_rq->tasks_timeline);
+    /*
+     * Update run-time statistics of the 'current'.
+     */
+    update_curr(cfs_rq);
+
+    if (cfs_rq->nr_running > 1)
+        check_preempt_tick(cfs_rq, curr);
 }
 
-static void
-set_next_entity(struct cfs_rq *cfs_rq, struct sched_entity *se)
+void init_cfs_rq(struct cfs_rq *cfs_rq)
 {
-    /* 'current' is not kept within the tree. */
-    if (se->on_rq) {
-        /*
-         * Any task has to be enqueued before it get to execute on
-         * a CPU. So account for the time it spent waiting on the
-         * runqueue.
-         */
-        __dequeue_entity(cfs_rq, se);
+    cfs_rq->tasks_timeline = RB_ROOT_CACHED;
+    cfs_rq->min_vruntime = (u64)(-(1LL << 20));
+}
+
+void init_tg_cfs_entry(struct task_group *tg, struct cfs_rq *cfs_rq,
+                       struct sched_entity *se, int cpu,
+                       struct sched_entity *parent)
+{
+    struct rq *rq = cpu_rq(cpu);
+
+    cfs_rq->tg = tg;
+    cfs_rq->rq = rq;
+
+    tg->cfs_rq[cpu] = cfs_rq;
+    tg->se[cpu] = se;
+
+    /* se could be NULL for root_task_group */
+    if (!se)
+        return;
+
+    if (!parent) {
+        se->cfs_rq = &rq->cfs;
+    } else {
+        se->cfs_rq = parent->my_q;
     }
 
-    cfs_rq->curr = se;
+    se->my_q = cfs_rq;
+    /* guarantee group entities always have weight */
+    update_load_set(&se->load, NICE_0_LOAD);
+    se->parent = parent;
 }
 
 /* runqueue "owned" by this group */
@@ -151,22 +478,84 @@ static inline struct cfs_rq *group_cfs_rq(struct sched_entity *grp)
     return grp->my_q;
 }
 
-struct task_struct *
-pick_next_task_fair(struct rq *rq, struct task_struct *prev)
+/* Nothing runs on it, and nothing is about to */
+static inline bool idle_cpu(int cpu)
 {
+    struct rq *rq = cpu_rq(cpu);
+
+    return rq->curr == rq->idle && !rq->nr_running;
+}
+
+/*
+ * This CPU is about to idle: pull the first waiting task of the other
+ * runqueue with the most tasks over, if one has any waiting at all.
+ * That is all the balancing there is, new and woken tasks are placed
+ * on idle CPUs in the first place, see select_task_rq_fair().
+ */
+static int newidle_balance(struct rq *this_rq)
+{
+    struct rq *rq, *busiest = NULL;
+    struct sched_entity *se;
     struct task_struct *p;
+    int cpu;
+
+    for_each_online_cpu(cpu) {
+        rq = cpu_rq(cpu);
+
+        /* The current task and one waiting behind it */
+        if (rq == this_rq || rq->nr_running < 2)
+            continue;
+
+        if (!busiest || rq->nr_running > busiest->nr_running)
+            busiest = rq;
+    }
+
+    if (!busiest)
+        return 0;
+
+    se = __pick_first_entity(&busiest->cfs);
+    if (!se)
+        return 0;
+    p = task_of(se);
+
+    update_rq_clock(busiest);
+    deactivate_task(busiest, p, 0);
+    set_task_cpu(p, cpu_of(this_rq));
+    activate_task(this_rq, p, 0);
+
+    return 1;
+}
+
+/* NULL when no fair task is runnable, the caller runs the idle task */
+struct task_struct *pick_next_task_fair(struct rq *rq)
+{
     struct sched_entity *se;
     struct cfs_rq *cfs_rq = &rq->cfs;
 
+    if (!cfs_rq->nr_running && !newidle_balance(rq))
+        return NULL;
+
     do {
         se = pick_next_entity(cfs_rq, NULL);
         set_next_entity(cfs_rq, se);
         cfs_rq = group_cfs_rq(se);
-        printk("%s: 1\n", __func__);
     } while (cfs_rq);
 
-    p = task_of(se);
-    return p;
+    return task_of(se);
+}
+
+/*
+ * Account for a descheduled task:
+ */
+static void put_prev_task_fair(struct rq *rq, struct task_struct *prev)
+{
+    struct sched_entity *se = &prev->se;
+    struct cfs_rq *cfs_rq;
+
+    for_each_sched_entity(se) {
+        cfs_rq = cfs_rq_of(se);
+        put_prev_entity(cfs_rq, se);
+    }
 }
 
 /*
@@ -185,16 +574,188 @@ enqueue_task_fair(struct rq *rq, struct task_struct *p, int flags)
             break;
 
         cfs_rq = cfs_rq_of(se);
-        printk("%s: cfs_rq(%lx)\n", __func__, cfs_rq);
         enqueue_entity(cfs_rq, se, flags);
 
         flags = ENQUEUE_WAKEUP;
     }
+
+    if (!se)
+        rq->nr_running++;
+}
+
+/*
+ * The dequeue_task method is called before nr_running is
+ * decreased. We remove the task from the rbtree and
+ * update the fair scheduling stats:
+ */
+static void
+dequeue_task_fair(struct rq *rq, struct task_struct *p, int flags)
+{
+    struct cfs_rq *cfs_rq;
+    struct sched_entity *se = &p->se;
+
+    for_each_sched_entity(se) {
+        cfs_rq = cfs_rq_of(se);
+        dequeue_entity(cfs_rq, se, flags);
+
+        /* Don't dequeue parent if it has other entities besides us */
+        if (cfs_rq->load.weight)
+            break;
+
+        flags |= DEQUEUE_SLEEP;
+    }
+
+    if (!se)
+        rq->nr_running--;
+}
+
+static unsigned long
+wakeup_gran(struct sched_entity *se)
+{
+    /*
+     * Since its curr running now, convert the gran from real-time
+     * to virtual-time in his units.
+     */
+    return calc_delta_fair(SCHED_WAKEUP_GRANULARITY, se);
+}
+
+/*
+ * Should 'se' preempt 'curr'.
+ *
+ *             |s1
+ *        |s2
+ *   |s3
+ *         g
+ *      |<--->|c
+ *
+ *  w(c, s1) = -1
+ *  w(c, s2) =  0
+ *  w(c, s3) =  1
+ *
+ */
+static int
+wakeup_preempt_entity(struct sched_entity *curr, struct sched_entity *se)
+{
+    s64 gran, vdiff = curr->vruntime - se->vruntime;
+
+    if (vdiff <= 0)
+        return -1;
+
+    gran = wakeup_gran(se);
+    if (vdiff > gran)
+        return 1;
+
+    return 0;
+}
+
+/*
+ * Preempt the current task with a newly woken task if needed:
+ */
+static void
+check_preempt_wakeup(struct rq *rq, struct task_struct *p, int wake_flags)
+{
+    struct task_struct *curr = rq->curr;
+    struct sched_entity *se = &curr->se, *pse = &p->se;
+
+    if (unlikely(se == pse))
+        return;
+
+    if (test_tsk_need_resched(curr))
+        return;
+
+    update_curr(cfs_rq_of(se));
+    if (wakeup_preempt_entity(se, pse) == 1)
+        resched_curr(rq);
+}
+
+/*
+ * scheduler tick hitting a task of our scheduling class.
+ */
+static void task_tick_fair(struct rq *rq, struct task_struct *curr, int queued)
+{
+    struct cfs_rq *cfs_rq;
+    struct sched_entity *se = &curr->se;
+
+    for_each_sched_entity(se) {
+        cfs_rq = cfs_rq_of(se);
+        entity_tick(cfs_rq, se, queued);
+    }
+}
+
+/*
+ * called on fork with the child task as argument from the parent's context
+ *  - child not yet on the tasklist
+ *  - preemption disabled
+ */
+static void task_fork_fair(struct task_struct *p)
+{
+    struct sched_entity *se = &p->se, *curr;
+    struct cfs_rq *cfs_rq = p->se.cfs_rq;
+    struct rq *rq = task_rq(p);
+
+    update_rq_clock(rq);
+
+    /*
+     * Children of the idle task, the boot threads, start together at
+     * min_vruntime and run in the order they were created.
+     */
+    curr = cfs_rq->curr;
+    if (!curr) {
+        se->vruntime = cfs_rq->min_vruntime;
+        return;
+    }
+
+    update_curr(cfs_rq);
+    se->vruntime = curr->vruntime;
+    place_entity(cfs_rq, se, 1);
+}
+
+/*
+ * The previous CPU of @p if it is idle, its cache may still be warm,
+ * else the first idle one, else the one with the fewest tasks.
+ */
+static int select_task_rq_fair(struct task_struct *p, int prev_cpu)
+{
+    int cpu, best = prev_cpu;
+
+    if (idle_cpu(prev_cpu))
+        return prev_cpu;
+
+    for_each_online_cpu(cpu) {
+        if (idle_cpu(cpu))
+            return cpu;
+
+        if (cpu_rq(cpu)->nr_running < cpu_rq(best)->nr_running)
+            best = cpu;
+    }
+
+    return best;
+}
+
+/*
+ * The vruntime of @p is relative to the min_vruntime of the cfs_rq it
+ * leaves, it keeps its lead or lag on that of the one it goes to.
+ */
+static void migrate_task_rq_fair(struct task_struct *p, int new_cpu)
+{
+    struct sched_entity *se = &p->se;
+
+    se->vruntime -= cfs_rq_of(se)->min_vruntime;
+    set_task_rq(p, new_cpu);
+    se->vruntime += cfs_rq_of(se)->min_vruntime;
 }
 
 /*
  * All the scheduling class methods:
  */
 const struct sched_class fair_sched_class = {
-    .enqueue_task = enqueue_task_fair,
+    .enqueue_task   = enqueue_task_fair,
+    .dequeue_task   = dequeue_task_fair,
+    .check_preempt_curr = check_preempt_wakeup,
+    .put_prev_task  = put_prev_task_fair,
+    .task_tick      = task_tick_fair,
+    .task_fork      = task_fork_fair,
+
+    .select_task_rq = select_task_rq_fair,
+    .migrate_task_rq = migrate_task_rq_fair,
 };
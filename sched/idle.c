@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Generic entry point for the idle thread.
+ */
+
+#include <smp.h>
+#include <tick.h>
+#include <sched.h>
+#include <export.h>
+#include <printk.h>
+#include <irqflags.h>
+#include <processor.h>
+
+#include "internal.h"
+
+/*
+ * Entered with interrupts off, so that one which comes after the test
+ * of need_resched() still ends the wait: wfi returns on a pending
+ * interrupt whatever sstatus.SIE says, it is taken once they are on.
+ */
+static void default_idle_call(void)
+{
+    wait_for_interrupt();
+    local_irq_enable();
+}
+
+/*
+ * Generic idle loop implementation
+ *
+ * Every interrupt ends the wait and comes back around, the tick is
+ * stopped again up to the next timer that it may have queued.
+ */
+static void do_idle(void)
+{
+    /*
+     * Nothing else to do, and the tick may not come to drain the log.
+     * Only on the boot CPU, which the console and its interrupt are on.
+     * The idle loop runs without the kernel lock, the tasks on the
+     * other CPUs write to the console as well.
+     */
+    if (!smp_processor_id()) {
+        lock_kernel();
+        console_flush();
+        unlock_kernel();
+    }
+
+    tick_nohz_idle_enter();
+
+    while (!need_resched()) {
+        local_irq_disable();
+
+        tick_nohz_idle_stop_tick();
+        if (need_resched()) {
+            local_irq_enable();
+            break;
+        }
+
+        default_idle_call();
+    }
+
+    tick_nohz_idle_exit();
+    schedule();
+}
+
+void cpu_startup_entry(void)
+{
+    while (1)
+        do_idle();
+}
+EXPORT_SYMBOL(cpu_startup_entry);
@@ -0,0 +1,68 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+
+#include <sched.h>
+#include <ktime.h>
+#include <clocksource.h>
+
+/*
+ * Increase resolution of nice-level calculations for 64-bit
+ * architectures. The extra resolution improves shares distribution
+ * and load balancing of low-weight task groups.
+ */
+#define scale_load(w)       ((w) << SCHED_FIXEDPOINT_SHIFT)
+#define scale_load_down(w)                                  \
+({                                                          \
+    unsigned long __w = (w);                                \
+    if (__w)                                                \
+        __w = max(2UL, __w >> SCHED_FIXEDPOINT_SHIFT);      \
+    __w;                                                    \
+})
+
+#define WEIGHT_IDLEPRIO     3
+#define WMULT_IDLEPRIO      1431655765
+
+extern const int sched_prio_to_weight[40];
+extern const u32 sched_prio_to_wmult[40];
+
+/* Targeted preemption latency for CPU-bound tasks, in ns */
+#define SCHED_LATENCY           (6 * NSEC_PER_MSEC)
+/* Minimal preemption granularity for CPU-bound tasks */
+#define SCHED_MIN_GRANULARITY   (750 * NSEC_PER_USEC)
+/* More runnable tasks than that stretch the period, see __sched_period() */
+#define SCHED_NR_LATENCY        8
+/* Lead in vruntime a woken task needs to preempt the current one */
+#define SCHED_WAKEUP_GRANULARITY    (1 * NSEC_PER_MSEC)
+
+static inline u64 rq_clock(struct rq *rq)
+{
+    return rq->clock;
+}
+
+static inline void update_rq_clock(struct rq *rq)
+{
+    rq->clock = sched_clock();
+}
+
+static inline void update_load_add(struct load_weight *lw, unsigned long inc)
+{
+    lw->weight += inc;
+    lw->inv_weight = 0;
+}
+
+static inline void update_load_sub(struct load_weight *lw, unsigned long dec)
+{
+    lw->weight -= dec;
+    lw->inv_weight = 0;
+}
+
+static inline void update_load_set(struct load_weight *lw, unsigned long w)
+{
+    lw->weight = w;
+    lw->inv_weight = 0;
+}
+
+void resched_curr(struct rq *rq);
+
+void activate_task(struct rq *rq, struct task_struct *p, int flags);
+void deactivate_task(struct rq *rq, struct task_struct *p, int flags);
+void set_task_cpu(struct task_struct *p, unsigned int new_cpu);
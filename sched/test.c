@@ -1 +1,138 @@
 // SPDX-License-Identifier: GPL-2.0-only
+
+#include <wait.h>
+#include <sched.h>
+#include <printk.h>
+#include <linkage.h>
+#include <current.h>
+#include <wait_bit.h>
+
+static unsigned long test_woken;
+
+static int
+test_wake_function(struct wait_queue_entry *wq_entry,
+                   unsigned mode, int flags, void *key)
+{
+    test_woken++;
+    return 1;
+}
+
+static int
+test_wake_up(void)
+{
+    DECLARE_WAIT_QUEUE_HEAD(wq_head);
+    struct wait_queue_entry entries[3];
+    int i;
+
+    for (i = 0; i < 3; i++) {
+        init_waitqueue_entry(&entries[i], current);
+        entries[i].func = test_wake_function;
+    }
+
+    add_wait_queue(&wq_head, &entries[0]);
+    add_wait_queue_exclusive(&wq_head, &entries[1]);
+    add_wait_queue_exclusive(&wq_head, &entries[2]);
+
+    /* All the non-exclusive ones and a single exclusive one */
+    test_woken = 0;
+    wake_up(&wq_head);
+    if (test_woken != 2) {
+        printk(_RED("wake_up woke %lu!\n"), test_woken);
+        return -1;
+    }
+
+    test_woken = 0;
+    wake_up_all(&wq_head);
+    if (test_woken != 3) {
+        printk(_RED("wake_up_all woke %lu!\n"), test_woken);
+        return -1;
+    }
+
+    for (i = 0; i < 3; i++)
+        remove_wait_queue(&wq_head, &entries[i]);
+
+    if (waitqueue_active(&wq_head)) {
+        printk(_RED("waitqueue still active!\n"));
+        return -1;
+    }
+
+    return 0;
+}
+
+static int
+test_try_to_wake_up(void)
+{
+    DECLARE_WAIT_QUEUE_HEAD(wq_head);
+    DEFINE_WAIT(wait);
+
+    prepare_to_wait(&wq_head, &wait, TASK_UNINTERRUPTIBLE);
+    if (current->state != TASK_UNINTERRUPTIBLE) {
+        printk(_RED("state %lx after prepare_to_wait!\n"), current->state);
+        return -1;
+    }
+
+    /* Autoremoved when woken, so the queue is empty after */
+    wake_up(&wq_head);
+    if (current->state != TASK_RUNNING || waitqueue_active(&wq_head)) {
+        printk(_RED("not woken, state %lx!\n"), current->state);
+        return -1;
+    }
+    finish_wait(&wq_head, &wait);
+
+    if (wake_up_process(current)) {
+        printk(_RED("woke up a running task!\n"));
+        return -1;
+    }
+
+    return 0;
+}
+
+static int
+test_wait_on_bit(void)
+{
+    unsigned long word = 0;
+
+    /* Clear or taken at once, neither sleeps */
+    if (wait_on_bit_io(&word, 3, TASK_UNINTERRUPTIBLE)) {
+        printk(_RED("wait on a clear bit failed!\n"));
+        return -1;
+    }
+
+    if (wait_on_bit_lock_io(&word, 3, TASK_UNINTERRUPTIBLE) || word != 8) {
+        printk(_RED("bit lock failed, word %lx!\n"), word);
+        return -1;
+    }
+
+    if (bit_waitqueue(&word, 3) != bit_waitqueue(&word, 3)) {
+        printk(_RED("bit waitqueue isn't stable!\n"));
+        return -1;
+    }
+
+    return 0;
+}
+
+static int __init
+init_module(void)
+{
+    printk("module[test_sched]: init begin ...\n");
+
+    if (test_wake_up()) {
+        printk(_RED("test wake_up failed!\n"));
+        return -1;
+    }
+
+    if (test_try_to_wake_up()) {
+        printk(_RED("test try_to_wake_up failed!\n"));
+        return -1;
+    }
+
+    if (test_wait_on_bit()) {
+        printk(_RED("test wait_on_bit failed!\n"));
+        return -1;
+    }
+
+    printk(_GREEN("okay!\n"));
+
+    printk("module[test_sched]: init end!\n");
+    return 0;
+}
@@ -0,0 +1,141 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * benchcmp - compare the bench tables of two console logs
+ *
+ * Usage: benchcmp base.log new.log [percent]
+ *
+ * Takes the last table that the bench module wrote into each log and
+ * compares the median cycles of every benchmark in both. Exits with 1
+ * if any got slower by more than @percent, 5 by default, so it can
+ * gate changes on a run with 'make BENCH=1'.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Keep in sync with bench/bench.c */
+#define BENCH_PREFIX    "bench: "
+
+struct row {
+    char name[64];
+    unsigned long arg;
+    unsigned long min, median, p99, insns;
+};
+
+struct table {
+    struct row *rows;
+    unsigned int nr;
+};
+
+static void
+fatal(const char *fmt, const char *arg)
+{
+    fprintf(stderr, "benchcmp: ");
+    fprintf(stderr, fmt, arg);
+    fprintf(stderr, "\n");
+    exit(2);
+}
+
+static void
+read_table(const char *path, struct table *t)
+{
+    char line[512];
+    struct row r;
+    const char *p;
+    unsigned int ops;
+    FILE *fp;
+
+    fp = fopen(path, "r");
+    if (!fp)
+        fatal("cannot open %s", path);
+
+    t->rows = NULL;
+    t->nr = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        p = strstr(line, BENCH_PREFIX);
+        if (!p)
+            continue;
+        p += strlen(BENCH_PREFIX);
+
+        /* A later table replaces an earlier one */
+        if (!strncmp(p, "begin", 5)) {
+            t->nr = 0;
+            continue;
+        }
+        if (sscanf(p, "%63s %lu %u %lu %lu %lu %lu", r.name, &r.arg, &ops,
+                   &r.min, &r.median, &r.p99, &r.insns) != 7)
+            continue;
+
+        t->rows = realloc(t->rows, (t->nr + 1) * sizeof(*t->rows));
+        if (!t->rows)
+            fatal("%s", "out of memory");
+        t->rows[t->nr++] = r;
+    }
+    fclose(fp);
+
+    if (!t->nr)
+        fatal("no bench table in %s", path);
+}
+
+static const struct row *
+find_row(const struct table *t, const struct row *r)
+{
+    unsigned int i;
+
+    for (i = 0; i < t->nr; i++) {
+        if (!strcmp(t->rows[i].name, r->name) && t->rows[i].arg == r->arg)
+            return t->rows + i;
+    }
+    return NULL;
+}
+
+int main(int argc, char *argv[])
+{
+    struct table base, new;
+    const struct row *b, *n;
+    double limit = 5, delta;
+    unsigned int i, regressed = 0;
+
+    if (argc < 3 || argc > 4) {
+        fprintf(stderr, "Usage: %s base.log new.log [percent]\n", argv[0]);
+        return 2;
+    }
+    if (argc == 4)
+        limit = atof(argv[3]);
+
+    read_table(argv[1], &base);
+    read_table(argv[2], &new);
+
+    printf("# %-20s %8s %10s %10s %8s  (median cycles)\n",
+           "name", "arg", "base", "new", "delta");
+    for (i = 0; i < new.nr; i++) {
+        n = new.rows + i;
+        b = find_row(&base, n);
+        if (!b) {
+            printf("  %-20s %8lu %10s %10lu %8s\n",
+                   n->name, n->arg, "-", n->median, "new");
+            continue;
+        }
+
+        delta = b->median ? 100.0 * ((double)n->median - b->median) /
+            b->median : 0;
+        printf("  %-20s %8lu %10lu %10lu %+7.1f%%%s\n",
+               n->name, n->arg, b->median, n->median, delta,
+               delta > limit ? "  REGRESSED" : "");
+        if (delta > limit)
+            regressed++;
+    }
+
+    for (i = 0; i < base.nr; i++) {
+        if (!find_row(&new, base.rows + i))
+            printf("  %-20s %8lu %10lu %10s %8s\n", base.rows[i].name,
+                   base.rows[i].arg, base.rows[i].median, "-", "gone");
+    }
+
+    if (regressed) {
+        printf("# %u regressed by more than %.1f%%\n", regressed, limit);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,26 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef _SCRIPTS_INITCALL_H
+#define _SCRIPTS_INITCALL_H
+
+/*
+ * Force-included by scripts/Makefile.monolithic into the file which
+ * defines init_module() of a subsystem. The entry is collected into
+ * the initcall table by startup.lds and called by load_modules() in
+ * place of loading the module.
+ */
+
+#include <module.h>
+
+static int init_module(void);
+
+/* Stays MODULE_INIT_BOOT unless the file has MODULE_INIT_LEVEL(). */
+static const int init_module_level;
+
+static const struct initcall __initcall_entry
+__attribute__((used, section(".initcall." INITCALL_LEVEL))) = {
+    .init   = init_module,
+    .level  = &init_module_level,
+    .idx    = INITCALL_IDX,
+};
+
+#endif /* _SCRIPTS_INITCALL_H */
@@ -0,0 +1,49 @@
+#!/bin/sh
+# SPDX-License-Identifier: GPL-2.0
+#
+# Usage: initcall_deps.sh <nm> <subdir>...
+#
+# Writes the table of which subsystem of the monolithic image uses the
+# symbols of which other one to stdout, from the objects listed in the
+# objs.mono of each <subdir>. Subsystems are numbered from 1 in the
+# order given, like the idx of scripts/Makefile.monolithic, and
+# startup/module.c promotes the deferred initcalls with it as the
+# loader does for modules.
+
+nm=$1
+shift
+nr=$#
+
+idx=0
+for dir in "$@"; do
+    idx=$((idx + 1))
+    $nm $(cat $dir/objs.mono) | awk -v idx=$idx '
+        NF == 2 && $1 == "U"        { print idx, "U", $2 }
+        NF == 3 && $2 ~ /^[A-Z]$/   { print idx, "D", $3 }'
+done | awk '
+    $2 == "D"   { owner[$3] = $1; next }
+                { used[$1, $3] = 1 }
+    END {
+        for (k in used) {
+            split(k, u, SUBSEP)
+            if (u[2] in owner && owner[u[2]] != u[1])
+                print u[1], owner[u[2]]
+        }
+    }' | sort -n -k1,1 -k2,2 -u | awk -v nr=$nr '
+    BEGIN {
+        print "/* Generated by scripts/initcall_deps.sh, do not edit */"
+        print ""
+        print "#include <module.h>"
+        print ""
+        print "const struct initcall_dep initcall_deps[] = {"
+    }
+          { printf "    { %d, %d },\n", $1, $2 }
+    END {
+        print "};"
+        print ""
+        print "const int nr_initcall_deps ="
+        print "    sizeof(initcall_deps) / sizeof(initcall_deps[0]);"
+        print ""
+        print "/* By subsystem, set when a boot one needs a deferred one */"
+        printf "bool initcall_promoted[%d];\n", nr + 1
+    }'
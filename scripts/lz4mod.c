@@ -0,0 +1,346 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * lz4mod - compress a module for the boot loader
+ *
+ * Usage: lz4mod module.ko module.ko.lz4
+ *
+ * Splits the module into the meta, image and init LZ4 blocks described
+ * by include/lz4.h. The image is laid out here like layout_sections() in
+ * startup/module.c does it, so that the loader can decompress it
+ * straight to the load address instead of copying section by section.
+ *
+ * Any change to layout_sections() in startup/module.c must be mirrored
+ * here.
+ */
+
+#include <elf.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ROUND_UP(x, n) (((x) + (n) - 1UL) & ~((n) - 1UL))
+
+/* Keep in sync with include/lz4.h */
+#define MODULE_LZ4_MAGIC    "XLMODLZ4"
+#define MODULE_LZ4_SMAGIC   8
+
+struct module_lz4_header {
+    char magic[MODULE_LZ4_SMAGIC];
+    uint32_t meta_size;
+    uint32_t meta_csize;
+    uint32_t image_size;
+    uint32_t image_csize;
+    uint32_t init_size;
+    uint32_t init_csize;
+};
+
+/* Marks the sh_entsize of a section laid out in the init area */
+#define INIT_OFFSET_MASK    (1UL << 63)
+
+#define LZ4_MINMATCH        4
+#define LZ4_LASTLITERALS    5   /* the last bytes are always literals */
+#define LZ4_MFLIMIT         12  /* no match starts within these */
+#define LZ4_MAX_OFFSET      65535
+#define LZ4_HASH_BITS       16
+
+static void
+fatal(const char *fmt, const char *arg)
+{
+    fprintf(stderr, "lz4mod: ");
+    fprintf(stderr, fmt, arg);
+    fprintf(stderr, "\n");
+    exit(1);
+}
+
+static void *
+xzalloc(size_t size)
+{
+    void *p = calloc(1, size ? : 1);
+    if (!p)
+        fatal("%s", "out of memory");
+    return p;
+}
+
+static unsigned char *
+read_file(const char *path, size_t *len)
+{
+    unsigned char *data;
+    FILE *fp;
+    long n;
+
+    fp = fopen(path, "rb");
+    if (!fp)
+        fatal("cannot open %s", path);
+
+    fseek(fp, 0, SEEK_END);
+    n = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+
+    data = xzalloc(n);
+    if (n < 0 || fread(data, 1, n, fp) != (size_t)n)
+        fatal("cannot read %s", path);
+
+    fclose(fp);
+    *len = n;
+    return data;
+}
+
+static uint32_t
+read32(const unsigned char *p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static unsigned char *
+put_length(unsigned char *op, size_t len)
+{
+    for (; len >= 255; len -= 255)
+        *op++ = 255;
+    *op++ = len;
+    return op;
+}
+
+static unsigned char *
+put_sequence(unsigned char *op, const unsigned char *lit, size_t lit_len,
+             size_t offset, size_t match_len)
+{
+    unsigned char *token = op++;
+
+    *token = (lit_len < 15 ? lit_len : 15) << 4;
+    if (lit_len >= 15)
+        op = put_length(op, lit_len - 15);
+
+    memcpy(op, lit, lit_len);
+    op += lit_len;
+
+    /* The last sequence ends with the literals. */
+    if (!match_len)
+        return op;
+
+    *op++ = offset & 0xff;
+    *op++ = offset >> 8;
+
+    match_len -= LZ4_MINMATCH;
+    *token |= match_len < 15 ? match_len : 15;
+    if (match_len >= 15)
+        op = put_length(op, match_len - 15);
+
+    return op;
+}
+
+/* Greedy LZ4 block compression, @dst has room for lz4_bound(len) */
+static size_t
+lz4_compress(const unsigned char *src, size_t len, unsigned char *dst)
+{
+    uint32_t *table = xzalloc(sizeof(uint32_t) << LZ4_HASH_BITS);
+    unsigned char *op = dst;
+    size_t anchor = 0;
+    size_t ip = 0;
+
+    while (len > LZ4_MFLIMIT && ip < len - LZ4_MFLIMIT) {
+        uint32_t seq = read32(src + ip);
+        uint32_t h = (seq * 2654435761U) >> (32 - LZ4_HASH_BITS);
+        size_t ref = table[h];
+        size_t match_len;
+
+        table[h] = ip + 1;
+
+        if (!ref-- || ip - ref > LZ4_MAX_OFFSET ||
+            read32(src + ref) != seq) {
+            ip++;
+            continue;
+        }
+
+        match_len = LZ4_MINMATCH;
+        while (ip + match_len < len - LZ4_LASTLITERALS &&
+               src[ref + match_len] == src[ip + match_len])
+            match_len++;
+
+        op = put_sequence(op, src + anchor, ip - anchor, ip - ref, match_len);
+        ip += match_len;
+        anchor = ip;
+    }
+
+    op = put_sequence(op, src + anchor, len - anchor, 0, 0);
+
+    free(table);
+    return op - dst;
+}
+
+static size_t
+lz4_bound(size_t len)
+{
+    return len + len / 255 + 16;
+}
+
+static uint64_t
+get_offset(uint64_t *size, Elf64_Shdr *s)
+{
+    uint64_t align = s->sh_addralign ? : 1;
+    uint64_t ret;
+
+    ret = (*size + align - 1) & ~(align - 1);
+    *size = ret + s->sh_size;
+    return ret;
+}
+
+static int
+is_init_section(const char *name)
+{
+    return !strncmp(name, ".init", 5);
+}
+
+/* Mirror of layout_sections() in startup/module.c */
+static void
+layout_sections(Elf64_Ehdr *hdr, Elf64_Shdr *sechdrs, const char *secstrings,
+                uint64_t *size, uint64_t *init_size)
+{
+    static unsigned long const masks[][2] = {
+        { SHF_EXECINSTR | SHF_ALLOC, 0 },
+        { SHF_ALLOC, SHF_WRITE },
+        { SHF_WRITE | SHF_ALLOC, 0 },
+        { SHF_ALLOC, 0 }
+    };
+    unsigned int m, i;
+
+    *size = 0;
+    *init_size = 0;
+
+    for (i = 0; i < hdr->e_shnum; i++)
+        sechdrs[i].sh_entsize = ~0UL;
+
+    for (m = 0; m < sizeof(masks) / sizeof(masks[0]); ++m) {
+        for (i = 0; i < hdr->e_shnum; ++i) {
+            Elf64_Shdr *s = sechdrs + i;
+
+            if ((s->sh_flags & masks[m][0]) != masks[m][0]
+                || (s->sh_flags & masks[m][1])
+                || s->sh_entsize != ~0UL
+                || is_init_section(secstrings + s->sh_name))
+                continue;
+
+            s->sh_entsize = get_offset(size, s);
+        }
+    }
+
+    for (m = 0; m < sizeof(masks) / sizeof(masks[0]); ++m) {
+        for (i = 0; i < hdr->e_shnum; ++i) {
+            Elf64_Shdr *s = sechdrs + i;
+
+            if ((s->sh_flags & masks[m][0]) != masks[m][0]
+                || (s->sh_flags & masks[m][1])
+                || s->sh_entsize != ~0UL
+                || !is_init_section(secstrings + s->sh_name))
+                continue;
+
+            s->sh_entsize = get_offset(init_size, s) | INIT_OFFSET_MASK;
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    struct module_lz4_header lz;
+    unsigned char *data, *meta, *image, *init, *zmeta, *zimage, *zinit;
+    const char *secstrings;
+    Elf64_Ehdr *hdr;
+    Elf64_Shdr *sechdrs, *layout, *meta_sechdrs;
+    uint64_t image_size, init_size, meta_size;
+    size_t len;
+    unsigned int i;
+    FILE *fp;
+
+    if (argc != 3) {
+        fprintf(stderr, "Usage: %s module.ko module.ko.lz4\n", argv[0]);
+        return 1;
+    }
+
+    data = read_file(argv[1], &len);
+    hdr = (Elf64_Ehdr *)data;
+    if (len < sizeof(*hdr) || memcmp(hdr->e_ident, ELFMAG, SELFMAG) ||
+        hdr->e_type != ET_REL || hdr->e_machine != EM_RISCV ||
+        hdr->e_shoff + hdr->e_shnum * sizeof(Elf64_Shdr) > len)
+        fatal("%s is not a RISC-V module", argv[1]);
+
+    sechdrs = (Elf64_Shdr *)(data + hdr->e_shoff);
+    if (hdr->e_shstrndx >= hdr->e_shnum ||
+        sechdrs[hdr->e_shstrndx].sh_offset >= len)
+        fatal("%s has no section names", argv[1]);
+    secstrings = (const char *)data + sechdrs[hdr->e_shstrndx].sh_offset;
+
+    /* image and init: allocated sections at their offsets from layout */
+    layout = xzalloc(hdr->e_shnum * sizeof(Elf64_Shdr));
+    memcpy(layout, sechdrs, hdr->e_shnum * sizeof(Elf64_Shdr));
+    layout_sections(hdr, layout, secstrings, &image_size, &init_size);
+    image = xzalloc(image_size);
+    init = xzalloc(init_size);
+
+    /* meta: ELF header, non-allocated sections, section headers */
+    meta = xzalloc(len + hdr->e_shnum * sizeof(Elf64_Shdr));
+    meta_size = sizeof(*hdr);
+
+    for (i = 1; i < hdr->e_shnum; i++) {
+        Elf64_Shdr *s = sechdrs + i;
+
+        if (s->sh_type != SHT_NOBITS && s->sh_offset + s->sh_size > len)
+            fatal("%s has a truncated section", argv[1]);
+
+        if (s->sh_flags & SHF_ALLOC) {
+            uint64_t offset = layout[i].sh_entsize;
+
+            if (s->sh_type != SHT_NOBITS) {
+                if (offset & INIT_OFFSET_MASK)
+                    memcpy(init + (offset & ~INIT_OFFSET_MASK),
+                           data + s->sh_offset, s->sh_size);
+                else
+                    memcpy(image + offset, data + s->sh_offset, s->sh_size);
+            }
+            s->sh_offset = 0;
+            continue;
+        }
+
+        meta_size = ROUND_UP(meta_size, s->sh_addralign > 8 ?
+                             s->sh_addralign : 8);
+        memcpy(meta + meta_size, data + s->sh_offset, s->sh_size);
+        s->sh_offset = meta_size;
+        meta_size += s->sh_size;
+    }
+
+    meta_size = ROUND_UP(meta_size, 8);
+    meta_sechdrs = (Elf64_Shdr *)(meta + meta_size);
+    memcpy(meta_sechdrs, sechdrs, hdr->e_shnum * sizeof(Elf64_Shdr));
+
+    hdr->e_phoff = 0;
+    hdr->e_shoff = meta_size;
+    memcpy(meta, hdr, sizeof(*hdr));
+    meta_size += hdr->e_shnum * sizeof(Elf64_Shdr);
+
+    zmeta = xzalloc(lz4_bound(meta_size));
+    zimage = xzalloc(lz4_bound(image_size));
+    zinit = xzalloc(lz4_bound(init_size));
+
+    memset(&lz, 0, sizeof(lz));
+    memcpy(lz.magic, MODULE_LZ4_MAGIC, MODULE_LZ4_SMAGIC);
+    lz.meta_size = meta_size;
+    lz.meta_csize = lz4_compress(meta, meta_size, zmeta);
+    lz.image_size = image_size;
+    lz.image_csize = lz4_compress(image, image_size, zimage);
+    lz.init_size = init_size;
+    lz.init_csize = lz4_compress(init, init_size, zinit);
+
+    fp = fopen(argv[2], "wb");
+    if (!fp)
+        fatal("cannot create %s", argv[2]);
+
+    if (fwrite(&lz, sizeof(lz), 1, fp) != 1 ||
+        fwrite(zmeta, 1, lz.meta_csize, fp) != lz.meta_csize ||
+        fwrite(zimage, 1, lz.image_csize, fp) != lz.image_csize ||
+        fwrite(zinit, 1, lz.init_csize, fp) != lz.init_csize)
+        fatal("cannot write %s", argv[2]);
+
+    fclose(fp);
+    return 0;
+}
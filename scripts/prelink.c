@@ -0,0 +1,724 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * prelink - link modules into a fixed-layout boot image on the host
+ *
+ * Usage: prelink startup.elf modules.img module.ko ...
+ *
+ * Does the same work as init_other_modules() in startup/module.c for
+ * each module in the given order: layout sections, copy them to the
+ * load address, resolve symbols and apply relocations. The result is
+ * written as an image described by include/prelink.h, which the boot
+ * loader copies to the load address as is.
+ *
+ * Any change to the layout or relocation code in startup/module.c
+ * must be mirrored here.
+ */
+
+#include <elf.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "asm-offsets.h"
+
+#define ROUND_UP(x, n) (((x) + (n) - 1UL) & ~((n) - 1UL))
+
+#define SHN_LIVEPATCH   0xff20
+
+/* Keep in sync with include/prelink.h */
+#define PRELINK_MAGIC   "XLPRELNK"
+#define PRELINK_SMAGIC  8
+#define PRELINK_VERSION 5
+
+#define MODULE_NAME_LEN 32
+
+/* Keep in sync with include/module.h */
+#define MODULE_INIT_BOOT        0
+#define MODULE_INIT_DEFERRED    1
+
+struct prelink_header {
+    char magic[PRELINK_SMAGIC];
+    uint32_t version;
+    uint32_t nr_modules;
+    uint64_t base;
+    uint64_t module_size;
+    uint64_t total_size;
+    uint64_t ksymtab_hash;
+};
+
+#define PRELINK_FNV_OFFSET  0xcbf29ce484222325ULL
+#define PRELINK_FNV_PRIME   0x100000001b3ULL
+
+struct prelink_entry {
+    char name[MODULE_NAME_LEN];
+    uint64_t addr;
+    uint64_t size;
+    uint64_t syms;
+    uint64_t num_syms;
+    uint64_t init;
+    uint64_t exit;
+    uint64_t init_level;
+    uint64_t jump_entries;
+    uint64_t num_jump_entries;
+};
+
+/* Same layout as struct kernel_symbol on the target */
+struct kernel_symbol {
+    uint64_t value;
+    uint64_t name;
+};
+
+struct ksym {
+    const char *name;
+    uint64_t value;
+    int owner;          /* index into entries, -1 for the kernel */
+};
+
+/* Deferred modules used by each module, as in struct module */
+struct deps {
+    int *mods;
+    int nr;
+};
+
+struct elf_file {
+    const char *path;
+    unsigned char *data;
+    size_t len;
+    Elf64_Ehdr *hdr;
+    Elf64_Shdr *sechdrs;
+    const char *secstrings;
+    unsigned int symindex;
+    const char *strtab;
+};
+
+static struct ksym *ksyms;
+static size_t nr_ksyms;
+static size_t max_ksyms;
+
+static unsigned char *image;
+static uint64_t image_base;
+static uint64_t image_len;
+
+static struct prelink_entry *entries;
+static struct deps *entry_deps;
+static unsigned int nr_entries;
+static struct deps cur_deps;
+
+static int unresolved;
+
+/* Of the names and values in _ksymtab, as ksymtab_hash() at boot */
+static uint64_t ksymtab_hash = PRELINK_FNV_OFFSET;
+
+static void
+fatal(const char *fmt, const char *arg)
+{
+    fprintf(stderr, "prelink: ");
+    fprintf(stderr, fmt, arg);
+    fprintf(stderr, "\n");
+    exit(1);
+}
+
+static void *
+xrealloc(void *p, size_t size)
+{
+    p = realloc(p, size);
+    if (!p)
+        fatal("%s", "out of memory");
+    return p;
+}
+
+static void
+read_elf(const char *path, struct elf_file *ef)
+{
+    unsigned int i;
+    FILE *fp;
+
+    fp = fopen(path, "rb");
+    if (!fp)
+        fatal("cannot open %s", path);
+
+    fseek(fp, 0, SEEK_END);
+    ef->len = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+
+    ef->data = xrealloc(NULL, ef->len);
+    if (fread(ef->data, 1, ef->len, fp) != ef->len)
+        fatal("cannot read %s", path);
+    fclose(fp);
+
+    ef->path = path;
+    ef->hdr = (Elf64_Ehdr *)ef->data;
+    if (memcmp(ef->hdr->e_ident, ELFMAG, SELFMAG) ||
+        ef->hdr->e_ident[EI_CLASS] != ELFCLASS64 ||
+        ef->hdr->e_machine != EM_RISCV)
+        fatal("%s is not a riscv64 ELF file", path);
+
+    ef->sechdrs = (Elf64_Shdr *)(ef->data + ef->hdr->e_shoff);
+    ef->secstrings = (char *)ef->data +
+        ef->sechdrs[ef->hdr->e_shstrndx].sh_offset;
+
+    ef->symindex = 0;
+    ef->strtab = NULL;
+    for (i = 1; i < ef->hdr->e_shnum; i++) {
+        if (ef->sechdrs[i].sh_type == SHT_SYMTAB) {
+            ef->symindex = i;
+            ef->strtab = (char *)ef->data +
+                ef->sechdrs[ef->sechdrs[i].sh_link].sh_offset;
+            break;
+        }
+    }
+    if (!ef->symindex)
+        fatal("%s has no symbol table", path);
+}
+
+static Elf64_Shdr *
+find_section(struct elf_file *ef, const char *name)
+{
+    unsigned int i;
+
+    for (i = 1; i < ef->hdr->e_shnum; i++) {
+        if (!strcmp(ef->secstrings + ef->sechdrs[i].sh_name, name))
+            return ef->sechdrs + i;
+    }
+    return NULL;
+}
+
+static Elf64_Sym *
+find_symbol(struct elf_file *ef, const char *name)
+{
+    Elf64_Shdr *symsec = ef->sechdrs + ef->symindex;
+    Elf64_Sym *sym = (Elf64_Sym *)(ef->data + symsec->sh_offset);
+    size_t i;
+
+    for (i = 1; i < symsec->sh_size / sizeof(Elf64_Sym); i++) {
+        if (!strcmp(ef->strtab + sym[i].st_name, name))
+            return sym + i;
+    }
+    return NULL;
+}
+
+static const struct ksym *
+lookup_ksym(const char *name)
+{
+    size_t i;
+
+    for (i = 0; i < nr_ksyms; i++) {
+        if (!strcmp(ksyms[i].name, name))
+            return ksyms + i;
+    }
+    return NULL;
+}
+
+/* The first definition of a name wins, as in resolve_symbol(). */
+static void
+add_ksym(const char *name, uint64_t value, int owner)
+{
+    if (lookup_ksym(name))
+        return;
+
+    if (nr_ksyms == max_ksyms) {
+        max_ksyms = max_ksyms ? max_ksyms * 2 : 1024;
+        ksyms = xrealloc(ksyms, max_ksyms * sizeof(*ksyms));
+    }
+    ksyms[nr_ksyms].name = name;
+    ksyms[nr_ksyms].value = value;
+    ksyms[nr_ksyms].owner = owner;
+    nr_ksyms++;
+}
+
+static void
+hash_bytes(const void *p, size_t len)
+{
+    const unsigned char *c = p;
+
+    while (len--) {
+        ksymtab_hash ^= *c++;
+        ksymtab_hash *= PRELINK_FNV_PRIME;
+    }
+}
+
+/* Exported symbols of the startup image, from _ksymtab */
+static void
+load_kernel_symbols(struct elf_file *ef)
+{
+    Elf64_Shdr *tab = find_section(ef, "_ksymtab");
+    Elf64_Shdr *str = find_section(ef, "_ksymtab_strings");
+    struct kernel_symbol *ks;
+    const char *name;
+    size_t i;
+
+    if (!tab || !str)
+        fatal("%s has no ksymtab", ef->path);
+
+    ks = (struct kernel_symbol *)(ef->data + tab->sh_offset);
+    for (i = 0; i < tab->sh_size / sizeof(*ks); i++) {
+        if (ks[i].name < str->sh_addr ||
+            ks[i].name >= str->sh_addr + str->sh_size)
+            fatal("%s has a bad ksymtab entry", ef->path);
+
+        name = (char *)ef->data + str->sh_offset +
+            (ks[i].name - str->sh_addr);
+        add_ksym(name, ks[i].value, -1);
+
+        hash_bytes(name, strlen(name) + 1);
+        hash_bytes(&ks[i].value, sizeof(ks[i].value));
+    }
+}
+
+static void *
+image_ptr(uint64_t addr)
+{
+    if (addr < image_base || addr >= image_base + image_len)
+        fatal("%s", "address out of the prelinked image");
+    return image + (addr - image_base);
+}
+
+static uint64_t
+get_offset(uint64_t *size, Elf64_Shdr *s)
+{
+    uint64_t align = s->sh_addralign ? : 1;
+    uint64_t ret;
+
+    ret = (*size + align - 1) & ~(align - 1);
+    *size = ret + s->sh_size;
+    return ret;
+}
+
+/*
+ * Mirror of layout_sections() in startup/module.c, except that .init.*
+ * sections stay with the module: the prelinked image has no init area.
+ */
+static uint64_t
+layout_sections(struct elf_file *ef)
+{
+    static unsigned long const masks[][2] = {
+        { SHF_EXECINSTR | SHF_ALLOC, 0 },
+        { SHF_ALLOC, SHF_WRITE },
+        { SHF_WRITE | SHF_ALLOC, 0 },
+        { SHF_ALLOC, 0 }
+    };
+    uint64_t size = 0;
+    unsigned int m, i;
+
+    for (i = 0; i < ef->hdr->e_shnum; i++)
+        ef->sechdrs[i].sh_entsize = ~0UL;
+
+    for (m = 0; m < sizeof(masks) / sizeof(masks[0]); ++m) {
+        for (i = 0; i < ef->hdr->e_shnum; ++i) {
+            Elf64_Shdr *s = ef->sechdrs + i;
+
+            if ((s->sh_flags & masks[m][0]) != masks[m][0]
+                || (s->sh_flags & masks[m][1])
+                || s->sh_entsize != ~0UL)
+                continue;
+
+            s->sh_entsize = get_offset(&size, s);
+        }
+    }
+
+    return size;
+}
+
+static void
+move_module(struct elf_file *ef, uint64_t addr)
+{
+    unsigned int i;
+
+    for (i = 0; i < ef->hdr->e_shnum; i++) {
+        Elf64_Shdr *s = ef->sechdrs + i;
+
+        if (!(s->sh_flags & SHF_ALLOC))
+            continue;
+
+        s->sh_addr = addr + s->sh_entsize;
+
+        if (s->sh_type != SHT_NOBITS)
+            memcpy(image_ptr(s->sh_addr), ef->data + s->sh_offset,
+                   s->sh_size);
+    }
+}
+
+/* Mirror of promote_module() in startup/module.c */
+static void
+promote_module(int idx)
+{
+    int i;
+
+    if (entries[idx].init_level != MODULE_INIT_DEFERRED)
+        return;
+
+    entries[idx].init_level = MODULE_INIT_BOOT;
+    for (i = 0; i < entry_deps[idx].nr; i++)
+        promote_module(entry_deps[idx].mods[i]);
+}
+
+static void
+add_dep(int owner)
+{
+    int i;
+
+    if (entries[owner].init_level != MODULE_INIT_DEFERRED)
+        return;
+
+    for (i = 0; i < cur_deps.nr; i++) {
+        if (cur_deps.mods[i] == owner)
+            return;
+    }
+
+    cur_deps.mods = xrealloc(cur_deps.mods,
+                             (cur_deps.nr + 1) * sizeof(int));
+    cur_deps.mods[cur_deps.nr++] = owner;
+}
+
+static void
+simplify_symbols(struct elf_file *ef)
+{
+    Elf64_Shdr *symsec = ef->sechdrs + ef->symindex;
+    Elf64_Sym *sym = (Elf64_Sym *)(ef->data + symsec->sh_offset);
+    const struct ksym *ksym;
+    size_t i;
+
+    for (i = 1; i < symsec->sh_size / sizeof(Elf64_Sym); i++) {
+        const char *name = ef->strtab + sym[i].st_name;
+
+        switch (sym[i].st_shndx) {
+        case SHN_COMMON:
+            fprintf(stderr, "%s: 'SHN_COMMON' isn't supported for %s\n",
+                    ef->path, name);
+            break;
+        case SHN_ABS:
+        case SHN_LIVEPATCH:
+            break;
+        case SHN_UNDEF:
+            ksym = lookup_ksym(name);
+            if (ksym) {
+                sym[i].st_value = ksym->value;
+                if (ksym->owner >= 0)
+                    add_dep(ksym->owner);
+                break;
+            }
+
+            fprintf(stderr, "%s: %s can't be resolved\n", ef->path, name);
+            unresolved++;
+            break;
+        default:
+            sym[i].st_value += ef->sechdrs[sym[i].st_shndx].sh_addr;
+            break;
+        }
+    }
+}
+
+static uint32_t
+read32(void *p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static void
+write32(void *p, uint32_t v)
+{
+    memcpy(p, &v, sizeof(v));
+}
+
+static uint16_t
+read16(void *p)
+{
+    uint16_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static void
+write16(void *p, uint16_t v)
+{
+    memcpy(p, &v, sizeof(v));
+}
+
+/* Mirror of apply_relocate_add() in startup/module.c */
+static void
+apply_relocate_add(struct elf_file *ef, unsigned int relsec)
+{
+    Elf64_Shdr *sechdrs = ef->sechdrs;
+    Elf64_Shdr *shdr = sechdrs + relsec;
+    Elf64_Rela *rel = (Elf64_Rela *)(ef->data + shdr->sh_offset);
+    Elf64_Sym *syms = (Elf64_Sym *)(ef->data + sechdrs[ef->symindex].sh_offset);
+    size_t i, j;
+
+    for (i = 0; i < shdr->sh_size / sizeof(*rel); i++) {
+        uint64_t loc = sechdrs[shdr->sh_info].sh_addr + rel[i].r_offset;
+        unsigned char *p = image_ptr(loc);
+        Elf64_Sym *sym = syms + ELF64_R_SYM(rel[i].r_info);
+        uint64_t v = sym->st_value + rel[i].r_addend;
+        unsigned int type = ELF64_R_TYPE(rel[i].r_info);
+        int64_t offset = (int64_t)(v - loc);
+
+        switch (type) {
+        case R_RISCV_64:
+            memcpy(p, &v, sizeof(v));
+            break;
+        case R_RISCV_PCREL_HI20: {
+            int32_t hi20 = (offset + 0x800) & 0xfffff000;
+            write32(p, (read32(p) & 0xfff) | hi20);
+            break;
+        }
+        case R_RISCV_JAL: {
+            uint32_t imm20 = (offset & 0x100000) << (31 - 20);
+            uint32_t imm19_12 = (offset & 0xff000);
+            uint32_t imm11 = (offset & 0x800) << (20 - 11);
+            uint32_t imm10_1 = (offset & 0x7fe) << (30 - 10);
+
+            write32(p, (read32(p) & 0xfff) |
+                    imm20 | imm19_12 | imm11 | imm10_1);
+            break;
+        }
+        case R_RISCV_CALL: {
+            uint32_t hi20, lo12;
+
+            hi20 = (offset + 0x800) & 0xfffff000;
+            lo12 = (offset - hi20) & 0xfff;
+            write32(p, (read32(p) & 0xfff) | hi20);
+            write32(p + 4, (read32(p + 4) & 0xfffff) | (lo12 << 20));
+            break;
+        }
+        case R_RISCV_BRANCH: {
+            uint32_t imm12 = (offset & 0x1000) << (31 - 12);
+            uint32_t imm11 = (offset & 0x800) >> (11 - 7);
+            uint32_t imm10_5 = (offset & 0x7e0) << (30 - 10);
+            uint32_t imm4_1 = (offset & 0x1e) << (11 - 4);
+
+            write32(p, (read32(p) & 0x1fff07f) |
+                    imm12 | imm11 | imm10_5 | imm4_1);
+            break;
+        }
+        case R_RISCV_RVC_JUMP: {
+            uint16_t imm11 = (offset & 0x800) << (12 - 11);
+            uint16_t imm10 = (offset & 0x400) >> (10 - 8);
+            uint16_t imm9_8 = (offset & 0x300) << (12 - 11);
+            uint16_t imm7 = (offset & 0x80) >> (7 - 6);
+            uint16_t imm6 = (offset & 0x40) << (12 - 11);
+            uint16_t imm5 = (offset & 0x20) >> (5 - 2);
+            uint16_t imm4 = (offset & 0x10) << (12 - 5);
+            uint16_t imm3_1 = (offset & 0xe) << (12 - 10);
+
+            write16(p, (read16(p) & 0xe003) | imm11 | imm10 | imm9_8 |
+                    imm7 | imm6 | imm5 | imm4 | imm3_1);
+            break;
+        }
+        case R_RISCV_RVC_BRANCH: {
+            uint16_t imm8 = (offset & 0x100) << (12 - 8);
+            uint16_t imm7_6 = (offset & 0xc0) >> (6 - 5);
+            uint16_t imm5 = (offset & 0x20) >> (5 - 2);
+            uint16_t imm4_3 = (offset & 0x18) << (12 - 5);
+            uint16_t imm2_1 = (offset & 0x6) << (12 - 10);
+
+            write16(p, (read16(p) & 0xe383) |
+                    imm8 | imm7_6 | imm5 | imm4_3 | imm2_1);
+            break;
+        }
+        case R_RISCV_RELAX:
+            break;
+        case R_RISCV_ADD32:
+            write32(p, read32(p) + (uint32_t)v);
+            break;
+        case R_RISCV_SUB32:
+            write32(p, read32(p) - (uint32_t)v);
+            break;
+        case R_RISCV_PCREL_LO12_I:
+        case R_RISCV_PCREL_LO12_S:
+            for (j = 0; j < shdr->sh_size / sizeof(*rel); j++) {
+                uint64_t hi20_loc = sechdrs[shdr->sh_info].sh_addr +
+                    rel[j].r_offset;
+                Elf64_Sym *hi20_sym;
+                int32_t hi20, lo12;
+                uint64_t hi20_off;
+
+                if (hi20_loc != sym->st_value ||
+                    ELF64_R_TYPE(rel[j].r_info) != R_RISCV_PCREL_HI20)
+                    continue;
+
+                hi20_sym = syms + ELF64_R_SYM(rel[j].r_info);
+                hi20_off = hi20_sym->st_value + rel[j].r_addend - hi20_loc;
+
+                hi20 = (hi20_off + 0x800) & 0xfffff000;
+                lo12 = hi20_off - hi20;
+
+                if (type == R_RISCV_PCREL_LO12_I) {
+                    write32(p, (read32(p) & 0xfffff) |
+                            ((lo12 & 0xfff) << 20));
+                } else {
+                    uint32_t imm11_5 = (lo12 & 0xfe0) << (31 - 11);
+                    uint32_t imm4_0 = (lo12 & 0x1f) << (11 - 4);
+                    write32(p, (read32(p) & 0x1fff07f) | imm11_5 | imm4_0);
+                }
+                break;
+            }
+            break;
+        default:
+            fprintf(stderr, "%s: bad relocation type %u\n", ef->path, type);
+            exit(1);
+        }
+    }
+}
+
+static void
+apply_relocations(struct elf_file *ef)
+{
+    unsigned int i;
+
+    for (i = 1; i < ef->hdr->e_shnum; i++) {
+        unsigned int infosec = ef->sechdrs[i].sh_info;
+
+        if (infosec >= ef->hdr->e_shnum)
+            continue;
+
+        if (!(ef->sechdrs[infosec].sh_flags & SHF_ALLOC))
+            continue;
+
+        if (ef->sechdrs[i].sh_type == SHT_RELA)
+            apply_relocate_add(ef, i);
+    }
+}
+
+static uint64_t
+query_sym(struct elf_file *ef, const char *name)
+{
+    Elf64_Sym *sym = find_symbol(ef, name);
+    return sym ? sym->st_value : 0;
+}
+
+/* Register the exports of a linked module for the following ones. */
+static void
+add_module_symbols(struct prelink_entry *e)
+{
+    struct kernel_symbol *ks = image_ptr(e->syms);
+    uint64_t i;
+
+    /* The image moves as it grows, so keep copies of the names. */
+    for (i = 0; i < e->num_syms; i++)
+        add_ksym(strdup(image_ptr(ks[i].name)), ks[i].value, e - entries);
+}
+
+static uint64_t
+prelink_module(const char *path, uint64_t addr)
+{
+    struct elf_file ef;
+    struct prelink_entry *e;
+    Elf64_Shdr *modname;
+    Elf64_Shdr *jump_table;
+    uint64_t size, next, level;
+    int i;
+
+    read_elf(path, &ef);
+    if (ef.hdr->e_type != ET_REL)
+        fatal("%s is not a relocatable module", path);
+
+    size = layout_sections(&ef);
+    next = ROUND_UP(addr + size + MODULE_STRUCT_SIZE, 8);
+
+    image = xrealloc(image, next - image_base);
+    memset(image + image_len, 0, next - image_base - image_len);
+    image_len = next - image_base;
+
+    move_module(&ef, addr);
+    cur_deps.mods = NULL;
+    cur_deps.nr = 0;
+    simplify_symbols(&ef);
+    apply_relocations(&ef);
+
+    entries = xrealloc(entries, (nr_entries + 1) * sizeof(*entries));
+    entry_deps = xrealloc(entry_deps, (nr_entries + 1) * sizeof(*entry_deps));
+    entry_deps[nr_entries] = cur_deps;
+    e = entries + nr_entries++;
+    memset(e, 0, sizeof(*e));
+    modname = find_section(&ef, ".modname");
+    if (modname)
+        strncpy(e->name, (char *)ef.data + modname->sh_offset,
+                MODULE_NAME_LEN - 1);
+    e->addr = addr;
+    e->size = size;
+    e->syms = query_sym(&ef, "_start_mod_ksymtab");
+    e->num_syms = (query_sym(&ef, "_end_mod_ksymtab") - e->syms) /
+        sizeof(struct kernel_symbol);
+    e->init = query_sym(&ef, "init_module");
+    e->exit = query_sym(&ef, "exit_module");
+
+    /* Same layout as struct jump_entry on the target */
+    jump_table = find_section(&ef, "__jump_table");
+    if (jump_table) {
+        e->jump_entries = jump_table->sh_addr;
+        e->num_jump_entries = jump_table->sh_size / (3 * sizeof(uint64_t));
+    }
+
+    level = query_sym(&ef, "init_module_level");
+    e->init_level = level ?
+        *(int32_t *)image_ptr(level) : MODULE_INIT_BOOT;
+    if (e->init_level == MODULE_INIT_BOOT) {
+        for (i = 0; i < cur_deps.nr; i++)
+            promote_module(cur_deps.mods[i]);
+    }
+
+    if (e->num_syms)
+        add_module_symbols(e);
+
+    return next;
+}
+
+int main(int argc, char *argv[])
+{
+    struct prelink_header hdr;
+    struct elf_file kernel;
+    Elf64_Sym *end;
+    uint64_t addr;
+    FILE *fp;
+    int i;
+
+    if (argc < 3) {
+        fprintf(stderr, "Usage: %s startup.elf modules.img module.ko ...\n",
+                argv[0]);
+        return 1;
+    }
+
+    read_elf(argv[1], &kernel);
+    load_kernel_symbols(&kernel);
+
+    end = find_symbol(&kernel, "_end");
+    if (!end)
+        fatal("%s has no _end", argv[1]);
+
+    image_base = ROUND_UP(end->st_value, 8);
+    addr = image_base;
+    for (i = 3; i < argc; i++)
+        addr = prelink_module(argv[i], addr);
+
+    /* Leave no image behind, the loader would jump through zeroes */
+    if (unresolved) {
+        fprintf(stderr, "prelink: %d symbols can't be resolved\n",
+                unresolved);
+        return 1;
+    }
+
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, PRELINK_MAGIC, PRELINK_SMAGIC);
+    hdr.version = PRELINK_VERSION;
+    hdr.nr_modules = nr_entries;
+    hdr.base = image_base;
+    hdr.module_size = MODULE_STRUCT_SIZE;
+    hdr.total_size = image_len;
+    hdr.ksymtab_hash = ksymtab_hash;
+
+    fp = fopen(argv[2], "wb");
+    if (!fp)
+        fatal("cannot create %s", argv[2]);
+
+    if (fwrite(&hdr, sizeof(hdr), 1, fp) != 1 ||
+        (nr_entries &&
+         fwrite(entries, sizeof(*entries), nr_entries, fp) != nr_entries) ||
+        (image_len && fwrite(image, image_len, 1, fp) != 1))
+        fatal("cannot write %s", argv[2]);
+
+    fclose(fp);
+    return 0;
+}
@@ -0,0 +1,404 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * profile - flat profile from a profile dump in a console log
+ *
+ * Usage: profile console.log startup.elf [module.ko ...]
+ *
+ * Reads the last dump that profile_dump() in lib/profile.c wrote into
+ * the log and symbolizes its buckets: startup.elf is linked at its run
+ * address, the text of each module is placed at the base from the
+ * load map of the dump, laid out as startup/module.c does. Modules are
+ * matched to .ko files by their .modname. Prints the samples per
+ * module and then per function, most first.
+ */
+
+#include <elf.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ROUND_UP(x, n) (((x) + (n) - 1UL) & ~((n) - 1UL))
+
+/* Keep in sync with lib/profile.c */
+#define PROFILE_PREFIX  "profile: "
+
+struct module {
+    char name[64];
+    uint64_t base;
+    uint64_t size;
+    int prelinked;
+    unsigned long samples;
+};
+
+struct symbol {
+    const char *name;
+    uint64_t addr;
+    uint64_t size;
+    int module;             /* index into modules */
+    unsigned long samples;
+};
+
+struct hit {
+    uint64_t addr;
+    unsigned long count;
+};
+
+struct elf_file {
+    unsigned char *data;
+    size_t len;
+    Elf64_Ehdr *hdr;
+    Elf64_Shdr *sechdrs;
+    const char *secstrings;
+};
+
+static unsigned long prof_hz, prof_samples, prof_user, prof_other;
+static unsigned int prof_shift;
+
+static struct module *modules;
+static unsigned int nr_modules;
+
+static struct hit *hits;
+static size_t nr_hits;
+
+static struct symbol *symbols;
+static size_t nr_symbols;
+
+static void
+fatal(const char *fmt, const char *arg)
+{
+    fprintf(stderr, "profile: ");
+    fprintf(stderr, fmt, arg);
+    fprintf(stderr, "\n");
+    exit(1);
+}
+
+static void *
+xrealloc(void *p, size_t size)
+{
+    p = realloc(p, size);
+    if (!p)
+        fatal("%s", "out of memory");
+    return p;
+}
+
+/* A later dump replaces an earlier one */
+static void
+read_line(const char *line)
+{
+    const char *p = strstr(line, PROFILE_PREFIX);
+    struct module *mod;
+    char kind[16];
+    unsigned long count;
+    uint64_t addr;
+
+    if (!p)
+        return;
+    p += strlen(PROFILE_PREFIX);
+
+    if (sscanf(p, "begin %lx %x %*x %lx %lx %lx", &prof_hz, &prof_shift,
+               &prof_samples, &prof_user, &prof_other) == 5) {
+        nr_modules = 0;
+        nr_hits = 0;
+    } else if (!strncmp(p, "module ", 7)) {
+        modules = xrealloc(modules, (nr_modules + 1) * sizeof(*modules));
+        mod = modules + nr_modules;
+        memset(mod, 0, sizeof(*mod));
+        if (sscanf(p, "module %63s %lx %lx %15s", mod->name,
+                   &mod->base, &mod->size, kind) != 4)
+            fatal("bad line '%s'", line);
+        mod->prelinked = !strcmp(kind, "prelinked");
+        nr_modules++;
+    } else if (sscanf(p, "hit %lx %lx", &addr, &count) == 2) {
+        hits = xrealloc(hits, (nr_hits + 1) * sizeof(*hits));
+        hits[nr_hits].addr = addr;
+        hits[nr_hits].count = count;
+        nr_hits++;
+    }
+}
+
+static void
+read_elf(const char *path, struct elf_file *ef)
+{
+    FILE *fp;
+
+    fp = fopen(path, "rb");
+    if (!fp)
+        fatal("cannot open %s", path);
+
+    fseek(fp, 0, SEEK_END);
+    ef->len = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+
+    ef->data = xrealloc(NULL, ef->len);
+    if (fread(ef->data, 1, ef->len, fp) != ef->len)
+        fatal("cannot read %s", path);
+    fclose(fp);
+
+    ef->hdr = (Elf64_Ehdr *)ef->data;
+    if (ef->len < sizeof(*ef->hdr) ||
+        memcmp(ef->hdr->e_ident, ELFMAG, SELFMAG))
+        fatal("%s is not an ELF file", path);
+
+    ef->sechdrs = (Elf64_Shdr *)(ef->data + ef->hdr->e_shoff);
+    ef->secstrings = (char *)ef->data +
+        ef->sechdrs[ef->hdr->e_shstrndx].sh_offset;
+}
+
+static Elf64_Shdr *
+find_section(struct elf_file *ef, const char *name)
+{
+    unsigned int i;
+
+    for (i = 1; i < ef->hdr->e_shnum; i++) {
+        if (!strcmp(ef->secstrings + ef->sechdrs[i].sh_name, name))
+            return ef->sechdrs + i;
+    }
+    return NULL;
+}
+
+static int
+find_module(const char *name)
+{
+    unsigned int i;
+
+    for (i = 0; i < nr_modules; i++) {
+        if (!strcmp(modules[i].name, name))
+            return i;
+    }
+    return -1;
+}
+
+/*
+ * Take the functions of @ef, @addrs gives the run address of each
+ * section or 0 if it isn't loaded with the module.
+ */
+static void
+add_symbols(struct elf_file *ef, const uint64_t *addrs, int mod)
+{
+    Elf64_Shdr *symsec = NULL;
+    const Elf64_Sym *sym;
+    const char *strtab;
+    unsigned int i, n;
+
+    for (i = 1; i < ef->hdr->e_shnum; i++) {
+        if (ef->sechdrs[i].sh_type == SHT_SYMTAB) {
+            symsec = ef->sechdrs + i;
+            break;
+        }
+    }
+    if (!symsec)
+        return;
+
+    sym = (Elf64_Sym *)(ef->data + symsec->sh_offset);
+    n = symsec->sh_size / sizeof(*sym);
+    strtab = (char *)ef->data + ef->sechdrs[symsec->sh_link].sh_offset;
+
+    for (i = 1; i < n; i++) {
+        struct symbol *s;
+
+        if (ELF64_ST_TYPE(sym[i].st_info) != STT_FUNC ||
+            sym[i].st_shndx == SHN_UNDEF ||
+            sym[i].st_shndx >= ef->hdr->e_shnum ||
+            (addrs && !addrs[sym[i].st_shndx]))
+            continue;
+
+        symbols = xrealloc(symbols, (nr_symbols + 1) * sizeof(*symbols));
+        s = symbols + nr_symbols++;
+        s->name = strtab + sym[i].st_name;
+        s->addr = sym[i].st_value;
+        if (addrs)
+            s->addr += addrs[sym[i].st_shndx];
+        s->size = sym[i].st_size;
+        s->module = mod;
+        s->samples = 0;
+    }
+}
+
+static int
+is_init_section(const char *name)
+{
+    return !memcmp(name, ".init", 5);
+}
+
+/*
+ * Text comes first in layout_sections() of startup/module.c, in the
+ * order of the section headers. Modules linked at boot leave their
+ * .init.* text to the init area, freed by now.
+ */
+static void
+load_module(const char *path)
+{
+    struct elf_file ef;
+    Elf64_Shdr *modname;
+    uint64_t *addrs, size = 0;
+    unsigned int i;
+    int mod;
+
+    read_elf(path, &ef);
+    modname = find_section(&ef, ".modname");
+    if (!modname)
+        fatal("%s has no .modname", path);
+
+    mod = find_module((char *)ef.data + modname->sh_offset);
+    if (mod < 0)
+        return;
+
+    addrs = xrealloc(NULL, ef.hdr->e_shnum * sizeof(*addrs));
+    memset(addrs, 0, ef.hdr->e_shnum * sizeof(*addrs));
+
+    for (i = 1; i < ef.hdr->e_shnum; i++) {
+        Elf64_Shdr *s = ef.sechdrs + i;
+        uint64_t align = s->sh_addralign ? : 1;
+
+        if ((s->sh_flags & (SHF_EXECINSTR | SHF_ALLOC)) !=
+            (SHF_EXECINSTR | SHF_ALLOC))
+            continue;
+        if (!modules[mod].prelinked &&
+            is_init_section(ef.secstrings + s->sh_name))
+            continue;
+
+        size = ROUND_UP(size, align);
+        addrs[i] = modules[mod].base + size;
+        size += s->sh_size;
+    }
+
+    add_symbols(&ef, addrs, mod);
+    free(addrs);
+}
+
+static int
+cmp_symbol_addr(const void *a, const void *b)
+{
+    const struct symbol *sa = a, *sb = b;
+
+    if (sa->addr != sb->addr)
+        return sa->addr < sb->addr ? -1 : 1;
+    return 0;
+}
+
+static int
+cmp_symbol_samples(const void *a, const void *b)
+{
+    const struct symbol *sa = a, *sb = b;
+
+    if (sa->samples != sb->samples)
+        return sa->samples > sb->samples ? -1 : 1;
+    return sa->addr < sb->addr ? -1 : sa->addr > sb->addr;
+}
+
+/* The function at @addr, NULL if it falls between functions */
+static struct symbol *
+lookup_symbol(uint64_t addr)
+{
+    size_t lo = 0, hi = nr_symbols;
+    struct symbol *s;
+
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+
+        if (symbols[mid].addr <= addr)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    if (!lo)
+        return NULL;
+
+    s = symbols + lo - 1;
+    if (s->size && addr >= s->addr + s->size)
+        return NULL;
+    return s;
+}
+
+static int
+lookup_module(uint64_t addr)
+{
+    unsigned int i;
+
+    for (i = 0; i < nr_modules; i++) {
+        if (addr - modules[i].base < modules[i].size)
+            return i;
+    }
+    return -1;
+}
+
+static double
+percent(unsigned long n)
+{
+    return prof_samples ? 100.0 * n / prof_samples : 0;
+}
+
+int main(int argc, char *argv[])
+{
+    char line[4096];
+    unsigned long unknown = 0, kernel;
+    struct elf_file kernel_elf;
+    unsigned int i;
+    size_t h;
+    FILE *fp;
+    int mod, arg;
+
+    if (argc < 3) {
+        fprintf(stderr, "Usage: %s console.log startup.elf [module.ko ...]\n",
+                argv[0]);
+        return 1;
+    }
+
+    fp = fopen(argv[1], "r");
+    if (!fp)
+        fatal("cannot open %s", argv[1]);
+    while (fgets(line, sizeof(line), fp))
+        read_line(line);
+    fclose(fp);
+
+    if (!prof_hz)
+        fatal("%s", "no profile dump found");
+
+    mod = find_module("startup");
+    if (mod < 0)
+        fatal("%s", "no startup in the load map");
+    read_elf(argv[2], &kernel_elf);
+    add_symbols(&kernel_elf, NULL, mod);
+
+    for (arg = 3; arg < argc; arg++)
+        load_module(argv[arg]);
+
+    qsort(symbols, nr_symbols, sizeof(*symbols), cmp_symbol_addr);
+
+    for (h = 0; h < nr_hits; h++) {
+        struct symbol *s = lookup_symbol(hits[h].addr);
+
+        mod = lookup_module(hits[h].addr);
+        if (mod >= 0)
+            modules[mod].samples += hits[h].count;
+        if (s && s->module == mod)
+            s->samples += hits[h].count;
+        else
+            unknown += hits[h].count;
+    }
+
+    kernel = prof_samples - prof_user - prof_other;
+    printf("# %lu samples at %lu Hz, %u bytes per bucket\n",
+           prof_samples, prof_hz, 1U << prof_shift);
+    printf("# %6.2f%% kernel, %.2f%% user, %.2f%% elsewhere\n\n",
+           percent(kernel), percent(prof_user), percent(prof_other));
+
+    printf("#  %%      samples  module\n");
+    for (i = 0; i < nr_modules; i++) {
+        if (modules[i].samples)
+            printf("%6.2f %10lu  %s\n", percent(modules[i].samples),
+                   modules[i].samples, modules[i].name);
+    }
+
+    printf("\n#  %%      samples  function [module]\n");
+    qsort(symbols, nr_symbols, sizeof(*symbols), cmp_symbol_samples);
+    for (h = 0; h < nr_symbols && symbols[h].samples; h++) {
+        printf("%6.2f %10lu  %s [%s]\n", percent(symbols[h].samples),
+               symbols[h].samples, symbols[h].name,
+               modules[symbols[h].module].name);
+    }
+    if (unknown)
+        printf("%6.2f %10lu  (no symbol)\n", percent(unknown), unknown);
+    return 0;
+}
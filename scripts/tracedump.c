@@ -0,0 +1,336 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * tracedump - decode a trace dump from a console log on the host
+ *
+ * Usage: tracedump [console.log]
+ *
+ * Picks the "trace: <hex>" lines that trace_dump() in lib/trace.c
+ * writes out of the log (stdin by default), decodes the records of
+ * every event with the format it was dumped with and prints them as
+ * one timeline in cycle order, followed by a count per event. Of a
+ * log with several dumps, e.g. at boot and at power off, the last
+ * one is decoded.
+ *
+ * Fields are laid out in their natural alignment behind the u64
+ * timestamp, as the compiler does for struct trace_event_raw_<event>.
+ * Only the types below can be decoded, "unsigned long" fields are
+ * addresses and printed in hex.
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ROUND_UP(x, n) (((x) + (n) - 1UL) & ~((n) - 1UL))
+
+/* Keep in sync with lib/trace.c */
+#define TRACE_DUMP_MAGIC    "XLTRACE1"
+#define TRACE_DUMP_SMAGIC   8
+#define TRACE_DUMP_PREFIX   "trace: "
+
+#define MAX_FIELDS  16
+
+struct trace_dump_header {
+    char magic[TRACE_DUMP_SMAGIC];
+    uint32_t record_size;
+    uint32_t nr_records;
+    uint32_t name_len;
+    uint32_t format_len;
+};
+
+struct field_type {
+    const char *name;
+    unsigned int size;
+    int is_signed;
+};
+
+static const struct field_type field_types[] = {
+    { "u8", 1, 0 },
+    { "u16", 2, 0 },
+    { "u32", 4, 0 },
+    { "u64", 8, 0 },
+    { "s8", 1, 1 },
+    { "s16", 2, 1 },
+    { "s32", 4, 1 },
+    { "s64", 8, 1 },
+    { "bool", 1, 0 },
+    { "char", 1, 1 },
+    { "short", 2, 1 },
+    { "unsigned short", 2, 0 },
+    { "int", 4, 1 },
+    { "unsigned int", 4, 0 },
+    { "long", 8, 1 },
+    { "unsigned long", 8, 0 },
+    { "sector_t", 8, 0 },
+    { "pgoff_t", 8, 0 },
+    { "gfp_t", 4, 0 },
+};
+
+struct field {
+    char name[64];
+    const struct field_type *type;
+    unsigned int offset;
+};
+
+struct event {
+    char *name;
+    unsigned int record_size;
+    unsigned int nr_fields;
+    struct field fields[MAX_FIELDS];
+    unsigned long count;
+};
+
+struct record {
+    uint64_t ts;
+    unsigned long seq;
+    unsigned int event;     /* index into events */
+    const unsigned char *data;
+};
+
+static unsigned char *stream;
+static size_t stream_len;
+
+static struct event *events;
+static unsigned int nr_events;
+
+static struct record *records;
+static size_t nr_records;
+
+static void
+fatal(const char *fmt, const char *arg)
+{
+    fprintf(stderr, "tracedump: ");
+    fprintf(stderr, fmt, arg);
+    fprintf(stderr, "\n");
+    exit(1);
+}
+
+static void *
+xrealloc(void *p, size_t size)
+{
+    p = realloc(p, size);
+    if (!p)
+        fatal("%s", "out of memory");
+    return p;
+}
+
+static int
+hex_value(int c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    return -1;
+}
+
+/* Append the bytes of a "trace: <hex>" line, ignore any other line */
+static void
+read_line(const char *line)
+{
+    const char *p = strstr(line, TRACE_DUMP_PREFIX);
+    size_t len, i;
+
+    if (!p)
+        return;
+    p += strlen(TRACE_DUMP_PREFIX);
+
+    for (len = 0; hex_value(p[len]) >= 0; len++)
+        ;
+    if (!len || len % 2 || (p[len] && !isspace((unsigned char)p[len])))
+        return;
+
+    stream = xrealloc(stream, stream_len + len / 2);
+    for (i = 0; i < len; i += 2)
+        stream[stream_len++] = hex_value(p[i]) << 4 | hex_value(p[i + 1]);
+}
+
+static const struct field_type *
+find_type(const char *name)
+{
+    size_t i;
+
+    for (i = 0; i < sizeof(field_types) / sizeof(field_types[0]); i++) {
+        if (!strcmp(field_types[i].name, name))
+            return field_types + i;
+    }
+    return NULL;
+}
+
+/* Lay out "<type> <field>;..." behind the timestamp */
+static void
+parse_format(struct event *ev, char *format)
+{
+    unsigned int offset = sizeof(uint64_t);
+    char *decl, *name, *save;
+    struct field *f;
+
+    for (decl = strtok_r(format, ";", &save); decl;
+         decl = strtok_r(NULL, ";", &save)) {
+        name = strrchr(decl, ' ');
+        if (!name)
+            fatal("bad field '%s'", decl);
+        *name++ = 0;
+
+        if (ev->nr_fields == MAX_FIELDS)
+            fatal("too many fields in %s", ev->name);
+        f = ev->fields + ev->nr_fields++;
+        f->type = find_type(decl);
+        if (!f->type)
+            fatal("unknown field type '%s'", decl);
+        snprintf(f->name, sizeof(f->name), "%s", name);
+
+        offset = ROUND_UP(offset, f->type->size);
+        f->offset = offset;
+        offset += f->type->size;
+    }
+
+    if (ROUND_UP(offset, sizeof(uint64_t)) != ev->record_size)
+        fatal("format of %s doesn't match its record size", ev->name);
+}
+
+/* Forget the events of an earlier dump, a later one supersedes it */
+static void
+drop_dump(void)
+{
+    unsigned int e;
+
+    for (e = 0; e < nr_events; e++)
+        free(events[e].name);
+    nr_events = 0;
+    nr_records = 0;
+}
+
+static void
+parse_stream(void)
+{
+    struct trace_dump_header hdr;
+    struct event *ev;
+    size_t pos = 0;
+    uint32_t i;
+    char *format;
+
+    while (1) {
+        if (pos + sizeof(hdr) > stream_len)
+            fatal("%s", "trace dump is truncated");
+        memcpy(&hdr, stream + pos, sizeof(hdr));
+        pos += sizeof(hdr);
+
+        if (memcmp(hdr.magic, TRACE_DUMP_MAGIC, TRACE_DUMP_SMAGIC))
+            fatal("%s", "bad magic, not a dump of this version");
+        if (!hdr.name_len) {
+            if (pos == stream_len)
+                break;
+            drop_dump();
+            continue;
+        }
+
+        if (pos + hdr.name_len + hdr.format_len +
+            (uint64_t)hdr.record_size * hdr.nr_records > stream_len)
+            fatal("%s", "trace dump is truncated");
+
+        events = xrealloc(events, (nr_events + 1) * sizeof(*events));
+        ev = events + nr_events++;
+        memset(ev, 0, sizeof(*ev));
+        ev->name = strndup((char *)stream + pos, hdr.name_len);
+        pos += hdr.name_len;
+        format = strndup((char *)stream + pos, hdr.format_len);
+        pos += hdr.format_len;
+        ev->record_size = hdr.record_size;
+        parse_format(ev, format);
+        free(format);
+
+        records = xrealloc(records,
+                           (nr_records + hdr.nr_records) * sizeof(*records));
+        for (i = 0; i < hdr.nr_records; i++) {
+            struct record *r = records + nr_records;
+
+            memcpy(&r->ts, stream + pos, sizeof(r->ts));
+            r->seq = nr_records++;
+            r->event = nr_events - 1;
+            r->data = stream + pos;
+            pos += hdr.record_size;
+        }
+    }
+}
+
+static int
+cmp_record(const void *a, const void *b)
+{
+    const struct record *ra = a, *rb = b;
+
+    if (ra->ts != rb->ts)
+        return ra->ts < rb->ts ? -1 : 1;
+    return ra->seq < rb->seq ? -1 : ra->seq > rb->seq;
+}
+
+static void
+print_field(const struct field *f, const unsigned char *data)
+{
+    uint64_t v = 0;
+
+    memcpy(&v, data + f->offset, f->type->size);
+
+    if (f->type->is_signed) {
+        int shift = 64 - f->type->size * 8;
+
+        printf(" %s=%lld", f->name, (long long)(v << shift) >> shift);
+    } else if (!strcmp(f->type->name, "unsigned long")) {
+        printf(" %s=0x%llx", f->name, (unsigned long long)v);
+    } else {
+        printf(" %s=%llu", f->name, (unsigned long long)v);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    char line[4096];
+    unsigned int e, i;
+    uint64_t first, prev;
+    size_t r;
+    FILE *fp = stdin;
+
+    if (argc > 2) {
+        fprintf(stderr, "Usage: %s [console.log]\n", argv[0]);
+        return 1;
+    }
+    if (argc == 2) {
+        fp = fopen(argv[1], "r");
+        if (!fp)
+            fatal("cannot open %s", argv[1]);
+    }
+
+    while (fgets(line, sizeof(line), fp))
+        read_line(line);
+    if (fp != stdin)
+        fclose(fp);
+
+    if (!stream_len)
+        fatal("%s", "no trace dump found");
+    parse_stream();
+
+    qsort(records, nr_records, sizeof(*records), cmp_record);
+
+    printf("#       cycles      delta  event\n");
+    first = prev = nr_records ? records[0].ts : 0;
+    for (r = 0; r < nr_records; r++) {
+        const struct record *rec = records + r;
+        struct event *ev = events + rec->event;
+
+        printf("%14llu %+10lld  %s:", (unsigned long long)(rec->ts - first),
+               (long long)(rec->ts - prev), ev->name);
+        for (i = 0; i < ev->nr_fields; i++)
+            print_field(ev->fields + i, rec->data);
+        printf("\n");
+
+        ev->count++;
+        prev = rec->ts;
+    }
+
+    printf("\n# %zu records\n", nr_records);
+    for (e = 0; e < nr_events; e++)
+        printf("# %10lu  %s\n", events[e].count, events[e].name);
+    return 0;
+}
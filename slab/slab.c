@@ -10,6 +10,10 @@
 #include <printk.h>
 
 #include <export.h>
+#include <linkage.h>
+
+#define CREATE_TRACE_POINTS
+#include <trace/events/kmem.h>
 
 #define BYTES_PER_WORD  sizeof(void *)
 
@@ -357,6 +361,7 @@ cache_grow_end(struct kmem_cache *cachep, struct page *page)
     INIT_LIST_HEAD(&page->slab_list);
     n = cachep->node;
 
+    spin_lock(&n->list_lock);
     n->total_slabs++;
     if (!page->active) {
         list_add_tail(&page->slab_list, &n->slabs_free);
@@ -366,6 +371,7 @@ cache_grow_end(struct kmem_cache *cachep, struct page *page)
     }
 
     n->free_objects += cachep->num - page->active;
+    spin_unlock(&n->list_lock);
 }
 
 static void *
@@ -382,9 +388,11 @@ cache_alloc_refill(struct kmem_cache *cachep, gfp_t flags)
     n = cachep->node;
 
     BUG_ON(ac->avail > 0 || !n);
-    if (!n->free_objects) {
-        goto direct_grow;
-    }
+    trace_kmem_cache_refill(cachep, batchcount);
+
+    spin_lock(&n->list_lock);
+    if (!n->free_objects)
+        goto alloc_done;
 
     while (batchcount > 0) {
         /* Get slab alloc is to come from. */
@@ -399,7 +407,9 @@ cache_alloc_refill(struct kmem_cache *cachep, gfp_t flags)
  must_grow:
     n->free_objects -= ac->avail;
 
- direct_grow:
+ alloc_done:
+    spin_unlock(&n->list_lock);
+
     if (unlikely(!ac->avail)) {
         page = cache_grow_begin(cachep, gfp_exact_node(flags));
 
@@ -445,9 +455,12 @@ slab_want_init_on_alloc(gfp_t flags, struct kmem_cache *c)
 static __always_inline void *
 slab_alloc(struct kmem_cache *cachep, gfp_t flags, unsigned long caller)
 {
+    unsigned long save_flags;
     void *objp;
 
+    local_irq_save(save_flags);
     objp = __do_cache_alloc(cachep, flags);
+    local_irq_restore(save_flags);
     if (unlikely(slab_want_init_on_alloc(flags, cachep)) && objp)
         memset(objp, 0, cachep->object_size);
 
@@ -501,6 +514,7 @@ _kmemdup_nul(const char *s, size_t len, gfp_t gfp)
 static void
 kmem_cache_node_init(struct kmem_cache_node *node)
 {
+    spin_lock_init(&node->list_lock);
     INIT_LIST_HEAD(&node->slabs_full);
     INIT_LIST_HEAD(&node->slabs_partial);
     INIT_LIST_HEAD(&node->slabs_free);
@@ -710,6 +724,7 @@ do_tune_cpucache(struct kmem_cache *cachep,
 {
     struct array_cache *cpu_cache;
     struct array_cache *prev;
+    unsigned long flags;
     LIST_HEAD(list);
 
     cpu_cache = alloc_kmem_cache_cpus(cachep, limit, batchcount);
@@ -724,7 +739,9 @@ do_tune_cpucache(struct kmem_cache *cachep,
     if (!prev)
         goto setup_node;
 
+    spin_lock_irqsave(&cachep->node->list_lock, flags);
     free_block(cachep, prev->entry, prev->avail, &list);
+    spin_unlock_irqrestore(&cachep->node->list_lock, flags);
     slabs_destroy(cachep, &list);
 
  setup_node:
@@ -1073,11 +1090,14 @@ static void
 cache_flusharray(struct kmem_cache *cachep, struct array_cache *ac)
 {
     int batchcount;
+    struct kmem_cache_node *n = cachep->node;
     LIST_HEAD(list);
 
     batchcount = ac->batchcount;
 
+    spin_lock(&n->list_lock);
     free_block(cachep, ac->entry, batchcount, &list);
+    spin_unlock(&n->list_lock);
 
 free_done:
     slabs_destroy(cachep, &list);
@@ -1125,11 +1145,14 @@ _kfree(const void *objp)
 
     if (unlikely(ZERO_OR_NULL_PTR(objp)))
         return;
+    local_irq_save(flags);
     c = virt_to_cache(objp);
     if (!c) {
+        local_irq_restore(flags);
         return;
     }
     __cache_free(c, (void *)objp, _RET_IP_);
+    local_irq_restore(flags);
 }
 
 void
@@ -1244,10 +1267,12 @@ _kmem_cache_free(struct kmem_cache *cachep, void *objp)
     if (!cachep)
         return;
 
+    local_irq_save(flags);
     __cache_free(cachep, objp, _RET_IP_);
+    local_irq_restore(flags);
 }
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[slab]: init begin ...\n");
@@ -1263,6 +1288,8 @@ init_module(void)
     kmem_cache_init();
     kmem_cache_init_late();
 
+    trace_event_register(&event_kmem_cache_refill);
+
     printk("module[slab]: init end!\n");
     return 0;
 }
@@ -2,6 +2,7 @@
 #include <slab.h>
 #include <printk.h>
 #include <string.h>
+#include <linkage.h>
 
 static int
 kmalloc_specific_size(int size)
@@ -67,7 +68,7 @@ test_kfree(void)
     return 0;
 }
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[test_slab]: init begin ...\n");
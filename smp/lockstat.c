@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <ktime.h>
+#include <atomic.h>
+#include <export.h>
+#include <printk.h>
+#include <string.h>
+#include <cpumask.h>
+#include <lockstat.h>
+
+#ifdef CONFIG_LOCK_STAT
+
+/**
+ * lockstat_dump - Write the statistics of each lock class to the console
+ *
+ * The CPUs are summed up, times are in ns. Here rather than in lib/
+ * for cycles_to_ns() of the timer module. Counting goes on while the
+ * classes are read, so a line may be off by the acquisitions of then.
+ */
+void lockstat_dump(void)
+{
+    struct lock_class_stats sum;
+    struct lock_class_stats *stats;
+    struct lock_class *class;
+    int cpu;
+
+    pr_info("lockstat: class acquisitions contentions "
+            "wait-total wait-max hold-total hold-max\n");
+
+    for (class = READ_ONCE(lock_classes); class; class = class->next) {
+        memset(&sum, 0, sizeof(sum));
+
+        for_each_possible_cpu(cpu) {
+            stats = &class->stats[cpu];
+            sum.acquisitions += stats->acquisitions;
+            sum.contentions += stats->contentions;
+            sum.wait_total += stats->wait_total;
+            sum.wait_max = max(sum.wait_max, stats->wait_max);
+            sum.hold_total += stats->hold_total;
+            sum.hold_max = max(sum.hold_max, stats->hold_max);
+        }
+
+        pr_info("lockstat: %s %lu %lu %lu %lu %lu %lu\n",
+                class->name, sum.acquisitions, sum.contentions,
+                cycles_to_ns(sum.wait_total), cycles_to_ns(sum.wait_max),
+                cycles_to_ns(sum.hold_total), cycles_to_ns(sum.hold_max));
+    }
+}
+EXPORT_SYMBOL(lockstat_dump);
+
+#endif /* CONFIG_LOCK_STAT */
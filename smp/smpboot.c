@@ -0,0 +1,135 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Bring-up of the secondary harts, through SBI HSM
+ *
+ * Once online, a CPU runs the tasks the scheduler places on it, see
+ * select_task_rq_fair(). One CPU at a time runs in the kernel, under
+ * the kernel lock of startup/smp.c, the others run in user mode or
+ * idle. Device interrupts all go to the boot CPU.
+ */
+
+#include <csr.h>
+#include <sbi.h>
+#include <smp.h>
+#include <fork.h>
+#include <page.h>
+#include <vdso.h>
+#include <errno.h>
+#include <tick.h>
+#include <sched.h>
+#include <timex.h>
+#include <printk.h>
+#include <barrier.h>
+#include <cpumask.h>
+#include <irqflags.h>
+#include <linkage.h>
+
+extern void secondary_start_sbi(void);
+
+extern struct vdso_data *vdso_data;
+
+/* Read by each starting hart at its physical address, see core.S */
+static struct sbi_hart_boot_data boot_data[NR_CPUS];
+
+static int
+sbi_cpu_start(unsigned int cpu, struct task_struct *tidle)
+{
+    unsigned long hartid = cpuid_to_hartid_map(cpu);
+    struct sbi_hart_boot_data *bdata = &boot_data[cpu];
+
+    bdata->task_ptr = tidle;
+    bdata->stack_ptr = tidle->stack + THREAD_SIZE;
+
+    /* Make sure boot data is updated */
+    smp_mb();
+
+    return sbi_hart_start(hartid, __pa(secondary_start_sbi), __pa(bdata));
+}
+
+/* Start @cpu on a new idle task and wait a second for it to be online */
+static int
+__cpu_up(unsigned int cpu)
+{
+    struct task_struct *tidle;
+    u64 timeout;
+    int ret;
+
+    tidle = fork_idle(cpu);
+
+    ret = sbi_cpu_start(cpu, tidle);
+    if (ret) {
+        printk("CPU%u: hart %lu can't be started, %d\n",
+               cpu, cpuid_to_hartid_map(cpu), ret);
+        return ret;
+    }
+
+    timeout = get_time() + riscv_timebase;
+    while (!cpu_online(cpu)) {
+        if (get_time() > timeout) {
+            printk("CPU%u: hart %lu failed to come online\n",
+                   cpu, cpuid_to_hartid_map(cpu));
+            return -EIO;
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * The secondary CPU on its idle task, with interrupts off. It takes
+ * IPIs and its tick, device interrupts all go to the boot CPU. There
+ * is no tick while it has nothing to run.
+ */
+static void _smp_callin(void)
+{
+    /* As vdso_init() did on the boot hart, the CSR is of each hart */
+    csr_set(CSR_SCOUNTEREN, SCOUNTEREN_TM);
+    csr_set(CSR_IE, IE_SIE);
+    tick_init_secondary();
+
+    set_cpu_online(smp_processor_id(), true);
+
+    local_irq_enable();
+    cpu_startup_entry();
+}
+
+static void
+smp_init(void)
+{
+    unsigned int cpu;
+
+    smp_callin_func = _smp_callin;
+
+    /*
+     * The boot thread is in the kernel from here on with the others,
+     * it holds the kernel lock up to rest_init(), see init/main.c.
+     */
+    lock_kernel();
+
+    /* The IPIs of the boot CPU, the others take theirs in smp_callin() */
+    csr_set(CSR_IE, IE_SIE);
+
+    for_each_possible_cpu(cpu) {
+        if (cpu_online(cpu))
+            continue;
+
+        /* Without HSM no other hart can be started */
+        if (__cpu_up(cpu) == -EOPNOTSUPP)
+            break;
+    }
+
+    WRITE_ONCE(vdso_data->nr_cpus, num_online_cpus());
+
+    printk("smp: Brought up %u of %u CPUs\n", num_online_cpus(), nr_cpu_ids);
+}
+
+static int __init
+init_module(void)
+{
+    printk("module[smp]: init begin ...\n");
+
+    smp_init();
+
+    printk("module[smp]: init end!\n");
+    return 0;
+}
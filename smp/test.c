@@ -0,0 +1,254 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <csr.h>
+#include <smp.h>
+#include <sched.h>
+#include <timex.h>
+#include <printk.h>
+#include <cpumask.h>
+#include <linkage.h>
+#include <spinlock.h>
+
+static int
+test_cpu_ids(void)
+{
+    if (smp_processor_id() != 0 || !cpu_online(0)) {
+        printk(_RED("boot on CPU%u!\n"), smp_processor_id());
+        return -1;
+    }
+
+    if (cpuid_to_hartid_map(0) != boot_cpu_hartid ||
+        riscv_hartid_to_cpuid(boot_cpu_hartid) != 0) {
+        printk(_RED("boot hart %lu isn't CPU0!\n"), boot_cpu_hartid);
+        return -1;
+    }
+
+    if (num_online_cpus() > nr_cpu_ids) {
+        printk(_RED("%u CPUs online of %u!\n"), num_online_cpus(), nr_cpu_ids);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int
+test_runqueues(void)
+{
+    struct rq *rq;
+    int cpu;
+
+    for_each_online_cpu(cpu) {
+        rq = cpu_rq(cpu);
+        if (cpu_of(rq) != cpu || !rq->idle || task_cpu(rq->idle) != cpu) {
+            printk(_RED("runqueue of CPU%d is off!\n"), cpu);
+            return -1;
+        }
+    }
+
+    if (this_rq() != task_rq(current)) {
+        printk(_RED("current isn't on this runqueue!\n"));
+        return -1;
+    }
+
+    return 0;
+}
+
+/*
+ * The idle loop of the other CPU clears the flag once the IPI woke it.
+ * Its interrupt and schedule() take the kernel lock, which the boot
+ * thread holds since smp_init(): let go of it meanwhile.
+ */
+static int
+test_reschedule_ipi(void)
+{
+    struct task_struct *idle;
+    u64 timeout;
+    int cpu;
+    int ret = 0;
+
+    unlock_kernel();
+
+    for_each_online_cpu(cpu) {
+        if (cpu == smp_processor_id())
+            continue;
+
+        idle = cpu_rq(cpu)->idle;
+        set_tsk_need_resched(idle);
+        smp_send_reschedule(cpu);
+
+        timeout = get_time() + riscv_timebase;
+        while (test_tsk_need_resched(idle)) {
+            if (get_time() > timeout) {
+                printk(_RED("CPU%d didn't reschedule!\n"), cpu);
+                ret = -1;
+                goto out;
+            }
+        }
+    }
+
+out:
+    lock_kernel();
+    return ret;
+}
+
+/* Nested in the hold of the boot thread, as an interrupt would be */
+static int
+test_kernel_lock(void)
+{
+    if (!kernel_locked()) {
+        printk(_RED("boot thread without the kernel lock!\n"));
+        return -1;
+    }
+
+    lock_kernel();
+    unlock_kernel();
+
+    if (!kernel_locked()) {
+        printk(_RED("nested unlock let go of the kernel lock!\n"));
+        return -1;
+    }
+
+    return 0;
+}
+
+/*
+ * Nothing runs yet, each CPU is idle and keeps the tasks which ran on
+ * it before. The boot CPU counts as idle too, on its idle task.
+ */
+static int
+test_select_task_rq(void)
+{
+    int cpu, target;
+
+    for_each_online_cpu(cpu) {
+        target = fair_sched_class.select_task_rq(current, cpu);
+        if (target != cpu) {
+            printk(_RED("task of idle CPU%d placed on CPU%d!\n"),
+                   cpu, target);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static DEFINE_SPINLOCK(test_lock);
+static DEFINE_RWLOCK(test_rw);
+
+/* The tickets go round in step, the irqsave variant keeps SIE off */
+static int
+test_spinlock(void)
+{
+    unsigned long flags;
+    int i;
+
+    for (i = 0; i < 3; i++) {
+        spin_lock(&test_lock);
+        if (!spin_is_locked(&test_lock) || spin_trylock(&test_lock)) {
+            printk(_RED("lock %d isn't taken!\n"), i);
+            return -1;
+        }
+        spin_unlock(&test_lock);
+    }
+
+    if (!spin_trylock(&test_lock)) {
+        printk(_RED("free lock can't be taken!\n"));
+        return -1;
+    }
+    spin_unlock(&test_lock);
+
+    if (test_lock.raw_lock.tickets.owner != 4 ||
+        test_lock.raw_lock.tickets.next != 4) {
+        printk(_RED("tickets at %u/%u!\n"),
+               test_lock.raw_lock.tickets.owner,
+               test_lock.raw_lock.tickets.next);
+        return -1;
+    }
+
+    spin_lock_irqsave(&test_lock, flags);
+    if (csr_read(CSR_STATUS) & SR_IE) {
+        printk(_RED("interrupts on under the lock!\n"));
+        return -1;
+    }
+    spin_unlock_irqrestore(&test_lock, flags);
+
+    if ((csr_read(CSR_STATUS) & SR_IE) != (flags & SR_IE)) {
+        printk(_RED("interrupts not restored!\n"));
+        return -1;
+    }
+
+    return 0;
+}
+
+static int
+test_rwlock(void)
+{
+    read_lock(&test_rw);
+    if (!read_trylock(&test_rw) || write_trylock(&test_rw)) {
+        printk(_RED("readers don't share or let a writer in!\n"));
+        return -1;
+    }
+    read_unlock(&test_rw);
+    read_unlock(&test_rw);
+
+    write_lock(&test_rw);
+    if (read_trylock(&test_rw) || write_trylock(&test_rw)) {
+        printk(_RED("writer isn't alone!\n"));
+        return -1;
+    }
+    write_unlock(&test_rw);
+
+    if (!write_trylock(&test_rw)) {
+        printk(_RED("free rwlock can't be taken!\n"));
+        return -1;
+    }
+    write_unlock(&test_rw);
+
+    return 0;
+}
+
+static int __init
+init_module(void)
+{
+    printk("module[test_smp]: init begin ...\n");
+
+    if (test_cpu_ids()) {
+        printk(_RED("test cpu ids failed!\n"));
+        return -1;
+    }
+
+    if (test_runqueues()) {
+        printk(_RED("test runqueues failed!\n"));
+        return -1;
+    }
+
+    if (test_spinlock()) {
+        printk(_RED("test spinlock failed!\n"));
+        return -1;
+    }
+
+    if (test_rwlock()) {
+        printk(_RED("test rwlock failed!\n"));
+        return -1;
+    }
+
+    if (test_kernel_lock()) {
+        printk(_RED("test kernel lock failed!\n"));
+        return -1;
+    }
+
+    if (test_select_task_rq()) {
+        printk(_RED("test select task rq failed!\n"));
+        return -1;
+    }
+
+    if (test_reschedule_ipi()) {
+        printk(_RED("test reschedule ipi failed!\n"));
+        return -1;
+    }
+
+    printk(_GREEN("okay!\n"));
+
+    printk("module[test_smp]: init end!\n");
+    return 0;
+}
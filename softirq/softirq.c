@@ -5,6 +5,7 @@
 #include <export.h>
 #include <printk.h>
 #include <hardirq.h>
+#include <linkage.h>
 
 irq_cpustat_t irq_stat;
 EXPORT_SYMBOL(irq_stat);
@@ -82,7 +83,7 @@ void __do_softirq(void)
 }
 EXPORT_SYMBOL(__do_softirq);
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[softirq]: init begin ...\n");
@@ -70,6 +70,7 @@ __aligned(L1_CACHE_BYTES) = {
     .signal = &init_signals,
     .nsproxy = &init_nsproxy,
 
+    .static_prio = MAX_PRIO - 20,
     .normal_prio = MAX_PRIO - 20,
     .sched_task_group = &root_task_group,
 };
@@ -114,6 +115,18 @@ EXPORT_SYMBOL(add_to_page_cache_lru);
 schedule_tail_t schedule_tail_func;
 EXPORT_SYMBOL(schedule_tail_func);
 
+scheduler_tick_t scheduler_tick_func;
+EXPORT_SYMBOL(scheduler_tick_func);
+
+schedule_user_t schedule_user_func;
+EXPORT_SYMBOL(schedule_user_func);
+
+schedule_t schedule_func;
+EXPORT_SYMBOL(schedule_func);
+
+try_to_wake_up_t try_to_wake_up_func;
+EXPORT_SYMBOL(try_to_wake_up_func);
+
 extern struct task_struct *
 __switch_to(struct task_struct *, struct task_struct *);
 EXPORT_SYMBOL(__switch_to);
@@ -132,6 +145,47 @@ void schedule_tail(struct task_struct *p)
     schedule_tail_func(p);
 }
 
+/* From the tick, which may run before the sched module is loaded */
+void scheduler_tick(void)
+{
+    if (scheduler_tick_func)
+        scheduler_tick_func();
+}
+EXPORT_SYMBOL(scheduler_tick);
+
+/* From the return to user mode in entry.S, with irqs off */
+void schedule_user(void)
+{
+    schedule_user_func();
+}
+
+/*
+ * Waits at boot, before the sched module is there, come back at once
+ * and poll their condition, the boot thread is all that runs.
+ */
+void schedule(void)
+{
+    if (schedule_func)
+        schedule_func();
+}
+EXPORT_SYMBOL(schedule);
+
+int try_to_wake_up(struct task_struct *p, unsigned int state, int wake_flags)
+{
+    if (!try_to_wake_up_func) {
+        p->state = TASK_RUNNING;
+        return 1;
+    }
+    return try_to_wake_up_func(p, state, wake_flags);
+}
+EXPORT_SYMBOL(try_to_wake_up);
+
+int wake_up_process(struct task_struct *p)
+{
+    return try_to_wake_up(p, TASK_INTERRUPTIBLE | TASK_UNINTERRUPTIBLE, 0);
+}
+EXPORT_SYMBOL(wake_up_process);
+
 void start_kernel(void)
 {
     if (start_kernel_fn)
@@ -0,0 +1,121 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <mm.h>
+#include <smp.h>
+#include <types.h>
+#include <export.h>
+#include <module.h>
+#include <jump_label.h>
+
+#define RISCV_INSN_NOP  0x00000013U
+#define RISCV_INSN_JAL  0x0000006fU     /* jal x0, 0 */
+
+extern struct jump_entry __start___jump_table[];
+extern struct jump_entry __stop___jump_table[];
+
+/* Set once init text is gone, its sites must not be patched anymore */
+static bool initmem_freed;
+
+static u32
+jump_insn(unsigned long code, unsigned long target)
+{
+    long offset = target - code;
+
+    return RISCV_INSN_JAL |
+        (((offset >> 20) & 0x1) << 31) |
+        (((offset >> 1) & 0x3ff) << 21) |
+        (((offset >> 11) & 0x1) << 20) |
+        (((offset >> 12) & 0xff) << 12);
+}
+
+static bool
+entry_is_init(const struct jump_entry *entry)
+{
+    if (entry->code >= (unsigned long)__init_begin &&
+        entry->code < (unsigned long)__init_end)
+        return true;
+
+    return entry->code >= modules_init_start &&
+        entry->code < modules_init_end;
+}
+
+static void
+update_entries(struct jump_entry *start, struct jump_entry *stop,
+               struct static_key *key)
+{
+    struct jump_entry *entry;
+
+    for (entry = start; entry < stop; entry++) {
+        if (!entry->code || (key && entry->key != key))
+            continue;
+
+        if (initmem_freed && entry_is_init(entry)) {
+            entry->code = 0;
+            continue;
+        }
+
+        if (static_key_enabled(entry->key))
+            *(u32 *)entry->code = jump_insn(entry->code, entry->target);
+        else
+            *(u32 *)entry->code = RISCV_INSN_NOP;
+    }
+}
+
+static void
+jump_label_update(struct static_key *key)
+{
+    struct module *mod;
+
+    update_entries(__start___jump_table, __stop___jump_table, key);
+    list_for_each_entry(mod, &modules, list) {
+        update_entries(mod->jump_entries,
+                       mod->jump_entries + mod->num_jump_entries, key);
+    }
+
+    flush_icache_all();
+}
+
+void static_key_enable(struct static_key *key)
+{
+    if (key->enabled++)
+        return;
+    jump_label_update(key);
+}
+EXPORT_SYMBOL(static_key_enable);
+
+void static_key_disable(struct static_key *key)
+{
+    if (!key->enabled || --key->enabled)
+        return;
+    jump_label_update(key);
+}
+EXPORT_SYMBOL(static_key_disable);
+
+/*
+ * Sites are emitted as nops, only those of keys enabled before the
+ * module got loaded need patching.
+ */
+void jump_label_apply_module(struct module *mod)
+{
+    struct jump_entry *entry;
+    bool patched = false;
+
+    for (entry = mod->jump_entries;
+         entry < mod->jump_entries + mod->num_jump_entries;
+         entry++) {
+        if (!static_key_enabled(entry->key))
+            continue;
+        *(u32 *)entry->code = jump_insn(entry->code, entry->target);
+        patched = true;
+    }
+
+    if (patched)
+        flush_icache_all();
+}
+
+void jump_label_invalidate_initmem(void)
+{
+    initmem_freed = true;
+    jump_label_update(NULL);
+}
+EXPORT_SYMBOL(jump_label_invalidate_initmem);
@@ -0,0 +1,196 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Lock statistics, the slow paths of the locks with CONFIG_LOCK_STAT.
+ * Here rather than in lib/ so that startup can take the locks too.
+ */
+
+#include <smp.h>
+#include <timex.h>
+#include <export.h>
+#include <irqflags.h>
+#include <atomic.h>
+#include <lockstat.h>
+#include <spinlock.h>
+
+#ifdef CONFIG_LOCK_STAT
+
+struct lock_class *lock_classes;
+EXPORT_SYMBOL(lock_classes);
+
+/*
+ * Only for the list, the stats of each CPU are its own. Both are only
+ * changed with interrupts off, a handler may take a lock of the class
+ * that this CPU is counting for.
+ */
+static arch_spinlock_t lock_classes_lock = __ARCH_SPIN_LOCK_UNLOCKED;
+
+static void
+register_class(struct lock_class *class)
+{
+    arch_spin_lock(&lock_classes_lock);
+    if (!class->registered) {
+        class->next = lock_classes;
+        WRITE_ONCE(lock_classes, class);
+        class->registered = true;
+    }
+    arch_spin_unlock(&lock_classes_lock);
+}
+
+static void
+lock_acquired(struct lock_class *class, bool contended, u64 waited)
+{
+    struct lock_class_stats *stats;
+    unsigned long flags;
+
+    local_irq_save(flags);
+
+    if (unlikely(!READ_ONCE(class->registered)))
+        register_class(class);
+
+    stats = &class->stats[smp_processor_id()];
+    stats->acquisitions++;
+    if (contended) {
+        stats->contentions++;
+        stats->wait_total += waited;
+        if (waited > stats->wait_max)
+            stats->wait_max = waited;
+    }
+
+    local_irq_restore(flags);
+}
+
+static void
+lock_released(struct lock_class *class, u64 held)
+{
+    struct lock_class_stats *stats;
+    unsigned long flags;
+
+    local_irq_save(flags);
+
+    stats = &class->stats[smp_processor_id()];
+    stats->hold_total += held;
+    if (held > stats->hold_max)
+        stats->hold_max = held;
+
+    local_irq_restore(flags);
+}
+
+void __spin_lock_init(spinlock_t *lock, struct lock_class *class)
+{
+    lock->raw_lock = (arch_spinlock_t) __ARCH_SPIN_LOCK_UNLOCKED;
+    lock->class = class;
+    lock->acquired = 0;
+}
+EXPORT_SYMBOL(__spin_lock_init);
+
+void __rwlock_init(rwlock_t *lock, struct lock_class *class)
+{
+    lock->raw_lock = (arch_rwlock_t) __ARCH_RW_LOCK_UNLOCKED;
+    lock->class = class;
+    lock->acquired = 0;
+}
+EXPORT_SYMBOL(__rwlock_init);
+
+/* Found taken when the trylock fails, the wait is of the lock after */
+void do_raw_spin_lock(spinlock_t *lock)
+{
+    u64 start;
+
+    if (arch_spin_trylock(&lock->raw_lock)) {
+        lock->acquired = get_time();
+        lock_acquired(lock->class, false, 0);
+        return;
+    }
+
+    start = get_time();
+    arch_spin_lock(&lock->raw_lock);
+    lock->acquired = get_time();
+    lock_acquired(lock->class, true, lock->acquired - start);
+}
+EXPORT_SYMBOL(do_raw_spin_lock);
+
+int do_raw_spin_trylock(spinlock_t *lock)
+{
+    if (!arch_spin_trylock(&lock->raw_lock))
+        return 0;
+
+    lock->acquired = get_time();
+    lock_acquired(lock->class, false, 0);
+    return 1;
+}
+EXPORT_SYMBOL(do_raw_spin_trylock);
+
+void do_raw_spin_unlock(spinlock_t *lock)
+{
+    lock_released(lock->class, get_time() - lock->acquired);
+    arch_spin_unlock(&lock->raw_lock);
+}
+EXPORT_SYMBOL(do_raw_spin_unlock);
+
+void do_raw_read_lock(rwlock_t *lock)
+{
+    u64 start;
+
+    if (arch_read_trylock(&lock->raw_lock)) {
+        lock_acquired(lock->class, false, 0);
+        return;
+    }
+
+    start = get_time();
+    arch_read_lock(&lock->raw_lock);
+    lock_acquired(lock->class, true, get_time() - start);
+}
+EXPORT_SYMBOL(do_raw_read_lock);
+
+int do_raw_read_trylock(rwlock_t *lock)
+{
+    if (!arch_read_trylock(&lock->raw_lock))
+        return 0;
+
+    lock_acquired(lock->class, false, 0);
+    return 1;
+}
+EXPORT_SYMBOL(do_raw_read_trylock);
+
+void do_raw_read_unlock(rwlock_t *lock)
+{
+    arch_read_unlock(&lock->raw_lock);
+}
+EXPORT_SYMBOL(do_raw_read_unlock);
+
+void do_raw_write_lock(rwlock_t *lock)
+{
+    u64 start;
+
+    if (arch_write_trylock(&lock->raw_lock)) {
+        lock->acquired = get_time();
+        lock_acquired(lock->class, false, 0);
+        return;
+    }
+
+    start = get_time();
+    arch_write_lock(&lock->raw_lock);
+    lock->acquired = get_time();
+    lock_acquired(lock->class, true, lock->acquired - start);
+}
+EXPORT_SYMBOL(do_raw_write_lock);
+
+int do_raw_write_trylock(rwlock_t *lock)
+{
+    if (!arch_write_trylock(&lock->raw_lock))
+        return 0;
+
+    lock->acquired = get_time();
+    lock_acquired(lock->class, false, 0);
+    return 1;
+}
+EXPORT_SYMBOL(do_raw_write_trylock);
+
+void do_raw_write_unlock(rwlock_t *lock)
+{
+    lock_released(lock->class, get_time() - lock->acquired);
+    arch_write_unlock(&lock->raw_lock);
+}
+EXPORT_SYMBOL(do_raw_write_unlock);
+
+#endif /* CONFIG_LOCK_STAT */
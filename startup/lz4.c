@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <types.h>
+#include <string.h>
+#include <lz4.h>
+
+/* Add up the 255-terminated extension bytes of a length field */
+static bool
+read_length(const u8 **ip, const u8 *iend, size_t *len)
+{
+    u8 b;
+
+    do {
+        if (*ip >= iend)
+            return false;
+        b = *(*ip)++;
+        *len += b;
+    } while (b == 255);
+
+    return true;
+}
+
+long lz4_decompress(const void *src, size_t src_len,
+                    void *dst, size_t dst_len)
+{
+    const u8 *ip = src;
+    const u8 *iend = ip + src_len;
+    u8 *op = dst;
+    u8 *oend = op + dst_len;
+
+    while (ip < iend) {
+        unsigned int token = *ip++;
+        size_t offset;
+        size_t len;
+        const u8 *match;
+
+        /* literals */
+        len = token >> 4;
+        if (len == 15 && !read_length(&ip, iend, &len))
+            return -1;
+
+        if (len > iend - ip || len > oend - op)
+            return -1;
+
+        memcpy(op, ip, len);
+        ip += len;
+        op += len;
+
+        /* The last sequence has no match part. */
+        if (ip == iend)
+            break;
+
+        if (iend - ip < 2)
+            return -1;
+
+        offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+
+        if (!offset || offset > op - (u8 *)dst)
+            return -1;
+
+        len = token & 15;
+        if (len == 15 && !read_length(&ip, iend, &len))
+            return -1;
+        len += LZ4_MINMATCH;
+
+        if (len > oend - op)
+            return -1;
+
+        /* A match may overlap the bytes it produces. */
+        match = op - offset;
+        if (offset >= len) {
+            memcpy(op, match, len);
+            op += len;
+        } else {
+            while (len--)
+                *op++ = *match++;
+        }
+    }
+
+    return op - (u8 *)dst;
+}
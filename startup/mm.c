@@ -14,6 +14,12 @@
 uintptr_t kernel_start = 0;
 EXPORT_SYMBOL(kernel_start);
 
+/* Page aligned by startup.lds */
+extern char __init_begin[];
+EXPORT_SYMBOL(__init_begin);
+extern char __init_end[];
+EXPORT_SYMBOL(__init_end);
+
 pgd_t early_pgd[PTRS_PER_PGD] __initdata __aligned(PAGE_SIZE);
 EXPORT_SYMBOL(early_pgd);
 pmd_t early_pmd[PTRS_PER_PMD] __initdata __aligned(PAGE_SIZE);
@@ -39,7 +45,7 @@ EXPORT_SYMBOL(do_page_fault_func);
 
 extern char _start[];
 
-void setup_early_pgd(uintptr_t dtb_pa)
+void __init setup_early_pgd(uintptr_t dtb_pa)
 {
     uintptr_t load_pa = (uintptr_t)(&_start);
     uintptr_t pgd_idx = pgd_index(PAGE_OFFSET);
@@ -10,16 +10,36 @@
 #include <bug.h>
 #include <pgtable.h>
 #include <mm.h>
+#include <timex.h>
+#include <prelink.h>
+#include <lz4.h>
+#include <stringhash.h>
+#include <linkage.h>
+#include <jump_label.h>
 
 /* n must be power of 2 */
 #define ROUND_UP(x, n) (((x) + (n) - 1UL) & ~((n) - 1UL))
 
+/* Marks the sh_entsize of a section laid out in the init area */
+#define INIT_OFFSET_MASK (1UL << (BITS_PER_LONG - 1))
+
+extern char _start[];
 extern char _end[];
 extern uintptr_t kernel_start;
 
 extern const struct kernel_symbol _start_ksymtab[];
 extern const struct kernel_symbol _end_ksymtab[];
 
+extern const struct initcall _start_initcall[];
+extern const struct initcall _end_initcall[];
+
+#ifdef CONFIG_MONOLITHIC
+/* Generated into startup/initcall_deps.c by scripts/initcall_deps.sh */
+extern const struct initcall_dep initcall_deps[];
+extern const int nr_initcall_deps;
+extern bool initcall_promoted[];
+#endif
+
 #define ksymtab_num (_end_ksymtab - _start_ksymtab)
 
 LIST_HEAD(modules);
@@ -28,12 +48,52 @@ EXPORT_SYMBOL(modules);
 uintptr_t kernel_size = 0;
 EXPORT_SYMBOL(kernel_size);
 
+u64 modules_load_ticks = 0;
+EXPORT_SYMBOL(modules_load_ticks);
+
+/*
+ * The .init.* sections of all modules are packed top-down below the
+ * end of the early kernel mapping, away from the modules themselves,
+ * so that the area can be freed as whole pages after boot.
+ */
+uintptr_t modules_init_start = 0;
+EXPORT_SYMBOL(modules_init_start);
+uintptr_t modules_init_end = 0;
+EXPORT_SYMBOL(modules_init_end);
+
 struct module kernel_module;
 
+/*
+ * Index of all exported symbols, keyed by the hash of their names.
+ * Chains are linked through indexes into ksym_entries, 0 ends a chain.
+ */
+#define KSYM_HASH_BITS  10
+#define KSYM_HASH_SIZE  (1UL << KSYM_HASH_BITS)
+#define KSYM_ENTRY_MAX  2048
+
+struct ksym_entry {
+    const struct kernel_symbol *ksym;
+    struct module *owner;
+    u32 hash;
+    u32 next;
+};
+
+static u32 ksym_hash_table[KSYM_HASH_SIZE];
+static struct ksym_entry ksym_entries[KSYM_ENTRY_MAX];
+static u32 ksym_entry_count = 1;    /* Skip 0 because it ends chains. */
+static bool ksym_index_overflow;
+
+unsigned long ksym_lookups = 0;
+EXPORT_SYMBOL(ksym_lookups);
+
+unsigned long ksym_lookup_cycles = 0;
+EXPORT_SYMBOL(ksym_lookup_cycles);
+
 struct layout {
     unsigned int size;
     unsigned int text_size;
     unsigned int ro_size;
+    unsigned int init_size;
 };
 
 struct load_info {
@@ -50,18 +110,99 @@ struct load_info {
     } index;
 
     struct layout layout;
+
+    /* Header of a compressed module, NULL for a plain .ko */
+    const struct module_lz4_header *lz4;
+
+    /* Deferred modules whose symbols have been resolved */
+    struct module *deps[MODULE_MAX_DEPS];
+    unsigned int num_deps;
 };
 
-static void
+static u32 __init
+ksym_name_hash(const char *name)
+{
+    unsigned long hash = init_name_hash(0);
+
+    while (*name)
+        hash = partial_name_hash((unsigned char)*name++, hash);
+
+    return end_name_hash(hash);
+}
+
+static const struct ksym_entry * __init
+ksym_index_find(const char *name, u32 hash)
+{
+    u32 i;
+
+    i = ksym_hash_table[hash_32(hash, KSYM_HASH_BITS)];
+    for (; i; i = ksym_entries[i].next) {
+        if (ksym_entries[i].hash == hash &&
+            !strcmp(ksym_entries[i].ksym->name, name))
+            return &ksym_entries[i];
+    }
+
+    return NULL;
+}
+
+/*
+ * Add all symbols of a module into the index. A name which has been
+ * exported already keeps its first definition, the same one that a
+ * walk of the modules list in order would find.
+ */
+static void __init
+ksym_index_add(struct module *mod)
+{
+    int i;
+
+    for (i = 0; i < mod->num_syms; i++) {
+        const struct kernel_symbol *ksym = mod->syms + i;
+        u32 hash = ksym_name_hash(ksym->name);
+        u32 *head;
+
+        if (ksym_index_find(ksym->name, hash))
+            continue;
+
+        if (ksym_entry_count >= KSYM_ENTRY_MAX) {
+            if (!ksym_index_overflow)
+                sbi_puts("ksymtab index is full, fall back to list!\n");
+            ksym_index_overflow = true;
+            return;
+        }
+
+        head = &ksym_hash_table[hash_32(hash, KSYM_HASH_BITS)];
+        ksym_entries[ksym_entry_count].ksym = ksym;
+        ksym_entries[ksym_entry_count].owner = mod;
+        ksym_entries[ksym_entry_count].hash = hash;
+        ksym_entries[ksym_entry_count].next = *head;
+        *head = ksym_entry_count++;
+    }
+}
+
+static void __init
+set_module_name(struct module *mod, const char *name)
+{
+    int i;
+
+    for (i = 0; name && name[i] && i < MODULE_NAME_LEN - 1; i++)
+        mod->name[i] = name[i];
+    mod->name[i] = '\0';
+}
+
+static void __init
 init_kernel_module(void)
 {
+    set_module_name(&kernel_module, "startup");
+    kernel_module.base = (uintptr_t)_start;
+    kernel_module.size = _end - _start;
     kernel_module.syms = _start_ksymtab;
     kernel_module.num_syms = ksymtab_num;
 
     list_add_tail(&kernel_module.list, &modules);
+    ksym_index_add(&kernel_module);
 }
 
-static long
+static long __init
 get_offset(unsigned int *size, Elf64_Shdr *s)
 {
     long ret;
@@ -71,7 +212,13 @@ get_offset(unsigned int *size, Elf64_Shdr *s)
     return ret;
 }
 
-static void
+static bool __init
+is_init_section(const char *name)
+{
+    return !memcmp(name, ".init", 5);
+}
+
+static void __init
 layout_sections(struct load_info *info)
 {
     static unsigned long const masks[][2] = {
@@ -88,10 +235,12 @@ layout_sections(struct load_info *info)
     for (m = 0; m < ARRAY_SIZE(masks); ++m) {
         for (i = 0; i < info->hdr->e_shnum; ++i) {
             Elf64_Shdr *s = info->sechdrs + i;
+            const char *sname = info->secstrings + s->sh_name;
 
             if ((s->sh_flags & masks[m][0]) != masks[m][0]
                 || (s->sh_flags & masks[m][1])
-                || s->sh_entsize != ~0UL)
+                || s->sh_entsize != ~0UL
+                || is_init_section(sname))
                 continue;
 
             s->sh_entsize = get_offset(&(info->layout.size), s);
@@ -106,9 +255,25 @@ layout_sections(struct load_info *info)
             break;
         }
     }
+
+    for (m = 0; m < ARRAY_SIZE(masks); ++m) {
+        for (i = 0; i < info->hdr->e_shnum; ++i) {
+            Elf64_Shdr *s = info->sechdrs + i;
+            const char *sname = info->secstrings + s->sh_name;
+
+            if ((s->sh_flags & masks[m][0]) != masks[m][0]
+                || (s->sh_flags & masks[m][1])
+                || s->sh_entsize != ~0UL
+                || !is_init_section(sname))
+                continue;
+
+            s->sh_entsize = get_offset(&(info->layout.init_size), s)
+                | INIT_OFFSET_MASK;
+        }
+    }
 }
 
-static void
+static void __init
 rewrite_section_headers(struct load_info *info)
 {
     int i;
@@ -120,7 +285,7 @@ rewrite_section_headers(struct load_info *info)
     }
 }
 
-static void
+static void __init
 setup_load_info(uintptr_t base, struct load_info *info)
 {
     int i;
@@ -142,9 +307,48 @@ setup_load_info(uintptr_t base, struct load_info *info)
             break;
         }
     }
+
+    for (i = 1; i < info->hdr->e_shnum; i++) {
+        const char *secname = info->secstrings + info->sechdrs[i].sh_name;
+        if (!strcmp(secname, ".modname")) {
+            info->name = (char *)info->hdr + info->sechdrs[i].sh_offset;
+            break;
+        }
+    }
 }
 
-static uintptr_t
+/*
+ * Decompress the meta block of a compressed module to scratch memory
+ * behind the space of the module at @addr. It is only needed until
+ * the module is linked, the next module is loaded over it.
+ */
+static bool __init
+setup_compressed_load_info(uintptr_t base, uintptr_t addr,
+                           struct load_info *info)
+{
+    const struct module_lz4_header *hdr = (void *)base;
+    uintptr_t scratch;
+
+    scratch = ROUND_UP(addr + hdr->image_size + sizeof(struct module), 8);
+    if (scratch + hdr->meta_size + hdr->init_size > modules_init_start) {
+        sbi_puts("no room to decompress module!\n");
+        return false;
+    }
+
+    if (lz4_decompress(hdr + 1, hdr->meta_csize,
+                       (void *)scratch, hdr->meta_size) != hdr->meta_size) {
+        sbi_puts("bad compressed module!\n");
+        return false;
+    }
+
+    setup_load_info(scratch, info);
+    info->len = sizeof(*hdr) + hdr->meta_csize + hdr->image_csize +
+        hdr->init_csize;
+    info->lz4 = hdr;
+    return true;
+}
+
+static uintptr_t __init
 modules_source_base(void)
 {
     uintptr_t base = (FLASH_VA + FLASH_HEAD_SIZE);
@@ -152,12 +356,30 @@ modules_source_base(void)
     return ROUND_UP((base + hdr->image_size), 8);
 }
 
-static void
-move_module(uintptr_t addr, struct load_info *info)
+static unsigned long __init
+move_module(uintptr_t addr, uintptr_t init_addr, struct load_info *info)
 {
     int i;
-
-    memset((void*)addr, 0, info->layout.size);
+    unsigned long bytes = 0;
+
+    /* A compressed image is already laid out, NOBITS included. */
+    if (info->lz4) {
+        const void *src = (const void *)(info->lz4 + 1) +
+            info->lz4->meta_csize;
+
+        if (lz4_decompress(src, info->lz4->image_csize, (void *)addr,
+                           info->layout.size) != info->layout.size ||
+            lz4_decompress(src + info->lz4->image_csize,
+                           info->lz4->init_csize, (void *)init_addr,
+                           info->layout.init_size) != info->layout.init_size) {
+            sbi_puts("bad compressed module!\n");
+            halt();
+        }
+        bytes = info->layout.size + info->layout.init_size;
+    } else {
+        memset((void*)addr, 0, info->layout.size);
+        memset((void*)init_addr, 0, info->layout.init_size);
+    }
 
     for (i = 0; i < info->hdr->e_shnum; i++) {
         void *p;
@@ -166,18 +388,25 @@ move_module(uintptr_t addr, struct load_info *info)
         if (!(s->sh_flags & SHF_ALLOC))
             continue;
 
-        p = (void*)addr + s->sh_entsize;
+        if (s->sh_entsize & INIT_OFFSET_MASK)
+            p = (void*)init_addr + (s->sh_entsize & ~INIT_OFFSET_MASK);
+        else
+            p = (void*)addr + s->sh_entsize;
 
-        if (s->sh_type != SHT_NOBITS)
+        if (!info->lz4 && s->sh_type != SHT_NOBITS) {
             memcpy(p, (void *)s->sh_addr, s->sh_size);
+            bytes += s->sh_size;
+        }
 
         /* Update sh_addr to point to copy in image. */
         s->sh_addr = (unsigned long)p;
     }
+
+    return bytes;
 }
 
-static const struct kernel_symbol *
-resolve_symbol(const struct load_info *info, const char *name)
+static const struct kernel_symbol * __init
+lookup_symbol_slow(const char *name, struct module **owner)
 {
     int i;
     struct module *mod;
@@ -185,18 +414,78 @@ resolve_symbol(const struct load_info *info, const char *name)
     list_for_each_entry(mod, &modules, list) {
         for (i = 0; i < mod->num_syms; i++) {
             const struct kernel_symbol *ksym = mod->syms + i;
-            if (!strcmp(ksym->name, name))
+            if (!strcmp(ksym->name, name)) {
+                *owner = mod;
                 return ksym;
+            }
         }
     }
 
     return NULL;
 }
 
-static void
-simplify_symbols(const struct load_info *info)
+static const struct kernel_symbol * __init
+resolve_symbol(const struct load_info *info, const char *name,
+               struct module **owner)
+{
+    const struct ksym_entry *e;
+    const struct kernel_symbol *ksym = NULL;
+    cycles_t start = get_cycles();
+
+    e = ksym_index_find(name, ksym_name_hash(name));
+    if (e) {
+        ksym = e->ksym;
+        *owner = e->owner;
+    } else if (ksym_index_overflow) {
+        ksym = lookup_symbol_slow(name, owner);
+    }
+
+    ksym_lookup_cycles += get_cycles() - start;
+    ksym_lookups++;
+    return ksym;
+}
+
+/* The init of @mod is needed at boot, and so are the ones it uses. */
+static void __init
+promote_module(struct module *mod)
 {
     int i;
+
+    if (mod->init_level != MODULE_INIT_DEFERRED)
+        return;
+
+    mod->init_level = MODULE_INIT_BOOT;
+    for (i = 0; i < mod->num_deps; i++)
+        promote_module(mod->deps[i]);
+}
+
+static void __init
+add_module_dep(struct load_info *info, struct module *owner)
+{
+    int i;
+
+    if (owner->init_level != MODULE_INIT_DEFERRED)
+        return;
+
+    for (i = 0; i < info->num_deps; i++) {
+        if (info->deps[i] == owner)
+            return;
+    }
+
+    /* Too many to track, so be safe and init it at boot. */
+    if (info->num_deps >= MODULE_MAX_DEPS) {
+        promote_module(owner);
+        return;
+    }
+
+    info->deps[info->num_deps++] = owner;
+}
+
+static void __init
+simplify_symbols(struct load_info *info)
+{
+    int i;
+    struct module *owner;
     const struct kernel_symbol *ksym;
     Elf64_Shdr *symsec = &info->sechdrs[info->index.sym];
     Elf64_Sym *sym = (void *)symsec->sh_addr;
@@ -214,9 +503,10 @@ simplify_symbols(const struct load_info *info)
         case SHN_LIVEPATCH:
             break;
         case SHN_UNDEF:
-            ksym = resolve_symbol(info, name);
+            ksym = resolve_symbol(info, name, &owner);
             if (ksym && !IS_ERR(ksym)) {
                 sym[i].st_value = ksym->value;
+                add_module_dep(info, owner);
                 break;
             }
 
@@ -230,7 +520,7 @@ simplify_symbols(const struct load_info *info)
     }
 }
 
-static void
+static void __init
 apply_relocate_add(Elf64_Shdr *sechdrs, const char *strtab,
                    unsigned int symindex, unsigned int relsec)
 {
@@ -376,7 +666,7 @@ apply_relocate_add(Elf64_Shdr *sechdrs, const char *strtab,
     }
 }
 
-static void
+static void __init
 apply_relocations(const struct load_info *info)
 {
     int i;
@@ -398,7 +688,7 @@ apply_relocations(const struct load_info *info)
     }
 }
 
-static u64
+static u64 __init
 query_sym(const char *target, struct load_info *info)
 {
     int i;
@@ -415,87 +705,376 @@ query_sym(const char *target, struct load_info *info)
     return 0;
 }
 
-static struct module *
+static struct module * __init
+register_module(uintptr_t addr, const char *name,
+                const struct kernel_symbol *syms, unsigned int num_syms,
+                init_module_t init, exit_module_t exit, int init_level)
+{
+    struct module *mod = (struct module *) addr;
+
+    memset((void*)mod, 0, sizeof(struct module));
+    INIT_LIST_HEAD(&mod->list);
+    list_add_tail(&mod->list, &modules);
+    set_module_name(mod, name);
+
+    mod->syms = syms;
+    mod->num_syms = num_syms;
+    ksym_index_add(mod);
+
+    mod->init = init;
+    mod->exit = exit;
+    mod->init_level = init_level;
+    return mod;
+}
+
+static struct module * __init
 finalize_module(uintptr_t addr, struct load_info *info)
 {
     int i;
     struct kernel_symbol *start;
     struct kernel_symbol *end;
+    const int *level;
     struct module *mod;
 
-    mod = (struct module *) (addr + info->layout.size);
-    info->layout.size += sizeof(struct module);
-
-    memset((void*)mod, 0, sizeof(struct module));
-    INIT_LIST_HEAD(&mod->list);
-    list_add_tail(&mod->list, &modules);
-
     start = (struct kernel_symbol *) query_sym("_start_mod_ksymtab", info);
     end = (struct kernel_symbol *) query_sym("_end_mod_ksymtab", info);
+    level = (const int *) query_sym("init_module_level", info);
+
+    mod = register_module(addr + info->layout.size, info->name,
+                          start, end - start,
+                          (init_module_t) query_sym("init_module", info),
+                          (exit_module_t) query_sym("exit_module", info),
+                          level ? *level : MODULE_INIT_BOOT);
+
+    mod->base = addr;
+    mod->size = info->layout.size;
 
-    mod->syms = start;
-    mod->num_syms = end - start;
+    for (i = 0; i < info->num_deps; i++)
+        mod->deps[i] = info->deps[i];
+    mod->num_deps = info->num_deps;
 
-    mod->init = (init_module_t) query_sym("init_module", info);
-    mod->exit = (exit_module_t) query_sym("exit_module", info);
+    if (mod->init_level == MODULE_INIT_BOOT) {
+        for (i = 0; i < mod->num_deps; i++)
+            promote_module(mod->deps[i]);
+    }
+
+    for (i = 1; i < info->hdr->e_shnum; i++) {
+        Elf64_Shdr *s = info->sechdrs + i;
+
+        if (strcmp(info->secstrings + s->sh_name, "__jump_table"))
+            continue;
+        mod->jump_entries = (struct jump_entry *) s->sh_addr;
+        mod->num_jump_entries = s->sh_size / sizeof(struct jump_entry);
+    }
+    jump_label_apply_module(mod);
+
+    info->layout.size += sizeof(struct module);
     return mod;
 }
 
 static void
 do_init_module(struct module *mod)
 {
-    if (mod->init)
-        mod->init();
+    cycles_t start;
+
+    if (mod->init_done)
+        return;
+
+    mod->init_done = true;
+    if (!mod->init)
+        return;
+
+    start = get_cycles();
+    mod->init();
+    mod->boot_stat.init = get_cycles() - start;
 }
 
-static void
-init_other_modules(void)
+static void __init
+ksymtab_hash_bytes(u64 *hash, const void *p, size_t len)
+{
+    const unsigned char *c = p;
+
+    while (len--) {
+        *hash ^= *c++;
+        *hash *= PRELINK_FNV_PRIME;
+    }
+}
+
+/* FNV-1a of the names and values of _ksymtab, as in scripts/prelink */
+static u64 __init
+ksymtab_hash(void)
+{
+    const struct kernel_symbol *ks;
+    u64 hash = PRELINK_FNV_OFFSET;
+
+    for (ks = _start_ksymtab; ks < _end_ksymtab; ks++) {
+        ksymtab_hash_bytes(&hash, ks->name, strlen(ks->name) + 1);
+        ksymtab_hash_bytes(&hash, &ks->value, sizeof(ks->value));
+    }
+    return hash;
+}
+
+/*
+ * Take the prelinked image built by scripts/prelink if there is one.
+ * It is only valid for the exact startup image that it was built
+ * against, otherwise fall back to linking each module at boot. Its
+ * init sections stay in place, so all of it must end below the init
+ * area of the modules.
+ */
+static bool __init
+load_prelinked_modules(uintptr_t src_addr, uintptr_t *dst_addr)
 {
     int i;
+    void *image;
+    struct prelink_header *hdr = (struct prelink_header *) src_addr;
+    struct prelink_entry *entries = (struct prelink_entry *) (hdr + 1);
+
+    if (memcmp(hdr->magic, PRELINK_MAGIC, PRELINK_SMAGIC))
+        return false;
+
+    if (hdr->version != PRELINK_VERSION ||
+        hdr->base != *dst_addr ||
+        hdr->module_size != sizeof(struct module) ||
+        hdr->ksymtab_hash != ksymtab_hash()) {
+        sbi_puts("prelinked modules are stale, link them at boot!\n");
+        return false;
+    }
+
+    if (hdr->base + hdr->total_size > modules_init_start) {
+        sbi_puts("prelinked modules overlap their init area!\n");
+        return false;
+    }
+
+    image = (void *) (entries + hdr->nr_modules);
+
+    for (i = 0; i < hdr->nr_modules; i++) {
+        struct prelink_entry *e = entries + i;
+        struct module *mod;
+        cycles_t start = get_cycles();
+
+        memcpy((void *)e->addr, image + (e->addr - hdr->base), e->size);
+
+        mod = register_module(e->addr + e->size, e->name,
+                              (const struct kernel_symbol *) e->syms,
+                              e->num_syms,
+                              (init_module_t) e->init,
+                              (exit_module_t) e->exit,
+                              e->init_level);
+
+        mod->base = e->addr;
+        mod->size = e->size;
+        mod->prelinked = true;
+
+        mod->jump_entries = (struct jump_entry *) e->jump_entries;
+        mod->num_jump_entries = e->num_jump_entries;
+        jump_label_apply_module(mod);
+
+        mod->boot_stat.copy = get_cycles() - start;
+        mod->boot_stat.bytes = e->size;
+    }
+
+    *dst_addr = hdr->base + hdr->total_size;
+    return true;
+}
+
+static void __init
+link_modules(uintptr_t src_addr, uintptr_t *dst_addr)
+{
     struct load_info info;
+    struct module_boot_stat stat;
     struct module *mod;
-
-    uintptr_t src_addr = modules_source_base();
-    uintptr_t dst_addr = ROUND_UP((uintptr_t)_end, 8);
+    cycles_t t0, t1, t2, t3, t4;
 
     while (1) {
-        /* should start with "ELF" magic number */
-        if (memcmp((void *)src_addr, ELFMAG, SELFMAG))
-            break;
-
         memset((void*)&info, 0, sizeof(struct load_info));
 
-        setup_load_info(src_addr, &info);
+        t0 = get_cycles();
+
+        /* should start with "ELF" or compressed module magic number */
+        if (!memcmp((void *)src_addr, ELFMAG, SELFMAG)) {
+            setup_load_info(src_addr, &info);
+        } else if (!memcmp((void *)src_addr, MODULE_LZ4_MAGIC,
+                           MODULE_LZ4_SMAGIC)) {
+            if (!setup_compressed_load_info(src_addr, *dst_addr, &info)) {
+                sbi_puts("bad compressed module!\n");
+                break;
+            }
+        } else {
+            break;
+        }
 
         rewrite_section_headers(&info);
 
         layout_sections(&info);
 
-        move_module(dst_addr, &info);
+        if (info.lz4 && (info.layout.size != info.lz4->image_size ||
+                         info.layout.init_size != info.lz4->init_size)) {
+            sbi_puts("compressed module has another layout!\n");
+            break;
+        }
+
+        modules_init_start -= ROUND_UP(info.layout.init_size, 8);
+        if (*dst_addr + info.layout.size + sizeof(struct module) >
+            modules_init_start) {
+            sbi_puts("no room to load module!\n");
+            halt();
+        }
+
+        t1 = get_cycles();
+
+        stat.bytes = move_module(*dst_addr, modules_init_start, &info);
+
+        t2 = get_cycles();
 
         simplify_symbols(&info);
 
+        t3 = get_cycles();
+
         apply_relocations(&info);
 
-        mod = finalize_module(dst_addr, &info);
+        t4 = get_cycles();
+
+        mod = finalize_module(*dst_addr, &info);
+
+        stat.layout = t1 - t0;
+        stat.copy = t2 - t1;
+        stat.symbols = t3 - t2;
+        stat.relocate = t4 - t3;
+        stat.init = 0;
+        mod->boot_stat = stat;
 
         /* next */
         src_addr += ROUND_UP(info.len, 8);
-        dst_addr += ROUND_UP(info.layout.size, 8);
+        *dst_addr += ROUND_UP(info.layout.size, 8);
+    }
+}
+
+static void __init
+init_other_modules(void)
+{
+    uintptr_t src_addr = modules_source_base();
+    uintptr_t dst_addr = ROUND_UP((uintptr_t)_end, 8);
+
+    /* The early mapping covers PMD_SIZE from _start. */
+    modules_init_end = (uintptr_t)_start + PMD_SIZE;
+    modules_init_start = modules_init_end;
+
+#ifndef CONFIG_MONOLITHIC
+    if (!load_prelinked_modules(src_addr, &dst_addr))
+        link_modules(src_addr, &dst_addr);
+#endif
+
+    /* Free whole pages of the init area after boot */
+    modules_init_start &= PAGE_MASK;
+    if (dst_addr > modules_init_start) {
+        sbi_puts("modules overlap their init area!\n");
+        halt();
     }
 
     kernel_size = __pa(dst_addr) - kernel_start;
 }
 
-void load_modules(void)
+#ifdef CONFIG_MONOLITHIC
+/* A subsystem without an initcall has nothing to defer */
+static int
+initcall_level(int idx)
+{
+    const struct initcall *call;
+
+    if (initcall_promoted[idx])
+        return MODULE_INIT_BOOT;
+
+    for (call = _start_initcall; call < _end_initcall; call++) {
+        if (call->idx == idx)
+            return *call->level;
+    }
+    return MODULE_INIT_BOOT;
+}
+
+/* As promote_module(), the subsystem and the ones it uses */
+static void __init
+promote_initcall(int idx)
+{
+    int i;
+
+    if (initcall_level(idx) != MODULE_INIT_DEFERRED)
+        return;
+
+    initcall_promoted[idx] = true;
+    for (i = 0; i < nr_initcall_deps; i++) {
+        if (initcall_deps[i].user == idx)
+            promote_initcall(initcall_deps[i].owner);
+    }
+}
+
+/*
+ * Without symbol lookups to go by, the link of the image records the
+ * subsystems each one uses. Those of boot subsystems get their init
+ * at boot, like add_module_dep() does for modules.
+ */
+static void __init
+promote_initcalls(void)
+{
+    int i;
+
+    for (i = 0; i < nr_initcall_deps; i++) {
+        if (initcall_level(initcall_deps[i].user) == MODULE_INIT_BOOT)
+            promote_initcall(initcall_deps[i].owner);
+    }
+}
+#else
+static inline int initcall_level(int idx) { return MODULE_INIT_BOOT; }
+static inline void promote_initcalls(void) { }
+#endif
+
+/*
+ * All subsystems are linked into the monolithic image, so their
+ * init_module() are called from the initcall table in SUBDIRS order.
+ */
+static void
+do_initcalls(int level)
+{
+    const struct initcall *call;
+
+    for (call = _start_initcall; call < _end_initcall; call++) {
+        if (initcall_level(call->idx) == level)
+            call->init();
+    }
+}
+
+/*
+ * Call init_module() of the modules left at MODULE_INIT_DEFERRED, in
+ * load order. It runs from a kernel thread once /sbin/init has been
+ * started.
+ */
+void do_deferred_modules(void)
+{
+    struct module *mod;
+
+    list_for_each_entry(mod, &modules, list) {
+        do_init_module(mod);
+    }
+
+    do_initcalls(MODULE_INIT_DEFERRED);
+}
+EXPORT_SYMBOL(do_deferred_modules);
+
+void __init load_modules(void)
 {
     struct module *mod;
+    u64 start = get_time();
 
     init_kernel_module();
 
     init_other_modules();
 
     list_for_each_entry(mod, &modules, list) {
-        do_init_module(mod);
+        if (mod->init_level == MODULE_INIT_BOOT)
+            do_init_module(mod);
     }
+
+    promote_initcalls();
+    do_initcalls(MODULE_INIT_BOOT);
+
+    modules_load_ticks = get_time() - start;
 }
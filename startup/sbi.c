@@ -1,5 +1,7 @@
 // SPDX-License-Identifier: GPL-2.0-only
+#include <page.h>
 #include <types.h>
+#include <errno.h>
 #include <export.h>
 
 enum sbi_ext_id {
@@ -12,8 +14,34 @@ enum sbi_ext_id {
     SBI_EXT_0_1_REMOTE_SFENCE_VMA = 0x6,
     SBI_EXT_0_1_REMOTE_SFENCE_VMA_ASID = 0x7,
     SBI_EXT_0_1_SHUTDOWN = 0x8,
+    SBI_EXT_BASE = 0x10,
+    SBI_EXT_TIME = 0x54494D45,
+    SBI_EXT_IPI = 0x735049,
+    SBI_EXT_HSM = 0x48534D,
+    SBI_EXT_RFENCE = 0x52464E43,
+    SBI_EXT_DBCN = 0x4442434E,
+    SBI_EXT_SRST = 0x53525354,
 };
 
+#define SBI_EXT_BASE_PROBE_EXT      3
+#define SBI_EXT_TIME_SET_TIMER      0
+#define SBI_EXT_DBCN_CONSOLE_WRITE  0
+#define SBI_EXT_IPI_SEND_IPI        0
+#define SBI_EXT_HSM_HART_START      0
+#define SBI_EXT_RFENCE_REMOTE_FENCE_I   0
+#define SBI_EXT_SRST_RESET          0
+
+#define SBI_SRST_RESET_TYPE_SHUTDOWN    0
+#define SBI_SRST_RESET_REASON_NONE      0
+
+#define SBI_SUCCESS                 0
+#define SBI_ERR_FAILURE             -1
+#define SBI_ERR_NOT_SUPPORTED       -2
+#define SBI_ERR_INVALID_PARAM       -3
+#define SBI_ERR_DENIED              -4
+#define SBI_ERR_INVALID_ADDRESS     -5
+#define SBI_ERR_ALREADY_AVAILABLE   -6
+
 struct sbiret {
     long error;
     long value;
@@ -60,3 +88,205 @@ void sbi_puts(const char *s)
     }
 }
 EXPORT_SYMBOL(sbi_puts);
+
+static long
+sbi_probe_extension(int ext)
+{
+    struct sbiret ret;
+
+    ret = sbi_ecall(SBI_EXT_BASE, SBI_EXT_BASE_PROBE_EXT, ext, 0, 0, 0, 0, 0);
+    if (ret.error)
+        return 0;
+    return ret.value;
+}
+
+/* Write @len bytes from @s in one go, returns false if DBCN is absent */
+static bool
+sbi_dbcn_write(const char *s, unsigned long len)
+{
+    static int has_dbcn = -1;
+    struct sbiret ret;
+
+    if (has_dbcn < 0)
+        has_dbcn = sbi_probe_extension(SBI_EXT_DBCN) > 0;
+    if (!has_dbcn)
+        return false;
+
+    while (len) {
+        ret = sbi_ecall(SBI_EXT_DBCN, SBI_EXT_DBCN_CONSOLE_WRITE,
+                        len, __pa(s), 0, 0, 0, 0);
+        if (ret.error)
+            return false;
+        s += ret.value;
+        len -= ret.value;
+    }
+    return true;
+}
+
+/*
+ * Like sbi_puts() for @len bytes of @s, but with one ecall per line
+ * when the firmware has the debug console extension.
+ */
+void sbi_console_write(const char *s, unsigned long len)
+{
+    unsigned long n;
+
+    while (len) {
+        for (n = 0; n < len && s[n] != '\n'; n++)
+            ;
+        if (n && !sbi_dbcn_write(s, n)) {
+            for (; len; s++, len--) {
+                if (*s == '\n')
+                    sbi_putchar('\r');
+                sbi_putchar(*s);
+            }
+            return;
+        }
+        s += n;
+        len -= n;
+        if (len) {
+            if (!sbi_dbcn_write("\r\n", 2)) {
+                sbi_putchar('\r');
+                sbi_putchar('\n');
+            }
+            s++;
+            len--;
+        }
+    }
+}
+EXPORT_SYMBOL(sbi_console_write);
+
+/*
+ * Program the next supervisor timer interrupt at @stime_value of the
+ * time CSR, which also clears the pending one.
+ */
+void sbi_set_timer(u64 stime_value)
+{
+    static int has_time = -1;
+
+    if (has_time < 0)
+        has_time = sbi_probe_extension(SBI_EXT_TIME) > 0;
+
+    if (has_time)
+        sbi_ecall(SBI_EXT_TIME, SBI_EXT_TIME_SET_TIMER,
+                  stime_value, 0, 0, 0, 0, 0);
+    else
+        sbi_ecall(SBI_EXT_0_1_SET_TIMER, 0, stime_value, 0, 0, 0, 0, 0);
+}
+EXPORT_SYMBOL(sbi_set_timer);
+
+static int
+sbi_err_map_linux_errno(long err)
+{
+    switch (err) {
+    case SBI_SUCCESS:
+        return 0;
+    case SBI_ERR_DENIED:
+        return -EPERM;
+    case SBI_ERR_INVALID_PARAM:
+        return -EINVAL;
+    case SBI_ERR_INVALID_ADDRESS:
+        return -EFAULT;
+    case SBI_ERR_ALREADY_AVAILABLE:
+        return -EBUSY;
+    case SBI_ERR_NOT_SUPPORTED:
+    case SBI_ERR_FAILURE:
+    default:
+        return -EOPNOTSUPP;
+    }
+}
+
+/*
+ * The legacy calls take a pointer to a single word of mask starting
+ * at hart 0, the harts above it are out of their reach.
+ */
+static bool
+sbi_legacy_mask(unsigned long *hart_mask, unsigned long hart_mask_base)
+{
+    if (hart_mask_base >= BITS_PER_LONG ||
+        (*hart_mask << hart_mask_base) >> hart_mask_base != *hart_mask) {
+        sbi_puts("sbi: hart out of reach of the legacy calls!\n");
+        return false;
+    }
+
+    *hart_mask <<= hart_mask_base;
+    return true;
+}
+
+/*
+ * Raise the supervisor software interrupt of the harts set in
+ * @hart_mask, whose bit n is hart @hart_mask_base + n.
+ */
+void sbi_send_ipi(unsigned long hart_mask, unsigned long hart_mask_base)
+{
+    static int has_ipi = -1;
+
+    if (has_ipi < 0)
+        has_ipi = sbi_probe_extension(SBI_EXT_IPI) > 0;
+
+    if (has_ipi)
+        sbi_ecall(SBI_EXT_IPI, SBI_EXT_IPI_SEND_IPI,
+                  hart_mask, hart_mask_base, 0, 0, 0, 0);
+    else if (sbi_legacy_mask(&hart_mask, hart_mask_base))
+        sbi_ecall(SBI_EXT_0_1_SEND_IPI, 0,
+                  (unsigned long)&hart_mask, 0, 0, 0, 0, 0);
+}
+EXPORT_SYMBOL(sbi_send_ipi);
+
+/*
+ * Have the harts set in @hart_mask, as for sbi_send_ipi(), execute
+ * fence.i, so that they fetch the instructions written by this one.
+ * Returns once they have.
+ */
+void sbi_remote_fence_i(unsigned long hart_mask, unsigned long hart_mask_base)
+{
+    static int has_rfence = -1;
+
+    if (has_rfence < 0)
+        has_rfence = sbi_probe_extension(SBI_EXT_RFENCE) > 0;
+
+    if (has_rfence)
+        sbi_ecall(SBI_EXT_RFENCE, SBI_EXT_RFENCE_REMOTE_FENCE_I,
+                  hart_mask, hart_mask_base, 0, 0, 0, 0);
+    else if (sbi_legacy_mask(&hart_mask, hart_mask_base))
+        sbi_ecall(SBI_EXT_0_1_REMOTE_FENCE_I, 0,
+                  (unsigned long)&hart_mask, 0, 0, 0, 0, 0);
+}
+EXPORT_SYMBOL(sbi_remote_fence_i);
+
+/*
+ * Start @hartid at the physical address @saddr with the MMU off, it
+ * finds its hart ID in a0 and @priv in a1. There is no way to start
+ * a hart without the hart state management extension.
+ */
+int sbi_hart_start(unsigned long hartid, unsigned long saddr,
+                   unsigned long priv)
+{
+    static int has_hsm = -1;
+    struct sbiret ret;
+
+    if (has_hsm < 0)
+        has_hsm = sbi_probe_extension(SBI_EXT_HSM) > 0;
+    if (!has_hsm)
+        return -EOPNOTSUPP;
+
+    ret = sbi_ecall(SBI_EXT_HSM, SBI_EXT_HSM_HART_START,
+                    hartid, saddr, priv, 0, 0, 0);
+    return sbi_err_map_linux_errno(ret.error);
+}
+EXPORT_SYMBOL(sbi_hart_start);
+
+/*
+ * Power the machine off, with the legacy call if the system reset
+ * extension is absent. Returns only if the firmware refused both.
+ */
+void sbi_shutdown(void)
+{
+    if (sbi_probe_extension(SBI_EXT_SRST) > 0)
+        sbi_ecall(SBI_EXT_SRST, SBI_EXT_SRST_RESET,
+                  SBI_SRST_RESET_TYPE_SHUTDOWN, SBI_SRST_RESET_REASON_NONE,
+                  0, 0, 0, 0);
+
+    sbi_ecall(SBI_EXT_0_1_SHUTDOWN, 0, 0, 0, 0, 0, 0, 0);
+}
+EXPORT_SYMBOL(sbi_shutdown);
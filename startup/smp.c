@@ -0,0 +1,232 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * SMP initialisation and IPI support
+ */
+
+#include <bug.h>
+#include <csr.h>
+#include <sbi.h>
+#include <smp.h>
+#include <errno.h>
+#include <export.h>
+#include <kernel.h>
+#include <barrier.h>
+#include <cpumask.h>
+#include <irqflags.h>
+#include <spinlock.h>
+
+unsigned long boot_cpu_hartid;
+EXPORT_SYMBOL(boot_cpu_hartid);
+
+unsigned long __cpuid_to_hartid_map[NR_CPUS] = {
+    [0 ... NR_CPUS-1] = INVALID_HARTID
+};
+EXPORT_SYMBOL(__cpuid_to_hartid_map);
+
+/* The boot CPU is there from the start, the others are found in the DT */
+unsigned int nr_cpu_ids = 1;
+EXPORT_SYMBOL(nr_cpu_ids);
+
+struct cpumask __cpu_possible_mask = { .bits = { BIT(0) } };
+EXPORT_SYMBOL(__cpu_possible_mask);
+
+struct cpumask __cpu_online_mask = { .bits = { BIT(0) } };
+EXPORT_SYMBOL(__cpu_online_mask);
+
+/* Entry of the secondary harts in core.S, handed to SBI HSM */
+extern void secondary_start_sbi(void);
+EXPORT_SYMBOL(secondary_start_sbi);
+
+/* Set by the smp module, which brings up the secondary harts */
+smp_callin_t smp_callin_func;
+EXPORT_SYMBOL(smp_callin_func);
+
+/*
+ * The kernel lock, one CPU at a time runs in the kernel. Most of it
+ * was written for a single CPU: the wait queues, the timer wheel, the
+ * tty and the runqueues are kept with interrupts off only, this lock
+ * makes that hold across the CPUs. The user mode of the tasks runs
+ * in parallel, and so do the idle loops.
+ *
+ * A CPU takes it on each entry into the kernel, see entry.S, and a
+ * task holds it for as long as it runs in there, interrupts nest in
+ * it. The scheduler keeps it across the switch to the next task, see
+ * sched_lock_kernel(), so a task only lets go of it on the way back
+ * to user mode or by switching to the idle task.
+ */
+static DEFINE_SPINLOCK(kernel_flag);
+
+/* How often each CPU holds the kernel lock, 0 when it doesn't */
+static unsigned int kernel_lock_depth[NR_CPUS];
+
+void lock_kernel(void)
+{
+    unsigned long flags;
+    int cpu;
+
+    /* An interrupt in between would take the lock as held */
+    local_irq_save(flags);
+
+    cpu = smp_processor_id();
+    if (!kernel_lock_depth[cpu]++)
+        spin_lock(&kernel_flag);
+
+    local_irq_restore(flags);
+}
+EXPORT_SYMBOL(lock_kernel);
+
+void unlock_kernel(void)
+{
+    unsigned long flags;
+    int cpu;
+
+    local_irq_save(flags);
+
+    cpu = smp_processor_id();
+    BUG_ON(!kernel_lock_depth[cpu]);
+    if (!--kernel_lock_depth[cpu])
+        spin_unlock(&kernel_flag);
+
+    local_irq_restore(flags);
+}
+EXPORT_SYMBOL(unlock_kernel);
+
+bool kernel_locked(void)
+{
+    return kernel_lock_depth[smp_processor_id()];
+}
+EXPORT_SYMBOL(kernel_locked);
+
+/*
+ * For __schedule(), with interrupts off. The kernel lock is held up to
+ * the task switched to, which takes it over with sched_unlock_kernel().
+ * Returns how often the task switching out holds it, none for an idle
+ * task.
+ */
+unsigned int sched_lock_kernel(void)
+{
+    int cpu = smp_processor_id();
+    unsigned int depth = kernel_lock_depth[cpu];
+
+    if (!depth) {
+        spin_lock(&kernel_flag);
+        kernel_lock_depth[cpu] = 1;
+    }
+    return depth;
+}
+EXPORT_SYMBOL(sched_lock_kernel);
+
+/*
+ * Back on a task in __schedule(), or on a new one in schedule_tail(),
+ * which holds the kernel lock @depth times. Let go of it for an idle
+ * task.
+ */
+void sched_unlock_kernel(unsigned int depth)
+{
+    int cpu = smp_processor_id();
+
+    kernel_lock_depth[cpu] = depth;
+    if (!depth)
+        spin_unlock(&kernel_flag);
+}
+EXPORT_SYMBOL(sched_unlock_kernel);
+
+enum ipi_message_type {
+    IPI_RESCHEDULE,
+    IPI_MAX
+};
+
+/* A cache line each, the senders of one CPU don't bounce another's */
+static struct {
+    unsigned long bits;
+} __aligned(SMP_CACHE_BYTES) ipi_data[NR_CPUS];
+
+int riscv_hartid_to_cpuid(unsigned long hartid)
+{
+    int i;
+
+    for (i = 0; i < NR_CPUS; i++)
+        if (cpuid_to_hartid_map(i) == hartid)
+            return i;
+
+    return -ENOENT;
+}
+EXPORT_SYMBOL(riscv_hartid_to_cpuid);
+
+static void
+send_ipi_single(int cpu, enum ipi_message_type op)
+{
+    smp_mb();
+    set_bit(op, &ipi_data[cpu].bits);
+    smp_mb();
+
+    sbi_send_ipi(1, cpuid_to_hartid_map(cpu));
+}
+
+void handle_IPI(struct pt_regs *regs)
+{
+    unsigned long *pending_ipis = &ipi_data[smp_processor_id()].bits;
+
+    /* Cleared before the bits, an IPI sent in between is taken again */
+    csr_clear(CSR_IP, IE_SIE);
+    smp_mb();
+
+    /*
+     * Nothing more to do, the sender flagged the current task already
+     * and the return from the interrupt or the idle loop acts on it.
+     */
+    test_and_clear_bit(IPI_RESCHEDULE, pending_ipis);
+}
+EXPORT_SYMBOL(handle_IPI);
+
+void smp_send_reschedule(int cpu)
+{
+    send_ipi_single(cpu, IPI_RESCHEDULE);
+}
+EXPORT_SYMBOL(smp_send_reschedule);
+
+/*
+ * Have all online CPUs fetch the instructions this one wrote, such as
+ * the sites patched by jump labels.
+ */
+void flush_icache_all(void)
+{
+    unsigned long hart_mask = 0;
+    unsigned long hart_mask_base = 0;
+    unsigned long hartid;
+    int cpu;
+
+    asm volatile ("fence.i" ::: "memory");
+
+    /* A word of mask at a time, from the first hart it holds */
+    for_each_online_cpu(cpu) {
+        if (cpu == smp_processor_id())
+            continue;
+
+        hartid = cpuid_to_hartid_map(cpu);
+        if (hart_mask && (hartid < hart_mask_base ||
+                          hartid - hart_mask_base >= BITS_PER_LONG)) {
+            sbi_remote_fence_i(hart_mask, hart_mask_base);
+            hart_mask = 0;
+        }
+        if (!hart_mask)
+            hart_mask_base = hartid;
+        hart_mask |= BIT(hartid - hart_mask_base);
+    }
+
+    if (hart_mask)
+        sbi_remote_fence_i(hart_mask, hart_mask_base);
+}
+EXPORT_SYMBOL(flush_icache_all);
+
+/*
+ * Entered from secondary_start_sbi in core.S on the idle task of the
+ * CPU, with the MMU on and interrupts off.
+ */
+void smp_callin(void)
+{
+    /* Nothing of the boot page tables may stay behind */
+    local_flush_tlb_all();
+
+    smp_callin_func();
+}
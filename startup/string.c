@@ -2,9 +2,16 @@
 
 #include <types.h>
 #include <export.h>
+#include <vector.h>
+#include <word-at-a-time.h>
 
 extern void *__memset(void *, int, __kernel_size_t);
 extern void *__memcpy(void *, const void *, __kernel_size_t);
+extern void *__memmove(void *, const void *, __kernel_size_t);
+
+/* The scalar copies on their own, for test_startup to benchmark */
+EXPORT_SYMBOL(__memcpy);
+EXPORT_SYMBOL(__memmove);
 
 /**
  * memset - Fill a region of memory with the given value
@@ -16,6 +23,13 @@ extern void *__memcpy(void *, const void *, __kernel_size_t);
  */
 void *memset(void *s, int c, size_t count)
 {
+    if (count >= RISCV_V_MIN_BYTES && may_use_vector()) {
+        kernel_vector_begin();
+        __memset_rvv(s, c, count);
+        kernel_vector_end();
+        return s;
+    }
+
     return __memset(s, c, count);
 }
 EXPORT_SYMBOL(memset);
@@ -31,10 +45,38 @@ EXPORT_SYMBOL(memset);
  */
 void *memcpy(void *dest, const void *src, size_t count)
 {
+    if (count >= RISCV_V_MIN_BYTES && may_use_vector()) {
+        kernel_vector_begin();
+        __memcpy_rvv(dest, src, count);
+        kernel_vector_end();
+        return dest;
+    }
+
     return __memcpy(dest, src, count);
 }
 EXPORT_SYMBOL(memcpy);
 
+/**
+ * memmove - Copy one area of memory to another
+ * @dest: Where to copy to
+ * @src: Where to copy from
+ * @count: The size of the area.
+ *
+ * Unlike memcpy(), memmove() copes with overlapping areas.
+ */
+void *memmove(void *dest, const void *src, size_t count)
+{
+    if (count >= RISCV_V_MIN_BYTES && may_use_vector()) {
+        kernel_vector_begin();
+        __memmove_rvv(dest, src, count);
+        kernel_vector_end();
+        return dest;
+    }
+
+    return __memmove(dest, src, count);
+}
+EXPORT_SYMBOL(memmove);
+
 /**
  * memcmp - Compare two areas of memory
  * @cs: One area of memory
@@ -61,7 +103,32 @@ EXPORT_SYMBOL(memcmp);
 int strcmp(const char *cs, const char *ct)
 {
     unsigned char c1, c2;
+    const struct word_at_a_time constants = WORD_AT_A_TIME_CONSTANTS;
+
+    /* Whole words once both strings reach a word boundary together */
+    if (IS_ALIGNED((unsigned long)cs ^ (unsigned long)ct,
+                   sizeof(unsigned long))) {
+        while (*cs == *ct && *cs &&
+               !IS_ALIGNED((unsigned long)cs, sizeof(unsigned long))) {
+            cs++;
+            ct++;
+        }
+
+        if (IS_ALIGNED((unsigned long)cs, sizeof(unsigned long))) {
+            for (;;) {
+                unsigned long w1 = read_word_at_a_time(cs);
+                unsigned long w2 = read_word_at_a_time(ct);
+                unsigned long data;
+
+                if (w1 != w2 || has_zero(w1, &data, &constants))
+                    break;
+                cs += sizeof(unsigned long);
+                ct += sizeof(unsigned long);
+            }
+        }
+    }
 
+    /* The rest, or the word holding the difference or the NUL */
     while (1) {
         c1 = *cs++;
         c2 = *ct++;
@@ -63,3 +63,38 @@ SYSCALL_DEFINE3(write, unsigned int, fd,
 {
     return ksys_write(fd, buf, count);
 }
+
+do_sys_clock_gettime_t do_sys_clock_gettime;
+EXPORT_SYMBOL(do_sys_clock_gettime);
+
+SYSCALL_DEFINE2(clock_gettime, clockid_t, which_clock,
+                struct __kernel_timespec *, tp)
+{
+    return do_sys_clock_gettime(which_clock, tp);
+}
+
+do_sys_gettimeofday_t do_sys_gettimeofday;
+EXPORT_SYMBOL(do_sys_gettimeofday);
+
+SYSCALL_DEFINE2(gettimeofday, struct __kernel_old_timeval *, tv,
+                struct timezone *, tz)
+{
+    return do_sys_gettimeofday(tv, tz);
+}
+
+do_sys_getcpu_t do_sys_getcpu;
+EXPORT_SYMBOL(do_sys_getcpu);
+
+SYSCALL_DEFINE3(getcpu, unsigned *, cpu, unsigned *, node, void *, cache)
+{
+    return do_sys_getcpu(cpu, node, cache);
+}
+
+do_sys_reboot_t do_sys_reboot;
+EXPORT_SYMBOL(do_sys_reboot);
+
+SYSCALL_DEFINE4(reboot, int, magic1, int, magic2, unsigned int, cmd,
+                void *, arg)
+{
+    return do_sys_reboot(magic1, magic2, cmd, arg);
+}
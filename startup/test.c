@@ -1,2 +1,91 @@
 // SPDX-License-Identifier: GPL-2.0-only
 
+#include <printk.h>
+#include <string.h>
+#include <linkage.h>
+#include <timex.h>
+#include <uaccess.h>
+
+/*
+ * Copy throughput for every (src, dst) alignment pair, in bytes per
+ * thousand cycles. memcpy() and memmove() would take the RVV versions
+ * for these sizes on a CPU with V, so the scalar __memcpy() and
+ * __memmove() are measured. The uaccess helpers are run on kernel
+ * buffers, which SUM doesn't get in the way of.
+ */
+
+#define BENCH_LEN       4096
+#define BENCH_LOOPS     16
+
+typedef void *(*copy_fn_t)(void *, const void *, size_t);
+
+extern void *__memcpy(void *, const void *, __kernel_size_t);
+extern void *__memmove(void *, const void *, __kernel_size_t);
+
+static unsigned char src_buf[BENCH_LEN + 8] __attribute__((aligned(8)));
+static unsigned char dst_buf[BENCH_LEN + 8] __attribute__((aligned(8)));
+
+static void *
+bench_copy_to_user(void *dst, const void *src, size_t len)
+{
+    asm_copy_to_user(dst, src, len);
+    return dst;
+}
+
+static void *
+bench_copy_from_user(void *dst, const void *src, size_t len)
+{
+    asm_copy_from_user(dst, src, len);
+    return dst;
+}
+
+static unsigned long
+bench_one(copy_fn_t fn, size_t src_off, size_t dst_off)
+{
+    cycles_t start, cycles;
+    int i;
+
+    /* Warm up the caches */
+    fn(dst_buf + dst_off, src_buf + src_off, BENCH_LEN);
+
+    start = get_cycles();
+    for (i = 0; i < BENCH_LOOPS; i++)
+        fn(dst_buf + dst_off, src_buf + src_off, BENCH_LEN);
+    cycles = get_cycles() - start;
+
+    if (!cycles)
+        cycles = 1;
+    return (BENCH_LEN * BENCH_LOOPS * 1000UL) / cycles;
+}
+
+static void
+bench_copy(const char *name, copy_fn_t fn)
+{
+    unsigned long r[8];
+    size_t s, d;
+
+    printk("%s (bytes/Kcycle, rows: src offset, columns: dst offset 0-7)\n",
+           name);
+    for (s = 0; s < 8; s++) {
+        for (d = 0; d < 8; d++)
+            r[d] = bench_one(fn, s, d);
+        printk("  %lu: %lu %lu %lu %lu %lu %lu %lu %lu\n", s,
+               r[0], r[1], r[2], r[3], r[4], r[5], r[6], r[7]);
+    }
+}
+
+static int __init
+init_module(void)
+{
+    printk("module[test_startup]: init begin ...\n");
+
+    memset(src_buf, 0x5a, sizeof(src_buf));
+
+    bench_copy("__memcpy", __memcpy);
+    bench_copy("__memmove", __memmove);
+    bench_copy("copy_to_user", bench_copy_to_user);
+    bench_copy("copy_from_user", bench_copy_from_user);
+
+    printk("module[test_startup]: init end!\n");
+    return 0;
+}
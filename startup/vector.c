@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <csr.h>
+#include <smp.h>
+#include <types.h>
+#include <export.h>
+#include <vector.h>
+
+bool riscv_v_enabled;
+EXPORT_SYMBOL(riscv_v_enabled);
+
+/*
+ * Kernel vector sections neither nest nor sleep, an interrupt inside
+ * one falls back to scalar code. There is no kernel preemption, so a
+ * section begins and ends on the same CPU.
+ */
+static bool kernel_vector_active[NR_CPUS];
+
+/* Single-letter extensions come before the first '_', e.g. rv64gcv_zba */
+static bool
+isa_has_v(const char *isa)
+{
+    if ((isa[0] | 0x20) != 'r' || (isa[1] | 0x20) != 'v')
+        return false;
+
+    for (isa += 2; *isa >= '0' && *isa <= '9'; isa++)
+        ;
+
+    for (; *isa && *isa != '_'; isa++) {
+        if ((*isa | 0x20) == 'v')
+            return true;
+    }
+
+    return false;
+}
+
+bool riscv_v_setup(const char *isa)
+{
+    unsigned long vlenb;
+
+    if (!isa || !isa_has_v(isa))
+        return false;
+
+    csr_set(CSR_SSTATUS, SR_VS_INITIAL);
+    vlenb = csr_read(CSR_VLENB);
+    csr_clear(CSR_SSTATUS, SR_VS);
+
+    if (!vlenb)
+        return false;
+
+    riscv_v_enabled = true;
+    return true;
+}
+EXPORT_SYMBOL(riscv_v_setup);
+
+bool may_use_vector(void)
+{
+    return riscv_v_enabled && !kernel_vector_active[smp_processor_id()];
+}
+EXPORT_SYMBOL(may_use_vector);
+
+/*
+ * User tasks start with VS off (start_thread()) and nothing turns it
+ * on, so there is no user vector state to save: the section may
+ * clobber all vector registers.
+ */
+void kernel_vector_begin(void)
+{
+    kernel_vector_active[smp_processor_id()] = true;
+
+    /* The trap entry turned V off */
+    csr_set(CSR_SSTATUS, SR_VS_INITIAL);
+}
+EXPORT_SYMBOL(kernel_vector_begin);
+
+void kernel_vector_end(void)
+{
+    csr_clear(CSR_SSTATUS, SR_VS);
+    kernel_vector_active[smp_processor_id()] = false;
+}
+EXPORT_SYMBOL(kernel_vector_end);
@@ -1,11 +1,23 @@
 // SPDX-License-Identifier: GPL-2.0-only
 
 #include <bug.h>
+#include <sbi.h>
+#include <smp.h>
+#include <tick.h>
+#include <reboot.h>
 #include <printk.h>
+#include <profile.h>
+#include <lockstat.h>
+#include <irqflags.h>
+#include <processor.h>
+#include <tracepoint.h>
+#include <export.h>
 #include <string.h>
 #include <uaccess.h>
 #include <utsname.h>
 #include <syscalls.h>
+#include <linkage.h>
+#include <current.h>
 
 long _do_sys_newuname(struct new_utsname *name)
 {
@@ -17,12 +29,62 @@ long _do_sys_newuname(struct new_utsname *name)
     return 0;
 }
 
-static int
+long _do_sys_getcpu(unsigned *cpup, unsigned *nodep, void *unused)
+{
+    int err = 0;
+    int cpu = smp_processor_id();
+
+    if (cpup)
+        err |= put_user(cpu, cpup);
+    if (nodep)
+        err |= put_user(0, nodep);
+    return err ? -EFAULT : 0;
+}
+
+void kernel_power_off(void)
+{
+    printk("Power down\n");
+
+    trace_dump();
+    profile_dump();
+    lockstat_dump();
+    tick_nohz_dump();
+    console_flush();
+
+    sbi_shutdown();
+
+    printk("reboot: firmware refused to power off, halting\n");
+    console_flush();
+    local_irq_disable();
+    for (;;)
+        wait_for_interrupt();
+}
+EXPORT_SYMBOL(kernel_power_off);
+
+long _do_sys_reboot(int magic1, int magic2, unsigned int cmd, void *arg)
+{
+    if (magic1 != LINUX_REBOOT_MAGIC1 ||
+        (magic2 != LINUX_REBOOT_MAGIC2 &&
+         magic2 != LINUX_REBOOT_MAGIC2A &&
+         magic2 != LINUX_REBOOT_MAGIC2B &&
+         magic2 != LINUX_REBOOT_MAGIC2C))
+        return -EINVAL;
+
+    /* Neither restart nor halt, a VM is just switched off */
+    if (cmd != LINUX_REBOOT_CMD_POWER_OFF)
+        return -EINVAL;
+
+    kernel_power_off();
+}
+
+static int __init
 init_module(void)
 {
     printk("module[sys]: init begin ...\n");
 
     do_sys_newuname = _do_sys_newuname;
+    do_sys_getcpu = _do_sys_getcpu;
+    do_sys_reboot = _do_sys_reboot;
 
     printk("module[sys]: init end!\n");
     return 0;
@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#include <bug.h>
+#include <ktime.h>
+#include <timex.h>
+#include <errno.h>
+#include <export.h>
+#include <printk.h>
+#include <clocksource.h>
+
+#include "internal.h"
+
+/**
+ * clocks_calc_mult_shift - calculate mult/shift factors for scaled math of clocks
+ * @mult:   pointer to mult variable
+ * @shift:  pointer to shift variable
+ * @from:   frequency to convert from
+ * @to:     frequency to convert to
+ * @maxsec: guaranteed runtime conversion range in seconds
+ *
+ * The function evaluates the shift/mult pair for the scaled math
+ * operations of clocksources and clockevents.
+ *
+ * @to and @from are frequency values in HZ. For clock sources @to is
+ * NSEC_PER_SEC == 1GHz and @from is the counter frequency. For clock
+ * event @to is the counter frequency and @from is NSEC_PER_SEC.
+ *
+ * The @maxsec conversion range argument controls the time frame in
+ * seconds which must be covered by the runtime conversion with the
+ * calculated mult and shift factors. This guarantees that no 64bit
+ * overflow happens when the input value of the conversion is
+ * multiplied with the calculated mult factor. Larger ranges may
+ * reduce the conversion accuracy by choosing smaller mult and shift
+ * factors.
+ */
+void
+clocks_calc_mult_shift(u32 *mult, u32 *shift, u32 from, u32 to, u32 maxsec)
+{
+    u64 tmp;
+    u32 sft, sftacc = 32;
+
+    /*
+     * Calculate the shift factor which is limiting the conversion
+     * range:
+     */
+    tmp = ((u64)maxsec * from) >> 32;
+    while (tmp) {
+        tmp >>= 1;
+        sftacc--;
+    }
+
+    /*
+     * Find the conversion shift/mult pair which has the best
+     * accuracy and fits the maxsec conversion range:
+     */
+    for (sft = 32; sft > 0; sft--) {
+        tmp = (u64) to << sft;
+        tmp += from / 2;
+        tmp /= from;
+        if ((tmp >> sftacc) == 0)
+            break;
+    }
+    *mult = tmp;
+    *shift = sft;
+}
+EXPORT_SYMBOL(clocks_calc_mult_shift);
+
+/*
+ * The conversions don't overflow with the 128 bit product, the range
+ * only trades against precision. Ten minutes as Linux caps it.
+ */
+#define CLOCKSOURCE_MAXSEC  600
+
+/**
+ * clocksource_register_hz - Register a clocksource running at @hz
+ * @cs:     clocksource to be registered
+ * @hz:     frequency of the counter
+ *
+ * The one with the highest rating becomes the clock of ktime_get().
+ */
+int clocksource_register_hz(struct clocksource *cs, u32 hz)
+{
+    if (!hz)
+        return -EINVAL;
+
+    clocks_calc_mult_shift(&cs->mult, &cs->shift, hz, NSEC_PER_SEC,
+                           CLOCKSOURCE_MAXSEC);
+
+    pr_info("clocksource: %s: mask: 0x%lx mult: %u shift: %u\n",
+            cs->name, cs->mask, cs->mult, cs->shift);
+
+    if (!tk_core.clock || cs->rating > tk_core.clock->rating)
+        timekeeping_set_clock(cs, hz);
+    return 0;
+}
+EXPORT_SYMBOL(clocksource_register_hz);
+
+/* The time CSR, at timebase-frequency from the device tree */
+static u64 riscv_clocksource_rdtime(struct clocksource *cs)
+{
+    return get_time();
+}
+
+static struct clocksource riscv_clocksource = {
+    .name   = "riscv_clocksource",
+    .rating = 300,
+    .mask   = CLOCKSOURCE_MASK(64),
+    .read   = riscv_clocksource_rdtime,
+};
+
+int clocksource_init(void)
+{
+    return clocksource_register_hz(&riscv_clocksource, riscv_timebase);
+}
@@ -0,0 +1,13 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#include <types.h>
+#include <timekeeper_internal.h>
+
+extern struct timekeeper tk_core;
+
+void timekeeping_set_clock(struct clocksource *cs, u32 hz);
+void update_wall_time(void);
+
+int clocksource_init(void);
+
+void time_init_syscalls(void);
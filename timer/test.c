@@ -0,0 +1,185 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <ktime.h>
+#include <timex.h>
+#include <timer.h>
+#include <printk.h>
+#include <linkage.h>
+#include <clocksource.h>
+
+static unsigned long test_fired;
+
+static int
+test_clock(void)
+{
+    ktime_t t0, t1;
+    u64 ns, cyc;
+
+    /* A second of the timebase both ways, off by rounding at most */
+    ns = cycles_to_ns(riscv_timebase);
+    if (ns < NSEC_PER_SEC - 1 || ns > NSEC_PER_SEC + 1) {
+        printk(_RED("%lu cycles are %lu ns!\n"), riscv_timebase, ns);
+        return -1;
+    }
+
+    cyc = ns_to_cycles(NSEC_PER_SEC);
+    if (cyc < riscv_timebase - 1 || cyc > riscv_timebase + 1) {
+        printk(_RED("a second is %lu cycles!\n"), cyc);
+        return -1;
+    }
+
+    /* Far past the conversion range, still no overflow */
+    ns = cycles_to_ns(riscv_timebase * 86400 * 365);
+    if (ns / NSEC_PER_SEC < 86400 * 365 - 1) {
+        printk(_RED("a year is %lu s!\n"), ns / NSEC_PER_SEC);
+        return -1;
+    }
+
+    t0 = ktime_get();
+    t1 = ktime_get();
+    if (t1 < t0 || sched_clock() < t1) {
+        printk(_RED("clock went back %ld %ld!\n"), t0, t1);
+        return -1;
+    }
+
+    return 0;
+}
+
+static void
+test_timer_fn(struct timer_list *t)
+{
+    test_fired++;
+}
+
+static int
+test_pending(void)
+{
+    struct timer_list timer;
+
+    timer_setup(&timer, test_timer_fn, 0);
+    if (timer_pending(&timer)) {
+        printk(_RED("new timer is pending!\n"));
+        return -1;
+    }
+
+    if (mod_timer(&timer, jiffies + HZ)) {
+        printk(_RED("mod_timer of an inactive timer returned 1!\n"));
+        return -1;
+    }
+    if (!timer_pending(&timer)) {
+        printk(_RED("timer isn't pending!\n"));
+        return -1;
+    }
+
+    /* Same bucket and another level, and past the wheel */
+    if (!mod_timer(&timer, jiffies + HZ + 1) ||
+        !mod_timer(&timer, jiffies + 100 * HZ) ||
+        !mod_timer(&timer, jiffies + 365 * 24 * 3600UL * HZ)) {
+        printk(_RED("mod_timer of a pending timer returned 0!\n"));
+        return -1;
+    }
+
+    if (!del_timer(&timer) || timer_pending(&timer)) {
+        printk(_RED("del_timer of a pending timer failed!\n"));
+        return -1;
+    }
+    if (del_timer(&timer)) {
+        printk(_RED("del_timer of an inactive timer returned 1!\n"));
+        return -1;
+    }
+
+    return 0;
+}
+
+/* What the idle loop stops the tick for */
+static int
+test_next_timer(void)
+{
+    struct timer_list timer;
+    unsigned long basej = jiffies, next;
+
+    timer_setup(&timer, test_timer_fn, 0);
+    mod_timer(&timer, basej + 100);
+
+    /* Later than asked by the granularity of its level at most */
+    next = get_next_timer_interrupt(basej);
+    if (time_after(next, basej + 100 + 8)) {
+        printk(_RED("next timer at +%lu!\n"), next - basej);
+        del_timer(&timer);
+        return -1;
+    }
+
+    /* Due already */
+    if (get_next_timer_interrupt(basej + 200) != basej + 200) {
+        printk(_RED("due timer not reported!\n"));
+        del_timer(&timer);
+        return -1;
+    }
+
+    del_timer(&timer);
+    return 0;
+}
+
+/* Only when the tick already runs, intc starts it */
+static int
+test_expiry(void)
+{
+    struct timer_list timer, never;
+    unsigned long start = jiffies;
+    u64 end = get_time() + riscv_timebase / HZ * 8;
+
+    timer_setup(&timer, test_timer_fn, 0);
+    timer_setup(&never, test_timer_fn, 0);
+    timer.expires = jiffies + 2;
+    add_timer(&timer);
+    mod_timer(&never, jiffies + HZ);
+
+    while (get_time() < end && !test_fired)
+        ;
+
+    del_timer(&never);
+    if (jiffies == start) {
+        del_timer(&timer);
+        printk("no tick yet, expiry not checked\n");
+        return 0;
+    }
+
+    if (test_fired != 1 || timer_pending(&timer)) {
+        printk(_RED("timer fired %lu times by %lu!\n"),
+               test_fired, jiffies - start);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int __init
+init_module(void)
+{
+    printk("module[test_timer]: init begin ...\n");
+
+    if (test_clock()) {
+        printk(_RED("test clock failed!\n"));
+        return -1;
+    }
+
+    if (test_pending()) {
+        printk(_RED("test pending failed!\n"));
+        return -1;
+    }
+
+    if (test_next_timer()) {
+        printk(_RED("test next timer failed!\n"));
+        return -1;
+    }
+
+    if (test_expiry()) {
+        printk(_RED("test expiry failed!\n"));
+        return -1;
+    }
+
+    printk(_GREEN("okay!\n"));
+
+    printk("module[test_timer]: init end!\n");
+    return 0;
+}
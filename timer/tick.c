@@ -0,0 +1,296 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <csr.h>
+#include <sbi.h>
+#include <smp.h>
+#include <tick.h>
+#include <ktime.h>
+#include <timex.h>
+#include <timer.h>
+#include <export.h>
+#include <limits.h>
+#include <printk.h>
+#include <hardirq.h>
+#include <profile.h>
+#include <irqflags.h>
+
+/* Timebase ticks per jiffy */
+static u64 tick_period;
+
+/* The CPU which keeps jiffies and runs the timer wheel, the boot CPU */
+static int tick_do_timer_cpu;
+
+/*
+ * State of the tick and its idle residency, on each CPU. The ticks of
+ * the boot CPU are the jiffies, those of the others only drive the
+ * scheduler and are stopped whenever they idle.
+ */
+static struct tick_sched {
+    u64             next_tick;      /* timebase time of the next tick */
+    bool            inidle;
+    bool            tick_stopped;
+    u64             idle_expires;   /* timebase time of the next timer */
+    ktime_t         idle_entrytime;
+    ktime_t         idle_sleeptime;
+    unsigned long   idle_calls;     /* entries of the idle loop */
+    unsigned long   idle_sleeps;    /* with the tick stopped */
+} tick_cpu_sched[NR_CPUS];
+
+static inline struct tick_sched *this_tick_sched(void)
+{
+    return &tick_cpu_sched[smp_processor_id()];
+}
+
+static void tick_program(struct tick_sched *ts)
+{
+    u64 next = profile_next_event();
+
+    if (ts->tick_stopped)
+        sbi_set_timer(min(ts->idle_expires, next));
+    else
+        sbi_set_timer(min(ts->next_tick, next));
+}
+
+/* Late ticks are caught up in one go, returns how many */
+static unsigned long tick_advance(struct tick_sched *ts, u64 now)
+{
+    unsigned long ticks;
+
+    if (now < ts->next_tick)
+        return 0;
+
+    ticks = (now - ts->next_tick) / tick_period + 1;
+    ts->next_tick += ticks * tick_period;
+    return ticks;
+}
+
+/* On the boot CPU only */
+static unsigned long tick_do_update_jiffies(struct tick_sched *ts, u64 now)
+{
+    unsigned long ticks = tick_advance(ts, now);
+
+    if (ticks)
+        do_timer(ticks);
+    return ticks;
+}
+
+/**
+ * tick_init - Start the periodic tick
+ *
+ * The timer interrupt goes through the handler of the interrupt
+ * controller, so it can't be enabled before that is installed.
+ */
+int tick_init(void)
+{
+    struct tick_sched *ts = this_tick_sched();
+
+    tick_do_timer_cpu = smp_processor_id();
+    tick_period = riscv_timebase / HZ;
+    ts->next_tick = get_time() + tick_period;
+
+    pr_info("tick: %d Hz, %lu timebase ticks each\n", HZ, tick_period);
+
+    tick_program(ts);
+    csr_set(CSR_IE, IE_TIE);
+    return 0;
+}
+EXPORT_SYMBOL(tick_init);
+
+/**
+ * tick_init_secondary - Start the tick of a secondary CPU
+ *
+ * Called on the CPU as it comes online, right before its idle loop,
+ * with interrupts off. It starts out with the tick stopped, that is
+ * with no timer at all, and ticks once it runs a task.
+ */
+void tick_init_secondary(void)
+{
+    struct tick_sched *ts = this_tick_sched();
+
+    ts->next_tick = get_time() + tick_period;
+    ts->idle_expires = ULONG_MAX;
+    ts->tick_stopped = true;
+
+    tick_program(ts);
+    csr_set(CSR_IE, IE_TIE);
+}
+EXPORT_SYMBOL(tick_init_secondary);
+
+void tick_interrupt(struct pt_regs *regs)
+{
+    struct tick_sched *ts = this_tick_sched();
+    u64 now = get_time();
+
+    irq_enter();
+
+    /*
+     * Tick again after the timer of a stopped tick, the idle loop
+     * stops it once more if there is still nothing to do.
+     */
+    ts->tick_stopped = false;
+
+    if (smp_processor_id() == tick_do_timer_cpu) {
+        if (tick_do_update_jiffies(ts, now))
+            update_process_times(user_mode(regs));
+        printk_tick();
+    } else if (tick_advance(ts, now)) {
+        /* The timers are all on the wheel of the boot CPU */
+        scheduler_tick();
+    }
+
+    profile_tick(regs);
+    tick_program(ts);
+
+    irq_exit();
+}
+EXPORT_SYMBOL(tick_interrupt);
+
+/**
+ * tick_nohz_idle_enter - prepare for entering idle on the current CPU
+ *
+ * Called when we start the idle loop, the time from here on up to
+ * tick_nohz_idle_exit() is idle time.
+ */
+void tick_nohz_idle_enter(void)
+{
+    struct tick_sched *ts = this_tick_sched();
+    unsigned long flags;
+
+    local_irq_save(flags);
+
+    ts->inidle = true;
+    ts->idle_entrytime = ktime_get();
+    ts->idle_calls++;
+
+    local_irq_restore(flags);
+}
+EXPORT_SYMBOL(tick_nohz_idle_enter);
+
+/**
+ * tick_nohz_idle_stop_tick - stop the idle tick from the idle task
+ *
+ * Called with interrupts off right before the CPU waits for one.
+ * Programs the timer for the next timer of the wheel instead of the
+ * next jiffy, or for no time at all without any. An interrupt ends
+ * the wait, the idle loop comes back here for anything it queued.
+ *
+ * The timers are all on the wheel of the boot CPU. The other CPUs
+ * stop their tick for good, an IPI brings them out of idle.
+ */
+void tick_nohz_idle_stop_tick(void)
+{
+    struct tick_sched *ts = this_tick_sched();
+    unsigned long basej, delta;
+
+    if (smp_processor_id() != tick_do_timer_cpu) {
+        ts->idle_expires = ULONG_MAX;
+        goto stop;
+    }
+
+    tick_do_update_jiffies(ts, get_time());
+
+    /* Tasks on the other CPUs queue timers */
+    lock_kernel();
+    basej = jiffies;
+    delta = get_next_timer_interrupt(basej) - basej;
+    unlock_kernel();
+
+    /* A timer on the next jiffy, nothing to save */
+    if (delta <= 1)
+        return;
+
+    if (delta >= NEXT_TIMER_MAX_DELTA)
+        ts->idle_expires = ULONG_MAX;
+    else
+        ts->idle_expires = ts->next_tick + (delta - 1) * tick_period;
+
+stop:
+    if (!ts->tick_stopped) {
+        ts->tick_stopped = true;
+        ts->idle_sleeps++;
+    }
+    tick_program(ts);
+}
+EXPORT_SYMBOL(tick_nohz_idle_stop_tick);
+
+/**
+ * tick_nohz_idle_exit - restart the idle tick from the idle task
+ *
+ * Restart the idle tick when the CPU is woken up from idle, jiffies
+ * is brought up to date for the task about to run. The ticks another
+ * CPU missed meanwhile are skipped.
+ */
+void tick_nohz_idle_exit(void)
+{
+    struct tick_sched *ts = this_tick_sched();
+    unsigned long flags;
+    ktime_t now;
+
+    local_irq_save(flags);
+
+    now = ktime_get();
+    ts->idle_sleeptime += now - ts->idle_entrytime;
+    ts->inidle = false;
+
+    if (ts->tick_stopped) {
+        ts->tick_stopped = false;
+        if (smp_processor_id() == tick_do_timer_cpu)
+            tick_do_update_jiffies(ts, get_time());
+        else
+            tick_advance(ts, get_time());
+        tick_program(ts);
+    }
+
+    local_irq_restore(flags);
+}
+EXPORT_SYMBOL(tick_nohz_idle_exit);
+
+/**
+ * get_cpu_idle_time_us - get the total idle time of a CPU
+ * @cpu: CPU number to query
+ * @last_update_time: variable to store update time in, may be NULL
+ *
+ * Return the cumulative idle time (since boot) for a given
+ * CPU, in microseconds, the ongoing idle period included.
+ */
+u64 get_cpu_idle_time_us(int cpu, u64 *last_update_time)
+{
+    struct tick_sched *ts = &tick_cpu_sched[cpu];
+    unsigned long flags;
+    ktime_t now, idle;
+
+    local_irq_save(flags);
+
+    now = ktime_get();
+    idle = ts->idle_sleeptime;
+    if (ts->inidle)
+        idle += now - ts->idle_entrytime;
+
+    local_irq_restore(flags);
+
+    if (last_update_time)
+        *last_update_time = ktime_to_us(now);
+    return ktime_to_us(idle);
+}
+EXPORT_SYMBOL(get_cpu_idle_time_us);
+
+/* Idle and busy residency of each CPU since boot, to the console */
+void tick_nohz_dump(void)
+{
+    struct tick_sched *ts;
+    u64 now, idle, busy;
+    int cpu;
+
+    for_each_online_cpu(cpu) {
+        ts = &tick_cpu_sched[cpu];
+        idle = get_cpu_idle_time_us(cpu, &now);
+        busy = now - idle;
+
+        pr_info("tick: cpu%d idle %lu ms busy %lu ms (%lu percent idle), "
+                "%lu idle entries, %lu with the tick stopped\n",
+                cpu, idle / USEC_PER_MSEC, busy / USEC_PER_MSEC,
+                now ? idle * 100 / now : 0,
+                ts->idle_calls, ts->idle_sleeps);
+    }
+}
+EXPORT_SYMBOL(tick_nohz_dump);
@@ -0,0 +1,68 @@
+// SPDX-License-Identifier: GPL-2.0
+
+#include <time.h>
+#include <errno.h>
+#include <ktime.h>
+#include <uaccess.h>
+#include <syscalls.h>
+
+#include "internal.h"
+
+/*
+ * The syscall side of the vDSO clocks, for callers without it and for
+ * the clocks it doesn't know. Both read the same mult/shift.
+ */
+static long
+_do_sys_clock_gettime(clockid_t which_clock, struct __kernel_timespec *tp)
+{
+    struct __kernel_timespec ts;
+    u64 ns;
+
+    switch (which_clock) {
+    case CLOCK_REALTIME:
+    case CLOCK_MONOTONIC:
+    case CLOCK_MONOTONIC_RAW:
+    case CLOCK_BOOTTIME:
+        ns = ktime_get_ns();
+        break;
+    case CLOCK_REALTIME_COARSE:
+    case CLOCK_MONOTONIC_COARSE:
+        ns = tk_core.base;
+        break;
+    default:
+        return -EINVAL;
+    }
+
+    ts.tv_sec = ns / NSEC_PER_SEC;
+    ts.tv_nsec = ns % NSEC_PER_SEC;
+    if (copy_to_user(tp, &ts, sizeof(ts)))
+        return -EFAULT;
+    return 0;
+}
+
+static long
+_do_sys_gettimeofday(struct __kernel_old_timeval *tv, struct timezone *tz)
+{
+    if (likely(tv != NULL)) {
+        struct __kernel_old_timeval ktv;
+        u64 ns = ktime_get_ns();
+
+        ktv.tv_sec = ns / NSEC_PER_SEC;
+        ktv.tv_usec = (ns % NSEC_PER_SEC) / NSEC_PER_USEC;
+        if (copy_to_user(tv, &ktv, sizeof(ktv)))
+            return -EFAULT;
+    }
+    if (unlikely(tz != NULL)) {
+        struct timezone ktz = { 0 };
+
+        if (copy_to_user(tz, &ktz, sizeof(ktz)))
+            return -EFAULT;
+    }
+    return 0;
+}
+
+void time_init_syscalls(void)
+{
+    do_sys_clock_gettime = _do_sys_clock_gettime;
+    do_sys_gettimeofday = _do_sys_gettimeofday;
+}
@@ -0,0 +1,66 @@
+// SPDX-License-Identifier: GPL-2.0
+
+#include <ktime.h>
+#include <export.h>
+#include <clocksource.h>
+
+#include "internal.h"
+
+struct timekeeper tk_core;
+
+/* Nanoseconds the other way round are good for ten minutes as well */
+#define NS2CYC_MAXSEC   600
+
+void timekeeping_set_clock(struct clocksource *cs, u32 hz)
+{
+    tk_core.mult = cs->mult;
+    tk_core.shift = cs->shift;
+    clocks_calc_mult_shift(&tk_core.ns2cyc_mult, &tk_core.ns2cyc_shift,
+                           NSEC_PER_SEC, hz, NS2CYC_MAXSEC);
+    tk_core.clock = cs;
+    update_wall_time();
+}
+
+/* Called by do_timer(), for the coarse clocks and the vDSO */
+void update_wall_time(void)
+{
+    tk_core.base = ktime_get();
+    update_vsyscall(&tk_core);
+}
+
+/**
+ * ktime_get - The monotonic time of the clocksource
+ *
+ * The time CSR counts from reset and never goes backwards, nothing
+ * to accumulate or to protect with a seqcount.
+ */
+ktime_t ktime_get(void)
+{
+    struct clocksource *clock = tk_core.clock;
+
+    return clocksource_cyc2ns(clock->read(clock), tk_core.mult,
+                              tk_core.shift);
+}
+EXPORT_SYMBOL(ktime_get);
+
+u64 cycles_to_ns(u64 cycles)
+{
+    return clocksource_cyc2ns(cycles, tk_core.mult, tk_core.shift);
+}
+EXPORT_SYMBOL(cycles_to_ns);
+
+u64 ns_to_cycles(u64 ns)
+{
+    return mul_u64_u32_shr(ns, tk_core.ns2cyc_mult, tk_core.ns2cyc_shift);
+}
+EXPORT_SYMBOL(ns_to_cycles);
+
+/*
+ * Scheduler clock - returns current time in nanosec units. It is the
+ * same clock here, but what the scheduler calls on every switch.
+ */
+u64 sched_clock(void)
+{
+    return ktime_get();
+}
+EXPORT_SYMBOL(sched_clock);
@@ -0,0 +1,586 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <bug.h>
+#include <timer.h>
+#include <export.h>
+#include <printk.h>
+#include <sched.h>
+#include <hardirq.h>
+#include <find_bit.h>
+#include <irqflags.h>
+#include <linkage.h>
+
+#include "internal.h"
+
+unsigned long volatile jiffies = INITIAL_JIFFIES;
+EXPORT_SYMBOL(jiffies);
+
+/*
+ * The timer wheel has LVL_DEPTH array levels. Each level provides an array of
+ * LVL_SIZE buckets. Each level is driven by its own clock and therefor each
+ * level has a different granularity.
+ *
+ * The level granularity is:        LVL_CLK_DIV ^ lvl
+ * The level clock frequency is:    HZ / (LVL_CLK_DIV ^ level)
+ *
+ * The array level of a newly armed timer depends on the relative expiry
+ * time. The farther the expiry time is away the higher the array level and
+ * therefor the granularity becomes.
+ *
+ * Contrary to the original timer wheel implementation, which aims for 'exact'
+ * expiry of the timers, this implementation removes the need for recascading
+ * the timers into the lower array levels. The previous 'classic' timer wheel
+ * implementation of the kernel already violated the 'exact' expiry by adding
+ * slack to the expiry time to provide batched expiration. The granularity
+ * levels provide implicit batching.
+ *
+ * With HZ 250 and 9 levels the wheel covers about 12 days, with one
+ * jiffy of granularity for the first 63 jiffies, 8 up to 511 and so
+ * on. Timers farther out expire at the wheel capacity.
+ */
+
+/* Clock divisor for the next level */
+#define LVL_CLK_SHIFT   3
+#define LVL_CLK_DIV     (1UL << LVL_CLK_SHIFT)
+#define LVL_CLK_MASK    (LVL_CLK_DIV - 1)
+#define LVL_SHIFT(n)    ((n) * LVL_CLK_SHIFT)
+#define LVL_GRAN(n)     (1UL << LVL_SHIFT(n))
+
+/*
+ * The time start value for each level to select the bucket at enqueue
+ * time. We start from the last possible delta of the previous level
+ * so that we can later add an extra LVL_GRAN(n) to n (see calc_index()).
+ */
+#define LVL_START(n)    ((LVL_SIZE - 1) << (((n) - 1) * LVL_CLK_SHIFT))
+
+/* Size of each clock level */
+#define LVL_BITS        6
+#define LVL_SIZE        (1UL << LVL_BITS)
+#define LVL_MASK        (LVL_SIZE - 1)
+#define LVL_OFFS(n)     ((n) * LVL_SIZE)
+
+/* Level depth */
+#if HZ > 100
+# define LVL_DEPTH      9
+#else
+# define LVL_DEPTH      8
+#endif
+
+/* The cutoff (max. capacity of the wheel) */
+#define WHEEL_TIMEOUT_CUTOFF    (LVL_START(LVL_DEPTH))
+#define WHEEL_TIMEOUT_MAX       (WHEEL_TIMEOUT_CUTOFF - LVL_GRAN(LVL_DEPTH - 1))
+
+/* The resulting wheel size */
+#define WHEEL_SIZE      (LVL_SIZE * LVL_DEPTH)
+
+struct timer_base {
+    struct timer_list   *running_timer;
+    unsigned long       clk;
+    unsigned long       next_expiry;
+    bool                next_expiry_recalc;
+    bool                timers_pending;
+    DECLARE_BITMAP(pending_map, WHEEL_SIZE);
+    struct hlist_head   vectors[WHEEL_SIZE];
+};
+
+/* One CPU, one base, serialized by turning interrupts off */
+static struct timer_base timer_base;
+
+static inline unsigned int timer_get_idx(struct timer_list *timer)
+{
+    return (timer->flags & TIMER_ARRAYMASK) >> TIMER_ARRAYSHIFT;
+}
+
+static inline void timer_set_idx(struct timer_list *timer, unsigned int idx)
+{
+    timer->flags = (timer->flags & ~TIMER_ARRAYMASK) |
+        idx << TIMER_ARRAYSHIFT;
+}
+
+/*
+ * Helper function to calculate the array index for a given expiry
+ * time. The timer expires at the first tick of the bucket after it,
+ * never early.
+ */
+static inline unsigned
+calc_index(unsigned long expires, unsigned lvl, unsigned long *bucket_expiry)
+{
+    expires = (expires >> LVL_SHIFT(lvl)) + 1;
+    *bucket_expiry = expires << LVL_SHIFT(lvl);
+    return LVL_OFFS(lvl) + (expires & LVL_MASK);
+}
+
+static int
+calc_wheel_index(unsigned long expires, unsigned long clk,
+                 unsigned long *bucket_expiry)
+{
+    unsigned long delta = expires - clk;
+    unsigned int lvl;
+
+    /*
+     * Force expire obscene large timeouts to expire at the
+     * capacity limit of the wheel.
+     */
+    if ((long)delta < 0) {
+        *bucket_expiry = clk;
+        return clk & LVL_MASK;
+    }
+    if (delta >= WHEEL_TIMEOUT_CUTOFF) {
+        expires = clk + WHEEL_TIMEOUT_MAX;
+        delta = WHEEL_TIMEOUT_MAX;
+    }
+
+    for (lvl = 0; lvl < LVL_DEPTH - 1; lvl++) {
+        if (delta < LVL_START(lvl + 1))
+            break;
+    }
+    return calc_index(expires, lvl, bucket_expiry);
+}
+
+/*
+ * Enqueue the timer into the hash bucket, mark it pending in
+ * the bitmap, store the index in the timer flags and bring the
+ * next expiry forward if the bucket expires before it.
+ */
+static void
+enqueue_timer(struct timer_base *base, struct timer_list *timer,
+              unsigned int idx, unsigned long bucket_expiry)
+{
+    hlist_add_head(&timer->entry, base->vectors + idx);
+    __set_bit(idx, base->pending_map);
+    timer_set_idx(timer, idx);
+
+    if (time_before(bucket_expiry, base->next_expiry)) {
+        base->next_expiry = bucket_expiry;
+        base->timers_pending = true;
+        base->next_expiry_recalc = false;
+    }
+}
+
+static void
+internal_add_timer(struct timer_base *base, struct timer_list *timer)
+{
+    unsigned long bucket_expiry;
+    unsigned int idx;
+
+    idx = calc_wheel_index(timer->expires, base->clk, &bucket_expiry);
+    enqueue_timer(base, timer, idx, bucket_expiry);
+}
+
+static inline void detach_timer(struct timer_list *timer, bool clear_pending)
+{
+    struct hlist_node *entry = &timer->entry;
+
+    __hlist_del(entry);
+    if (clear_pending)
+        entry->pprev = NULL;
+    entry->next = NULL;
+}
+
+static int
+detach_if_pending(struct timer_list *timer, struct timer_base *base,
+                  bool clear_pending)
+{
+    unsigned idx = timer_get_idx(timer);
+
+    if (!timer_pending(timer))
+        return 0;
+
+    if (hlist_is_singular_node(&timer->entry, base->vectors + idx)) {
+        __clear_bit(idx, base->pending_map);
+        base->next_expiry_recalc = true;
+    }
+
+    detach_timer(timer, clear_pending);
+    return 1;
+}
+
+/*
+ * Find the next pending bucket of a level. Search from level start (@offset)
+ * + @clk upwards and if nothing there, search from start of the level
+ * (@offset) up to @offset + clk.
+ */
+static int
+next_pending_bucket(struct timer_base *base, unsigned offset, unsigned clk)
+{
+    unsigned pos, start = offset + clk;
+    unsigned end = offset + LVL_SIZE;
+
+    pos = find_next_bit(base->pending_map, end, start);
+    if (pos < end)
+        return pos - start;
+
+    pos = find_next_bit(base->pending_map, start, offset);
+    return pos < start ? pos + LVL_SIZE - start : -1;
+}
+
+/*
+ * Search the first expiring timer in the various clock levels. Caller must
+ * have interrupts off.
+ */
+static unsigned long __next_timer_interrupt(struct timer_base *base)
+{
+    unsigned long clk, next, adj;
+    unsigned lvl, offset = 0;
+
+    next = base->clk + NEXT_TIMER_MAX_DELTA;
+    clk = base->clk;
+    for (lvl = 0; lvl < LVL_DEPTH; lvl++, offset += LVL_SIZE) {
+        int pos = next_pending_bucket(base, offset, clk & LVL_MASK);
+        unsigned long lvl_clk = clk & LVL_CLK_MASK;
+
+        if (pos >= 0) {
+            unsigned long tmp = clk + (unsigned long)pos;
+
+            tmp <<= LVL_SHIFT(lvl);
+            if (time_before(tmp, next))
+                next = tmp;
+
+            /*
+             * If the next expiration happens before we reach
+             * the next level, no need to check further.
+             */
+            if (pos <= ((LVL_CLK_DIV - lvl_clk) & LVL_CLK_MASK))
+                break;
+        }
+        /*
+         * Clock for the next level. If the current level clock lower
+         * bits are zero, we look at the next level as is. If not we
+         * need to advance it by one because that's going to be the
+         * next expiring bucket in that level. base->clk is the next
+         * expiring jiffie. So in case of:
+         *
+         * LVL5 LVL4 LVL3 LVL2 LVL1 LVL0
+         *  0    0    0    0    0    0
+         *
+         * we have to look at all levels @index 0. With
+         *
+         * LVL5 LVL4 LVL3 LVL2 LVL1 LVL0
+         *  0    0    0    0    0    2
+         *
+         * LVL0 has the next expiring bucket @index 2. The upper
+         * levels have the next expiring bucket @index 1.
+         */
+        adj = lvl_clk ? 1 : 0;
+        clk >>= LVL_CLK_SHIFT;
+        clk += adj;
+    }
+
+    base->next_expiry_recalc = false;
+    base->timers_pending = !(next == base->clk + NEXT_TIMER_MAX_DELTA);
+    return next;
+}
+
+/**
+ * get_next_timer_interrupt - return the jiffy of the next pending timer
+ * @basej: base time jiffies
+ *
+ * Called by the idle loop with interrupts off. Returns @basej when a
+ * timer is due already, @basej + NEXT_TIMER_MAX_DELTA without any.
+ */
+unsigned long get_next_timer_interrupt(unsigned long basej)
+{
+    struct timer_base *base = &timer_base;
+
+    if (base->next_expiry_recalc)
+        base->next_expiry = __next_timer_interrupt(base);
+
+    if (!base->timers_pending)
+        return basej + NEXT_TIMER_MAX_DELTA;
+
+    if (time_before_eq(base->next_expiry, basej))
+        return basej;
+
+    return base->next_expiry;
+}
+EXPORT_SYMBOL(get_next_timer_interrupt);
+
+/*
+ * Without a timer to expire base->clk lags behind jiffies, bring it
+ * up before a timer is queued so that the level is picked from the
+ * real delta, not one as old as the last expiry.
+ */
+static void forward_timer_base(struct timer_base *base)
+{
+    unsigned long jnow = jiffies;
+
+    if (time_before_eq(jnow, base->clk))
+        return;
+
+    if (base->next_expiry_recalc)
+        base->next_expiry = __next_timer_interrupt(base);
+
+    if (time_after(base->next_expiry, jnow))
+        base->clk = jnow;
+    else if (time_after(base->next_expiry, base->clk))
+        base->clk = base->next_expiry;
+}
+
+static inline int
+__mod_timer(struct timer_list *timer, unsigned long expires)
+{
+    struct timer_base *base = &timer_base;
+    unsigned long bucket_expiry, flags;
+    unsigned int idx;
+    int ret;
+
+    BUG_ON(!timer->function);
+
+    local_irq_save(flags);
+
+    /*
+     * This is a common optimization triggered by the networking code -
+     * if the timer is re-modified to have the same timeout or ends up
+     * in the same array bucket then just return.
+     */
+    if (timer_pending(timer)) {
+        if (timer->expires == expires) {
+            local_irq_restore(flags);
+            return 1;
+        }
+
+        forward_timer_base(base);
+        idx = calc_wheel_index(expires, base->clk, &bucket_expiry);
+        if (idx == timer_get_idx(timer)) {
+            timer->expires = expires;
+            local_irq_restore(flags);
+            return 1;
+        }
+    } else {
+        forward_timer_base(base);
+    }
+
+    ret = detach_if_pending(timer, base, false);
+
+    timer->expires = expires;
+    internal_add_timer(base, timer);
+
+    local_irq_restore(flags);
+    return ret;
+}
+
+/**
+ * mod_timer - modify a timer's timeout
+ * @timer: the timer to be modified
+ * @expires: new timeout in jiffies
+ *
+ * mod_timer() is a more efficient way to update the expire field of an
+ * active timer (if the timer is inactive it will be activated)
+ *
+ * The function returns whether it has modified a pending timer or not.
+ * (ie. mod_timer() of an inactive timer returns 0, mod_timer() of an
+ * active timer returns 1.)
+ */
+int mod_timer(struct timer_list *timer, unsigned long expires)
+{
+    return __mod_timer(timer, expires);
+}
+EXPORT_SYMBOL(mod_timer);
+
+/**
+ * add_timer - start a timer
+ * @timer: the timer to be added
+ *
+ * The kernel will do a ->function(@timer) callback from the
+ * timer interrupt at the ->expires point in the future. The
+ * current time is 'jiffies'.
+ *
+ * The timer's ->expires, ->function fields must be set prior calling
+ * this function.
+ *
+ * Timers with an ->expires field in the past will be executed in the
+ * next timer tick.
+ */
+void add_timer(struct timer_list *timer)
+{
+    BUG_ON(timer_pending(timer));
+    __mod_timer(timer, timer->expires);
+}
+EXPORT_SYMBOL(add_timer);
+
+/**
+ * del_timer - deactivate a timer.
+ * @timer: the timer to be deactivated
+ *
+ * del_timer() deactivates a timer - this works on both active and inactive
+ * timers.
+ *
+ * The function returns whether it has deactivated a pending timer or not.
+ * (ie. del_timer() of an inactive timer returns 0, del_timer() of an
+ * active timer returns 1.)
+ */
+int del_timer(struct timer_list *timer)
+{
+    unsigned long flags;
+    int ret;
+
+    local_irq_save(flags);
+    ret = detach_if_pending(timer, &timer_base, true);
+    local_irq_restore(flags);
+
+    return ret;
+}
+EXPORT_SYMBOL(del_timer);
+
+static void expire_timers(struct timer_base *base, struct hlist_head *head)
+{
+    while (!hlist_empty(head)) {
+        struct timer_list *timer;
+
+        timer = hlist_entry(head->first, struct timer_list, entry);
+
+        base->running_timer = timer;
+        detach_timer(timer, true);
+
+        timer->function(timer);
+    }
+    base->running_timer = NULL;
+}
+
+static int
+__collect_expired_timers(struct timer_base *base, struct hlist_head *heads)
+{
+    unsigned long clk = base->clk;
+    struct hlist_head *vec;
+    int i, levels = 0;
+    unsigned int idx;
+
+    for (i = 0; i < LVL_DEPTH; i++) {
+        idx = (clk & LVL_MASK) + i * LVL_SIZE;
+
+        if (test_bit(idx, base->pending_map)) {
+            __clear_bit(idx, base->pending_map);
+            vec = base->vectors + idx;
+            hlist_move_list(vec, heads++);
+            levels++;
+        }
+        /* Is it time to look at the next level? */
+        if (clk & LVL_CLK_MASK)
+            break;
+        /* Shift clock for the next level granularity */
+        clk >>= LVL_CLK_SHIFT;
+    }
+    return levels;
+}
+
+/*
+ * After jiffies ran ahead, e.g. with no timer queued for a while,
+ * jump base->clk straight to the next expiry instead of walking it
+ * up one jiffy at a time.
+ */
+static int
+collect_expired_timers(struct timer_base *base, struct hlist_head *heads)
+{
+    unsigned long now = jiffies;
+
+    if ((long)(now - base->clk) > 2) {
+        unsigned long next = __next_timer_interrupt(base);
+
+        /*
+         * If the next timer is ahead of time forward to current
+         * jiffies, otherwise forward to the next expiry time:
+         */
+        if (time_after(next, now)) {
+            /*
+             * The call site will increment base->clk and then
+             * terminate the expiry loop immediately.
+             */
+            base->clk = now;
+            return 0;
+        }
+        base->clk = next;
+    }
+    return __collect_expired_timers(base, heads);
+}
+
+/**
+ * __run_timers - run all expired timers (if any) on this CPU.
+ * @base: the timer vector to be processed.
+ */
+static inline void __run_timers(struct timer_base *base)
+{
+    struct hlist_head heads[LVL_DEPTH];
+    int levels;
+
+    if (time_before(jiffies, base->next_expiry))
+        return;
+
+    while (time_after_eq(jiffies, base->clk) &&
+           time_after_eq(jiffies, base->next_expiry)) {
+        levels = collect_expired_timers(base, heads);
+        base->clk++;
+        base->next_expiry = __next_timer_interrupt(base);
+
+        while (levels--)
+            expire_timers(base, heads + levels);
+    }
+}
+
+/*
+ * This function runs timers and the timer-tq in bottom half context.
+ */
+static void run_timer_softirq(struct softirq_action *h)
+{
+    __run_timers(&timer_base);
+}
+
+/*
+ * Called by the local, per-CPU timer interrupt on SMP.
+ */
+static void run_local_timers(void)
+{
+    if (time_before(jiffies, timer_base.next_expiry))
+        return;
+
+    raise_softirq_irqoff(TIMER_SOFTIRQ);
+}
+
+/*
+ * Called from the timer interrupt handler to charge one tick to the current
+ * process.  user_tick is 1 if the tick is user time, 0 for system.
+ */
+void update_process_times(int user_tick)
+{
+    run_local_timers();
+    scheduler_tick();
+}
+EXPORT_SYMBOL(update_process_times);
+
+/*
+ * Called by the tick with interrupts off, @ticks is more than one
+ * when ticks were missed.
+ */
+void do_timer(unsigned long ticks)
+{
+    jiffies += ticks;
+    update_wall_time();
+}
+EXPORT_SYMBOL(do_timer);
+
+static void init_timer_cpus(void)
+{
+    struct timer_base *base = &timer_base;
+    unsigned int i;
+
+    for (i = 0; i < WHEEL_SIZE; i++)
+        INIT_HLIST_HEAD(base->vectors + i);
+
+    base->clk = jiffies;
+    base->next_expiry = base->clk + NEXT_TIMER_MAX_DELTA;
+}
+
+static int __init
+init_module(void)
+{
+    printk("module[timer]: init begin ...\n");
+
+    if (clocksource_init())
+        panic("no clocksource!");
+
+    init_timer_cpus();
+    open_softirq(TIMER_SOFTIRQ, run_timer_softirq);
+    time_init_syscalls();
+
+    printk("module[timer]: init end!\n");
+    return 0;
+}
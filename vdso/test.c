@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <elf.h>
+#include <page.h>
+#include <vdso.h>
+#include <ktime.h>
+#include <timex.h>
+#include <printk.h>
+#include <string.h>
+#include <jiffies.h>
+#include <linkage.h>
+
+extern struct vdso_data *vdso_data;
+
+static int
+test_image(void)
+{
+    struct elfhdr *ehdr = (void *)vdso_data + PAGE_SIZE;
+
+    if (!PAGE_ALIGNED(vdso_data)) {
+        printk(_RED("data page at %lx!\n"), (unsigned long)vdso_data);
+        return -1;
+    }
+
+    if (memcmp(ehdr->e_ident, ELFMAG, SELFMAG) || ehdr->e_type != ET_DYN) {
+        printk(_RED("no shared object behind the data page!\n"));
+        return -1;
+    }
+
+    return 0;
+}
+
+/* The data page follows the tick, once the timer module runs it */
+static int
+test_data(void)
+{
+    unsigned long start = jiffies;
+    u64 end = get_time() + riscv_timebase / HZ * 8;
+    unsigned seq;
+    u64 ns, now;
+
+    if (!vdso_data->mult) {
+        printk("no clocksource yet, data not checked\n");
+        return 0;
+    }
+
+    while (get_time() < end && jiffies == start)
+        ;
+
+    if (jiffies == start) {
+        printk("no tick yet, data not checked\n");
+        return 0;
+    }
+
+    do {
+        seq = read_seqcount_begin(&vdso_data->seq);
+        ns = vdso_data->coarse_ns;
+    } while (read_seqcount_retry(&vdso_data->seq, seq));
+
+    if (seq & 1) {
+        printk(_RED("update left the seqcount odd!\n"));
+        return -1;
+    }
+
+    now = ktime_get_ns();
+    if (ns > now || now - ns > 8 * NSEC_PER_SEC / HZ) {
+        printk(_RED("coarse time %lu at %lu!\n"), ns, now);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int __init
+init_module(void)
+{
+    printk("module[test_vdso]: init begin ...\n");
+
+    if (test_image()) {
+        printk(_RED("test image failed!\n"));
+        return -1;
+    }
+
+    if (test_data()) {
+        printk(_RED("test data failed!\n"));
+        return -1;
+    }
+
+    printk(_GREEN("okay!\n"));
+
+    printk("module[test_vdso]: init end!\n");
+    return 0;
+}
@@ -0,0 +1,135 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <mm.h>
+#include <csr.h>
+#include <gfp.h>
+#include <log2.h>
+#include <slab.h>
+#include <vdso.h>
+#include <errno.h>
+#include <export.h>
+#include <kernel.h>
+#include <printk.h>
+#include <string.h>
+#include <current.h>
+#include <linkage.h>
+#include <irqflags.h>
+#include <timekeeper_internal.h>
+
+/* vdso.so as linked, see image.S */
+extern char vdso_start[], vdso_end[];
+
+static unsigned int vdso_pages;
+
+/* The data page, then the text, NULL terminated */
+static struct page **vdso_pagelist;
+
+struct vdso_data *vdso_data;
+EXPORT_SYMBOL(vdso_data);
+
+static struct vm_special_mapping vdso_mappings[] = {
+    { .name = "[vvar]" },
+    { .name = "[vdso]" },
+};
+
+/* Called by the tick with irqs off, and once by clocksource_init() */
+void update_vsyscall(struct timekeeper *tk)
+{
+    struct vdso_data *vdata = vdso_data;
+    unsigned long flags;
+
+    local_irq_save(flags);
+    write_seqcount_begin(&vdata->seq);
+
+    vdata->mult = tk->mult;
+    vdata->shift = tk->shift;
+    vdata->coarse_ns = tk->base;
+
+    write_seqcount_end(&vdata->seq);
+    local_irq_restore(flags);
+}
+EXPORT_SYMBOL(update_vsyscall);
+
+int arch_setup_additional_pages(struct linux_binprm *bprm, int uses_interp)
+{
+    struct mm_struct *mm = current->mm;
+    struct vm_area_struct *vma;
+    unsigned long vdso_base, vdso_len;
+
+    vdso_len = (vdso_pages + 1) << PAGE_SHIFT;
+    vdso_base = get_unmapped_area(NULL, 0, vdso_len, 0, 0);
+    if (IS_ERR_VALUE(vdso_base))
+        return vdso_base;
+
+    vma = _install_special_mapping(mm, vdso_base, PAGE_SIZE,
+                                   VM_READ | VM_MAYREAD,
+                                   &vdso_mappings[0]);
+    if (IS_ERR(vma))
+        return PTR_ERR(vma);
+
+    vdso_base += PAGE_SIZE;
+    vma = _install_special_mapping(mm, vdso_base, vdso_pages << PAGE_SHIFT,
+                                   VM_READ | VM_EXEC |
+                                   VM_MAYREAD | VM_MAYWRITE | VM_MAYEXEC,
+                                   &vdso_mappings[1]);
+    if (IS_ERR(vma))
+        return PTR_ERR(vma);
+
+    mm->vdso = (void *)vdso_base;
+    return 0;
+}
+EXPORT_SYMBOL(arch_setup_additional_pages);
+
+static int
+vdso_init(void)
+{
+    struct page *page;
+    unsigned int i;
+    void *base;
+
+    vdso_pages = PAGE_ALIGN(vdso_end - vdso_start) >> PAGE_SHIFT;
+
+    vdso_pagelist = kmalloc(sizeof(struct page *) * (vdso_pages + 2),
+                            GFP_KERNEL);
+    if (!vdso_pagelist)
+        return -ENOMEM;
+
+    /* The text goes right behind the data, as vdso.lds expects */
+    page = alloc_pages(GFP_KERNEL | __GFP_ZERO,
+                       get_order((vdso_pages + 1) << PAGE_SHIFT));
+    if (!page) {
+        kfree(vdso_pagelist);
+        return -ENOMEM;
+    }
+
+    base = page_address(page);
+    memcpy(base + PAGE_SIZE, vdso_start, vdso_end - vdso_start);
+    asm volatile ("fence.i" ::: "memory");
+
+    for (i = 0; i <= vdso_pages; i++)
+        vdso_pagelist[i] = page + i;
+    vdso_pagelist[i] = NULL;
+
+    vdso_data = base;
+    vdso_data->nr_cpus = 1;
+    vdso_mappings[0].pages = vdso_pagelist;
+    vdso_mappings[1].pages = vdso_pagelist + 1;
+
+    /* rdtime of the vDSO traps unless U-mode may read the time CSR */
+    csr_set(CSR_SCOUNTEREN, SCOUNTEREN_TM);
+    return 0;
+}
+
+static int __init
+init_module(void)
+{
+    printk("module[vdso]: init begin ...\n");
+
+    if (vdso_init())
+        panic("no memory for the vdso!");
+
+    printk("module[vdso]: %u pages of text\n", vdso_pages);
+
+    printk("module[vdso]: init end!\n");
+    return 0;
+}
@@ -0,0 +1,40 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <types.h>
+#include <vdso.h>
+
+#undef __SYSCALL
+#define __SYSCALL(nr, call)
+#include <asm_unistd.h>
+
+extern const struct vdso_data _vdso_data __attribute__((visibility("hidden")));
+
+static int
+getcpu_fallback(unsigned *_cpu, unsigned *_node, void *_unused)
+{
+    register unsigned *cpu asm("a0") = _cpu;
+    register unsigned *node asm("a1") = _node;
+    register void *unused asm("a2") = _unused;
+    register long nr asm("a7") = __NR_getcpu;
+    register long ret asm("a0");
+
+    asm volatile ("ecall\n"
+                  : "=r" (ret)
+                  : "r" (cpu), "r" (node), "r" (unused), "r" (nr)
+                  : "memory");
+
+    return ret;
+}
+
+/* Nothing in user mode tells the hart, only the kernel knows with SMP */
+int __vdso_getcpu(unsigned *cpu, unsigned *node, void *unused)
+{
+    if (READ_ONCE(_vdso_data.nr_cpus) > 1)
+        return getcpu_fallback(cpu, node, unused);
+
+    if (cpu)
+        *cpu = 0;
+    if (node)
+        *node = 0;
+    return 0;
+}
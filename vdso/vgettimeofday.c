@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Clock reads of the vDSO, run in user mode: the time CSR and the
+ * mult/shift of the data page, no trap unless the clock is unknown.
+ */
+
+#include <time.h>
+#include <vdso.h>
+#include <ktime.h>
+#include <timex.h>
+#include <math64.h>
+
+#undef __SYSCALL
+#define __SYSCALL(nr, call)
+#include <asm_unistd.h>
+
+extern const struct vdso_data _vdso_data __attribute__((visibility("hidden")));
+
+static long
+clock_gettime_fallback(clockid_t _clkid, struct __kernel_timespec *_ts)
+{
+    register clockid_t clkid asm("a0") = _clkid;
+    register struct __kernel_timespec *ts asm("a1") = _ts;
+    register long nr asm("a7") = __NR_clock_gettime;
+    register long ret asm("a0");
+
+    asm volatile ("ecall\n"
+                  : "=r" (ret)
+                  : "r" (clkid), "r" (ts), "r" (nr)
+                  : "memory");
+
+    return ret;
+}
+
+/* The ns of ktime_get(), or of the last tick when @coarse */
+static u64
+vdso_read_ns(const struct vdso_data *vd, bool coarse)
+{
+    unsigned seq;
+    u64 ns;
+
+    do {
+        seq = read_seqcount_begin(&vd->seq);
+        if (coarse)
+            ns = vd->coarse_ns;
+        else
+            ns = mul_u64_u32_shr(get_time(), vd->mult, vd->shift);
+    } while (read_seqcount_retry(&vd->seq, seq));
+
+    return ns;
+}
+
+int __vdso_clock_gettime(clockid_t clock, struct __kernel_timespec *ts)
+{
+    u64 ns;
+
+    switch (clock) {
+    case CLOCK_REALTIME:
+    case CLOCK_MONOTONIC:
+    case CLOCK_MONOTONIC_RAW:
+    case CLOCK_BOOTTIME:
+        ns = vdso_read_ns(&_vdso_data, false);
+        break;
+    case CLOCK_REALTIME_COARSE:
+    case CLOCK_MONOTONIC_COARSE:
+        ns = vdso_read_ns(&_vdso_data, true);
+        break;
+    default:
+        return clock_gettime_fallback(clock, ts);
+    }
+
+    ts->tv_sec = ns / NSEC_PER_SEC;
+    ts->tv_nsec = ns % NSEC_PER_SEC;
+    return 0;
+}
+
+int __vdso_gettimeofday(struct __kernel_old_timeval *tv, struct timezone *tz)
+{
+    u64 ns;
+
+    if (likely(tv != NULL)) {
+        ns = vdso_read_ns(&_vdso_data, false);
+        tv->tv_sec = ns / NSEC_PER_SEC;
+        tv->tv_usec = (ns % NSEC_PER_SEC) / NSEC_PER_USEC;
+    }
+    if (unlikely(tz != NULL)) {
+        tz->tz_minuteswest = 0;
+        tz->tz_dsttime = 0;
+    }
+    return 0;
+}
@@ -4,6 +4,7 @@
 #include <export.h>
 #include <printk.h>
 #include <virtio.h>
+#include <linkage.h>
 
 int _virtio_index = 0;
 EXPORT_SYMBOL(_virtio_index);
@@ -249,7 +250,7 @@ virtio_check_driver_offered_feature(const struct virtio_device *vdev,
 }
 EXPORT_SYMBOL(virtio_check_driver_offered_feature);
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[virtio]: init begin ...\n");
@@ -15,6 +15,8 @@
 #include <virtio_blk.h>
 #include <scatterlist.h>
 #include <virtio_ring.h>
+#include <trace/events/block.h>
+#include <linkage.h>
 
 #define PART_BITS 4
 #define VQ_NAME_LEN 16
@@ -375,6 +377,8 @@ virtio_queue_rq(struct blk_mq_hw_ctx *hctx,
         break;
     }
 
+    trace_block_rq_issue(req);
+
     vbr->out_hdr.type   = type;
     vbr->out_hdr.sector = type ? 0 : blk_rq_pos(req);
     vbr->out_hdr.ioprio = req_get_ioprio(req);
@@ -543,7 +547,7 @@ static struct virtio_driver virtio_blk = {
     .feature_table_size_legacy  = ARRAY_SIZE(features_legacy),
 };
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[virtio_blk]: init begin ...\n");
@@ -11,6 +11,7 @@
 #include <virtio_mmio.h>
 #include <virtio_config.h>
 #include <virtio_ring.h>
+#include <linkage.h>
 
 /* The alignment to use between consumer and producer parts of vring.
  * Currently hardcoded to the page size. */
@@ -429,7 +430,7 @@ virtio_mmio_init(void)
 }
 EXPORT_SYMBOL(virtio_mmio_init);
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[virtio_mmio]: init begin ...\n");
@@ -3,6 +3,7 @@
 #include <vma.h>
 #include <printk.h>
 #include <string.h>
+#include <linkage.h>
 
 static int
 test_get_vma(void)
@@ -17,7 +18,7 @@ test_get_vma(void)
     return 0;
 }
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[test_get_vma]: init begin ...\n");
@@ -10,6 +10,7 @@
 #include <limits.h>
 #include <rbtree.h>
 #include <pgtable.h>
+#include <linkage.h>
 
 /*
  * This linked list is used in pair with free_vmap_area_root.
@@ -560,7 +561,7 @@ free_vm_area(struct vm_struct *area)
 }
 EXPORT_SYMBOL(free_vm_area);
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[vma]: init begin ...\n");
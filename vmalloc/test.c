@@ -2,6 +2,7 @@
 #include <printk.h>
 #include <string.h>
 #include <vmalloc.h>
+#include <linkage.h>
 
 static int
 test_vmalloc(void)
@@ -16,7 +17,7 @@ test_vmalloc(void)
     return 0;
 }
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[test_vmalloc]: init begin ...\n");
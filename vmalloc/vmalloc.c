@@ -6,6 +6,7 @@
 #include <export.h>
 #include <pgtable.h>
 #include <vmalloc.h>
+#include <linkage.h>
 
 //static struct kmem_cache *vmap_area_cachep;
 
@@ -144,7 +145,7 @@ vmalloc(unsigned long size)
 EXPORT_SYMBOL(vmalloc);
 */
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[vmalloc]: init begin ...\n");
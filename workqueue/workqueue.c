@@ -6,7 +6,9 @@
 #include <printk.h>
 #include <string.h>
 #include <jiffies.h>
+#include <irqflags.h>
 #include <workqueue.h>
+#include <linkage.h>
 
 #define MIN_NICE    -20
 
@@ -153,13 +155,48 @@ alloc_workqueue(const char *fmt, unsigned int flags, int max_active)
 }
 EXPORT_SYMBOL(alloc_workqueue);
 
+/**
+ * try_to_grab_pending - steal work item from worklist and disable irq
+ * @work: work item to steal
+ * @is_dwork: @work is a delayed_work
+ * @flags: place to store irq state
+ *
+ * Try to grab PENDING bit of @work.  This function can handle @work in any
+ * stable state - idle, on timer or on worklist.
+ *
+ * Return:
+ *  1       if @work was pending and we successfully stole PENDING
+ *  0       if @work was idle and we claimed PENDING
+ *
+ * On return, irqs are disabled and the caller is responsible for
+ * restoring them with local_irq_restore(*@flags).
+ */
 static int
 try_to_grab_pending(struct work_struct *work, bool is_dwork,
                     unsigned long *flags)
 {
-    BUG_ON(!is_dwork);
+    local_irq_save(*flags);
+
+    /* try to steal the timer if it exists */
+    if (is_dwork) {
+        struct delayed_work *dwork = to_delayed_work(work);
+
+        /*
+         * Timers run with irqs off under the kernel lock.  If del_timer()
+         * fails, it's guaranteed that the timer is not queued
+         * anywhere and not running.
+         */
+        if (likely(del_timer(&dwork->timer)))
+            return 1;
+    }
 
-    return 0;
+    /* try to claim PENDING the normal way */
+    if (!test_and_set_bit(WORK_STRUCT_PENDING_BIT, work_data_bits(work)))
+        return 0;
+
+    /* Works run as they are queued, so it can only be a nested one */
+    list_del_init(&work->entry);
+    return 1;
 }
 
 static inline void
@@ -183,6 +220,9 @@ static void process_one_work(struct work_struct *work)
 {
     list_del_init(&work->entry);
 
+    /* It may queue itself again from ->func */
+    set_work_data(work, WORK_STRUCT_NO_POOL, 0);
+
     work->func(work);
 }
 
@@ -230,18 +270,59 @@ __queue_work(int cpu, struct workqueue_struct *wq, struct work_struct *work)
     insert_work(pwq, work, worklist, 0);
 }
 
+void delayed_work_timer_fn(struct timer_list *t)
+{
+    struct delayed_work *dwork = from_timer(dwork, t, timer);
+
+    /* should have been called from irqsafe timer with irq already off */
+    __queue_work(dwork->cpu, dwork->wq, &dwork->work);
+}
+EXPORT_SYMBOL(delayed_work_timer_fn);
+
 static void
 __queue_delayed_work(int cpu, struct workqueue_struct *wq,
                      struct delayed_work *dwork, unsigned long delay)
 {
+    struct timer_list *timer = &dwork->timer;
+    struct work_struct *work = &dwork->work;
+
+    BUG_ON(timer->function != delayed_work_timer_fn);
+    BUG_ON(timer_pending(timer));
+    BUG_ON(!list_empty(&work->entry));
+
+    /*
+     * If @delay is 0, queue @dwork->work immediately.  This is for
+     * both optimization and correctness.  The earliest @timer can
+     * expire is on the closest next tick and delayed_work users depend
+     * on that there's no such delay when @delay is 0.
+     */
     if (!delay) {
         __queue_work(cpu, wq, &dwork->work);
         return;
     }
 
-    panic("%s: !", __func__);
+    dwork->wq = wq;
+    dwork->cpu = cpu;
+    timer->expires = jiffies + delay;
+
+    add_timer(timer);
 }
 
+/**
+ * mod_delayed_work_on - modify delay of or queue a delayed work on specific CPU
+ * @cpu: CPU number to execute work on
+ * @wq: workqueue to use
+ * @dwork: work to queue
+ * @delay: number of jiffies to wait before queueing
+ *
+ * If @dwork is idle, equivalent to queue_delayed_work_on(); otherwise,
+ * modify @dwork's timer so that it expires after @delay.  If @delay is
+ * zero, @work is guaranteed to be scheduled immediately regardless of its
+ * current state.
+ *
+ * Return: %false if @dwork was idle and queued, %true if @dwork was
+ * pending and its timer was modified.
+ */
 bool
 mod_delayed_work_on(int cpu,
                     struct workqueue_struct *wq,
@@ -251,19 +332,36 @@ mod_delayed_work_on(int cpu,
     int ret;
     unsigned long flags;
 
-    do {
-        ret = try_to_grab_pending(&dwork->work, true, &flags);
-    } while (unlikely(ret == -EAGAIN));
-
-    if (likely(ret >= 0)) {
-        __queue_delayed_work(cpu, wq, dwork, delay);
-    }
+    ret = try_to_grab_pending(&dwork->work, true, &flags);
+    __queue_delayed_work(cpu, wq, dwork, delay);
+    local_irq_restore(flags);
 
-    /* -ENOENT from try_to_grab_pending() becomes %true */
     return ret;
 }
 EXPORT_SYMBOL(mod_delayed_work_on);
 
+/**
+ * cancel_delayed_work - cancel a delayed work
+ * @dwork: delayed_work to cancel
+ *
+ * Kill off a pending delayed_work.
+ *
+ * Return: %true if @dwork was pending and canceled; %false if it wasn't
+ * pending.
+ */
+bool cancel_delayed_work(struct delayed_work *dwork)
+{
+    unsigned long flags;
+    int ret;
+
+    ret = try_to_grab_pending(&dwork->work, true, &flags);
+    set_work_data(&dwork->work, WORK_STRUCT_NO_POOL, 0);
+    local_irq_restore(flags);
+
+    return ret;
+}
+EXPORT_SYMBOL(cancel_delayed_work);
+
 static int init_worker_pool(struct worker_pool *pool)
 {
     INIT_LIST_HEAD(&pool->worklist);
@@ -279,7 +377,7 @@ void workqueue_init(void)
         init_worker_pool(pool);
 }
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[workqueue]: init begin ...\n");
@@ -3,6 +3,7 @@
 #include <printk.h>
 #include <string.h>
 #include <xarray.h>
+#include <linkage.h>
 
 static int
 test_xas_load(struct xarray *xarray, pgoff_t offset)
@@ -111,7 +112,7 @@ test2(void)
     return 0;
 }
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[test_xarray]: init begin ...\n");
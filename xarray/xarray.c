@@ -6,6 +6,7 @@
 #include <printk.h>
 #include <string.h>
 #include <xarray.h>
+#include <linkage.h>
 
 struct kmem_cache *xa_node_cachep;
 
@@ -329,7 +330,7 @@ void xarray_init(void)
                                        xa_node_ctor);
 }
 
-static int
+static int __init
 init_module(void)
 {
     printk("module[xarray]: init begin ...\n");